@@ -27,6 +27,7 @@
 /* USER CODE BEGIN Includes */
 #include "trace.h"
 #include "w25qxx_Demo.h"
+#include "w25qxx_Queue.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -48,6 +49,11 @@
 
 /* Private variables ---------------------------------------------------------*/
 /* USER CODE BEGIN Variables */
+static w25qxx_HandleTypeDef w25qxx_Handle;
+w25qxx_QueueTypeDef w25qxx_Queue; // Other tasks submit flash requests here
+osMutexId_t w25qxxMutexHandle;
+osMutexId_t w25qxxQueueMutexHandle;
+osSemaphoreId_t w25qxxQueueSemHandle;
 
 /* USER CODE END Variables */
 /* Definitions for blinkTask */
@@ -105,6 +111,8 @@ void MX_FREERTOS_Init(void)
 
     /* USER CODE BEGIN RTOS_MUTEX */
     /* add mutexes, ... */
+    w25qxxMutexHandle = osMutexNew(NULL);
+    w25qxxQueueMutexHandle = osMutexNew(NULL);
     /* USER CODE END RTOS_MUTEX */
 
     /* Create the semaphores(s) */
@@ -113,6 +121,7 @@ void MX_FREERTOS_Init(void)
 
     /* USER CODE BEGIN RTOS_SEMAPHORES */
     /* add semaphores, ... */
+    w25qxxQueueSemHandle = osSemaphoreNew(1, 0, NULL);
     /* USER CODE END RTOS_SEMAPHORES */
 
     /* USER CODE BEGIN RTOS_TIMERS */
@@ -201,12 +210,32 @@ void BlinkStart(void *argument)
 void w25qxxStart(void *argument)
 {
     /* USER CODE BEGIN w25qxxStart */
-    /* Infinite loop */
-    for (;;)
-    {
-        w25qxx_Demo(Trace, true);
+    w25qxx_Demo(Trace, true);
+
+    /* Link platform functions */
+    w25qxx_Handle.interface.handle = &hspi1;
+    w25qxx_Handle.interface.receive = w25qxx_SPI_Receive;
+    w25qxx_Handle.interface.transmit = w25qxx_SPI_Transmit;
+    w25qxx_Handle.interface.cs_set = w25qxx_SPI1_CS0_Set;
+    w25qxx_Handle.interface.delay = w25qxx_Delay;
+    w25qxx_Handle.interface.lock = w25qxx_Lock;
+    w25qxx_Handle.interface.unlock = w25qxx_Unlock;
+    w25qxx_Handle.interface.lockContext = w25qxxMutexHandle;
+    w25qxx_Init(&w25qxx_Handle);
+
+    /* Link OS functions */
+    w25qxx_Queue.interface.lock = w25qxx_Lock;
+    w25qxx_Queue.interface.unlock = w25qxx_Unlock;
+    w25qxx_Queue.interface.lockContext = w25qxxQueueMutexHandle;
+    w25qxx_Queue.interface.notify = w25qxx_Notify;
+    w25qxx_Queue.interface.wait = w25qxx_Wait;
+    w25qxx_Queue.interface.notifyContext = w25qxxQueueSemHandle;
+    w25qxx_Queue.interface.now = w25qxx_Now;
+    if (w25qxx_QueueInit(&w25qxx_Queue, &w25qxx_Handle) != W25QXX_ERROR_NONE)
         osThreadSuspend(osThreadGetId());
-    }
+
+    /* Serve flash requests of other tasks: expired deadlines first, then reads, writes, erases in background */
+    w25qxx_QueueWorker(&w25qxx_Queue);
     /* USER CODE END w25qxxStart */
 }
 
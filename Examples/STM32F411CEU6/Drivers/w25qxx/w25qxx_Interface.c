@@ -79,6 +79,31 @@ void w25qxx_Print(const char *message)
     }
 }
 
+void w25qxx_Lock(void *context)
+{
+    osMutexAcquire((osMutexId_t) context, osWaitForever);
+}
+
+void w25qxx_Unlock(void *context)
+{
+    osMutexRelease((osMutexId_t) context);
+}
+
+void w25qxx_Notify(void *context)
+{
+    osSemaphoreRelease((osSemaphoreId_t) context);
+}
+
+bool w25qxx_Wait(void *context, uint32_t timeout)
+{
+    return (osSemaphoreAcquire((osSemaphoreId_t) context, timeout) == osOK);
+}
+
+uint32_t w25qxx_Now(void)
+{
+    return osKernelGetTickCount();
+}
+
 /**
  * @section Private Functions
  */
@@ -62,6 +62,38 @@ uint32_t w25qxx_Delay(uint32_t ms);
  */
 void w25qxx_Print(const char *message);
 
+/**
+ * @brief Takes the mutex
+ * @param context mutex ID
+ */
+void w25qxx_Lock(void *context);
+
+/**
+ * @brief Releases the mutex
+ * @param context mutex ID
+ */
+void w25qxx_Unlock(void *context);
+
+/**
+ * @brief Wakes the task waiting on the semaphore
+ * @param context semaphore ID
+ */
+void w25qxx_Notify(void *context);
+
+/**
+ * @brief Waits for the semaphore
+ * @param context semaphore ID
+ * @param timeout timeout duration [ms], `osWaitForever` to block until released
+ * @return true if the semaphore is acquired, false on timeout
+ */
+bool w25qxx_Wait(void *context, uint32_t timeout);
+
+/**
+ * @brief Returns the kernel tick used for request deadlines
+ * @return Tick count [ms]
+ */
+uint32_t w25qxx_Now(void);
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
@@ -0,0 +1,228 @@
+#include "w25qxx_Interface.h"
+#include "w25qxx_Test.h"
+
+/* Configuration */
+#define ASYNC_IMAGE        "w25qxx_AsyncTest.img"
+#define ASYNC_HOLD_TIME    20 // Time the held transfer keeps the handle [ms], below the driver transfer timeout
+#define ASYNC_COMPLETE_MAX 1000 // [ms]
+#define ASYNC_TIMEOUT_MAX  500 // Time the lost transfer keeps the handle without the tick and microsecond delay [ms]
+
+/* Private variables */
+static pthread_mutex_t handleMutex = PTHREAD_MUTEX_INITIALIZER;
+static sem_t transferDone;
+static w25qxx_Error_t transferError;
+static w25qxx_rx_async_fp portReceiveAsync;
+static w25qxx_abort_async_fp portAbortAsync;
+static uint32_t aborts;
+static struct {
+    void *handle;
+    uint8_t *pDataRx;
+    uint16_t size;
+    void *owner;
+} held; // Data phase kept from the DMA until `Async_Release()`
+
+static void Async_Complete(void *context, w25qxx_Error_t error);
+static void Async_Wait(void);
+static w25qxx_Transfer_Status_t Async_HoldReceive(void *handle, uint8_t *pDataRx, uint16_t size, void *owner);
+static void Async_Release(void);
+static void Async_Abort(void *handle);
+static void *Async_ReaderThread(void *argument);
+static void Test_WriteRead(w25qxx_HandleTypeDef *w25qxx_Handle, w25qxx_PortTypeDef *w25qxx_Port);
+static void Test_Checksum(w25qxx_HandleTypeDef *w25qxx_Handle, w25qxx_PortTypeDef *w25qxx_Port);
+static void Test_Owner(w25qxx_HandleTypeDef *w25qxx_Handle, w25qxx_PortTypeDef *w25qxx_Port);
+static void Test_Timeout(w25qxx_HandleTypeDef *w25qxx_Handle, w25qxx_PortTypeDef *w25qxx_Port);
+
+int main(void)
+{
+    static w25qxx_PortTypeDef port;
+    static w25qxx_HandleTypeDef w25qxx_Handle;
+
+    TEST_CHECK(sem_init(&transferDone, 0, 0) == 0);
+    Test_Open(&port, &w25qxx_Handle, ASYNC_IMAGE);
+    w25qxx_Handle.interface.lock = w25qxx_Lock;
+    w25qxx_Handle.interface.unlock = w25qxx_Unlock;
+    w25qxx_Handle.interface.lockContext = &handleMutex;
+    TEST_CHECK(w25qxx_PortAsyncLink(&port, &w25qxx_Handle));
+    portReceiveAsync = w25qxx_Handle.interface.receive_async;
+    portAbortAsync = w25qxx_Handle.interface.abort_async;
+    w25qxx_Handle.interface.abort_async = Async_Abort;
+
+    Test_WriteRead(&w25qxx_Handle, &port);
+    Test_Checksum(&w25qxx_Handle, &port);
+    Test_Owner(&w25qxx_Handle, &port);
+    Test_Timeout(&w25qxx_Handle, &port);
+
+    w25qxx_PortClose(&port);
+
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @section Private functions
+ */
+static void Async_Complete(void *context, w25qxx_Error_t error)
+{
+    (void) context;
+
+    transferError = error;
+    sem_post(&transferDone);
+}
+
+static void Async_Wait(void)
+{
+    TEST_CHECK(w25qxx_Wait(&transferDone, ASYNC_COMPLETE_MAX));
+}
+
+static w25qxx_Transfer_Status_t Async_HoldReceive(void *handle, uint8_t *pDataRx, uint16_t size, void *owner)
+{
+    held.handle = handle;
+    held.pDataRx = pDataRx;
+    held.size = size;
+    held.owner = owner;
+
+    return W25QXX_TRANSFER_SUCCESS;
+}
+
+static void Async_Release(void)
+{
+    TEST_CHECK(portReceiveAsync(held.handle, held.pDataRx, held.size, held.owner) == W25QXX_TRANSFER_SUCCESS);
+}
+
+static void Async_Abort(void *handle)
+{
+    aborts++;
+    portAbortAsync(handle);
+}
+
+static void *Async_ReaderThread(void *argument)
+{
+    static uint8_t page[W25QXX_PAGE_SIZE];
+    static w25qxx_Error_t error;
+
+    error = w25qxx_Read(argument, page, W25QXX_PAGE_SIZE - sizeof(uint16_t), 0x0000, W25QXX_CRC, W25QXX_FASTREAD_NO);
+
+    return &error;
+}
+
+static void Test_WriteRead(w25qxx_HandleTypeDef *w25qxx_Handle, w25qxx_PortTypeDef *w25qxx_Port)
+{
+    static uint8_t page[W25QXX_PAGE_SIZE - sizeof(uint16_t)], readBack[W25QXX_PAGE_SIZE - sizeof(uint16_t)];
+
+    /* Data and checksum phases end in the completion, /CS is released by the finish */
+    Test_Pattern(page, sizeof(page), 1);
+    TEST_CHECK(w25qxx_WriteAsync(w25qxx_Handle, page, sizeof(page), 0x0000, W25QXX_CRC, Async_Complete, NULL) ==
+               W25QXX_ERROR_NONE);
+    Async_Wait();
+    TEST_CHECK(transferError == W25QXX_ERROR_NONE);
+    TEST_CHECK(w25qxx_Port->sim.selected && (w25qxx_Handle->status == W25QXX_STATUS_WRITE));
+    TEST_CHECK(w25qxx_AsyncFinish(w25qxx_Handle) == W25QXX_ERROR_NONE);
+    TEST_CHECK(!w25qxx_Port->sim.selected && (w25qxx_Handle->status == W25QXX_STATUS_READY));
+    TEST_CHECK(w25qxx_Handle->async.stage == W25QXX_ASYNC_IDLE);
+
+    /* The frame checksum is stored behind the data */
+    TEST_CHECK(w25qxx_Read(w25qxx_Handle, readBack, sizeof(readBack), 0x0000, W25QXX_CRC, W25QXX_FASTREAD_NO) ==
+               W25QXX_ERROR_NONE);
+    TEST_CHECK(memcmp(readBack, page, sizeof(page)) == 0);
+
+    memset(readBack, 0, sizeof(readBack));
+    TEST_CHECK(w25qxx_ReadAsync(w25qxx_Handle, readBack, sizeof(readBack), 0x0000, W25QXX_CRC, W25QXX_FASTREAD,
+                                Async_Complete, NULL) == W25QXX_ERROR_NONE);
+    Async_Wait();
+    TEST_CHECK(transferError == W25QXX_ERROR_NONE);
+    TEST_CHECK(w25qxx_Port->sim.selected);
+    TEST_CHECK(w25qxx_AsyncFinish(w25qxx_Handle) == W25QXX_ERROR_NONE);
+    TEST_CHECK(!w25qxx_Port->sim.selected && (w25qxx_Handle->status == W25QXX_STATUS_READY));
+    TEST_CHECK(memcmp(readBack, page, sizeof(page)) == 0);
+
+    /* Nothing in flight */
+    TEST_CHECK(w25qxx_AsyncFinish(w25qxx_Handle) == W25QXX_ERROR_NONE);
+}
+
+static void Test_Checksum(w25qxx_HandleTypeDef *w25qxx_Handle, w25qxx_PortTypeDef *w25qxx_Port)
+{
+    static uint8_t page[W25QXX_PAGE_SIZE - sizeof(uint16_t)];
+
+    /* Stored checksum is broken, the completion reports it and the finish keeps it */
+    w25qxx_Port->sim.memory[W25QXX_PAGE_SIZE - 1] ^= 0x01;
+    TEST_CHECK(w25qxx_ReadAsync(w25qxx_Handle, page, sizeof(page), 0x0000, W25QXX_CRC, W25QXX_FASTREAD_NO,
+                                Async_Complete, NULL) == W25QXX_ERROR_NONE);
+    Async_Wait();
+    TEST_CHECK(transferError == W25QXX_ERROR_CHECKSUM);
+    TEST_CHECK(w25qxx_AsyncFinish(w25qxx_Handle) == W25QXX_ERROR_CHECKSUM);
+    TEST_CHECK(!w25qxx_Port->sim.selected);
+    w25qxx_Port->sim.memory[W25QXX_PAGE_SIZE - 1] ^= 0x01;
+
+    TEST_CHECK(w25qxx_ResetError(w25qxx_Handle) == W25QXX_ERROR_NONE);
+    TEST_CHECK(w25qxx_Handle->status == W25QXX_STATUS_READY);
+}
+
+static void Test_Owner(w25qxx_HandleTypeDef *w25qxx_Handle, w25qxx_PortTypeDef *w25qxx_Port)
+{
+    static uint8_t page[W25QXX_PAGE_SIZE - sizeof(uint16_t)], readBack[W25QXX_PAGE_SIZE - sizeof(uint16_t)];
+    w25qxx_Error_t *readerError;
+    pthread_t reader;
+
+    /* Another caller waits for the transfer in flight instead of failing on the status */
+    Test_Pattern(page, sizeof(page), 1);
+    w25qxx_Handle->interface.receive_async = Async_HoldReceive;
+    TEST_CHECK(w25qxx_ReadAsync(w25qxx_Handle, readBack, sizeof(readBack), 0x0000, W25QXX_CRC, W25QXX_FASTREAD_NO,
+                                Async_Complete, NULL) == W25QXX_ERROR_NONE);
+    w25qxx_Handle->interface.receive_async = portReceiveAsync;
+    TEST_CHECK(pthread_create(&reader, NULL, Async_ReaderThread, w25qxx_Handle) == 0);
+    w25qxx_Delay(ASYNC_HOLD_TIME);
+    TEST_CHECK(w25qxx_Port->sim.selected && (w25qxx_Handle->status == W25QXX_STATUS_READ));
+    TEST_CHECK(w25qxx_Handle->error == W25QXX_ERROR_NONE);
+
+    Async_Release();
+    Async_Wait();
+    TEST_CHECK(transferError == W25QXX_ERROR_NONE);
+    TEST_CHECK(pthread_join(reader, (void **) &readerError) == 0);
+    TEST_CHECK(*readerError == W25QXX_ERROR_NONE);
+    TEST_CHECK(memcmp(readBack, page, sizeof(page)) == 0);
+
+    /* Frame has been finished by the reader */
+    TEST_CHECK(w25qxx_AsyncFinish(w25qxx_Handle) == W25QXX_ERROR_NONE);
+    TEST_CHECK(!w25qxx_Port->sim.selected && (w25qxx_Handle->status == W25QXX_STATUS_READY));
+}
+
+static void Test_Timeout(w25qxx_HandleTypeDef *w25qxx_Handle, w25qxx_PortTypeDef *w25qxx_Port)
+{
+    static uint8_t readBack[W25QXX_PAGE_SIZE];
+    uint32_t start;
+
+    /* Lost completion ends the frame with the timeout, the channel is stopped */
+    w25qxx_Handle->interface.receive_async = Async_HoldReceive;
+    TEST_CHECK(w25qxx_ReadAsync(w25qxx_Handle, readBack, sizeof(readBack), 0x0000, W25QXX_CRC_NO, W25QXX_FASTREAD_NO,
+                                Async_Complete, NULL) == W25QXX_ERROR_NONE);
+    w25qxx_Handle->interface.receive_async = portReceiveAsync;
+    TEST_CHECK(w25qxx_AsyncFinish(w25qxx_Handle) == W25QXX_ERROR_TIMEOUT);
+    TEST_CHECK(!w25qxx_Port->sim.selected && (w25qxx_Handle->async.stage == W25QXX_ASYNC_IDLE));
+    TEST_CHECK(aborts == 1);
+
+    /* Late completion is dropped */
+    w25qxx_TransferComplete(w25qxx_Handle, W25QXX_TRANSFER_SUCCESS);
+    TEST_CHECK(sem_trywait(&transferDone) != 0);
+
+    TEST_CHECK(w25qxx_ResetError(w25qxx_Handle) == W25QXX_ERROR_NONE);
+    TEST_CHECK(w25qxx_Read(w25qxx_Handle, readBack, sizeof(readBack), 0x0000, W25QXX_CRC_NO, W25QXX_FASTREAD_NO) ==
+               W25QXX_ERROR_NONE);
+
+    /* Timeout is counted in the 1ms delays used without the tick and microsecond delay */
+    w25qxx_Handle->interface.tick = NULL;
+    w25qxx_Handle->interface.delay_us = NULL;
+    w25qxx_Handle->interface.receive_async = Async_HoldReceive;
+    TEST_CHECK(w25qxx_ReadAsync(w25qxx_Handle, readBack, sizeof(readBack), 0x0000, W25QXX_CRC_NO, W25QXX_FASTREAD_NO,
+                                Async_Complete, NULL) == W25QXX_ERROR_NONE);
+    w25qxx_Handle->interface.receive_async = portReceiveAsync;
+    start = w25qxx_Now();
+    TEST_CHECK(w25qxx_AsyncFinish(w25qxx_Handle) == W25QXX_ERROR_TIMEOUT);
+    TEST_CHECK((w25qxx_Now() - start) < ASYNC_TIMEOUT_MAX);
+    TEST_CHECK(aborts == 2);
+    TEST_CHECK(w25qxx_ResetError(w25qxx_Handle) == W25QXX_ERROR_NONE);
+
+    /* Async hooks come with the abort */
+    w25qxx_Handle->interface.abort_async = NULL;
+    TEST_CHECK(w25qxx_ReadAsync(w25qxx_Handle, readBack, sizeof(readBack), 0x0000, W25QXX_CRC_NO, W25QXX_FASTREAD_NO,
+                                Async_Complete, NULL) == W25QXX_ERROR_PLATFORM);
+    TEST_CHECK(w25qxx_Handle->async.stage == W25QXX_ASYNC_IDLE);
+}
\ No newline at end of file
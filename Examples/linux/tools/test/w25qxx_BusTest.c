@@ -0,0 +1,143 @@
+#include "w25qxx_Bus.h"
+#include "w25qxx_Interface.h"
+#include "w25qxx_Test.h"
+#include <sched.h>
+
+/* Configuration */
+#define BUS_DEVICES  2
+#define BUS_ADDRESS  0x10000 // Written by both tasks on their own device
+#define BUS_ROUNDS   50 // Write and read back rounds of each task
+#define BUS_PAGES    4 // Pages of one round
+
+/* Private variables */
+static const char *busImage[BUS_DEVICES] = {"w25qxx_BusTest0.img", "w25qxx_BusTest1.img"};
+static pthread_mutex_t busMutex = PTHREAD_MUTEX_INITIALIZER;
+static w25qxx_PortTypeDef port[BUS_DEVICES];
+static w25qxx_HandleTypeDef chipLink[BUS_DEVICES]; // Model functions of each chip, taken from the port
+static w25qxx_BusDeviceTypeDef busDevice[BUS_DEVICES];
+static uint32_t chip[BUS_DEVICES] = {0, 1};
+static volatile int32_t selected = -1; // Chip with /CS low, the shared lines are routed to it
+static volatile bool collision; // Second /CS went low while the bus was taken
+
+static w25qxx_Transfer_Status_t Bus_Receive(void *handle, uint8_t *pDataRx, uint16_t size, uint32_t timeout);
+static w25qxx_Transfer_Status_t Bus_Transmit(void *handle, const uint8_t *pDataTx, uint16_t size, uint32_t timeout);
+static void Bus_Select(void *context, w25qxx_CS_State_t newState);
+static void *Bus_Task(void *argument);
+
+int main(void)
+{
+    static w25qxx_BusTypeDef bus;
+    pthread_t task[BUS_DEVICES];
+    void *taskResult;
+
+    /* Two chips on one set of SPI lines, each with its own /CS */
+    bus.interface.receive = Bus_Receive;
+    bus.interface.transmit = Bus_Transmit;
+    bus.interface.lock = w25qxx_Lock;
+    bus.interface.unlock = w25qxx_Unlock;
+    bus.interface.lockContext = &busMutex;
+    for (uint32_t i = 0; i < BUS_DEVICES; i++)
+    {
+        Test_Open(&port[i], &chipLink[i], busImage[i]);
+        TEST_CHECK(w25qxx_BusAttach(&bus, &busDevice[i], Bus_Select, &chip[i], NULL) == W25QXX_ERROR_NONE);
+        TEST_CHECK(w25qxx_Init(&busDevice[i].w25qxx_Handle) == W25QXX_ERROR_NONE);
+        TEST_CHECK(busDevice[i].w25qxx_Handle.ID[1] == TEST_DEVICE);
+    }
+
+    /* Tasks use their devices at the same time, the transactions never interleave on the lines */
+    for (uint32_t i = 0; i < BUS_DEVICES; i++)
+        TEST_CHECK(pthread_create(&task[i], NULL, Bus_Task, &chip[i]) == 0);
+    for (uint32_t i = 0; i < BUS_DEVICES; i++)
+    {
+        TEST_CHECK(pthread_join(task[i], &taskResult) == 0);
+        TEST_CHECK(taskResult == NULL);
+    }
+    TEST_CHECK(!collision && (selected == -1));
+
+    /* Every chip holds only its own data */
+    for (uint32_t i = 0; i < BUS_DEVICES; i++)
+    {
+        static uint8_t data[W25QXX_PAGE_SIZE * BUS_PAGES];
+
+        Test_Pattern(data, sizeof(data), i * BUS_ROUNDS + BUS_ROUNDS - 1);
+        TEST_CHECK(memcmp(&port[i].sim.memory[BUS_ADDRESS], data, sizeof(data)) == 0);
+        w25qxx_PortClose(&port[i]);
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @section Private functions
+ */
+static w25qxx_Transfer_Status_t Bus_Receive(void *handle, uint8_t *pDataRx, uint16_t size, uint32_t timeout)
+{
+    int32_t device = selected;
+
+    (void) handle;
+
+    if (device < 0)
+        return W25QXX_TRANSFER_ERROR;
+
+    return chipLink[device].interface.receive(&port[device], pDataRx, size, timeout);
+}
+
+static w25qxx_Transfer_Status_t Bus_Transmit(void *handle, const uint8_t *pDataTx, uint16_t size, uint32_t timeout)
+{
+    int32_t device = selected;
+
+    (void) handle;
+
+    if (device < 0)
+        return W25QXX_TRANSFER_ERROR;
+
+    return chipLink[device].interface.transmit(&port[device], pDataTx, size, timeout);
+}
+
+static void Bus_Select(void *context, w25qxx_CS_State_t newState)
+{
+    int32_t device = (int32_t) *(uint32_t *) context;
+
+    if (newState == W25QXX_CS_LOW)
+    {
+        if ((selected != -1) && (selected != device))
+            collision = true;
+        selected = device;
+        chipLink[device].interface.cs_set_context(&port[device], W25QXX_CS_LOW);
+        sched_yield(); // Gives the other task a chance to break in
+    }
+    else
+    {
+        chipLink[device].interface.cs_set_context(&port[device], W25QXX_CS_HIGH);
+        if (selected == device)
+            selected = -1;
+    }
+}
+
+static void *Bus_Task(void *argument)
+{
+    static uint8_t data[BUS_DEVICES][W25QXX_PAGE_SIZE * BUS_PAGES], readBack[BUS_DEVICES][W25QXX_PAGE_SIZE * BUS_PAGES];
+    uint32_t device = *(uint32_t *) argument;
+    w25qxx_HandleTypeDef *w25qxx_Handle = &busDevice[device].w25qxx_Handle;
+
+    for (uint32_t round = 0; round < BUS_ROUNDS; round++)
+    {
+        Test_Pattern(data[device], sizeof(data[device]), device * BUS_ROUNDS + round);
+        if (w25qxx_Erase(w25qxx_Handle, W25QXX_SECTOR_ERASE_4KB, BUS_ADDRESS, W25QXX_WAIT_BUSY) != W25QXX_ERROR_NONE)
+            return w25qxx_Handle;
+        for (uint32_t page = 0; page < BUS_PAGES; page++)
+        {
+            if (w25qxx_Write(w25qxx_Handle, data[device] + page * W25QXX_PAGE_SIZE, W25QXX_PAGE_SIZE,
+                             BUS_ADDRESS + page * W25QXX_PAGE_SIZE, W25QXX_CRC_NO,
+                             W25QXX_WAIT_BUSY) != W25QXX_ERROR_NONE)
+                return w25qxx_Handle;
+        }
+        if (w25qxx_ReadStream(w25qxx_Handle, readBack[device], sizeof(readBack[device]), BUS_ADDRESS,
+                              W25QXX_FASTREAD) != W25QXX_ERROR_NONE)
+            return w25qxx_Handle;
+        if (memcmp(readBack[device], data[device], sizeof(data[device])) != 0)
+            return w25qxx_Handle;
+    }
+
+    return NULL;
+}
\ No newline at end of file
@@ -0,0 +1,130 @@
+#include "w25qxx_Cache.h"
+#include "w25qxx_Test.h"
+
+/* Configuration */
+#define CACHE_IMAGE      "w25qxx_CacheTest.img"
+#define CACHE_SIZE       (W25QXX_PAGE_SIZE * W25QXX_DEVICE_NUMBER_OF_PAGES(TEST_DEVICE))
+#define CACHE_LINES      4
+#define CACHE_RMW_SECTOR 16 // Partially written sector, its old content is kept around the new data
+#define CACHE_RMW_OFFSET 100
+#define CACHE_RMW_LENGTH 300
+#define CACHE_FULL       17 // Wholly written sector, nothing is read from the device
+#define CACHE_TRIM_START (W25QXX_SECTOR_TO_ADDRESS(31) + 10) // Sectors 32..49 are whole: one 64KB block and two sectors
+#define CACHE_TRIM_END   (W25QXX_SECTOR_TO_ADDRESS(50) + 20)
+#define CACHE_TRIM_DIRTY 33 // Dirty line within the trimmed range, dropped without the write-back
+
+/* Private variables */
+static uint8_t image[CACHE_SIZE]; // Expected device content
+static uint8_t data[W25QXX_SECTOR_SIZE_4KB], readBack[W25QXX_SECTOR_SIZE_4KB];
+
+static void Cache_Fill(w25qxx_PortTypeDef *w25qxx_Port, uint32_t firstSector, uint32_t numberOfSectors);
+static void Test_ReadModifyWrite(w25qxx_CacheTypeDef *w25qxx_Cache, w25qxx_PortTypeDef *w25qxx_Port);
+static void Test_Trim(w25qxx_CacheTypeDef *w25qxx_Cache, w25qxx_PortTypeDef *w25qxx_Port);
+static void Test_Image(void);
+
+int main(void)
+{
+    static w25qxx_PortTypeDef port;
+    static w25qxx_HandleTypeDef w25qxx_Handle;
+    static w25qxx_CacheTypeDef w25qxx_Cache;
+
+    Test_Open(&port, &w25qxx_Handle, CACHE_IMAGE);
+    TEST_CHECK(port.sim.size == sizeof(image));
+    memset(image, 0xFF, sizeof(image));
+    TEST_CHECK(w25qxx_CacheInit(&w25qxx_Cache, &w25qxx_Handle, CACHE_LINES) == W25QXX_ERROR_NONE);
+
+    Test_ReadModifyWrite(&w25qxx_Cache, &port);
+    Test_Trim(&w25qxx_Cache, &port);
+
+    w25qxx_CacheDeInit(&w25qxx_Cache);
+    w25qxx_PortClose(&port);
+    Test_Image();
+
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @section Private functions
+ */
+static void Cache_Fill(w25qxx_PortTypeDef *w25qxx_Port, uint32_t firstSector, uint32_t numberOfSectors)
+{
+    /* Old content written behind the cache */
+    for (uint32_t sector = firstSector; sector < firstSector + numberOfSectors; sector++)
+    {
+        Test_Pattern(&image[W25QXX_SECTOR_TO_ADDRESS(sector)], W25QXX_SECTOR_SIZE_4KB, sector);
+        memcpy(&w25qxx_Port->sim.memory[W25QXX_SECTOR_TO_ADDRESS(sector)], &image[W25QXX_SECTOR_TO_ADDRESS(sector)],
+               W25QXX_SECTOR_SIZE_4KB);
+    }
+}
+
+static void Test_ReadModifyWrite(w25qxx_CacheTypeDef *w25qxx_Cache, w25qxx_PortTypeDef *w25qxx_Port)
+{
+    uint32_t address = W25QXX_SECTOR_TO_ADDRESS(CACHE_RMW_SECTOR) + CACHE_RMW_OFFSET;
+
+    /* Partial write loads the sector, the device is untouched until the flush */
+    Cache_Fill(w25qxx_Port, CACHE_RMW_SECTOR, 2);
+    Test_Pattern(data, CACHE_RMW_LENGTH, 100);
+    TEST_CHECK(w25qxx_CacheWrite(w25qxx_Cache, data, CACHE_RMW_LENGTH, address) == W25QXX_ERROR_NONE);
+    TEST_CHECK(w25qxx_Cache->stats.misses == 1);
+    TEST_CHECK(memcmp(&w25qxx_Port->sim.memory[address], &image[address], CACHE_RMW_LENGTH) == 0);
+    memcpy(&image[address], data, CACHE_RMW_LENGTH);
+
+    /* Whole sector write skips the load */
+    Test_Pattern(data, W25QXX_SECTOR_SIZE_4KB, 101);
+    TEST_CHECK(w25qxx_CacheWrite(w25qxx_Cache, data, W25QXX_SECTOR_SIZE_4KB, W25QXX_SECTOR_TO_ADDRESS(CACHE_FULL)) ==
+               W25QXX_ERROR_NONE);
+    TEST_CHECK(w25qxx_Cache->stats.misses == 1);
+    memcpy(&image[W25QXX_SECTOR_TO_ADDRESS(CACHE_FULL)], data, W25QXX_SECTOR_SIZE_4KB);
+
+    /* Cached sector holds the old bytes around the new ones */
+    TEST_CHECK(w25qxx_CacheRead(w25qxx_Cache, readBack, W25QXX_SECTOR_SIZE_4KB,
+                                W25QXX_SECTOR_TO_ADDRESS(CACHE_RMW_SECTOR)) == W25QXX_ERROR_NONE);
+    TEST_CHECK(memcmp(readBack, &image[W25QXX_SECTOR_TO_ADDRESS(CACHE_RMW_SECTOR)], W25QXX_SECTOR_SIZE_4KB) == 0);
+    TEST_CHECK(w25qxx_Cache->stats.misses == 1);
+
+    /* Flush writes both sectors back */
+    TEST_CHECK(w25qxx_CacheFlush(w25qxx_Cache) == W25QXX_ERROR_NONE);
+    TEST_CHECK(w25qxx_Cache->stats.writeBacks == 2);
+    TEST_CHECK(memcmp(&w25qxx_Port->sim.memory[W25QXX_SECTOR_TO_ADDRESS(CACHE_RMW_SECTOR)],
+                      &image[W25QXX_SECTOR_TO_ADDRESS(CACHE_RMW_SECTOR)], 2 * W25QXX_SECTOR_SIZE_4KB) == 0);
+    TEST_CHECK(w25qxx_CacheFlush(w25qxx_Cache) == W25QXX_ERROR_NONE);
+    TEST_CHECK(w25qxx_Cache->stats.writeBacks == 2);
+}
+
+static void Test_Trim(w25qxx_CacheTypeDef *w25qxx_Cache, w25qxx_PortTypeDef *w25qxx_Port)
+{
+    uint32_t writeBacks = w25qxx_Cache->stats.writeBacks;
+
+    /* Dirty line of a trimmed sector is dropped */
+    Cache_Fill(w25qxx_Port, 31, 20);
+    Test_Pattern(data, W25QXX_SECTOR_SIZE_4KB, 102);
+    TEST_CHECK(w25qxx_CacheWrite(w25qxx_Cache, data, W25QXX_SECTOR_SIZE_4KB,
+                                 W25QXX_SECTOR_TO_ADDRESS(CACHE_TRIM_DIRTY)) == W25QXX_ERROR_NONE);
+
+    /* Whole sectors only, with the largest aligned erases */
+    TEST_CHECK(w25qxx_CacheTrim(w25qxx_Cache, CACHE_TRIM_START, CACHE_TRIM_END - CACHE_TRIM_START) ==
+               W25QXX_ERROR_NONE);
+    TEST_CHECK((w25qxx_Cache->stats.trimmedSectors == 18) && (w25qxx_Cache->stats.eraseInstructions == 3));
+    memset(&image[W25QXX_SECTOR_TO_ADDRESS(32)], 0xFF, W25QXX_SECTOR_TO_ADDRESS(18));
+    TEST_CHECK(memcmp(&w25qxx_Port->sim.memory[W25QXX_SECTOR_TO_ADDRESS(31)], &image[W25QXX_SECTOR_TO_ADDRESS(31)],
+                      W25QXX_SECTOR_TO_ADDRESS(20)) == 0);
+
+    TEST_CHECK(w25qxx_CacheFlush(w25qxx_Cache) == W25QXX_ERROR_NONE);
+    TEST_CHECK(w25qxx_Cache->stats.writeBacks == writeBacks);
+    TEST_CHECK(w25qxx_CacheRead(w25qxx_Cache, readBack, W25QXX_SECTOR_SIZE_4KB,
+                                W25QXX_SECTOR_TO_ADDRESS(CACHE_TRIM_DIRTY)) == W25QXX_ERROR_NONE);
+    TEST_CHECK(memcmp(readBack, &image[W25QXX_SECTOR_TO_ADDRESS(CACHE_TRIM_DIRTY)], W25QXX_SECTOR_SIZE_4KB) == 0);
+}
+
+static void Test_Image(void)
+{
+    static uint8_t file[CACHE_SIZE];
+    FILE *imageFile;
+
+    /* Closed port leaves the flushed content in the image file */
+    imageFile = fopen(CACHE_IMAGE, "rb");
+    TEST_CHECK(imageFile != NULL);
+    TEST_CHECK(fread(file, 1, sizeof(file), imageFile) == sizeof(file));
+    fclose(imageFile);
+    TEST_CHECK(memcmp(file, image, sizeof(image)) == 0);
+}
\ No newline at end of file
@@ -0,0 +1,104 @@
+#include "w25qxx_Coro.hpp"
+#include "w25qxx_Interface.h"
+#include "w25qxx_Test.h"
+#include <sched.h>
+
+/* Configuration */
+#define CORO_IMAGE   "w25qxx_CoroTest.img"
+#define CORO_ADDRESS 0x10000 // Erased and written by the job, 64KB block aligned
+#define CORO_OTHER   0x30000 // Read by the concurrent job
+#define CORO_LENGTH  600 // Data of the job, spans three pages
+
+/* Private variables */
+static uint32_t jobSeed; // Pattern of the job data
+
+static w25qxx::Task Coro_Job(w25qxx::Flash &flash, w25qxx_HandleTypeDef &w25qxx_Handle);
+static w25qxx::Task Coro_Reader(w25qxx::Flash &flash, uint8_t *buf, uint32_t length);
+static void Coro_Idle(void);
+static void Test_Run(w25qxx_HandleTypeDef &w25qxx_Handle, w25qxx_tick_fp tick, uint32_t seed);
+
+int main(void)
+{
+    static w25qxx_PortTypeDef port;
+    static w25qxx_HandleTypeDef w25qxx_Handle;
+
+    Test_Open(&port, &w25qxx_Handle, CORO_IMAGE);
+
+    /* Blocking data phases */
+    Test_Run(w25qxx_Handle, w25qxx_Now, 1);
+
+    /* Data phases on the fake DMA, busy polls with and without the tick */
+    TEST_CHECK(w25qxx_PortAsyncLink(&port, &w25qxx_Handle));
+    Test_Run(w25qxx_Handle, w25qxx_Now, 2);
+    Test_Run(w25qxx_Handle, nullptr, 3);
+
+    w25qxx_PortClose(&port);
+
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @section Private functions
+ */
+static w25qxx::Task Coro_Job(w25qxx::Flash &flash, w25qxx_HandleTypeDef &w25qxx_Handle)
+{
+    static uint8_t data[CORO_LENGTH], readBack[CORO_LENGTH], check[CORO_LENGTH];
+    w25qxx_Error_t error;
+
+    /* 32KB block and two sectors, the data of the previous run is erased */
+    error = co_await flash.Erase({CORO_ADDRESS, W25QXX_BLOCK_SIZE_32KB + 2 * W25QXX_SECTOR_SIZE_4KB});
+    TEST_CHECK(error == W25QXX_ERROR_NONE);
+    TEST_CHECK(w25qxx_ReadStream(&w25qxx_Handle, check, sizeof(check), CORO_ADDRESS, W25QXX_FASTREAD_NO) ==
+               W25QXX_ERROR_NONE);
+    for (uint32_t i = 0; i < sizeof(check); i++)
+        TEST_CHECK(check[i] == 0xFF);
+
+    Test_Pattern(data, sizeof(data), jobSeed);
+    error = co_await flash.Write(CORO_ADDRESS, w25qxx::Span<const uint8_t>(data, sizeof(data)));
+    TEST_CHECK(error == W25QXX_ERROR_NONE);
+
+    /* Unaligned head is read by the blocking stream, the rest page by page */
+    error = co_await flash.Read(CORO_ADDRESS + 16, w25qxx::Span<uint8_t>(readBack, sizeof(readBack) - 16));
+    TEST_CHECK(error == W25QXX_ERROR_NONE);
+    TEST_CHECK(memcmp(readBack, data + 16, sizeof(data) - 16) == 0);
+    TEST_CHECK((w25qxx_Handle.async.stage == W25QXX_ASYNC_IDLE) && (w25qxx_Handle.status == W25QXX_STATUS_READY));
+
+    co_return W25QXX_ERROR_NONE;
+}
+
+static w25qxx::Task Coro_Reader(w25qxx::Flash &flash, uint8_t *buf, uint32_t length)
+{
+    co_return co_await flash.Read(CORO_OTHER, w25qxx::Span<uint8_t>(buf, length));
+}
+
+static void Coro_Idle(void)
+{
+    sched_yield();
+}
+
+static void Test_Run(w25qxx_HandleTypeDef &w25qxx_Handle, w25qxx_tick_fp tick, uint32_t seed)
+{
+    static uint8_t other[W25QXX_PAGE_SIZE * 2], check[W25QXX_PAGE_SIZE * 2];
+    w25qxx::Executor executor(tick);
+    w25qxx::Flash flash(w25qxx_Handle, executor);
+
+    Test_Pattern(other, sizeof(other), seed + 100);
+    TEST_CHECK(w25qxx_Erase(&w25qxx_Handle, W25QXX_SECTOR_ERASE_4KB, CORO_OTHER, W25QXX_WAIT_BUSY) ==
+               W25QXX_ERROR_NONE);
+    for (uint32_t i = 0; i < sizeof(other); i += W25QXX_PAGE_SIZE)
+        TEST_CHECK(w25qxx_Write(&w25qxx_Handle, other + i, W25QXX_PAGE_SIZE, CORO_OTHER + i, W25QXX_CRC_NO,
+                                W25QXX_WAIT_BUSY) == W25QXX_ERROR_NONE);
+
+    /* Both jobs share the device, the reader is served between the job operations */
+    jobSeed = seed;
+    w25qxx::Task job = Coro_Job(flash, w25qxx_Handle);
+    w25qxx::Task reader = Coro_Reader(flash, check, sizeof(check));
+    job.Spawn(executor);
+    reader.Spawn(executor);
+    executor.Run(Coro_Idle);
+
+    TEST_CHECK(job.Done() && (job.Error() == W25QXX_ERROR_NONE));
+    TEST_CHECK(reader.Done() && (reader.Error() == W25QXX_ERROR_NONE));
+    TEST_CHECK(memcmp(check, other, sizeof(other)) == 0);
+    TEST_CHECK(!executor.Pending());
+}
\ No newline at end of file
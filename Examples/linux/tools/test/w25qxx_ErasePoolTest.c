@@ -0,0 +1,125 @@
+#include "w25qxx_ErasePool.h"
+#include "w25qxx_Test.h"
+
+/* Configuration */
+#define POOL_IMAGE        "w25qxx_ErasePoolTest.img"
+#define POOL_FIRST_SECTOR 16
+#define POOL_SECTORS      (W25QXX_ERASE_POOL_LOW_WATERMARK * 3) // Reclaimed sectors, well above the low watermark
+#define POOL_SR1_BUSY     0x01 // Erase in progress on the device model
+
+/* Private variables */
+static uint8_t data[W25QXX_PAGE_SIZE], readBack[W25QXX_PAGE_SIZE];
+
+static bool Pool_Erased(w25qxx_PortTypeDef *w25qxx_Port, uint32_t sector);
+static void Test_Background(w25qxx_ErasePoolTypeDef *w25qxx_ErasePool, w25qxx_HandleTypeDef *w25qxx_Handle,
+                            w25qxx_PortTypeDef *w25qxx_Port);
+static void Test_Full(w25qxx_ErasePoolTypeDef *w25qxx_ErasePool, w25qxx_HandleTypeDef *w25qxx_Handle);
+
+int main(void)
+{
+    static w25qxx_PortTypeDef port;
+    static w25qxx_HandleTypeDef w25qxx_Handle;
+    static w25qxx_ErasePoolTypeDef w25qxx_ErasePool;
+
+    Test_Open(&port, &w25qxx_Handle, POOL_IMAGE);
+
+    Test_Background(&w25qxx_ErasePool, &w25qxx_Handle, &port);
+    Test_Full(&w25qxx_ErasePool, &w25qxx_Handle);
+
+    w25qxx_PortClose(&port);
+
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @section Private functions
+ */
+static bool Pool_Erased(w25qxx_PortTypeDef *w25qxx_Port, uint32_t sector)
+{
+    for (uint32_t i = 0; i < W25QXX_SECTOR_SIZE_4KB; i++)
+    {
+        if (w25qxx_Port->sim.memory[W25QXX_SECTOR_TO_ADDRESS(sector) + i] != 0xFF)
+            return false;
+    }
+
+    return true;
+}
+
+static void Test_Background(w25qxx_ErasePoolTypeDef *w25qxx_ErasePool, w25qxx_HandleTypeDef *w25qxx_Handle,
+                            w25qxx_PortTypeDef *w25qxx_Port)
+{
+    uint32_t sector;
+
+    TEST_CHECK(w25qxx_ErasePoolInit(w25qxx_ErasePool, w25qxx_Handle) == W25QXX_ERROR_NONE);
+    TEST_CHECK(!w25qxx_ErasePoolLow(w25qxx_ErasePool));
+
+    /* Written sectors are reclaimed, nothing is erased yet */
+    for (sector = POOL_FIRST_SECTOR; sector < POOL_FIRST_SECTOR + POOL_SECTORS; sector++)
+    {
+        Test_Pattern(data, sizeof(data), sector);
+        TEST_CHECK(w25qxx_Write(w25qxx_Handle, data, sizeof(data), W25QXX_SECTOR_TO_ADDRESS(sector), W25QXX_CRC_NO,
+                                W25QXX_WAIT_BUSY) == W25QXX_ERROR_NONE);
+        TEST_CHECK(w25qxx_ErasePoolRelease(w25qxx_ErasePool, sector) == W25QXX_ERROR_NONE);
+    }
+    TEST_CHECK(w25qxx_ErasePoolLow(w25qxx_ErasePool));
+
+    /* Busy device is left alone, the erase in progress is collected later */
+    TEST_CHECK(w25qxx_ErasePoolService(w25qxx_ErasePool) == W25QXX_ERROR_NONE);
+    TEST_CHECK(w25qxx_ErasePool->erasing == POOL_FIRST_SECTOR);
+    w25qxx_Port->sim.statusRegister[0] |= POOL_SR1_BUSY;
+    TEST_CHECK(w25qxx_ErasePoolService(w25qxx_ErasePool) == W25QXX_ERROR_NONE);
+    TEST_CHECK((w25qxx_ErasePool->erasing == POOL_FIRST_SECTOR) && (w25qxx_ErasePool->erased.count == 0));
+    w25qxx_Port->sim.statusRegister[0] &= ~POOL_SR1_BUSY;
+
+    /* Idle time keeps erasing past the low watermark until every dirty sector is done */
+    for (uint32_t i = 0; i < POOL_SECTORS; i++)
+        TEST_CHECK(w25qxx_ErasePoolService(w25qxx_ErasePool) == W25QXX_ERROR_NONE);
+    TEST_CHECK(w25qxx_ErasePool->erasing == W25QXX_ERASE_POOL_NONE);
+    TEST_CHECK((w25qxx_ErasePool->erased.count == POOL_SECTORS) && (w25qxx_ErasePool->dirty.count == 0));
+    TEST_CHECK(w25qxx_ErasePool->stats.erasedBackground == POOL_SECTORS);
+    TEST_CHECK(!w25qxx_ErasePoolLow(w25qxx_ErasePool));
+
+    /* Writers get erased sectors in release order without waiting */
+    for (uint32_t i = 0; i < POOL_SECTORS; i++)
+    {
+        TEST_CHECK(w25qxx_ErasePoolAcquire(w25qxx_ErasePool, &sector) == W25QXX_ERROR_NONE);
+        TEST_CHECK(sector == POOL_FIRST_SECTOR + i);
+        TEST_CHECK(Pool_Erased(w25qxx_Port, sector));
+    }
+    TEST_CHECK(w25qxx_ErasePoolAcquire(w25qxx_ErasePool, &sector) == W25QXX_ERROR_NONE);
+    TEST_CHECK(sector == W25QXX_ERASE_POOL_NONE);
+    TEST_CHECK((w25qxx_ErasePool->stats.waited == 0) && (w25qxx_ErasePool->stats.erasedInline == 0));
+    TEST_CHECK(w25qxx_ErasePool->stats.acquired == POOL_SECTORS);
+
+    /* Exhausted pool erases within the writer */
+    Test_Pattern(data, sizeof(data), 1);
+    TEST_CHECK(w25qxx_Write(w25qxx_Handle, data, sizeof(data), W25QXX_SECTOR_TO_ADDRESS(POOL_FIRST_SECTOR),
+                            W25QXX_CRC_NO, W25QXX_WAIT_BUSY) == W25QXX_ERROR_NONE);
+    TEST_CHECK(w25qxx_ErasePoolRelease(w25qxx_ErasePool, POOL_FIRST_SECTOR) == W25QXX_ERROR_NONE);
+    TEST_CHECK(w25qxx_ErasePoolAcquire(w25qxx_ErasePool, &sector) == W25QXX_ERROR_NONE);
+    TEST_CHECK((sector == POOL_FIRST_SECTOR) && Pool_Erased(w25qxx_Port, sector));
+    TEST_CHECK((w25qxx_ErasePool->stats.waited == 1) && (w25qxx_ErasePool->stats.erasedInline == 1));
+    TEST_CHECK(w25qxx_Read(w25qxx_Handle, readBack, sizeof(readBack), W25QXX_SECTOR_TO_ADDRESS(sector),
+                           W25QXX_CRC_NO, W25QXX_FASTREAD_NO) == W25QXX_ERROR_NONE);
+    TEST_CHECK(readBack[0] == 0xFF);
+}
+
+static void Test_Full(w25qxx_ErasePoolTypeDef *w25qxx_ErasePool, w25qxx_HandleTypeDef *w25qxx_Handle)
+{
+    uint32_t sector;
+
+    /* Full dirty queue refuses the sector, the device handle stays usable */
+    TEST_CHECK(w25qxx_ErasePoolInit(w25qxx_ErasePool, w25qxx_Handle) == W25QXX_ERROR_NONE);
+    for (sector = 0; sector < W25QXX_ERASE_POOL_SIZE; sector++)
+        TEST_CHECK(w25qxx_ErasePoolRelease(w25qxx_ErasePool, POOL_FIRST_SECTOR + sector) == W25QXX_ERROR_NONE);
+    TEST_CHECK(w25qxx_ErasePoolRelease(w25qxx_ErasePool, POOL_FIRST_SECTOR + sector) == W25QXX_ERROR_ARGUMENT);
+    TEST_CHECK(w25qxx_Handle->error == W25QXX_ERROR_NONE);
+    TEST_CHECK(w25qxx_Read(w25qxx_Handle, readBack, sizeof(readBack), 0x0000, W25QXX_CRC_NO, W25QXX_FASTREAD_NO) ==
+               W25QXX_ERROR_NONE);
+
+    /* Erased queue fills up to the high watermark only */
+    for (uint32_t i = 0; i <= W25QXX_ERASE_POOL_SIZE; i++)
+        TEST_CHECK(w25qxx_ErasePoolService(w25qxx_ErasePool) == W25QXX_ERROR_NONE);
+    TEST_CHECK(w25qxx_ErasePool->erased.count == W25QXX_ERASE_POOL_HIGH_WATERMARK);
+    TEST_CHECK(w25qxx_ErasePool->erasing == W25QXX_ERASE_POOL_NONE);
+}
\ No newline at end of file
@@ -0,0 +1,145 @@
+#include "w25qxx_Ftl.h"
+#include "w25qxx_Test.h"
+
+/* Configuration */
+#define FTL_IMAGE        "w25qxx_FtlTest.img"
+#define FTL_FIRST_SECTOR 16
+#define FTL_SECTORS      (16 + W25QXX_FTL_TABLE_SECTORS) // Data sectors and the erase count table
+#define FTL_HOT_WRITES   600 // Rewrites of one logical sector, the journal is folded into a new table meanwhile
+
+/* Private variables */
+static uint8_t data[W25QXX_FTL_SECTOR_SIZE], readBack[W25QXX_FTL_SECTOR_SIZE];
+
+static void Ftl_Mount(w25qxx_FtlHandleTypeDef *w25qxx_FtlHandle, w25qxx_HandleTypeDef *w25qxx_Handle);
+static void Ftl_Check(w25qxx_FtlHandleTypeDef *w25qxx_FtlHandle, uint16_t logicalSector, uint32_t seed);
+static void Test_Remount(w25qxx_FtlHandleTypeDef *w25qxx_FtlHandle, w25qxx_HandleTypeDef *w25qxx_Handle);
+static void Test_Wear(w25qxx_FtlHandleTypeDef *w25qxx_FtlHandle, w25qxx_HandleTypeDef *w25qxx_Handle);
+static void Test_EraseLoss(w25qxx_FtlHandleTypeDef *w25qxx_FtlHandle, w25qxx_HandleTypeDef *w25qxx_Handle,
+                           w25qxx_PortTypeDef *w25qxx_Port);
+
+int main(void)
+{
+    static w25qxx_PortTypeDef port;
+    static w25qxx_HandleTypeDef w25qxx_Handle;
+    static w25qxx_FtlHandleTypeDef w25qxx_FtlHandle;
+
+    Test_Open(&port, &w25qxx_Handle, FTL_IMAGE);
+
+    Test_Remount(&w25qxx_FtlHandle, &w25qxx_Handle);
+    Test_Wear(&w25qxx_FtlHandle, &w25qxx_Handle);
+    Test_EraseLoss(&w25qxx_FtlHandle, &w25qxx_Handle, &port);
+
+    w25qxx_PortClose(&port);
+
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @section Private functions
+ */
+static void Ftl_Mount(w25qxx_FtlHandleTypeDef *w25qxx_FtlHandle, w25qxx_HandleTypeDef *w25qxx_Handle)
+{
+    TEST_CHECK(w25qxx_FtlInit(w25qxx_FtlHandle, w25qxx_Handle, FTL_FIRST_SECTOR, FTL_SECTORS) == W25QXX_ERROR_NONE);
+    TEST_CHECK(w25qxx_FtlHandle->numberOfSectors == FTL_SECTORS - W25QXX_FTL_TABLE_SECTORS);
+}
+
+static void Ftl_Check(w25qxx_FtlHandleTypeDef *w25qxx_FtlHandle, uint16_t logicalSector, uint32_t seed)
+{
+    Test_Pattern(data, sizeof(data), seed);
+    TEST_CHECK(w25qxx_FtlRead(w25qxx_FtlHandle, readBack, logicalSector) == W25QXX_ERROR_NONE);
+    TEST_CHECK(memcmp(readBack, data, sizeof(data)) == 0);
+}
+
+static void Test_Remount(w25qxx_FtlHandleTypeDef *w25qxx_FtlHandle, w25qxx_HandleTypeDef *w25qxx_Handle)
+{
+    uint32_t eraseCount[W25QXX_FTL_MAX_SECTORS];
+    uint16_t logical;
+
+    /* Blank region, nothing mapped and no table yet */
+    Ftl_Mount(w25qxx_FtlHandle, w25qxx_Handle);
+    TEST_CHECK(w25qxx_FtlHandle->table == W25QXX_FTL_TABLE_NONE);
+    TEST_CHECK(w25qxx_FtlRead(w25qxx_FtlHandle, readBack, 0) == W25QXX_ERROR_NONE);
+    for (uint32_t i = 0; i < sizeof(readBack); i++)
+        TEST_CHECK(readBack[i] == 0xFF);
+
+    for (logical = 0; logical < w25qxx_FtlHandle->numberOfLogicalSectors; logical++)
+    {
+        Test_Pattern(data, sizeof(data), logical);
+        TEST_CHECK(w25qxx_FtlWrite(w25qxx_FtlHandle, data, logical) == W25QXX_ERROR_NONE);
+    }
+    Test_Pattern(data, sizeof(data), 100);
+    TEST_CHECK(w25qxx_FtlWrite(w25qxx_FtlHandle, data, 0) == W25QXX_ERROR_NONE);
+    TEST_CHECK(w25qxx_FtlHandle->table != W25QXX_FTL_TABLE_NONE);
+    memcpy(eraseCount, w25qxx_FtlHandle->eraseCount, sizeof(eraseCount));
+
+    /* Map and counters are rebuilt from the headers and the table */
+    Ftl_Mount(w25qxx_FtlHandle, w25qxx_Handle);
+    Ftl_Check(w25qxx_FtlHandle, 0, 100);
+    for (logical = 1; logical < w25qxx_FtlHandle->numberOfLogicalSectors; logical++)
+        Ftl_Check(w25qxx_FtlHandle, logical, logical);
+    TEST_CHECK(memcmp(eraseCount, w25qxx_FtlHandle->eraseCount,
+                      w25qxx_FtlHandle->numberOfSectors * sizeof(eraseCount[0])) == 0);
+}
+
+static void Test_Wear(w25qxx_FtlHandleTypeDef *w25qxx_FtlHandle, w25qxx_HandleTypeDef *w25qxx_Handle)
+{
+    uint32_t eraseCount[W25QXX_FTL_MAX_SECTORS], maxCount = 0, tableSequence;
+    uint16_t physical;
+
+    /* One hot sector, the cold ones are moved once the spread reaches the threshold */
+    tableSequence = w25qxx_FtlHandle->tableSequence;
+    for (uint32_t i = 0; i < FTL_HOT_WRITES; i++)
+    {
+        Test_Pattern(data, sizeof(data), 1000 + i);
+        TEST_CHECK(w25qxx_FtlWrite(w25qxx_FtlHandle, data, 0) == W25QXX_ERROR_NONE);
+    }
+    TEST_CHECK(w25qxx_FtlHandle->relocations > 0);
+    TEST_CHECK(w25qxx_FtlHandle->tableSequence > tableSequence);
+    for (physical = 0; physical < w25qxx_FtlHandle->numberOfSectors; physical++)
+    {
+        if (w25qxx_FtlHandle->eraseCount[physical] > maxCount)
+            maxCount = w25qxx_FtlHandle->eraseCount[physical];
+    }
+    TEST_CHECK(maxCount < FTL_HOT_WRITES / (W25QXX_FTL_SPARE_SECTORS + 1)); // Dynamic leveling alone, free ones only
+    memcpy(eraseCount, w25qxx_FtlHandle->eraseCount, sizeof(eraseCount));
+
+    /* Counters survive the remount after the journal has been folded */
+    Ftl_Mount(w25qxx_FtlHandle, w25qxx_Handle);
+    TEST_CHECK(memcmp(eraseCount, w25qxx_FtlHandle->eraseCount,
+                      w25qxx_FtlHandle->numberOfSectors * sizeof(eraseCount[0])) == 0);
+    Ftl_Check(w25qxx_FtlHandle, 0, 1000 + FTL_HOT_WRITES - 1);
+    for (uint16_t logical = 1; logical < w25qxx_FtlHandle->numberOfLogicalSectors; logical++)
+        Ftl_Check(w25qxx_FtlHandle, logical, logical);
+}
+
+static void Test_EraseLoss(w25qxx_FtlHandleTypeDef *w25qxx_FtlHandle, w25qxx_HandleTypeDef *w25qxx_Handle,
+                           w25qxx_PortTypeDef *w25qxx_Port)
+{
+    uint32_t eraseCount[W25QXX_FTL_MAX_SECTORS];
+    uint16_t physical, logical;
+
+    /* Free sector with the highest wear, its erase is cut by a power loss and leaves it half erased */
+    memcpy(eraseCount, w25qxx_FtlHandle->eraseCount, sizeof(eraseCount));
+    physical = W25QXX_FTL_SECTOR_FREE;
+    for (uint16_t i = 0; i < w25qxx_FtlHandle->numberOfSectors; i++)
+    {
+        for (logical = 0; logical < w25qxx_FtlHandle->numberOfLogicalSectors; logical++)
+        {
+            if (w25qxx_FtlHandle->map[logical] == i)
+                break;
+        }
+        if ((logical == w25qxx_FtlHandle->numberOfLogicalSectors) &&
+            ((physical == W25QXX_FTL_SECTOR_FREE) || (eraseCount[i] > eraseCount[physical])))
+            physical = i;
+    }
+    TEST_CHECK(physical != W25QXX_FTL_SECTOR_FREE);
+    memset(&w25qxx_Port->sim.memory[W25QXX_SECTOR_TO_ADDRESS(FTL_FIRST_SECTOR + physical)], 0xFF,
+           W25QXX_SECTOR_SIZE_4KB / 2);
+
+    /* The sector keeps its own wear instead of the average of the region */
+    Ftl_Mount(w25qxx_FtlHandle, w25qxx_Handle);
+    TEST_CHECK(w25qxx_FtlHandle->eraseCount[physical] == eraseCount[physical]);
+    Ftl_Check(w25qxx_FtlHandle, 0, 1000 + FTL_HOT_WRITES - 1);
+    for (logical = 1; logical < w25qxx_FtlHandle->numberOfLogicalSectors; logical++)
+        Ftl_Check(w25qxx_FtlHandle, logical, logical);
+}
\ No newline at end of file
@@ -0,0 +1,118 @@
+#include "w25qxx_Mirror.h"
+#include "w25qxx_Test.h"
+
+/* Configuration */
+#define MIRROR_SECTOR 0x20000 // Sector of the mirrored frames
+#define MIRROR_PAGES  4 // Frames written to the sector
+#define MIRROR_FRAME  (W25QXX_PAGE_SIZE - sizeof(uint16_t)) // Page with the trailing checksum
+
+/* Private variables */
+static const char *mirrorImage[W25QXX_MIRROR_COPIES] = {"w25qxx_MirrorTest0.img", "w25qxx_MirrorTest1.img"};
+static w25qxx_PortTypeDef port[W25QXX_MIRROR_COPIES];
+static w25qxx_HandleTypeDef w25qxx_Handle[W25QXX_MIRROR_COPIES];
+static uint8_t data[MIRROR_PAGES][MIRROR_FRAME], readBack[MIRROR_FRAME];
+
+static bool Mirror_Match(void);
+static void Test_Write(w25qxx_MirrorTypeDef *w25qxx_Mirror);
+static void Test_Heal(w25qxx_MirrorTypeDef *w25qxx_Mirror);
+static void Test_BothBad(w25qxx_MirrorTypeDef *w25qxx_Mirror);
+
+int main(void)
+{
+    static w25qxx_MirrorTypeDef w25qxx_Mirror;
+
+    for (uint8_t copy = 0; copy < W25QXX_MIRROR_COPIES; copy++)
+        Test_Open(&port[copy], &w25qxx_Handle[copy], mirrorImage[copy]);
+    TEST_CHECK(w25qxx_MirrorInit(&w25qxx_Mirror, &w25qxx_Handle[0], &w25qxx_Handle[1]) == W25QXX_ERROR_NONE);
+
+    Test_Write(&w25qxx_Mirror);
+    Test_Heal(&w25qxx_Mirror);
+    Test_BothBad(&w25qxx_Mirror);
+
+    for (uint8_t copy = 0; copy < W25QXX_MIRROR_COPIES; copy++)
+        w25qxx_PortClose(&port[copy]);
+
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @section Private functions
+ */
+static bool Mirror_Match(void)
+{
+    return memcmp(&port[0].sim.memory[MIRROR_SECTOR], &port[1].sim.memory[MIRROR_SECTOR], W25QXX_SECTOR_SIZE_4KB) ==
+           0;
+}
+
+static void Test_Write(w25qxx_MirrorTypeDef *w25qxx_Mirror)
+{
+    /* Old data on both copies is erased one copy after another */
+    for (uint8_t copy = 0; copy < W25QXX_MIRROR_COPIES; copy++)
+        memset(&port[copy].sim.memory[MIRROR_SECTOR], 0x5A, W25QXX_SECTOR_SIZE_4KB);
+    TEST_CHECK(w25qxx_MirrorErase(w25qxx_Mirror, W25QXX_SECTOR_ERASE_4KB, MIRROR_SECTOR, W25QXX_WAIT_BUSY) ==
+               W25QXX_ERROR_NONE);
+    TEST_CHECK(w25qxx_Mirror->erase.copy == W25QXX_MIRROR_COPIES);
+    TEST_CHECK((port[0].sim.memory[MIRROR_SECTOR] == 0xFF) && (port[1].sim.memory[MIRROR_SECTOR] == 0xFF));
+
+    for (uint32_t page = 0; page < MIRROR_PAGES; page++)
+    {
+        Test_Pattern(data[page], MIRROR_FRAME, page);
+        TEST_CHECK(w25qxx_MirrorWrite(w25qxx_Mirror, data[page], MIRROR_FRAME,
+                                      MIRROR_SECTOR + W25QXX_PAGE_TO_ADDRESS(page), W25QXX_CRC) == W25QXX_ERROR_NONE);
+    }
+    TEST_CHECK(Mirror_Match());
+
+    /* Reads alternate between the copies */
+    for (uint32_t page = 0; page < MIRROR_PAGES; page++)
+    {
+        TEST_CHECK(w25qxx_MirrorRead(w25qxx_Mirror, readBack, MIRROR_FRAME,
+                                     MIRROR_SECTOR + W25QXX_PAGE_TO_ADDRESS(page), W25QXX_CRC,
+                                     W25QXX_FASTREAD_NO) == W25QXX_ERROR_NONE);
+        TEST_CHECK(memcmp(readBack, data[page], MIRROR_FRAME) == 0);
+    }
+    TEST_CHECK((w25qxx_Mirror->stats.reads[0] == MIRROR_PAGES / 2) &&
+               (w25qxx_Mirror->stats.reads[1] == MIRROR_PAGES / 2));
+}
+
+static void Test_Heal(w25qxx_MirrorTypeDef *w25qxx_Mirror)
+{
+    /* Corrupted frame of the first copy is served by the second one, nothing is written by the read */
+    port[0].sim.memory[MIRROR_SECTOR + W25QXX_PAGE_TO_ADDRESS(1) + 10] ^= 0x01;
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        w25qxx_Mirror->readCopy = 0;
+        TEST_CHECK(w25qxx_MirrorRead(w25qxx_Mirror, readBack, MIRROR_FRAME,
+                                     MIRROR_SECTOR + W25QXX_PAGE_TO_ADDRESS(1), W25QXX_CRC,
+                                     W25QXX_FASTREAD_NO) == W25QXX_ERROR_NONE);
+        TEST_CHECK(memcmp(readBack, data[1], MIRROR_FRAME) == 0);
+    }
+    TEST_CHECK((w25qxx_Handle[0].error == W25QXX_ERROR_NONE) && (w25qxx_Handle[0].status == W25QXX_STATUS_READY));
+    TEST_CHECK(w25qxx_Mirror->stats.mismatches == 2);
+    TEST_CHECK((w25qxx_Mirror->heal.count == 1) && (w25qxx_Mirror->heal.copy[0] == 0) &&
+               (w25qxx_Mirror->heal.sectorAddress[0] == MIRROR_SECTOR));
+    TEST_CHECK((w25qxx_Mirror->stats.healed == 0) && !Mirror_Match());
+
+    /* Explicit heal restores the whole sector from the good copy */
+    TEST_CHECK(w25qxx_MirrorHeal(w25qxx_Mirror) == W25QXX_ERROR_NONE);
+    TEST_CHECK((w25qxx_Mirror->heal.count == 0) && (w25qxx_Mirror->stats.healed == 1));
+    TEST_CHECK(Mirror_Match());
+    w25qxx_Mirror->readCopy = 0;
+    TEST_CHECK(w25qxx_MirrorRead(w25qxx_Mirror, readBack, MIRROR_FRAME, MIRROR_SECTOR + W25QXX_PAGE_TO_ADDRESS(1),
+                                 W25QXX_CRC, W25QXX_FASTREAD_NO) == W25QXX_ERROR_NONE);
+    TEST_CHECK(w25qxx_Mirror->stats.mismatches == 2);
+
+    /* Nothing left to heal */
+    TEST_CHECK(w25qxx_MirrorHeal(w25qxx_Mirror) == W25QXX_ERROR_NONE);
+    TEST_CHECK(w25qxx_Mirror->stats.healed == 1);
+}
+
+static void Test_BothBad(w25qxx_MirrorTypeDef *w25qxx_Mirror)
+{
+    /* No good copy, no report */
+    for (uint8_t copy = 0; copy < W25QXX_MIRROR_COPIES; copy++)
+        port[copy].sim.memory[MIRROR_SECTOR + W25QXX_PAGE_TO_ADDRESS(2) + 10] ^= 0x01;
+    TEST_CHECK(w25qxx_MirrorRead(w25qxx_Mirror, readBack, MIRROR_FRAME, MIRROR_SECTOR + W25QXX_PAGE_TO_ADDRESS(2),
+                                 W25QXX_CRC, W25QXX_FASTREAD_NO) == W25QXX_ERROR_CHECKSUM);
+    TEST_CHECK((w25qxx_Handle[0].error == W25QXX_ERROR_NONE) && (w25qxx_Handle[1].error == W25QXX_ERROR_NONE));
+    TEST_CHECK(w25qxx_Mirror->heal.count == 0);
+}
\ No newline at end of file
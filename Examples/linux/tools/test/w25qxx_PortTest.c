@@ -0,0 +1,86 @@
+#include "w25qxx_Test.h"
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* Configuration */
+#define PORT_IMAGE   "w25qxx_PortTest.img"
+#define PORT_MISSING "w25qxx_PortMissing.img" // Never created, opened by the device ID of the image only
+#define PORT_ADDRESS 0x1000
+
+/* Private variables */
+static uint8_t data[W25QXX_PAGE_SIZE], readBack[W25QXX_PAGE_SIZE];
+
+static void Test_Missing(void);
+static void Test_Existing(w25qxx_PortTypeDef *w25qxx_Port, w25qxx_HandleTypeDef *w25qxx_Handle);
+static void Test_ReadOnly(w25qxx_PortTypeDef *w25qxx_Port, w25qxx_HandleTypeDef *w25qxx_Handle);
+
+int main(void)
+{
+    static w25qxx_PortTypeDef port;
+    static w25qxx_HandleTypeDef w25qxx_Handle;
+
+    /* Image with known content */
+    Test_Open(&port, &w25qxx_Handle, PORT_IMAGE);
+    Test_Pattern(data, sizeof(data), 1);
+    TEST_CHECK(w25qxx_Write(&w25qxx_Handle, data, sizeof(data), PORT_ADDRESS, W25QXX_CRC_NO, W25QXX_WAIT_BUSY) ==
+               W25QXX_ERROR_NONE);
+    w25qxx_PortClose(&port);
+
+    Test_Missing();
+    Test_Existing(&port, &w25qxx_Handle);
+    Test_ReadOnly(&port, &w25qxx_Handle);
+
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @section Private functions
+ */
+static void Test_Missing(void)
+{
+    static w25qxx_PortTypeDef port;
+
+    /* Nothing to open, nothing is left behind */
+    unlink(PORT_MISSING);
+    TEST_CHECK(!w25qxx_PortOpen(&port, W25QXX_PORT_SIM_PREFIX PORT_MISSING, 0, 0));
+    w25qxx_PortClose(&port);
+    TEST_CHECK(access(PORT_MISSING, F_OK) != 0);
+}
+
+static void Test_Existing(w25qxx_PortTypeDef *w25qxx_Port, w25qxx_HandleTypeDef *w25qxx_Handle)
+{
+    /* Device is taken from the image size */
+    TEST_CHECK(w25qxx_PortOpen(w25qxx_Port, W25QXX_PORT_SIM_PREFIX PORT_IMAGE, 0, 0));
+    TEST_CHECK(!w25qxx_Port->sim.readOnly && (w25qxx_Port->sim.deviceID == TEST_DEVICE));
+    w25qxx_PortLink(w25qxx_Port, w25qxx_Handle, NULL);
+    TEST_CHECK(w25qxx_Init(w25qxx_Handle) == W25QXX_ERROR_NONE);
+    TEST_CHECK(w25qxx_Read(w25qxx_Handle, readBack, sizeof(readBack), PORT_ADDRESS, W25QXX_CRC_NO,
+                           W25QXX_FASTREAD_NO) == W25QXX_ERROR_NONE);
+    TEST_CHECK(memcmp(readBack, data, sizeof(data)) == 0);
+    w25qxx_PortClose(w25qxx_Port);
+}
+
+static void Test_ReadOnly(w25qxx_PortTypeDef *w25qxx_Port, w25qxx_HandleTypeDef *w25qxx_Handle)
+{
+    /* Write-protected image, the permission doesn't hold back root */
+    TEST_CHECK(chmod(PORT_IMAGE, 0444) == 0);
+    if (geteuid() != 0)
+    {
+        TEST_CHECK(w25qxx_PortOpen(w25qxx_Port, W25QXX_PORT_SIM_PREFIX PORT_IMAGE, 0, 0));
+        TEST_CHECK(w25qxx_Port->sim.readOnly);
+        w25qxx_PortLink(w25qxx_Port, w25qxx_Handle, NULL);
+        TEST_CHECK(w25qxx_Init(w25qxx_Handle) == W25QXX_ERROR_NONE);
+        TEST_CHECK(w25qxx_Read(w25qxx_Handle, readBack, sizeof(readBack), PORT_ADDRESS, W25QXX_CRC_NO,
+                               W25QXX_FASTREAD_NO) == W25QXX_ERROR_NONE);
+        TEST_CHECK(memcmp(readBack, data, sizeof(data)) == 0);
+
+        /* Model changes stay in memory */
+        TEST_CHECK(w25qxx_Erase(w25qxx_Handle, W25QXX_SECTOR_ERASE_4KB, PORT_ADDRESS, W25QXX_WAIT_BUSY) ==
+                   W25QXX_ERROR_NONE);
+        w25qxx_PortClose(w25qxx_Port);
+        TEST_CHECK(w25qxx_PortOpen(w25qxx_Port, W25QXX_PORT_SIM_PREFIX PORT_IMAGE, 0, 0));
+        TEST_CHECK(memcmp(&w25qxx_Port->sim.memory[PORT_ADDRESS], data, sizeof(data)) == 0);
+        w25qxx_PortClose(w25qxx_Port);
+    }
+    TEST_CHECK(chmod(PORT_IMAGE, 0644) == 0);
+}
\ No newline at end of file
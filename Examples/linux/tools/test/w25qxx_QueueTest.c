@@ -0,0 +1,385 @@
+#include "w25qxx_Queue.h"
+#include "w25qxx_Test.h"
+
+/* Configuration */
+#define QUEUE_IMAGE          "w25qxx_QueueTest.img"
+#define QUEUE_WORKER_TIMEOUT 1000 // [ms]
+#define QUEUE_ORDER_MAX      16
+
+/* Private variables */
+static pthread_mutex_t queueMutex = PTHREAD_MUTEX_INITIALIZER;
+static sem_t queueWakeup, requestDone;
+static w25qxx_QueueRequestTypeDef *order[QUEUE_ORDER_MAX];
+static uint32_t orderCount;
+static w25qxx_cs_context_fp portSelect;
+static uint32_t selections; // Instructions sent to the device model
+static uint32_t testNow; // Tick of the request deadlines
+
+static void Queue_Setup(w25qxx_QueueTypeDef *w25qxx_Queue, w25qxx_HandleTypeDef *w25qxx_Handle);
+static void Queue_Complete(w25qxx_QueueRequestTypeDef *request);
+static void Queue_Post(w25qxx_QueueRequestTypeDef *request);
+static void *Queue_WorkerThread(void *argument);
+static void Queue_Select(void *context, w25qxx_CS_State_t newState);
+static uint32_t Queue_Now(void);
+static void Queue_Read(w25qxx_QueueRequestTypeDef *request, uint32_t address, uint8_t *buf, uint16_t dataLength,
+                       w25qxx_CRC_t trailingCRC);
+static void Queue_Fill(w25qxx_HandleTypeDef *w25qxx_Handle, uint32_t firstPage, uint32_t numberOfPages);
+static void Test_Classes(w25qxx_QueueTypeDef *w25qxx_Queue);
+static void Test_Failure(w25qxx_QueueTypeDef *w25qxx_Queue);
+static void Test_Scan(w25qxx_QueueTypeDef *w25qxx_Queue);
+static void Test_Merge(w25qxx_QueueTypeDef *w25qxx_Queue);
+static void Test_MergeGap(w25qxx_QueueTypeDef *w25qxx_Queue);
+static void Test_MergeChecksum(w25qxx_QueueTypeDef *w25qxx_Queue, w25qxx_PortTypeDef *w25qxx_Port);
+static void Test_Deadline(w25qxx_QueueTypeDef *w25qxx_Queue);
+static void Test_Worker(w25qxx_QueueTypeDef *w25qxx_Queue);
+
+int main(void)
+{
+    static w25qxx_PortTypeDef port;
+    static w25qxx_HandleTypeDef w25qxx_Handle;
+    static w25qxx_QueueTypeDef w25qxx_Queue;
+
+    TEST_CHECK(sem_init(&queueWakeup, 0, 0) == 0);
+    TEST_CHECK(sem_init(&requestDone, 0, 0) == 0);
+    Test_Open(&port, &w25qxx_Handle, QUEUE_IMAGE);
+    portSelect = w25qxx_Handle.interface.cs_set_context;
+    w25qxx_Handle.interface.cs_set_context = Queue_Select;
+    Queue_Setup(&w25qxx_Queue, &w25qxx_Handle);
+
+    Test_Classes(&w25qxx_Queue);
+    Test_Failure(&w25qxx_Queue);
+    Test_Scan(&w25qxx_Queue);
+    Test_Merge(&w25qxx_Queue);
+    Test_MergeGap(&w25qxx_Queue);
+    Test_MergeChecksum(&w25qxx_Queue, &port);
+    Test_Deadline(&w25qxx_Queue);
+
+    /* Worker keeps running until the process exits */
+    Test_Worker(&w25qxx_Queue);
+
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @section Private functions
+ */
+static void Queue_Setup(w25qxx_QueueTypeDef *w25qxx_Queue, w25qxx_HandleTypeDef *w25qxx_Handle)
+{
+    memset(w25qxx_Queue, 0, sizeof(*w25qxx_Queue));
+    w25qxx_Queue->interface.lock = w25qxx_Lock;
+    w25qxx_Queue->interface.unlock = w25qxx_Unlock;
+    w25qxx_Queue->interface.lockContext = &queueMutex;
+    w25qxx_Queue->interface.notify = w25qxx_Notify;
+    w25qxx_Queue->interface.wait = w25qxx_Wait;
+    w25qxx_Queue->interface.notifyContext = &queueWakeup;
+    TEST_CHECK(w25qxx_QueueInit(w25qxx_Queue, w25qxx_Handle) == W25QXX_ERROR_NONE);
+    orderCount = 0;
+}
+
+static void Queue_Complete(w25qxx_QueueRequestTypeDef *request)
+{
+    /* Request is reported done before the callback */
+    TEST_CHECK(request->done);
+    TEST_CHECK(orderCount < QUEUE_ORDER_MAX);
+    order[orderCount++] = request;
+}
+
+static void Queue_Post(w25qxx_QueueRequestTypeDef *request)
+{
+    w25qxx_Notify(request->context);
+}
+
+static void *Queue_WorkerThread(void *argument)
+{
+    w25qxx_QueueWorker(argument);
+
+    return NULL;
+}
+
+static void Queue_Select(void *context, w25qxx_CS_State_t newState)
+{
+    if (newState == W25QXX_CS_LOW)
+        selections++;
+    portSelect(context, newState);
+}
+
+static uint32_t Queue_Now(void)
+{
+    return testNow;
+}
+
+static void Queue_Read(w25qxx_QueueRequestTypeDef *request, uint32_t address, uint8_t *buf, uint16_t dataLength,
+                       w25qxx_CRC_t trailingCRC)
+{
+    memset(request, 0, sizeof(*request));
+    request->operation = W25QXX_QUEUE_READ;
+    request->buf = buf;
+    request->dataLength = dataLength;
+    request->address = address;
+    request->trailingCRC = trailingCRC;
+    request->complete = Queue_Complete;
+}
+
+static void Queue_Fill(w25qxx_HandleTypeDef *w25qxx_Handle, uint32_t firstPage, uint32_t numberOfPages)
+{
+    uint8_t page[W25QXX_PAGE_SIZE];
+
+    /* Every page holds a full frame with checksum, the page number is the seed */
+    for (uint32_t i = firstPage; i < (firstPage + numberOfPages); i++)
+    {
+        Test_Pattern(page, sizeof(page), i);
+        TEST_CHECK(w25qxx_Write(w25qxx_Handle, page, W25QXX_PAGE_SIZE - sizeof(uint16_t), W25QXX_PAGE_TO_ADDRESS(i),
+                                W25QXX_CRC, W25QXX_WAIT_BUSY) == W25QXX_ERROR_NONE);
+    }
+}
+
+static void Test_Classes(w25qxx_QueueTypeDef *w25qxx_Queue)
+{
+    static uint8_t page[W25QXX_PAGE_SIZE], readBack[W25QXX_PAGE_SIZE], check[W25QXX_PAGE_SIZE];
+    w25qxx_QueueRequestTypeDef erase = {0}, write = {0}, read = {0};
+
+    /* Submitted in the reverse order of the classes, the read of the page goes ahead of its write */
+    Test_Pattern(page, sizeof(page), 1);
+    erase.operation = W25QXX_QUEUE_ERASE;
+    erase.eraseInstruction = W25QXX_SECTOR_ERASE_4KB;
+    erase.address = 0x1000;
+    erase.complete = Queue_Complete;
+    write.operation = W25QXX_QUEUE_WRITE;
+    write.buf = page;
+    write.dataLength = sizeof(page);
+    write.address = 0x2000;
+    write.complete = Queue_Complete;
+    read.operation = W25QXX_QUEUE_READ;
+    read.buf = readBack;
+    read.dataLength = sizeof(readBack);
+    read.address = 0x2000;
+    read.complete = Queue_Complete;
+    TEST_CHECK(w25qxx_QueueSubmit(w25qxx_Queue, &erase) == W25QXX_ERROR_NONE);
+    TEST_CHECK(w25qxx_QueueSubmit(w25qxx_Queue, &write) == W25QXX_ERROR_NONE);
+    TEST_CHECK(w25qxx_QueueSubmit(w25qxx_Queue, &read) == W25QXX_ERROR_NONE);
+    TEST_CHECK(!erase.done && !write.done && !read.done);
+
+    TEST_CHECK(w25qxx_QueueProcess(w25qxx_Queue, 0) == 3);
+    TEST_CHECK((orderCount == 3) && (order[0] == &read) && (order[1] == &write) && (order[2] == &erase));
+    TEST_CHECK((read.error == W25QXX_ERROR_NONE) && (write.error == W25QXX_ERROR_NONE));
+    TEST_CHECK(erase.error == W25QXX_ERROR_NONE);
+    for (uint32_t i = 0; i < sizeof(readBack); i++)
+        TEST_CHECK(readBack[i] == 0xFF);
+    TEST_CHECK(w25qxx_Read(w25qxx_Queue->w25qxx_Handle, check, sizeof(check), 0x2000, W25QXX_CRC_NO,
+                           W25QXX_FASTREAD_NO) == W25QXX_ERROR_NONE);
+    TEST_CHECK(memcmp(check, page, sizeof(page)) == 0);
+
+    TEST_CHECK(w25qxx_Queue->stats.submitted[W25QXX_QUEUE_READ] == 1);
+    TEST_CHECK(w25qxx_Queue->stats.submitted[W25QXX_QUEUE_WRITE] == 1);
+    TEST_CHECK(w25qxx_Queue->stats.submitted[W25QXX_QUEUE_ERASE] == 1);
+    TEST_CHECK((w25qxx_Queue->stats.completed == 3) && (w25qxx_Queue->stats.failed == 0));
+}
+
+static void Test_Failure(w25qxx_QueueTypeDef *w25qxx_Queue)
+{
+    static uint8_t page[W25QXX_PAGE_SIZE], readBack[W25QXX_PAGE_SIZE];
+    w25qxx_QueueRequestTypeDef write = {0}, read = {0};
+
+    /* Unaligned page program fails, the device error is reset for the next request */
+    Test_Pattern(page, sizeof(page), 2);
+    write.operation = W25QXX_QUEUE_WRITE;
+    write.buf = page;
+    write.dataLength = 16;
+    write.address = 0x3001;
+    read.operation = W25QXX_QUEUE_READ;
+    read.buf = readBack;
+    read.dataLength = sizeof(readBack);
+    read.address = 0x2000;
+    TEST_CHECK(w25qxx_QueueSubmit(w25qxx_Queue, &write) == W25QXX_ERROR_NONE);
+    TEST_CHECK(w25qxx_QueueProcess(w25qxx_Queue, 0) == 1);
+    TEST_CHECK(write.done && (write.error == W25QXX_ERROR_ADDRESS));
+    TEST_CHECK(w25qxx_Queue->w25qxx_Handle->error == W25QXX_ERROR_NONE);
+    TEST_CHECK(w25qxx_Queue->stats.failed == 1);
+
+    TEST_CHECK(w25qxx_QueueSubmit(w25qxx_Queue, &read) == W25QXX_ERROR_NONE);
+    TEST_CHECK(w25qxx_QueueProcess(w25qxx_Queue, 0) == 1);
+    TEST_CHECK(read.done && (read.error == W25QXX_ERROR_NONE));
+
+    /* Operation out of the classes is refused at once */
+    read.operation = W25QXX_QUEUE_CLASSES;
+    TEST_CHECK(w25qxx_QueueSubmit(w25qxx_Queue, &read) == W25QXX_ERROR_ARGUMENT);
+}
+
+static void Test_Scan(w25qxx_QueueTypeDef *w25qxx_Queue)
+{
+    static uint8_t buf[4][16];
+    w25qxx_QueueRequestTypeDef request[4];
+
+    /* Served from the last position upwards, then the lowest address (C-SCAN) */
+    Queue_Read(&request[0], 0x50000, buf[0], sizeof(buf[0]), W25QXX_CRC_NO);
+    TEST_CHECK(w25qxx_QueueSubmit(w25qxx_Queue, &request[0]) == W25QXX_ERROR_NONE);
+    TEST_CHECK(w25qxx_QueueProcess(w25qxx_Queue, 0) == 1);
+    TEST_CHECK(w25qxx_Queue->position == 0x50000);
+
+    orderCount = 0;
+    Queue_Read(&request[1], 0x20000, buf[1], sizeof(buf[1]), W25QXX_CRC_NO);
+    Queue_Read(&request[2], 0x90000, buf[2], sizeof(buf[2]), W25QXX_CRC_NO);
+    Queue_Read(&request[3], 0x70000, buf[3], sizeof(buf[3]), W25QXX_CRC_NO);
+    for (uint32_t i = 1; i < 4; i++)
+        TEST_CHECK(w25qxx_QueueSubmit(w25qxx_Queue, &request[i]) == W25QXX_ERROR_NONE);
+    TEST_CHECK(w25qxx_QueueProcess(w25qxx_Queue, 0) == 3);
+    TEST_CHECK((orderCount == 3) && (order[0] == &request[3]) && (order[1] == &request[2]) &&
+               (order[2] == &request[1]));
+    TEST_CHECK(w25qxx_Queue->stats.merged == 0);
+}
+
+static void Test_Merge(w25qxx_QueueTypeDef *w25qxx_Queue)
+{
+    static uint8_t buf[6][W25QXX_PAGE_SIZE];
+    uint8_t page[W25QXX_PAGE_SIZE];
+    w25qxx_QueueRequestTypeDef request[6];
+    uint32_t merged = w25qxx_Queue->stats.merged, instructions;
+
+    Queue_Fill(w25qxx_Queue->w25qxx_Handle, 0x100, 6);
+
+    /* Six consecutive pages submitted out of order: a full batch of four and a batch of two */
+    for (uint32_t i = 0; i < 6; i++)
+        Queue_Read(&request[i], W25QXX_PAGE_TO_ADDRESS(0x100 + (5 - i)), buf[i], W25QXX_PAGE_SIZE - sizeof(uint16_t),
+                   W25QXX_CRC);
+    w25qxx_Queue->position = 0;
+    for (uint32_t i = 0; i < 6; i++)
+        TEST_CHECK(w25qxx_QueueSubmit(w25qxx_Queue, &request[i]) == W25QXX_ERROR_NONE);
+    instructions = selections;
+    TEST_CHECK(w25qxx_QueueProcess(w25qxx_Queue, 0) == 6);
+    TEST_CHECK((selections - instructions) == 2);
+    TEST_CHECK((w25qxx_Queue->stats.merged - merged) == (W25QXX_QUEUE_MERGE_PAGES - 1) + 1);
+
+    for (uint32_t i = 0; i < 6; i++)
+    {
+        Test_Pattern(page, sizeof(page), 0x100 + (5 - i));
+        TEST_CHECK(request[i].done && (request[i].error == W25QXX_ERROR_NONE));
+        TEST_CHECK(memcmp(buf[i], page, request[i].dataLength) == 0);
+    }
+}
+
+static void Test_MergeGap(w25qxx_QueueTypeDef *w25qxx_Queue)
+{
+    static uint8_t buf[3][W25QXX_PAGE_SIZE];
+    uint8_t page[W25QXX_PAGE_SIZE];
+    w25qxx_QueueRequestTypeDef request[3];
+    uint32_t merged = w25qxx_Queue->stats.merged;
+
+    /* Frame ending exactly `W25QXX_QUEUE_MERGE_GAP` bytes before the next page still merges */
+    Queue_Read(&request[0], W25QXX_PAGE_TO_ADDRESS(0x100), buf[0], W25QXX_PAGE_SIZE - W25QXX_QUEUE_MERGE_GAP,
+               W25QXX_CRC_NO);
+    Queue_Read(&request[1], W25QXX_PAGE_TO_ADDRESS(0x101), buf[1], W25QXX_PAGE_SIZE - W25QXX_QUEUE_MERGE_GAP - 1,
+               W25QXX_CRC_NO);
+    Queue_Read(&request[2], W25QXX_PAGE_TO_ADDRESS(0x102), buf[2], 16, W25QXX_CRC_NO);
+    w25qxx_Queue->position = 0;
+    for (uint32_t i = 0; i < 3; i++)
+        TEST_CHECK(w25qxx_QueueSubmit(w25qxx_Queue, &request[i]) == W25QXX_ERROR_NONE);
+    TEST_CHECK(w25qxx_QueueProcess(w25qxx_Queue, 0) == 3);
+
+    /* The second frame leaves one byte more than the gap, the third page gets its own instruction */
+    TEST_CHECK((w25qxx_Queue->stats.merged - merged) == 1);
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        Test_Pattern(page, sizeof(page), 0x100 + i);
+        TEST_CHECK(request[i].done && (request[i].error == W25QXX_ERROR_NONE));
+        TEST_CHECK(memcmp(buf[i], page, request[i].dataLength) == 0);
+    }
+}
+
+static void Test_MergeChecksum(w25qxx_QueueTypeDef *w25qxx_Queue, w25qxx_PortTypeDef *w25qxx_Port)
+{
+    static uint8_t buf[3][W25QXX_PAGE_SIZE];
+    uint8_t page[W25QXX_PAGE_SIZE];
+    w25qxx_QueueRequestTypeDef request[3];
+    uint32_t merged = w25qxx_Queue->stats.merged, failed = w25qxx_Queue->stats.failed;
+
+    /* Middle frame is damaged in the model memory, only its request reports the checksum */
+    Queue_Fill(w25qxx_Queue->w25qxx_Handle, 0x200, 3);
+    w25qxx_Port->sim.memory[W25QXX_PAGE_TO_ADDRESS(0x201) + 10] ^= 0x01;
+    for (uint32_t i = 0; i < 3; i++)
+        Queue_Read(&request[i], W25QXX_PAGE_TO_ADDRESS(0x200 + i), buf[i], W25QXX_PAGE_SIZE - sizeof(uint16_t),
+                   W25QXX_CRC);
+    w25qxx_Queue->position = 0;
+    for (uint32_t i = 0; i < 3; i++)
+        TEST_CHECK(w25qxx_QueueSubmit(w25qxx_Queue, &request[i]) == W25QXX_ERROR_NONE);
+    TEST_CHECK(w25qxx_QueueProcess(w25qxx_Queue, 0) == 3);
+
+    TEST_CHECK((w25qxx_Queue->stats.merged - merged) == 2);
+    TEST_CHECK((w25qxx_Queue->stats.failed - failed) == 1);
+    TEST_CHECK(request[1].done && (request[1].error == W25QXX_ERROR_CHECKSUM));
+    TEST_CHECK(w25qxx_Queue->w25qxx_Handle->error == W25QXX_ERROR_NONE);
+    for (uint32_t i = 0; i < 3; i += 2)
+    {
+        Test_Pattern(page, sizeof(page), 0x200 + i);
+        TEST_CHECK(request[i].done && (request[i].error == W25QXX_ERROR_NONE));
+        TEST_CHECK(memcmp(buf[i], page, request[i].dataLength) == 0);
+    }
+}
+
+static void Test_Deadline(w25qxx_QueueTypeDef *w25qxx_Queue)
+{
+    static uint8_t buf[16], page[16];
+    w25qxx_QueueRequestTypeDef read, write = {0}, erase = {0}, relaxed = {0};
+
+    w25qxx_Queue->interface.now = Queue_Now;
+    testNow = 1000;
+
+    /* Expired requests preempt the classes, the earliest deadline first, a pending deadline changes nothing */
+    Queue_Read(&read, 0x10000, buf, sizeof(buf), W25QXX_CRC_NO);
+    Test_Pattern(page, sizeof(page), 4);
+    write.operation = W25QXX_QUEUE_WRITE;
+    write.buf = page;
+    write.dataLength = sizeof(page);
+    write.address = 0x11000;
+    write.deadline = 950;
+    write.complete = Queue_Complete;
+    erase.operation = W25QXX_QUEUE_ERASE;
+    erase.eraseInstruction = W25QXX_SECTOR_ERASE_4KB;
+    erase.address = 0x12000;
+    erase.deadline = 900;
+    erase.complete = Queue_Complete;
+    relaxed = erase;
+    relaxed.address = 0x13000;
+    relaxed.deadline = 2000;
+    TEST_CHECK(w25qxx_QueueSubmit(w25qxx_Queue, &relaxed) == W25QXX_ERROR_NONE);
+    TEST_CHECK(w25qxx_QueueSubmit(w25qxx_Queue, &read) == W25QXX_ERROR_NONE);
+    TEST_CHECK(w25qxx_QueueSubmit(w25qxx_Queue, &write) == W25QXX_ERROR_NONE);
+    TEST_CHECK(w25qxx_QueueSubmit(w25qxx_Queue, &erase) == W25QXX_ERROR_NONE);
+    orderCount = 0;
+    TEST_CHECK(w25qxx_QueueProcess(w25qxx_Queue, 0) == 4);
+
+    TEST_CHECK((orderCount == 4) && (order[0] == &erase) && (order[1] == &write) && (order[2] == &read) &&
+               (order[3] == &relaxed));
+    TEST_CHECK((w25qxx_Queue->stats.expired == 2) && (w25qxx_Queue->stats.late == 2));
+    w25qxx_Queue->interface.now = NULL;
+}
+
+static void Test_Worker(w25qxx_QueueTypeDef *w25qxx_Queue)
+{
+    static uint8_t page[W25QXX_PAGE_SIZE], readBack[W25QXX_PAGE_SIZE];
+    w25qxx_QueueRequestTypeDef write = {0}, read = {0};
+    pthread_t worker;
+
+    TEST_CHECK(pthread_create(&worker, NULL, Queue_WorkerThread, w25qxx_Queue) == 0);
+    pthread_detach(worker);
+
+    /* Requests of this thread are served by the worker, completion wakes the submitter */
+    Test_Pattern(page, sizeof(page), 3);
+    write.operation = W25QXX_QUEUE_WRITE;
+    write.buf = page;
+    write.dataLength = sizeof(page) - sizeof(uint16_t);
+    write.address = 0x4000;
+    write.trailingCRC = W25QXX_CRC;
+    write.complete = Queue_Post;
+    write.context = &requestDone;
+    read = write;
+    read.operation = W25QXX_QUEUE_READ;
+    read.buf = readBack;
+    TEST_CHECK(w25qxx_QueueSubmit(w25qxx_Queue, &write) == W25QXX_ERROR_NONE);
+    TEST_CHECK(w25qxx_Wait(&requestDone, QUEUE_WORKER_TIMEOUT));
+    TEST_CHECK(write.done && (write.error == W25QXX_ERROR_NONE));
+
+    TEST_CHECK(w25qxx_QueueSubmit(w25qxx_Queue, &read) == W25QXX_ERROR_NONE);
+    TEST_CHECK(w25qxx_Wait(&requestDone, QUEUE_WORKER_TIMEOUT));
+    TEST_CHECK(read.done && (read.error == W25QXX_ERROR_NONE));
+    TEST_CHECK(memcmp(readBack, page, write.dataLength) == 0);
+}
\ No newline at end of file
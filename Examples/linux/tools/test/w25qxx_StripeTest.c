@@ -0,0 +1,108 @@
+#include "w25qxx_Stripe.h"
+#include "w25qxx_Test.h"
+
+/* Configuration */
+#define STRIPE_DEVICES 2
+#define STRIPE_UNIT    (W25QXX_SECTOR_SIZE_4KB * STRIPE_DEVICES) // Erase unit of the volume
+#define STRIPE_ADDRESS (STRIPE_UNIT + 3 * W25QXX_PAGE_SIZE) // Volume address of the data, odd page
+#define STRIPE_LENGTH  (5 * W25QXX_PAGE_SIZE + 100) // Spans both devices several times, partial last page
+#define STRIPE_OFFSET  17 // Unaligned read start within the data
+
+/* Private variables */
+static const char *stripeImage[STRIPE_DEVICES] = {"w25qxx_StripeTest0.img", "w25qxx_StripeTest1.img"};
+static w25qxx_PortTypeDef port[STRIPE_DEVICES];
+static w25qxx_HandleTypeDef w25qxx_Handle[STRIPE_DEVICES];
+static uint8_t data[STRIPE_LENGTH], readBack[STRIPE_LENGTH];
+
+static uint8_t *Stripe_Memory(uint32_t address);
+static void Test_Erase(w25qxx_StripeTypeDef *w25qxx_Stripe);
+static void Test_WriteRead(w25qxx_StripeTypeDef *w25qxx_Stripe);
+
+int main(void)
+{
+    static w25qxx_StripeTypeDef w25qxx_Stripe;
+    w25qxx_HandleTypeDef *w25qxx_Handles[STRIPE_DEVICES];
+
+    for (uint32_t i = 0; i < STRIPE_DEVICES; i++)
+    {
+        Test_Open(&port[i], &w25qxx_Handle[i], stripeImage[i]);
+        w25qxx_Handles[i] = &w25qxx_Handle[i];
+    }
+    TEST_CHECK(w25qxx_StripeInit(&w25qxx_Stripe, w25qxx_Handles, STRIPE_DEVICES) == W25QXX_ERROR_NONE);
+    TEST_CHECK(w25qxx_Stripe.numberOfPages == STRIPE_DEVICES * w25qxx_Handle[0].numberOfPages);
+
+    Test_Erase(&w25qxx_Stripe);
+    Test_WriteRead(&w25qxx_Stripe);
+
+    for (uint32_t i = 0; i < STRIPE_DEVICES; i++)
+        w25qxx_PortClose(&port[i]);
+
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @section Private functions
+ */
+static uint8_t *Stripe_Memory(uint32_t address)
+{
+    uint32_t page = address / W25QXX_PAGE_SIZE;
+
+    /* Consecutive volume pages are spread round-robin */
+    return &port[page % STRIPE_DEVICES]
+                .sim.memory[W25QXX_PAGE_TO_ADDRESS(page / STRIPE_DEVICES) + (address % W25QXX_PAGE_SIZE)];
+}
+
+static void Test_Erase(w25qxx_StripeTypeDef *w25qxx_Stripe)
+{
+    /* Old data on both devices, around and within the erased unit */
+    for (uint32_t i = 0; i < STRIPE_DEVICES; i++)
+        memset(port[i].sim.memory, 0x5A, 3 * W25QXX_SECTOR_SIZE_4KB);
+
+    /* Unit aligned range only */
+    TEST_CHECK(w25qxx_StripeErase(w25qxx_Stripe, W25QXX_SECTOR_SIZE_4KB, STRIPE_UNIT) == W25QXX_ERROR_ADDRESS);
+    TEST_CHECK(w25qxx_StripeErase(w25qxx_Stripe, STRIPE_UNIT, W25QXX_SECTOR_SIZE_4KB) == W25QXX_ERROR_ARGUMENT);
+
+    /* Second unit is the second sector of every device */
+    TEST_CHECK(w25qxx_StripeErase(w25qxx_Stripe, STRIPE_UNIT, STRIPE_UNIT) == W25QXX_ERROR_NONE);
+    for (uint32_t i = 0; i < STRIPE_DEVICES; i++)
+    {
+        for (uint32_t offset = 0; offset < 3 * W25QXX_SECTOR_SIZE_4KB; offset++)
+        {
+            if ((offset >= W25QXX_SECTOR_SIZE_4KB) && (offset < 2 * W25QXX_SECTOR_SIZE_4KB))
+                TEST_CHECK(port[i].sim.memory[offset] == 0xFF);
+            else
+                TEST_CHECK(port[i].sim.memory[offset] == 0x5A);
+        }
+    }
+}
+
+static void Test_WriteRead(w25qxx_StripeTypeDef *w25qxx_Stripe)
+{
+    /* Pages alternate between the devices, the last one is partial */
+    Test_Pattern(data, sizeof(data), 1);
+    TEST_CHECK(w25qxx_StripeWrite(w25qxx_Stripe, data, sizeof(data), STRIPE_ADDRESS + 1) == W25QXX_ERROR_ADDRESS);
+    TEST_CHECK(w25qxx_StripeWrite(w25qxx_Stripe, data, sizeof(data), STRIPE_ADDRESS) == W25QXX_ERROR_NONE);
+    for (uint32_t i = 0; i < sizeof(data); i++)
+        TEST_CHECK(*Stripe_Memory(STRIPE_ADDRESS + i) == data[i]);
+    TEST_CHECK(*Stripe_Memory(STRIPE_ADDRESS + sizeof(data)) == 0xFF);
+
+    /* Aligned read of the whole range */
+    TEST_CHECK(w25qxx_StripeRead(w25qxx_Stripe, readBack, sizeof(readBack), STRIPE_ADDRESS, W25QXX_FASTREAD_NO) ==
+               W25QXX_ERROR_NONE);
+    TEST_CHECK(memcmp(readBack, data, sizeof(data)) == 0);
+
+    /* Unaligned read starts within a page and crosses the device boundaries */
+    memset(readBack, 0, sizeof(readBack));
+    TEST_CHECK(w25qxx_StripeRead(w25qxx_Stripe, readBack, sizeof(readBack) - STRIPE_OFFSET,
+                                 STRIPE_ADDRESS + STRIPE_OFFSET, W25QXX_FASTREAD) == W25QXX_ERROR_NONE);
+    TEST_CHECK(memcmp(readBack, data + STRIPE_OFFSET, sizeof(data) - STRIPE_OFFSET) == 0);
+
+    /* End of the volume */
+    TEST_CHECK(w25qxx_StripeRead(w25qxx_Stripe, readBack, 2,
+                                 W25QXX_PAGE_TO_ADDRESS(w25qxx_Stripe->numberOfPages) - 1,
+                                 W25QXX_FASTREAD_NO) == W25QXX_ERROR_ADDRESS);
+    TEST_CHECK(w25qxx_StripeRead(w25qxx_Stripe, readBack, 1,
+                                 W25QXX_PAGE_TO_ADDRESS(w25qxx_Stripe->numberOfPages) - 1,
+                                 W25QXX_FASTREAD_NO) == W25QXX_ERROR_NONE);
+    TEST_CHECK(readBack[0] == 0xFF);
+}
\ No newline at end of file
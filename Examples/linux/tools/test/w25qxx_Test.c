@@ -0,0 +1,24 @@
+#include "w25qxx_Test.h"
+#include <unistd.h>
+
+void Test_Open(w25qxx_PortTypeDef *w25qxx_Port, w25qxx_HandleTypeDef *w25qxx_Handle, const char *image)
+{
+    char target[256];
+
+    unlink(image);
+    snprintf(target, sizeof(target), "%s%s", W25QXX_PORT_SIM_PREFIX, image);
+    TEST_CHECK(w25qxx_PortOpen(w25qxx_Port, target, 0, TEST_DEVICE));
+    w25qxx_PortLink(w25qxx_Port, w25qxx_Handle, NULL);
+    TEST_CHECK(w25qxx_Init(w25qxx_Handle) == W25QXX_ERROR_NONE);
+}
+
+void Test_Pattern(uint8_t *buf, uint32_t length, uint32_t seed)
+{
+    uint32_t state = seed * 2654435761u + 1;
+
+    for (uint32_t i = 0; i < length; i++)
+    {
+        state = state * 1103515245u + 12345u;
+        buf[i] = (uint8_t) (state >> 16);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "w25qxx_Port.h"
+#include <stdlib.h>
+
+/* Configuration */
+#define TEST_DEVICE W25Q16 // Model images are created in the working directory
+
+/* Macro */
+#define TEST_CHECK(CONDITION)                                                             \
+    do                                                                                    \
+    {                                                                                     \
+        if (!(CONDITION))                                                                 \
+        {                                                                                 \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #CONDITION); \
+            exit(EXIT_FAILURE);                                                           \
+        }                                                                                 \
+    }                                                                                     \
+    while (0)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Creates a blank device model and initializes the handle on it
+ * @param w25qxx_Port pointer to the port structure
+ * @param w25qxx_Handle pointer to the device handle structure
+ * @param image image file name, an existing file is replaced
+ */
+void Test_Open(w25qxx_PortTypeDef *w25qxx_Port, w25qxx_HandleTypeDef *w25qxx_Handle, const char *image);
+
+/**
+ * @brief Fills the buffer with a pattern that differs for every seed
+ * @param buf pointer to the buffer
+ * @param length number of bytes to fill
+ * @param seed pattern selector
+ */
+void Test_Pattern(uint8_t *buf, uint32_t length, uint32_t seed);
+
+#ifdef __cplusplus
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,323 @@
+#include "w25qxx_Cache.h"
+#include <stdlib.h>
+
+#define SECTORS_PER_BLOCK_64KB (W25QXX_BLOCK_SIZE_64KB / W25QXX_SECTOR_SIZE_4KB)
+
+static w25qxx_CacheLine_t *CacheLine_Find(w25qxx_CacheTypeDef *w25qxx_Cache, uint32_t sector);
+static w25qxx_CacheLine_t *CacheLine_Allocate(w25qxx_CacheTypeDef *w25qxx_Cache, uint32_t sector, bool load);
+static w25qxx_CacheLine_t *CacheLine_Load(w25qxx_CacheTypeDef *w25qxx_Cache, uint32_t sector);
+static w25qxx_Error_t CacheLine_WriteBack(w25qxx_CacheTypeDef *w25qxx_Cache, w25qxx_CacheLine_t *line);
+static bool RangeCheck(w25qxx_CacheTypeDef *w25qxx_Cache, uint32_t address, uint32_t dataLength);
+
+w25qxx_Error_t w25qxx_CacheInit(w25qxx_CacheTypeDef *w25qxx_Cache, w25qxx_HandleTypeDef *w25qxx_Handle,
+                                uint32_t numberOfLines)
+{
+    /* Avoid dereferencing the null handle */
+    if ((w25qxx_Cache == NULL) || (w25qxx_Handle == NULL))
+        return W25QXX_ERROR_ARGUMENT;
+
+    memset(w25qxx_Cache, 0, sizeof(*w25qxx_Cache));
+    if (numberOfLines == 0)
+        return W25QXX_ERROR_ARGUMENT;
+    w25qxx_Cache->line = calloc(numberOfLines, sizeof(*w25qxx_Cache->line));
+    if (w25qxx_Cache->line == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    w25qxx_Cache->w25qxx_Handle = w25qxx_Handle;
+    w25qxx_Cache->numberOfLines = numberOfLines;
+
+    return w25qxx_UpdateInit(&w25qxx_Cache->w25qxx_Update, w25qxx_Handle);
+}
+
+void w25qxx_CacheDeInit(w25qxx_CacheTypeDef *w25qxx_Cache)
+{
+    if (w25qxx_Cache == NULL)
+        return;
+
+    free(w25qxx_Cache->line);
+    w25qxx_Cache->line = NULL;
+    w25qxx_Cache->numberOfLines = 0;
+    free(w25qxx_Cache->readAheadBuf);
+    w25qxx_Cache->readAheadBuf = NULL;
+    w25qxx_Cache->readAhead = 0;
+}
+
+w25qxx_Error_t w25qxx_CacheSetReadAhead(w25qxx_CacheTypeDef *w25qxx_Cache, uint32_t readAhead)
+{
+    uint8_t *readAheadBuf = NULL;
+
+    /* Avoid dereferencing the null handle */
+    if ((w25qxx_Cache == NULL) || (w25qxx_Cache->w25qxx_Handle == NULL))
+        return W25QXX_ERROR_ARGUMENT;
+
+    /* Argument guards, the missing sector must not be evicted by its own read-ahead */
+    if (readAhead >= w25qxx_Cache->numberOfLines)
+        return w25qxx_Cache->w25qxx_Handle->error = W25QXX_ERROR_ARGUMENT;
+
+    if (readAhead != 0)
+    {
+        readAheadBuf = malloc((readAhead + 1) * W25QXX_SECTOR_SIZE_4KB);
+        if (readAheadBuf == NULL)
+            return W25QXX_ERROR_ARGUMENT;
+    }
+    free(w25qxx_Cache->readAheadBuf);
+    w25qxx_Cache->readAheadBuf = readAheadBuf;
+    w25qxx_Cache->readAhead = readAhead;
+
+    return w25qxx_Cache->w25qxx_Handle->error;
+}
+
+w25qxx_Error_t w25qxx_CacheRead(w25qxx_CacheTypeDef *w25qxx_Cache, uint8_t *buf, uint32_t dataLength,
+                                uint32_t address)
+{
+    w25qxx_CacheLine_t *line;
+    uint32_t offset, chunk;
+
+    /* Avoid dereferencing the null handle */
+    if ((w25qxx_Cache == NULL) || (w25qxx_Cache->w25qxx_Handle == NULL))
+        return W25QXX_ERROR_ARGUMENT;
+
+    /* Argument guards */
+    if (buf == NULL)
+        return w25qxx_Cache->w25qxx_Handle->error = W25QXX_ERROR_ARGUMENT;
+    if (!RangeCheck(w25qxx_Cache, address, dataLength))
+        return w25qxx_Cache->w25qxx_Handle->error = W25QXX_ERROR_ADDRESS;
+
+    while (dataLength != 0)
+    {
+        offset = address % W25QXX_SECTOR_SIZE_4KB;
+        chunk = W25QXX_SECTOR_SIZE_4KB - offset;
+        if (chunk > dataLength)
+            chunk = dataLength;
+
+        line = CacheLine_Find(w25qxx_Cache, address / W25QXX_SECTOR_SIZE_4KB);
+        if (line != NULL)
+            w25qxx_Cache->stats.hits++;
+        else if ((line = CacheLine_Load(w25qxx_Cache, address / W25QXX_SECTOR_SIZE_4KB)) == NULL)
+            return w25qxx_Cache->w25qxx_Handle->error;
+
+        memcpy(buf, line->data + offset, chunk);
+        line->lastUse = ++w25qxx_Cache->useCounter;
+        buf += chunk;
+        address += chunk;
+        dataLength -= chunk;
+    }
+
+    return w25qxx_Cache->w25qxx_Handle->error;
+}
+
+w25qxx_Error_t w25qxx_CacheWrite(w25qxx_CacheTypeDef *w25qxx_Cache, const uint8_t *buf, uint32_t dataLength,
+                                 uint32_t address)
+{
+    w25qxx_CacheLine_t *line;
+    uint32_t offset, chunk;
+
+    /* Avoid dereferencing the null handle */
+    if ((w25qxx_Cache == NULL) || (w25qxx_Cache->w25qxx_Handle == NULL))
+        return W25QXX_ERROR_ARGUMENT;
+
+    /* Argument guards */
+    if (buf == NULL)
+        return w25qxx_Cache->w25qxx_Handle->error = W25QXX_ERROR_ARGUMENT;
+    if (!RangeCheck(w25qxx_Cache, address, dataLength))
+        return w25qxx_Cache->w25qxx_Handle->error = W25QXX_ERROR_ADDRESS;
+
+    while (dataLength != 0)
+    {
+        offset = address % W25QXX_SECTOR_SIZE_4KB;
+        chunk = W25QXX_SECTOR_SIZE_4KB - offset;
+        if (chunk > dataLength)
+            chunk = dataLength;
+
+        /* Old content is only needed if the sector is partially written */
+        line = CacheLine_Find(w25qxx_Cache, address / W25QXX_SECTOR_SIZE_4KB);
+        if (line != NULL)
+            w25qxx_Cache->stats.hits++;
+        else if ((line = CacheLine_Allocate(w25qxx_Cache, address / W25QXX_SECTOR_SIZE_4KB,
+                                            chunk != W25QXX_SECTOR_SIZE_4KB)) == NULL)
+            return w25qxx_Cache->w25qxx_Handle->error;
+
+        memcpy(line->data + offset, buf, chunk);
+        line->dirty = true;
+        line->lastUse = ++w25qxx_Cache->useCounter;
+        buf += chunk;
+        address += chunk;
+        dataLength -= chunk;
+    }
+
+    return w25qxx_Cache->w25qxx_Handle->error;
+}
+
+w25qxx_Error_t w25qxx_CacheFlush(w25qxx_CacheTypeDef *w25qxx_Cache)
+{
+    w25qxx_CacheLine_t *next;
+
+    /* Avoid dereferencing the null handle */
+    if ((w25qxx_Cache == NULL) || (w25qxx_Cache->w25qxx_Handle == NULL))
+        return W25QXX_ERROR_ARGUMENT;
+
+    /* Lowest dirty sector first */
+    do
+    {
+        next = NULL;
+        for (uint32_t i = 0; i < w25qxx_Cache->numberOfLines; i++)
+        {
+            if (w25qxx_Cache->line[i].valid && w25qxx_Cache->line[i].dirty &&
+                ((next == NULL) || (w25qxx_Cache->line[i].sector < next->sector)))
+                next = &w25qxx_Cache->line[i];
+        }
+        if ((next != NULL) && (CacheLine_WriteBack(w25qxx_Cache, next) != W25QXX_ERROR_NONE))
+            return w25qxx_Cache->w25qxx_Handle->error;
+    }
+    while (next != NULL);
+
+    return w25qxx_Cache->w25qxx_Handle->error;
+}
+
+w25qxx_Error_t w25qxx_CacheTrim(w25qxx_CacheTypeDef *w25qxx_Cache, uint32_t address, uint32_t dataLength)
+{
+    uint32_t sector, endSector;
+
+    /* Avoid dereferencing the null handle */
+    if ((w25qxx_Cache == NULL) || (w25qxx_Cache->w25qxx_Handle == NULL))
+        return W25QXX_ERROR_ARGUMENT;
+
+    /* Argument guards */
+    if (!RangeCheck(w25qxx_Cache, address, dataLength))
+        return w25qxx_Cache->w25qxx_Handle->error = W25QXX_ERROR_ADDRESS;
+
+    /* Whole sectors only */
+    sector = (address + W25QXX_SECTOR_SIZE_4KB - 1) / W25QXX_SECTOR_SIZE_4KB;
+    endSector = (address + dataLength) / W25QXX_SECTOR_SIZE_4KB;
+    if (sector >= endSector)
+        return w25qxx_Cache->w25qxx_Handle->error;
+
+    for (uint32_t i = 0; i < w25qxx_Cache->numberOfLines; i++)
+    {
+        if ((w25qxx_Cache->line[i].sector >= sector) && (w25qxx_Cache->line[i].sector < endSector))
+        {
+            w25qxx_Cache->line[i].valid = false;
+            w25qxx_Cache->line[i].dirty = false;
+        }
+    }
+
+    /* Batch the range into the largest aligned erase units */
+    w25qxx_Cache->stats.trimmedSectors += endSector - sector;
+    while (sector < endSector)
+    {
+        if (((sector % SECTORS_PER_BLOCK_64KB) == 0) && ((endSector - sector) >= SECTORS_PER_BLOCK_64KB))
+        {
+            if (w25qxx_Erase(w25qxx_Cache->w25qxx_Handle, W25QXX_BLOCK_ERASE_64KB, W25QXX_SECTOR_TO_ADDRESS(sector),
+                             W25QXX_WAIT_BUSY) != W25QXX_ERROR_NONE)
+                return w25qxx_Cache->w25qxx_Handle->error;
+            sector += SECTORS_PER_BLOCK_64KB;
+        }
+        else
+        {
+            if (w25qxx_Erase(w25qxx_Cache->w25qxx_Handle, W25QXX_SECTOR_ERASE_4KB, W25QXX_SECTOR_TO_ADDRESS(sector),
+                             W25QXX_WAIT_BUSY) != W25QXX_ERROR_NONE)
+                return w25qxx_Cache->w25qxx_Handle->error;
+            sector++;
+        }
+        w25qxx_Cache->stats.eraseInstructions++;
+    }
+
+    return w25qxx_Cache->w25qxx_Handle->error;
+}
+
+/**
+ * @section Private functions
+ */
+static w25qxx_CacheLine_t *CacheLine_Find(w25qxx_CacheTypeDef *w25qxx_Cache, uint32_t sector)
+{
+    for (uint32_t i = 0; i < w25qxx_Cache->numberOfLines; i++)
+    {
+        if (w25qxx_Cache->line[i].valid && (w25qxx_Cache->line[i].sector == sector))
+            return &w25qxx_Cache->line[i];
+    }
+
+    return NULL;
+}
+
+static w25qxx_CacheLine_t *CacheLine_Allocate(w25qxx_CacheTypeDef *w25qxx_Cache, uint32_t sector, bool load)
+{
+    w25qxx_CacheLine_t *victim = &w25qxx_Cache->line[0];
+
+    /* Free line or the least recently used one */
+    for (uint32_t i = 0; i < w25qxx_Cache->numberOfLines; i++)
+    {
+        if (!w25qxx_Cache->line[i].valid)
+        {
+            victim = &w25qxx_Cache->line[i];
+            break;
+        }
+        if (w25qxx_Cache->line[i].lastUse < victim->lastUse)
+            victim = &w25qxx_Cache->line[i];
+    }
+    if (victim->valid && victim->dirty && (CacheLine_WriteBack(w25qxx_Cache, victim) != W25QXX_ERROR_NONE))
+        return NULL;
+
+    victim->valid = false;
+    if (load)
+    {
+        if (w25qxx_ReadStream(w25qxx_Cache->w25qxx_Handle, victim->data, W25QXX_SECTOR_SIZE_4KB,
+                              W25QXX_SECTOR_TO_ADDRESS(sector), W25QXX_FASTREAD) != W25QXX_ERROR_NONE)
+            return NULL;
+        w25qxx_Cache->stats.misses++;
+    }
+    victim->sector = sector;
+    victim->valid = true;
+    victim->dirty = false;
+
+    return victim;
+}
+
+static w25qxx_CacheLine_t *CacheLine_Load(w25qxx_CacheTypeDef *w25qxx_Cache, uint32_t sector)
+{
+    uint32_t numberOfSectors = W25QXX_PAGE_SIZE * w25qxx_Cache->w25qxx_Handle->numberOfPages / W25QXX_SECTOR_SIZE_4KB;
+    uint32_t count = 1;
+    w25qxx_CacheLine_t *line = NULL;
+
+    /* Following sectors up to the first cached one */
+    while ((count <= w25qxx_Cache->readAhead) && ((sector + count) < numberOfSectors) &&
+           (CacheLine_Find(w25qxx_Cache, sector + count) == NULL))
+        count++;
+    if (count == 1)
+        return CacheLine_Allocate(w25qxx_Cache, sector, true);
+
+    if (w25qxx_ReadStream(w25qxx_Cache->w25qxx_Handle, w25qxx_Cache->readAheadBuf, count * W25QXX_SECTOR_SIZE_4KB,
+                          W25QXX_SECTOR_TO_ADDRESS(sector), W25QXX_FASTREAD) != W25QXX_ERROR_NONE)
+        return NULL;
+
+    /* Missing sector is allocated last, so it is the most recently used one */
+    for (uint32_t i = count; i-- > 0;)
+    {
+        if ((line = CacheLine_Allocate(w25qxx_Cache, sector + i, false)) == NULL)
+            return NULL;
+        memcpy(line->data, w25qxx_Cache->readAheadBuf + i * W25QXX_SECTOR_SIZE_4KB, W25QXX_SECTOR_SIZE_4KB);
+        line->lastUse = ++w25qxx_Cache->useCounter;
+    }
+    w25qxx_Cache->stats.misses++;
+    w25qxx_Cache->stats.readAheads += count - 1;
+
+    return line;
+}
+
+static w25qxx_Error_t CacheLine_WriteBack(w25qxx_CacheTypeDef *w25qxx_Cache, w25qxx_CacheLine_t *line)
+{
+    if (w25qxx_UpdateSector(&w25qxx_Cache->w25qxx_Update, line->sector, line->data, W25QXX_SECTOR_SIZE_4KB) !=
+        W25QXX_ERROR_NONE)
+        return w25qxx_Cache->w25qxx_Handle->error;
+
+    line->dirty = false;
+    w25qxx_Cache->stats.writeBacks++;
+
+    return w25qxx_Cache->w25qxx_Handle->error;
+}
+
+static bool RangeCheck(w25qxx_CacheTypeDef *w25qxx_Cache, uint32_t address, uint32_t dataLength)
+{
+    uint32_t capacity = W25QXX_PAGE_SIZE * w25qxx_Cache->w25qxx_Handle->numberOfPages;
+
+    return (address <= capacity) && (dataLength <= capacity - address);
+}
\ No newline at end of file
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "w25qxx_Update.h"
+
+/* Configuration */
+#define W25QXX_CACHE_LINES_DEFAULT 64 // 4KB sector lines
+
+/* Data types */
+typedef struct w25qxx_CacheLine_s {
+    uint32_t sector;
+    bool valid;
+    bool dirty; // Line differs from the device, written back on eviction or flush
+    uint32_t lastUse;
+    uint8_t data[W25QXX_SECTOR_SIZE_4KB];
+} w25qxx_CacheLine_t;
+
+typedef struct w25qxx_CacheTypeDef_s {
+    w25qxx_HandleTypeDef *w25qxx_Handle;
+    w25qxx_UpdateTypeDef w25qxx_Update; // Write-back only touches the changed pages
+    w25qxx_CacheLine_t *line;
+    uint32_t numberOfLines;
+    uint32_t useCounter;
+    uint32_t readAhead; // Sectors loaded after a missing one by the same read instruction
+    uint8_t *readAheadBuf;
+
+    struct {
+        uint32_t hits;
+        uint32_t misses; // Sectors read from the device on demand
+        uint32_t readAheads; // Sectors read from the device ahead of the demand
+        uint32_t writeBacks; // Dirty sectors written to the device
+        uint32_t trimmedSectors; // Sectors erased by trim
+        uint32_t eraseInstructions; // Erase instructions used by trim
+    } stats;
+} w25qxx_CacheTypeDef;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Allocates the sector lines and links the cache to the device
+ * @param w25qxx_Cache pointer to the cache structure
+ * @param w25qxx_Handle pointer to the initialized device handle
+ * @param numberOfLines number of cached sectors
+ * @return `w25qxx_Handle->error`, `W25QXX_ERROR_ARGUMENT` if out of memory
+ */
+w25qxx_Error_t w25qxx_CacheInit(w25qxx_CacheTypeDef *w25qxx_Cache, w25qxx_HandleTypeDef *w25qxx_Handle,
+                                uint32_t numberOfLines);
+
+/**
+ * @brief Releases the sector lines, dirty lines are lost (see `w25qxx_CacheFlush()`)
+ * @param w25qxx_Cache pointer to the cache structure
+ */
+void w25qxx_CacheDeInit(w25qxx_CacheTypeDef *w25qxx_Cache);
+
+/**
+ * @brief Sets the number of sectors loaded ahead on a read miss
+ * @param w25qxx_Cache pointer to the cache structure
+ * @param readAhead number of following sectors (< number of lines), 0 to disable
+ * @note Sectors ahead are only loaded up to the first cached one, all of them with a single read instruction
+ * @return `w25qxx_Handle->error`, `W25QXX_ERROR_ARGUMENT` if out of memory
+ */
+w25qxx_Error_t w25qxx_CacheSetReadAhead(w25qxx_CacheTypeDef *w25qxx_Cache, uint32_t readAhead);
+
+/**
+ * @brief Reads any number of bytes from any address, missing sectors are loaded into the cache
+ * @param w25qxx_Cache pointer to the cache structure
+ * @param buf pointer to external buffer, that will contain the data
+ * @param dataLength number of bytes to read
+ * @param address start address to read
+ * @return `w25qxx_Handle->error`
+ */
+w25qxx_Error_t w25qxx_CacheRead(w25qxx_CacheTypeDef *w25qxx_Cache, uint8_t *buf, uint32_t dataLength,
+                                uint32_t address);
+
+/**
+ * @brief Writes any number of bytes to any address, the device is updated on eviction or flush
+ * @param w25qxx_Cache pointer to the cache structure
+ * @param buf pointer to the data
+ * @param dataLength number of bytes to write
+ * @param address start address to write
+ * @note Partially written sectors are read first (read-modify-write), whole sectors are not
+ * @return `w25qxx_Handle->error`
+ */
+w25qxx_Error_t w25qxx_CacheWrite(w25qxx_CacheTypeDef *w25qxx_Cache, const uint8_t *buf, uint32_t dataLength,
+                                 uint32_t address);
+
+/**
+ * @brief Writes all dirty sectors back to the device in ascending order
+ * @param w25qxx_Cache pointer to the cache structure
+ * @return `w25qxx_Handle->error`
+ */
+w25qxx_Error_t w25qxx_CacheFlush(w25qxx_CacheTypeDef *w25qxx_Cache);
+
+/**
+ * @brief Discards the content of the range, whole sectors within it are erased
+ * @param w25qxx_Cache pointer to the cache structure
+ * @param address start address of the range
+ * @param dataLength length of the range
+ * @note Partially covered sectors are kept. The range is erased with 64KB block erases where aligned and sector
+ * erases elsewhere, cached lines of the range are dropped
+ * @return `w25qxx_Handle->error`
+ */
+w25qxx_Error_t w25qxx_CacheTrim(w25qxx_CacheTypeDef *w25qxx_Cache, uint32_t address, uint32_t dataLength);
+
+#ifdef __cplusplus
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,65 @@
+#include "w25qxx_Interface.h"
+#include <time.h>
+#include <unistd.h>
+
+uint32_t w25qxx_Delay(uint32_t ms)
+{
+    usleep(ms * 1000u);
+
+    return ms;
+}
+
+uint32_t w25qxx_DelayUs(uint32_t us)
+{
+    usleep(us);
+
+    return us;
+}
+
+void w25qxx_Print(const char *message)
+{
+    fputs(message, stderr);
+}
+
+uint32_t w25qxx_Now(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint32_t) (now.tv_sec * 1000u + now.tv_nsec / 1000000u);
+}
+
+void w25qxx_Lock(void *context)
+{
+    pthread_mutex_lock((pthread_mutex_t *) context);
+}
+
+void w25qxx_Unlock(void *context)
+{
+    pthread_mutex_unlock((pthread_mutex_t *) context);
+}
+
+void w25qxx_Notify(void *context)
+{
+    sem_post((sem_t *) context);
+}
+
+bool w25qxx_Wait(void *context, uint32_t timeout)
+{
+    struct timespec deadline;
+
+    if (timeout == 0xFFFFFFFF)
+        return (sem_wait((sem_t *) context) == 0);
+
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += timeout / 1000;
+    deadline.tv_nsec += (long) (timeout % 1000) * 1000000;
+    if (deadline.tv_nsec >= 1000000000)
+    {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000;
+    }
+
+    return (sem_timedwait((sem_t *) context, &deadline) == 0);
+}
\ No newline at end of file
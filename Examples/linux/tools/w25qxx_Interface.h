@@ -0,0 +1,84 @@
+#pragma once
+
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Data types */
+typedef enum w25qxx_Transfer_Status_e {
+    W25QXX_TRANSFER_SUCCESS,
+    W25QXX_TRANSFER_ERROR,
+} w25qxx_Transfer_Status_t;
+
+typedef enum w25qxx_CS_State_e { W25QXX_CS_LOW, W25QXX_CS_HIGH } w25qxx_CS_State_t;
+
+/**
+ * @section General functions
+ */
+
+/**
+ * @brief Provides minimum delay (in milliseconds)
+ * @param ms: specifies the delay time length, in milliseconds
+ * @return Delay time length
+ */
+uint32_t w25qxx_Delay(uint32_t ms);
+
+/**
+ * @brief Provides minimum delay (in microseconds)
+ * @param us: specifies the delay time length, in microseconds
+ * @return Delay time length
+ */
+uint32_t w25qxx_DelayUs(uint32_t us);
+
+/**
+ * @brief Function used to print any debug messages
+ * @param message: the message to print
+ */
+void w25qxx_Print(const char *message);
+
+/**
+ * @brief Returns the monotonic time
+ * @return Time in milliseconds
+ */
+uint32_t w25qxx_Now(void);
+
+/**
+ * @section OS functions
+ */
+
+/**
+ * @brief Locks the mutex
+ * @param context: pointer to `pthread_mutex_t`
+ */
+void w25qxx_Lock(void *context);
+
+/**
+ * @brief Unlocks the mutex
+ * @param context: pointer to `pthread_mutex_t`
+ */
+void w25qxx_Unlock(void *context);
+
+/**
+ * @brief Posts the semaphore
+ * @param context: pointer to `sem_t`
+ */
+void w25qxx_Notify(void *context);
+
+/**
+ * @brief Waits for the semaphore
+ * @param context: pointer to `sem_t`
+ * @param timeout: timeout duration in milliseconds, 0xFFFFFFFF to wait forever
+ * @return true if the semaphore is taken, false on timeout
+ */
+bool w25qxx_Wait(void *context, uint32_t timeout);
+
+#ifdef __cplusplus
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,651 @@
+#include "w25qxx_Port.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/spi/spidev.h>
+#include <stdlib.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define SIM_SR1_BUSY             (1u << 0)
+#define SIM_SR1_WRITE_ENABLE     (1u << 1)
+#define SIM_DEVICE_SIZE(DEVICE)  (W25QXX_KB_TO_BYTE(1024) << ((DEVICE) - W25Q80))
+#define SPIDEV_BUFSIZE_PARAMETER "/sys/module/spidev/parameters/bufsiz"
+
+static bool Spidev_Open(w25qxx_PortTypeDef *w25qxx_Port, const char *path, uint32_t speed);
+static bool Spidev_Message(w25qxx_PortTypeDef *w25qxx_Port, uint8_t *pDataRx, uint32_t rxLength, bool release);
+static w25qxx_Transfer_Status_t Spidev_Receive(void *handle, uint8_t *pDataRx, uint16_t size, uint32_t timeout);
+static w25qxx_Transfer_Status_t Spidev_Transmit(void *handle, const uint8_t *pDataTx, uint16_t size, uint32_t timeout);
+static void Spidev_CS_Set(void *context, w25qxx_CS_State_t newState);
+static bool Sim_Open(w25qxx_PortTypeDef *w25qxx_Port, const char *path, uint8_t simDevice);
+static uint8_t Sim_Exchange(w25qxx_PortTypeDef *w25qxx_Port, uint8_t dataIn);
+static void Sim_Deselect(w25qxx_PortTypeDef *w25qxx_Port);
+static w25qxx_Transfer_Status_t Sim_Receive(void *handle, uint8_t *pDataRx, uint16_t size, uint32_t timeout);
+static w25qxx_Transfer_Status_t Sim_Transmit(void *handle, const uint8_t *pDataTx, uint16_t size, uint32_t timeout);
+static void Sim_CS_Set(void *context, w25qxx_CS_State_t newState);
+static w25qxx_Transfer_Status_t DMA_Start(w25qxx_PortTypeDef *w25qxx_Port, uint8_t *pData, uint16_t size, void *owner,
+                                          bool receive);
+static w25qxx_Transfer_Status_t DMA_Receive(void *handle, uint8_t *pDataRx, uint16_t size, void *owner);
+static w25qxx_Transfer_Status_t DMA_Transmit(void *handle, const uint8_t *pDataTx, uint16_t size, void *owner);
+static void DMA_Abort(void *handle);
+static void *DMA_Thread(void *argument);
+
+bool w25qxx_PortOpen(w25qxx_PortTypeDef *w25qxx_Port, const char *target, uint32_t speed, uint8_t simDevice)
+{
+    if ((w25qxx_Port == NULL) || (target == NULL))
+        return false;
+
+    memset(w25qxx_Port, 0, sizeof(*w25qxx_Port));
+    w25qxx_Port->fd = -1;
+
+    if (strncmp(target, W25QXX_PORT_SIM_PREFIX, strlen(W25QXX_PORT_SIM_PREFIX)) == 0)
+    {
+        w25qxx_Port->type = W25QXX_PORT_SIM;
+
+        return Sim_Open(w25qxx_Port, target + strlen(W25QXX_PORT_SIM_PREFIX), simDevice);
+    }
+    w25qxx_Port->type = W25QXX_PORT_SPIDEV;
+
+    return Spidev_Open(w25qxx_Port, target, speed);
+}
+
+void w25qxx_PortLink(w25qxx_PortTypeDef *w25qxx_Port, w25qxx_HandleTypeDef *w25qxx_Handle, w25qxx_print_fp print)
+{
+    if ((w25qxx_Port == NULL) || (w25qxx_Handle == NULL))
+        return;
+
+    memset(w25qxx_Handle, 0, sizeof(*w25qxx_Handle));
+    w25qxx_Handle->interface.handle = w25qxx_Port;
+    w25qxx_Handle->interface.cs_context = w25qxx_Port;
+    w25qxx_Handle->interface.delay = w25qxx_Delay;
+    w25qxx_Handle->interface.delay_us = w25qxx_DelayUs;
+    w25qxx_Handle->interface.tick = w25qxx_Now;
+    w25qxx_Handle->interface.print = print;
+
+    switch (w25qxx_Port->type)
+    {
+    case W25QXX_PORT_SPIDEV:
+        w25qxx_Handle->interface.receive = Spidev_Receive;
+        w25qxx_Handle->interface.transmit = Spidev_Transmit;
+        w25qxx_Handle->interface.cs_set_context = Spidev_CS_Set;
+        break;
+
+    case W25QXX_PORT_SIM:
+        w25qxx_Handle->interface.receive = Sim_Receive;
+        w25qxx_Handle->interface.transmit = Sim_Transmit;
+        w25qxx_Handle->interface.cs_set_context = Sim_CS_Set;
+        break;
+    }
+}
+
+bool w25qxx_PortAsyncLink(w25qxx_PortTypeDef *w25qxx_Port, w25qxx_HandleTypeDef *w25qxx_Handle)
+{
+    if ((w25qxx_Port == NULL) || (w25qxx_Handle == NULL))
+        return false;
+
+    if (!w25qxx_Port->dma.started)
+    {
+        pthread_mutex_init(&w25qxx_Port->dma.mutex, NULL);
+        pthread_cond_init(&w25qxx_Port->dma.request, NULL);
+        pthread_cond_init(&w25qxx_Port->dma.idle, NULL);
+        w25qxx_Port->dma.stop = false;
+        if (pthread_create(&w25qxx_Port->dma.thread, NULL, DMA_Thread, w25qxx_Port) != 0)
+            return false;
+        w25qxx_Port->dma.started = true;
+    }
+    w25qxx_Handle->interface.receive_async = DMA_Receive;
+    w25qxx_Handle->interface.transmit_async = DMA_Transmit;
+    w25qxx_Handle->interface.abort_async = DMA_Abort;
+
+    return true;
+}
+
+void w25qxx_PortClose(w25qxx_PortTypeDef *w25qxx_Port)
+{
+    if (w25qxx_Port == NULL)
+        return;
+
+    if (w25qxx_Port->dma.started)
+    {
+        pthread_mutex_lock(&w25qxx_Port->dma.mutex);
+        w25qxx_Port->dma.stop = true;
+        pthread_cond_signal(&w25qxx_Port->dma.request);
+        pthread_mutex_unlock(&w25qxx_Port->dma.mutex);
+        pthread_join(w25qxx_Port->dma.thread, NULL);
+        pthread_cond_destroy(&w25qxx_Port->dma.request);
+        pthread_cond_destroy(&w25qxx_Port->dma.idle);
+        pthread_mutex_destroy(&w25qxx_Port->dma.mutex);
+        w25qxx_Port->dma.started = false;
+    }
+
+    if (w25qxx_Port->sim.memory != NULL)
+    {
+        msync(w25qxx_Port->sim.memory, w25qxx_Port->sim.size, MS_SYNC);
+        munmap(w25qxx_Port->sim.memory, w25qxx_Port->sim.size);
+        w25qxx_Port->sim.memory = NULL;
+    }
+    free(w25qxx_Port->spi.pending);
+    w25qxx_Port->spi.pending = NULL;
+    if (w25qxx_Port->fd >= 0)
+        close(w25qxx_Port->fd);
+    w25qxx_Port->fd = -1;
+}
+
+/**
+ * @section Private functions
+ */
+static bool Spidev_Open(w25qxx_PortTypeDef *w25qxx_Port, const char *path, uint32_t speed)
+{
+    uint8_t mode = SPI_MODE_0, bitsPerWord = 8;
+    unsigned long bufSize = W25QXX_PORT_SPI_BUFSIZE;
+    FILE *parameter;
+
+    w25qxx_Port->fd = open(path, O_RDWR);
+    if (w25qxx_Port->fd < 0)
+        return false;
+
+    if ((ioctl(w25qxx_Port->fd, SPI_IOC_WR_MODE, &mode) < 0) ||
+        (ioctl(w25qxx_Port->fd, SPI_IOC_WR_BITS_PER_WORD, &bitsPerWord) < 0) ||
+        (ioctl(w25qxx_Port->fd, SPI_IOC_WR_MAX_SPEED_HZ, &speed) < 0))
+        return false;
+
+    /* The whole message has to fit the spidev bounce buffer */
+    parameter = fopen(SPIDEV_BUFSIZE_PARAMETER, "r");
+    if (parameter != NULL)
+    {
+        if ((fscanf(parameter, "%lu", &bufSize) != 1) || (bufSize == 0))
+            bufSize = W25QXX_PORT_SPI_BUFSIZE;
+        fclose(parameter);
+    }
+
+    w25qxx_Port->spi.speed = speed;
+    w25qxx_Port->spi.bufSize = (uint32_t) bufSize;
+    w25qxx_Port->spi.pending = malloc(bufSize);
+
+    return w25qxx_Port->spi.pending != NULL;
+}
+
+static bool Spidev_Message(w25qxx_PortTypeDef *w25qxx_Port, uint8_t *pDataRx, uint32_t rxLength, bool release)
+{
+    struct spi_ioc_transfer transfer[2];
+    uint32_t count = 0;
+
+    memset(transfer, 0, sizeof(transfer));
+    if (w25qxx_Port->spi.pendingLength != 0)
+    {
+        transfer[count].tx_buf = (uintptr_t) w25qxx_Port->spi.pending;
+        transfer[count].len = w25qxx_Port->spi.pendingLength;
+        count++;
+    }
+    if (rxLength != 0)
+    {
+        transfer[count].rx_buf = (uintptr_t) pDataRx;
+        transfer[count].len = rxLength;
+        count++;
+    }
+
+    /* Zero length transfer only drives the /CS */
+    if (count == 0)
+        count = 1;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        transfer[i].speed_hz = w25qxx_Port->spi.speed;
+        transfer[i].bits_per_word = 8;
+    }
+    transfer[count - 1].cs_change = release ? 0 : 1; // Keep /CS low after the message
+
+    w25qxx_Port->spi.pendingLength = 0;
+    w25qxx_Port->spi.selected = !release;
+
+    return ioctl(w25qxx_Port->fd, SPI_IOC_MESSAGE(count), transfer) >= 0;
+}
+
+static w25qxx_Transfer_Status_t Spidev_Receive(void *handle, uint8_t *pDataRx, uint16_t size, uint32_t timeout)
+{
+    w25qxx_PortTypeDef *w25qxx_Port = handle;
+    uint32_t chunk;
+
+    (void) timeout;
+
+    if ((w25qxx_Port == NULL) || (pDataRx == NULL) || (size == 0u))
+        return W25QXX_TRANSFER_ERROR;
+
+    while (size != 0u)
+    {
+        if (w25qxx_Port->spi.pendingLength >= w25qxx_Port->spi.bufSize)
+        {
+            if (!Spidev_Message(w25qxx_Port, NULL, 0, false))
+                return W25QXX_TRANSFER_ERROR;
+        }
+        chunk = w25qxx_Port->spi.bufSize - w25qxx_Port->spi.pendingLength;
+        if (chunk > size)
+            chunk = size;
+
+        if (!Spidev_Message(w25qxx_Port, pDataRx, chunk, false))
+            return W25QXX_TRANSFER_ERROR;
+        pDataRx += chunk;
+        size -= (uint16_t) chunk;
+    }
+
+    return W25QXX_TRANSFER_SUCCESS;
+}
+
+static w25qxx_Transfer_Status_t Spidev_Transmit(void *handle, const uint8_t *pDataTx, uint16_t size, uint32_t timeout)
+{
+    w25qxx_PortTypeDef *w25qxx_Port = handle;
+    uint32_t chunk;
+
+    (void) timeout;
+
+    if ((w25qxx_Port == NULL) || (pDataTx == NULL) || (size == 0u))
+        return W25QXX_TRANSFER_ERROR;
+
+    /* Caller buffer may not outlive the call, the data is copied */
+    while (size != 0u)
+    {
+        if (w25qxx_Port->spi.pendingLength >= w25qxx_Port->spi.bufSize)
+        {
+            if (!Spidev_Message(w25qxx_Port, NULL, 0, false))
+                return W25QXX_TRANSFER_ERROR;
+        }
+        chunk = w25qxx_Port->spi.bufSize - w25qxx_Port->spi.pendingLength;
+        if (chunk > size)
+            chunk = size;
+
+        memcpy(w25qxx_Port->spi.pending + w25qxx_Port->spi.pendingLength, pDataTx, chunk);
+        w25qxx_Port->spi.pendingLength += chunk;
+        pDataTx += chunk;
+        size -= (uint16_t) chunk;
+    }
+
+    return W25QXX_TRANSFER_SUCCESS;
+}
+
+static void Spidev_CS_Set(void *context, w25qxx_CS_State_t newState)
+{
+    w25qxx_PortTypeDef *w25qxx_Port = context;
+
+    /* /CS goes low with the first message */
+    if (newState == W25QXX_CS_LOW)
+        return;
+
+    if ((w25qxx_Port->spi.pendingLength != 0) || w25qxx_Port->spi.selected)
+        Spidev_Message(w25qxx_Port, NULL, 0, true);
+}
+
+static bool Sim_Open(w25qxx_PortTypeDef *w25qxx_Port, const char *path, uint8_t simDevice)
+{
+    struct stat fileStat;
+    bool created = false;
+
+    /* Without the device ID only an existing image is opened, read-only if it can't be written */
+    w25qxx_Port->fd = open(path, (simDevice != 0) ? (O_RDWR | O_CREAT) : O_RDWR, 0644);
+    if ((w25qxx_Port->fd < 0) && (simDevice == 0) && ((errno == EACCES) || (errno == EPERM) || (errno == EROFS)))
+    {
+        w25qxx_Port->fd = open(path, O_RDONLY);
+        w25qxx_Port->sim.readOnly = true;
+    }
+    if ((w25qxx_Port->fd < 0) || (fstat(w25qxx_Port->fd, &fileStat) < 0))
+        return false;
+
+    if (fileStat.st_size == 0)
+    {
+        if ((simDevice < W25Q80) || (simDevice > W25Q128))
+            return false;
+        w25qxx_Port->sim.deviceID = simDevice;
+        if (ftruncate(w25qxx_Port->fd, SIM_DEVICE_SIZE(simDevice)) < 0)
+            return false;
+        created = true;
+    }
+    else
+    {
+        /* Device is recognized by the image size */
+        for (uint8_t device = W25Q80; device <= W25Q128; device++)
+        {
+            if ((off_t) SIM_DEVICE_SIZE(device) == fileStat.st_size)
+                w25qxx_Port->sim.deviceID = device;
+        }
+        if (w25qxx_Port->sim.deviceID == 0)
+            return false;
+    }
+
+    w25qxx_Port->sim.size = SIM_DEVICE_SIZE(w25qxx_Port->sim.deviceID);
+    w25qxx_Port->sim.memory = mmap(NULL, w25qxx_Port->sim.size, PROT_READ | PROT_WRITE,
+                                   w25qxx_Port->sim.readOnly ? MAP_PRIVATE : MAP_SHARED, w25qxx_Port->fd, 0);
+    if (w25qxx_Port->sim.memory == MAP_FAILED)
+    {
+        w25qxx_Port->sim.memory = NULL;
+
+        return false;
+    }
+    if (created)
+        memset(w25qxx_Port->sim.memory, 0xff, w25qxx_Port->sim.size);
+
+    return true;
+}
+
+static uint8_t Sim_Exchange(w25qxx_PortTypeDef *w25qxx_Port, uint8_t dataIn)
+{
+    uint32_t count = w25qxx_Port->sim.count++;
+    uint32_t offset;
+
+    /* Instruction byte */
+    if (count == 0)
+    {
+        w25qxx_Port->sim.instruction = dataIn;
+        if (w25qxx_Port->sim.powerDown && (dataIn != 0xAB))
+            w25qxx_Port->sim.instruction = 0x00; // Only the release is accepted
+
+        switch (w25qxx_Port->sim.instruction)
+        {
+        case 0x06:
+            w25qxx_Port->sim.writeEnable = true;
+            break;
+
+        case 0x04:
+            w25qxx_Port->sim.writeEnable = false;
+            break;
+
+        case 0x50:
+            w25qxx_Port->sim.volatileWriteEnable = true;
+            break;
+
+        case 0xAB:
+            w25qxx_Port->sim.powerDown = false;
+            break;
+
+        case 0xB9:
+            w25qxx_Port->sim.powerDown = true;
+            break;
+        }
+
+        return 0xff;
+    }
+
+    /* 24-bit address */
+    if ((count <= 3) && (w25qxx_Port->sim.instruction != 0x05) && (w25qxx_Port->sim.instruction != 0x35) &&
+        (w25qxx_Port->sim.instruction != 0x15) && (w25qxx_Port->sim.instruction != 0x9F) &&
+        (w25qxx_Port->sim.instruction != 0x01) && (w25qxx_Port->sim.instruction != 0x31) &&
+        (w25qxx_Port->sim.instruction != 0x11))
+    {
+        w25qxx_Port->sim.address = (count == 1) ? dataIn : ((w25qxx_Port->sim.address << 8) | dataIn);
+
+        return 0xff;
+    }
+
+    switch (w25qxx_Port->sim.instruction)
+    {
+    case 0x05:
+        return w25qxx_Port->sim.statusRegister[0] | (w25qxx_Port->sim.writeEnable ? SIM_SR1_WRITE_ENABLE : 0);
+
+    case 0x35:
+        return w25qxx_Port->sim.statusRegister[1];
+
+    case 0x15:
+        return w25qxx_Port->sim.statusRegister[2];
+
+    case 0x01:
+    case 0x31:
+    case 0x11:
+        if (!w25qxx_Port->sim.writeEnable && !w25qxx_Port->sim.volatileWriteEnable)
+            return 0xff;
+        if (w25qxx_Port->sim.instruction == 0x01)
+        {
+            if (count == 1)
+                w25qxx_Port->sim.statusRegister[0] = dataIn & ~(SIM_SR1_BUSY | SIM_SR1_WRITE_ENABLE);
+            else if (count == 2)
+                w25qxx_Port->sim.statusRegister[1] = dataIn;
+        }
+        else if (count == 1)
+        {
+            w25qxx_Port->sim.statusRegister[(w25qxx_Port->sim.instruction == 0x31) ? 1 : 2] = dataIn;
+        }
+        return 0xff;
+
+    case 0x90:
+        return ((count - 4) % 2 == 0) ? W25QXX_MANUFACTURER_ID : w25qxx_Port->sim.deviceID;
+
+    case 0x9F:
+        if (count == 1)
+            return W25QXX_MANUFACTURER_ID;
+        return (count == 2) ? 0x40 : (uint8_t) (w25qxx_Port->sim.deviceID + 1);
+
+    case 0xAB:
+        return w25qxx_Port->sim.deviceID;
+
+    case 0x03:
+        return w25qxx_Port->sim.memory[(w25qxx_Port->sim.address + count - 4) % w25qxx_Port->sim.size];
+
+    case 0x0B:
+        if (count == 4)
+            return 0xff; // Dummy clocks
+        return w25qxx_Port->sim.memory[(w25qxx_Port->sim.address + count - 5) % w25qxx_Port->sim.size];
+
+    case 0x02:
+        /* Page program wraps within the page and only clears bits */
+        if (w25qxx_Port->sim.writeEnable)
+        {
+            offset = (w25qxx_Port->sim.address & ~(uint32_t) (W25QXX_PAGE_SIZE - 1)) |
+                     ((w25qxx_Port->sim.address + count - 4) & (W25QXX_PAGE_SIZE - 1));
+            w25qxx_Port->sim.memory[offset % w25qxx_Port->sim.size] &= dataIn;
+        }
+        return 0xff;
+    }
+
+    return 0xff;
+}
+
+static void Sim_Deselect(w25qxx_PortTypeDef *w25qxx_Port)
+{
+    uint32_t eraseSize = 0;
+
+    /* Instructions take effect on the /CS rising edge */
+    switch (w25qxx_Port->sim.instruction)
+    {
+    case 0x02:
+        if (w25qxx_Port->sim.count > 4)
+            w25qxx_Port->sim.writeEnable = false;
+        break;
+
+    case 0x20:
+        eraseSize = W25QXX_SECTOR_SIZE_4KB;
+        break;
+
+    case 0x52:
+        eraseSize = W25QXX_BLOCK_SIZE_32KB;
+        break;
+
+    case 0xD8:
+        eraseSize = W25QXX_BLOCK_SIZE_64KB;
+        break;
+
+    case 0xC7:
+    case 0x60:
+        if (w25qxx_Port->sim.writeEnable)
+            memset(w25qxx_Port->sim.memory, 0xff, w25qxx_Port->sim.size);
+        w25qxx_Port->sim.writeEnable = false;
+        break;
+
+    case 0x01:
+    case 0x31:
+    case 0x11:
+        if (w25qxx_Port->sim.count >= 2)
+        {
+            w25qxx_Port->sim.writeEnable = false;
+            w25qxx_Port->sim.volatileWriteEnable = false;
+        }
+        break;
+
+    case 0x99:
+        if (w25qxx_Port->sim.resetEnable)
+        {
+            w25qxx_Port->sim.writeEnable = false;
+            w25qxx_Port->sim.volatileWriteEnable = false;
+        }
+        break;
+    }
+
+    if ((eraseSize != 0) && (w25qxx_Port->sim.count >= 4))
+    {
+        if (w25qxx_Port->sim.writeEnable)
+            memset(w25qxx_Port->sim.memory + ((w25qxx_Port->sim.address % w25qxx_Port->sim.size) & ~(eraseSize - 1)),
+                   0xff, eraseSize);
+        w25qxx_Port->sim.writeEnable = false;
+    }
+
+    w25qxx_Port->sim.resetEnable = (w25qxx_Port->sim.instruction == 0x66);
+}
+
+static w25qxx_Transfer_Status_t Sim_Receive(void *handle, uint8_t *pDataRx, uint16_t size, uint32_t timeout)
+{
+    w25qxx_PortTypeDef *w25qxx_Port = handle;
+
+    (void) timeout;
+
+    if ((w25qxx_Port == NULL) || (pDataRx == NULL) || (size == 0u) || !w25qxx_Port->sim.selected)
+        return W25QXX_TRANSFER_ERROR;
+
+    for (uint16_t i = 0; i < size; i++)
+        pDataRx[i] = Sim_Exchange(w25qxx_Port, 0x00);
+
+    return W25QXX_TRANSFER_SUCCESS;
+}
+
+static w25qxx_Transfer_Status_t Sim_Transmit(void *handle, const uint8_t *pDataTx, uint16_t size, uint32_t timeout)
+{
+    w25qxx_PortTypeDef *w25qxx_Port = handle;
+
+    (void) timeout;
+
+    if ((w25qxx_Port == NULL) || (pDataTx == NULL) || (size == 0u) || !w25qxx_Port->sim.selected)
+        return W25QXX_TRANSFER_ERROR;
+
+    for (uint16_t i = 0; i < size; i++)
+        Sim_Exchange(w25qxx_Port, pDataTx[i]);
+
+    return W25QXX_TRANSFER_SUCCESS;
+}
+
+static void Sim_CS_Set(void *context, w25qxx_CS_State_t newState)
+{
+    w25qxx_PortTypeDef *w25qxx_Port = context;
+
+    if (newState == W25QXX_CS_LOW)
+    {
+        if (!w25qxx_Port->sim.selected)
+        {
+            w25qxx_Port->sim.selected = true;
+            w25qxx_Port->sim.count = 0;
+        }
+    }
+    else if (w25qxx_Port->sim.selected)
+    {
+        if (w25qxx_Port->sim.count != 0)
+            Sim_Deselect(w25qxx_Port);
+        w25qxx_Port->sim.selected = false;
+    }
+}
+
+static w25qxx_Transfer_Status_t DMA_Start(w25qxx_PortTypeDef *w25qxx_Port, uint8_t *pData, uint16_t size, void *owner,
+                                          bool receive)
+{
+    if ((w25qxx_Port == NULL) || (pData == NULL) || (size == 0u) || !w25qxx_Port->dma.started)
+        return W25QXX_TRANSFER_ERROR;
+
+    pthread_mutex_lock(&w25qxx_Port->dma.mutex);
+    if (w25qxx_Port->dma.pending)
+    {
+        pthread_mutex_unlock(&w25qxx_Port->dma.mutex);
+        return W25QXX_TRANSFER_ERROR; // Channel busy
+    }
+    w25qxx_Port->dma.pData = pData;
+    w25qxx_Port->dma.size = size;
+    w25qxx_Port->dma.owner = owner;
+    w25qxx_Port->dma.receive = receive;
+    w25qxx_Port->dma.pending = true;
+    w25qxx_Port->dma.active = true;
+    pthread_cond_signal(&w25qxx_Port->dma.request);
+    pthread_mutex_unlock(&w25qxx_Port->dma.mutex);
+
+    return W25QXX_TRANSFER_SUCCESS;
+}
+
+static w25qxx_Transfer_Status_t DMA_Receive(void *handle, uint8_t *pDataRx, uint16_t size, void *owner)
+{
+    return DMA_Start(handle, pDataRx, size, owner, true);
+}
+
+static w25qxx_Transfer_Status_t DMA_Transmit(void *handle, const uint8_t *pDataTx, uint16_t size, void *owner)
+{
+    return DMA_Start(handle, (uint8_t *) pDataTx, size, owner, false);
+}
+
+static void DMA_Abort(void *handle)
+{
+    w25qxx_PortTypeDef *w25qxx_Port = handle;
+
+    if ((w25qxx_Port == NULL) || !w25qxx_Port->dma.started)
+        return;
+
+    /* The stream can't be cut, its completion is dropped and the chain ends with it */
+    pthread_mutex_lock(&w25qxx_Port->dma.mutex);
+    if (w25qxx_Port->dma.active)
+    {
+        w25qxx_Port->dma.abort = true;
+        while (w25qxx_Port->dma.active)
+            pthread_cond_wait(&w25qxx_Port->dma.idle, &w25qxx_Port->dma.mutex);
+    }
+    pthread_mutex_unlock(&w25qxx_Port->dma.mutex);
+}
+
+static void *DMA_Thread(void *argument)
+{
+    w25qxx_PortTypeDef *w25qxx_Port = argument;
+    w25qxx_Transfer_Status_t transferStatus;
+    void *owner;
+    bool dropped;
+
+    for (;;)
+    {
+        pthread_mutex_lock(&w25qxx_Port->dma.mutex);
+        while (!w25qxx_Port->dma.pending && !w25qxx_Port->dma.stop)
+            pthread_cond_wait(&w25qxx_Port->dma.request, &w25qxx_Port->dma.mutex);
+        pthread_mutex_unlock(&w25qxx_Port->dma.mutex);
+        if (!w25qxx_Port->dma.pending)
+            break;
+
+        /* Blocking transfer stands for the DMA stream */
+        if (w25qxx_Port->type == W25QXX_PORT_SIM)
+            transferStatus = w25qxx_Port->dma.receive
+                                 ? Sim_Receive(w25qxx_Port, w25qxx_Port->dma.pData, w25qxx_Port->dma.size, 0)
+                                 : Sim_Transmit(w25qxx_Port, w25qxx_Port->dma.pData, w25qxx_Port->dma.size, 0);
+        else
+            transferStatus = w25qxx_Port->dma.receive
+                                 ? Spidev_Receive(w25qxx_Port, w25qxx_Port->dma.pData, w25qxx_Port->dma.size, 0)
+                                 : Spidev_Transmit(w25qxx_Port, w25qxx_Port->dma.pData, w25qxx_Port->dma.size, 0);
+        owner = w25qxx_Port->dma.owner;
+
+        /* Channel is free before the completion, the driver may chain the next transfer from it */
+        pthread_mutex_lock(&w25qxx_Port->dma.mutex);
+        w25qxx_Port->dma.pending = false;
+        dropped = w25qxx_Port->dma.abort;
+        pthread_mutex_unlock(&w25qxx_Port->dma.mutex);
+
+        /* Transfer complete "interrupt" */
+        if (!dropped)
+            w25qxx_TransferComplete(owner, transferStatus);
+
+        /* Channel is idle unless the completion has chained the next transfer */
+        pthread_mutex_lock(&w25qxx_Port->dma.mutex);
+        if (!w25qxx_Port->dma.pending)
+        {
+            w25qxx_Port->dma.active = false;
+            w25qxx_Port->dma.abort = false;
+            pthread_cond_broadcast(&w25qxx_Port->dma.idle);
+        }
+        pthread_mutex_unlock(&w25qxx_Port->dma.mutex);
+    }
+
+    return NULL;
+}
\ No newline at end of file
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "w25qxx.h"
+#include <pthread.h>
+
+/* Configuration */
+#define W25QXX_PORT_SIM_PREFIX  "sim:"
+#define W25QXX_PORT_SPI_BUFSIZE 4096 // Default spidev message limit, used if the module parameter can't be read
+
+/* Data types */
+typedef enum w25qxx_PortType_e { W25QXX_PORT_SPIDEV, W25QXX_PORT_SIM } w25qxx_PortType_t;
+
+typedef struct w25qxx_PortTypeDef_s {
+    w25qxx_PortType_t type;
+    int fd;
+
+    /* spidev, transmitted bytes are held back and sent with the next receive, /CS stays low between messages */
+    struct {
+        uint32_t speed;
+        uint32_t bufSize;
+        uint8_t *pending;
+        uint32_t pendingLength;
+        bool selected; // Last message left /CS low
+    } spi;
+
+    /* File-backed device model, the image file is the memory array */
+    struct {
+        uint8_t *memory;
+        uint32_t size;
+        bool readOnly; // Image file can't be written, the model keeps its changes in memory
+        uint8_t deviceID;
+        uint8_t statusRegister[3];
+        bool writeEnable;
+        bool volatileWriteEnable;
+        bool powerDown;
+        bool resetEnable;
+        bool selected;
+        uint8_t instruction;
+        uint32_t count; // Bytes clocked since /CS low
+        uint32_t address;
+    } sim;
+
+    /* Fake DMA channel of the async hooks, a thread runs the blocking transfer and signals its completion */
+    struct {
+        pthread_t thread;
+        pthread_mutex_t mutex;
+        pthread_cond_t request;
+        pthread_cond_t idle;
+        bool started;
+        bool stop;
+        bool pending;
+        bool active; // From the start until the completion of the last chained transfer has returned
+        bool abort; // Completion of the transfer in progress is dropped
+        bool receive;
+        uint8_t *pData;
+        uint16_t size;
+        void *owner;
+    } dma;
+} w25qxx_PortTypeDef;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Opens the platform behind the handle
+ * @param w25qxx_Port pointer to the port structure
+ * @param target spidev node (e.g. `/dev/spidev0.0`) or `sim:FILE` for the file-backed device model
+ * @param speed SPI clock [Hz], unused by the model
+ * @param simDevice device ID of the model if the image file has to be created (e.g. `W25Q128`), 0 to open an existing
+ * image only
+ * @note The model takes its device ID from the size of an existing image, a new image is filled with 0xFF. Existing
+ * image opened without the device ID falls back to read-only (`sim.readOnly`) if it can't be written
+ * @return true on success
+ */
+bool w25qxx_PortOpen(w25qxx_PortTypeDef *w25qxx_Port, const char *target, uint32_t speed, uint8_t simDevice);
+
+/**
+ * @brief Links the port functions to the handle interface, the rest of the interface is cleared
+ * @param w25qxx_Port pointer to the opened port structure
+ * @param w25qxx_Handle pointer to the device handle structure
+ * @param print debug print function, `NULL` to keep the driver silent
+ */
+void w25qxx_PortLink(w25qxx_PortTypeDef *w25qxx_Port, w25qxx_HandleTypeDef *w25qxx_Handle, w25qxx_print_fp print);
+
+/**
+ * @brief Starts the fake DMA thread and links the async hooks (receive, transmit and abort) to the handle
+ * @param w25qxx_Port pointer to the opened port structure
+ * @param w25qxx_Handle pointer to the device handle structure linked by `w25qxx_PortLink()`
+ * @note `w25qxx_TransferComplete()` is called from the thread, as from the DMA interrupt
+ * @return true if the thread is started
+ */
+bool w25qxx_PortAsyncLink(w25qxx_PortTypeDef *w25qxx_Port, w25qxx_HandleTypeDef *w25qxx_Handle);
+
+/**
+ * @brief Releases the port, the fake DMA thread is stopped and the model image is synced to the file
+ * @param w25qxx_Port pointer to the port structure
+ */
+void w25qxx_PortClose(w25qxx_PortTypeDef *w25qxx_Port);
+
+#ifdef __cplusplus
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,451 @@
+#define FUSE_USE_VERSION 31
+
+#include "w25qxx_Cache.h"
+#include "w25qxx_Ftl.h"
+#include "w25qxx_Port.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <fuse.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* Configuration */
+#define FS_DEVICE_DEFAULT      "/dev/spidev0.0"
+#define FS_SPEED_DEFAULT       20000000 // [Hz]
+#define FS_CACHE_LINES_DEFAULT 256 // 1MB of 4KB sectors
+#define FS_READ_AHEAD_DEFAULT  31 // 128KB per read instruction
+#define FS_RAW                 "/raw.bin"
+#define FS_SECTORS             "/sectors"
+#define FS_FTL                 "/ftl"
+#define FS_FTL_MAP             "/ftl/map.txt"
+#define FS_INDEX_DIGITS        4 // File names are `NNNN.bin`
+
+/* Data types */
+typedef enum FsNodeType_e {
+    FS_NODE_NONE,
+    FS_NODE_ROOT,
+    FS_NODE_RAW,
+    FS_NODE_SECTORS,
+    FS_NODE_SECTOR,
+    FS_NODE_FTL,
+    FS_NODE_FTL_MAP,
+    FS_NODE_FTL_SECTOR
+} FsNodeType_t;
+
+typedef struct Fs_s {
+    w25qxx_PortTypeDef port;
+    w25qxx_HandleTypeDef w25qxx_Handle;
+    w25qxx_CacheTypeDef w25qxx_Cache;
+    w25qxx_FtlHandleTypeDef w25qxx_FtlHandle;
+    pthread_mutex_t mutex; // FUSE calls come from several threads, the device has a single owner
+    uint32_t capacity;
+    uint32_t numberOfSectors;
+    bool ftl; // FTL region is decoded
+    char *ftlMap; // Decoded sector headers of the FTL region
+    size_t ftlMapLength;
+    time_t mountTime;
+} Fs_t;
+
+/* Private variables */
+static Fs_t fs = {.mutex = PTHREAD_MUTEX_INITIALIZER};
+
+static void Usage(void);
+static bool Fs_FtlDecode(uint32_t firstSector, uint16_t numberOfSectors);
+static FsNodeType_t Fs_Lookup(const char *path, uint32_t *index);
+static bool Fs_ParseIndex(const char *name, uint32_t count, uint32_t *index);
+static off_t Fs_Size(FsNodeType_t type);
+static void *Fs_Init(struct fuse_conn_info *conn, struct fuse_config *cfg);
+static int Fs_Getattr(const char *path, struct stat *stbuf, struct fuse_file_info *fi);
+static int Fs_Readdir(const char *path, void *buf, fuse_fill_dir_t filler, off_t offset, struct fuse_file_info *fi,
+                      enum fuse_readdir_flags flags);
+static int Fs_Open(const char *path, struct fuse_file_info *fi);
+static int Fs_Read(const char *path, char *buf, size_t size, off_t offset, struct fuse_file_info *fi);
+
+static const struct fuse_operations fsOperations = {
+    .init = Fs_Init,
+    .getattr = Fs_Getattr,
+    .readdir = Fs_Readdir,
+    .open = Fs_Open,
+    .read = Fs_Read,
+};
+
+int main(int argc, char *argv[])
+{
+    const char *target = FS_DEVICE_DEFAULT;
+    uint32_t speed = FS_SPEED_DEFAULT, cacheLines = FS_CACHE_LINES_DEFAULT, readAhead = FS_READ_AHEAD_DEFAULT;
+    uint32_t ftlFirstSector = 0, ftlNumberOfSectors = 0;
+    char **fuseArgv;
+    int option, fuseArgc = 0, result;
+
+    /* Own options come first, the rest is passed to FUSE */
+    while ((option = getopt(argc, argv, "+d:s:C:R:F:h")) != -1)
+    {
+        switch (option)
+        {
+        case 'd':
+            target = optarg;
+            break;
+
+        case 's':
+            speed = (uint32_t) strtoul(optarg, NULL, 0);
+            break;
+
+        case 'C':
+            cacheLines = (uint32_t) strtoul(optarg, NULL, 0);
+            break;
+
+        case 'R':
+            readAhead = (uint32_t) strtoul(optarg, NULL, 0);
+            break;
+
+        case 'F':
+            if (sscanf(optarg, "%u:%u", &ftlFirstSector, &ftlNumberOfSectors) != 2)
+            {
+                Usage();
+                return 2;
+            }
+            break;
+
+        default:
+            Usage();
+            return 2;
+        }
+    }
+    if (optind >= argc)
+    {
+        Usage();
+        return 2;
+    }
+
+    /* Existing image only, its size gives the device, a write-protected one is opened read-only like the mount */
+    if (!w25qxx_PortOpen(&fs.port, target, speed, 0))
+    {
+        fprintf(stderr, "Can't open %s\n", target);
+        w25qxx_PortClose(&fs.port);
+        return 1;
+    }
+    w25qxx_PortLink(&fs.port, &fs.w25qxx_Handle, NULL);
+    if ((w25qxx_Init(&fs.w25qxx_Handle) != W25QXX_ERROR_NONE) ||
+        (w25qxx_CacheInit(&fs.w25qxx_Cache, &fs.w25qxx_Handle, cacheLines) != W25QXX_ERROR_NONE) ||
+        (w25qxx_CacheSetReadAhead(&fs.w25qxx_Cache, readAhead) != W25QXX_ERROR_NONE))
+    {
+        fprintf(stderr, "Device init failed\n");
+        w25qxx_PortClose(&fs.port);
+        return 1;
+    }
+    fs.capacity = W25QXX_PAGE_SIZE * fs.w25qxx_Handle.numberOfPages;
+    fs.numberOfSectors = fs.capacity / W25QXX_SECTOR_SIZE_4KB;
+    fs.mountTime = time(NULL);
+    if ((ftlNumberOfSectors != 0) && !Fs_FtlDecode(ftlFirstSector, (uint16_t) ftlNumberOfSectors))
+    {
+        fprintf(stderr, "Can't decode the FTL region %u:%u\n", ftlFirstSector, ftlNumberOfSectors);
+        w25qxx_CacheDeInit(&fs.w25qxx_Cache);
+        w25qxx_PortClose(&fs.port);
+        return 1;
+    }
+
+    /* Mount is read-only */
+    fuseArgv = calloc((size_t) (argc - optind) + 3, sizeof(*fuseArgv));
+    if (fuseArgv == NULL)
+        return 1;
+    fuseArgv[fuseArgc++] = argv[0];
+    fuseArgv[fuseArgc++] = "-oro";
+    for (int i = optind; i < argc; i++)
+        fuseArgv[fuseArgc++] = argv[i];
+
+    result = fuse_main(fuseArgc, fuseArgv, &fsOperations, NULL);
+
+    free(fuseArgv);
+    free(fs.ftlMap);
+    w25qxx_CacheDeInit(&fs.w25qxx_Cache);
+    w25qxx_PortClose(&fs.port);
+
+    return result;
+}
+
+/**
+ * @section Private functions
+ */
+static void Usage(void)
+{
+    fprintf(stderr,
+            "Usage: w25qxx-fuse [options] MOUNTPOINT [FUSE options]\n"
+            "Mounts the flash read-only:\n"
+            "  raw.bin           whole device\n"
+            "  sectors/NNNN.bin  4KB sectors\n"
+            "  ftl/map.txt       decoded FTL sector headers (with -F)\n"
+            "  ftl/NNNN.bin      FTL logical sectors, most recent copy (with -F)\n"
+            "Options:\n"
+            "  -d DEVICE        spidev node or sim:IMAGE of a dump (default " FS_DEVICE_DEFAULT ")\n"
+            "  -s HZ            SPI clock (default %u)\n"
+            "  -C LINES         number of cached 4KB sectors (default %u)\n"
+            "  -R SECTORS       sectors read ahead on a cache miss (default %u)\n"
+            "  -F FIRST:COUNT   FTL region (first sector and number of sectors)\n",
+            FS_SPEED_DEFAULT, FS_CACHE_LINES_DEFAULT, FS_READ_AHEAD_DEFAULT);
+}
+
+static bool Fs_FtlDecode(uint32_t firstSector, uint16_t numberOfSectors)
+{
+    w25qxx_FtlHeader_t header;
+    const char *state;
+    FILE *stream;
+
+    if (w25qxx_FtlInit(&fs.w25qxx_FtlHandle, &fs.w25qxx_Handle, firstSector, numberOfSectors) != W25QXX_ERROR_NONE)
+        return false;
+
+    /* Header of every physical sector, read as the FTL does it */
+    stream = open_memstream(&fs.ftlMap, &fs.ftlMapLength);
+    if (stream == NULL)
+        return false;
+    fprintf(stream, "physical  address   state  logical  erase count  sequence\n");
+    for (uint16_t physical = 0; physical < fs.w25qxx_FtlHandle.numberOfSectors; physical++)
+    {
+        w25qxx_Read(&fs.w25qxx_Handle, (uint8_t *) &header, sizeof(header),
+                    W25QXX_SECTOR_TO_ADDRESS(firstSector + physical), W25QXX_CRC, W25QXX_FASTREAD_NO);
+        if (fs.w25qxx_Handle.error == W25QXX_ERROR_CHECKSUM)
+        {
+            w25qxx_ResetError(&fs.w25qxx_Handle);
+            fprintf(stream, "%8u  0x%06X  blank\n", physical, W25QXX_SECTOR_TO_ADDRESS(firstSector + physical));
+            continue;
+        }
+        if ((fs.w25qxx_Handle.error != W25QXX_ERROR_NONE) || (header.magic != W25QXX_FTL_HEADER_MAGIC))
+        {
+            w25qxx_ResetError(&fs.w25qxx_Handle);
+            fprintf(stream, "%8u  0x%06X  bad\n", physical, W25QXX_SECTOR_TO_ADDRESS(firstSector + physical));
+            continue;
+        }
+
+        state = ((header.logicalSector < fs.w25qxx_FtlHandle.numberOfLogicalSectors) &&
+                 (fs.w25qxx_FtlHandle.map[header.logicalSector] == physical))
+                    ? "live "
+                    : "stale";
+        fprintf(stream, "%8u  0x%06X  %s  %7u  %11u  %8u\n", physical,
+                W25QXX_SECTOR_TO_ADDRESS(firstSector + physical), state, header.logicalSector, header.eraseCount,
+                header.sequence);
+    }
+    fclose(stream);
+    fs.ftl = true;
+
+    return true;
+}
+
+static FsNodeType_t Fs_Lookup(const char *path, uint32_t *index)
+{
+    if (strcmp(path, "/") == 0)
+        return FS_NODE_ROOT;
+    if (strcmp(path, FS_RAW) == 0)
+        return FS_NODE_RAW;
+    if (strcmp(path, FS_SECTORS) == 0)
+        return FS_NODE_SECTORS;
+    if ((strncmp(path, FS_SECTORS "/", strlen(FS_SECTORS "/")) == 0) &&
+        Fs_ParseIndex(path + strlen(FS_SECTORS "/"), fs.numberOfSectors, index))
+        return FS_NODE_SECTOR;
+    if (!fs.ftl)
+        return FS_NODE_NONE;
+    if (strcmp(path, FS_FTL) == 0)
+        return FS_NODE_FTL;
+    if (strcmp(path, FS_FTL_MAP) == 0)
+        return FS_NODE_FTL_MAP;
+    if ((strncmp(path, FS_FTL "/", strlen(FS_FTL "/")) == 0) &&
+        Fs_ParseIndex(path + strlen(FS_FTL "/"), fs.w25qxx_FtlHandle.numberOfLogicalSectors, index))
+        return FS_NODE_FTL_SECTOR;
+
+    return FS_NODE_NONE;
+}
+
+static bool Fs_ParseIndex(const char *name, uint32_t count, uint32_t *index)
+{
+    char *end;
+
+    *index = (uint32_t) strtoul(name, &end, 10);
+
+    return ((end - name) == FS_INDEX_DIGITS) && (strcmp(end, ".bin") == 0) && (*index < count);
+}
+
+static off_t Fs_Size(FsNodeType_t type)
+{
+    switch (type)
+    {
+    case FS_NODE_RAW:
+        return fs.capacity;
+
+    case FS_NODE_SECTOR:
+        return W25QXX_SECTOR_SIZE_4KB;
+
+    case FS_NODE_FTL_MAP:
+        return (off_t) fs.ftlMapLength;
+
+    case FS_NODE_FTL_SECTOR:
+        return W25QXX_FTL_SECTOR_SIZE;
+
+    default:
+        return 0;
+    }
+}
+
+static void *Fs_Init(struct fuse_conn_info *conn, struct fuse_config *cfg)
+{
+    (void) conn;
+
+    /* Content doesn't change behind the kernel page cache while mounted */
+    cfg->kernel_cache = 1;
+
+    return NULL;
+}
+
+static int Fs_Getattr(const char *path, struct stat *stbuf, struct fuse_file_info *fi)
+{
+    FsNodeType_t type;
+    uint32_t index;
+
+    (void) fi;
+
+    type = Fs_Lookup(path, &index);
+    if (type == FS_NODE_NONE)
+        return -ENOENT;
+
+    memset(stbuf, 0, sizeof(*stbuf));
+    stbuf->st_mtime = fs.mountTime;
+    stbuf->st_atime = fs.mountTime;
+    stbuf->st_ctime = fs.mountTime;
+    if ((type == FS_NODE_ROOT) || (type == FS_NODE_SECTORS) || (type == FS_NODE_FTL))
+    {
+        stbuf->st_mode = S_IFDIR | 0555;
+        stbuf->st_nlink = 2;
+    }
+    else
+    {
+        stbuf->st_mode = S_IFREG | 0444;
+        stbuf->st_nlink = 1;
+        stbuf->st_size = Fs_Size(type);
+    }
+
+    return 0;
+}
+
+static int Fs_Readdir(const char *path, void *buf, fuse_fill_dir_t filler, off_t offset, struct fuse_file_info *fi,
+                      enum fuse_readdir_flags flags)
+{
+    char name[16];
+    uint32_t index, count = 0;
+
+    (void) offset;
+    (void) fi;
+    (void) flags;
+
+    switch (Fs_Lookup(path, &index))
+    {
+    case FS_NODE_ROOT:
+        filler(buf, ".", NULL, 0, 0);
+        filler(buf, "..", NULL, 0, 0);
+        filler(buf, FS_RAW + 1, NULL, 0, 0);
+        filler(buf, FS_SECTORS + 1, NULL, 0, 0);
+        if (fs.ftl)
+            filler(buf, FS_FTL + 1, NULL, 0, 0);
+        return 0;
+
+    case FS_NODE_SECTORS:
+        count = fs.numberOfSectors;
+        break;
+
+    case FS_NODE_FTL:
+        count = fs.w25qxx_FtlHandle.numberOfLogicalSectors;
+        break;
+
+    default:
+        return -ENOTDIR;
+    }
+
+    filler(buf, ".", NULL, 0, 0);
+    filler(buf, "..", NULL, 0, 0);
+    if (strcmp(path, FS_FTL) == 0)
+        filler(buf, FS_FTL_MAP + strlen(FS_FTL "/"), NULL, 0, 0);
+    for (index = 0; index < count; index++)
+    {
+        snprintf(name, sizeof(name), "%0*u.bin", FS_INDEX_DIGITS, index);
+        filler(buf, name, NULL, 0, 0);
+    }
+
+    return 0;
+}
+
+static int Fs_Open(const char *path, struct fuse_file_info *fi)
+{
+    FsNodeType_t type;
+    uint32_t index;
+
+    type = Fs_Lookup(path, &index);
+    if (type == FS_NODE_NONE)
+        return -ENOENT;
+    if ((type == FS_NODE_ROOT) || (type == FS_NODE_SECTORS) || (type == FS_NODE_FTL))
+        return -EISDIR;
+    if ((fi->flags & O_ACCMODE) != O_RDONLY)
+        return -EROFS;
+    fi->keep_cache = 1;
+
+    return 0;
+}
+
+static int Fs_Read(const char *path, char *buf, size_t size, off_t offset, struct fuse_file_info *fi)
+{
+    FsNodeType_t type;
+    uint32_t index, address;
+    off_t fileSize;
+    uint16_t physical;
+    int result;
+
+    (void) fi;
+
+    type = Fs_Lookup(path, &index);
+    fileSize = Fs_Size(type);
+    if ((type == FS_NODE_NONE) || (offset < 0))
+        return -ENOENT;
+    if (offset >= fileSize)
+        return 0;
+    if ((off_t) size > fileSize - offset)
+        size = (size_t) (fileSize - offset);
+
+    /* File offset to device address */
+    switch (type)
+    {
+    case FS_NODE_RAW:
+        address = (uint32_t) offset;
+        break;
+
+    case FS_NODE_SECTOR:
+        address = W25QXX_SECTOR_TO_ADDRESS(index) + (uint32_t) offset;
+        break;
+
+    case FS_NODE_FTL_MAP:
+        memcpy(buf, fs.ftlMap + offset, size);
+        return (int) size;
+
+    case FS_NODE_FTL_SECTOR:
+        /* Never written logical sector reads as erased, data pages follow the header page */
+        physical = fs.w25qxx_FtlHandle.map[index];
+        if (physical == W25QXX_FTL_SECTOR_FREE)
+        {
+            memset(buf, 0xff, size);
+            return (int) size;
+        }
+        address = W25QXX_SECTOR_TO_ADDRESS(fs.w25qxx_FtlHandle.firstSector + physical) + W25QXX_PAGE_SIZE +
+                  (uint32_t) offset;
+        break;
+
+    default:
+        return -EISDIR;
+    }
+
+    pthread_mutex_lock(&fs.mutex);
+    result = (int) size;
+    if (w25qxx_CacheRead(&fs.w25qxx_Cache, (uint8_t *) buf, (uint32_t) size, address) != W25QXX_ERROR_NONE)
+    {
+        w25qxx_ResetError(&fs.w25qxx_Handle);
+        result = -EIO;
+    }
+    pthread_mutex_unlock(&fs.mutex);
+
+    return result;
+}
\ No newline at end of file
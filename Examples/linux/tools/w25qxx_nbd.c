@@ -0,0 +1,487 @@
+#include "w25qxx_Cache.h"
+#include "w25qxx_Port.h"
+#include <endian.h>
+#include <getopt.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+/* Configuration */
+#define NBD_DEVICE_DEFAULT  "/dev/spidev0.0"
+#define NBD_SPEED_DEFAULT   20000000 // [Hz]
+#define NBD_SIM_MB_DEFAULT  16
+#define NBD_EXPORT_DEFAULT  "w25qxx"
+#define NBD_REQUEST_MAX     (32u * 1024u * 1024u) // Longest read/write request accepted
+
+/* Protocol (fixed newstyle handshake, simple replies) */
+#define NBD_MAGIC               0x4e42444d41474943ull // "NBDMAGIC"
+#define NBD_OPTION_MAGIC        0x49484156454f5054ull // "IHAVEOPT"
+#define NBD_REPLY_OPTION_MAGIC  0x0003e889045565a9ull
+#define NBD_REQUEST_MAGIC       0x25609513u
+#define NBD_SIMPLE_REPLY_MAGIC  0x67446698u
+#define NBD_FLAG_FIXED_NEWSTYLE (1u << 0)
+#define NBD_FLAG_NO_ZEROES      (1u << 1)
+#define NBD_FLAG_HAS_FLAGS      (1u << 0)
+#define NBD_FLAG_SEND_FLUSH     (1u << 2)
+#define NBD_FLAG_SEND_TRIM      (1u << 5)
+#define NBD_OPT_EXPORT_NAME     1
+#define NBD_OPT_ABORT           2
+#define NBD_OPT_LIST            3
+#define NBD_OPT_INFO            6
+#define NBD_OPT_GO              7
+#define NBD_REP_ACK             1
+#define NBD_REP_SERVER          2
+#define NBD_REP_INFO            3
+#define NBD_REP_ERR_UNSUP       0x80000001u
+#define NBD_INFO_EXPORT         0
+#define NBD_INFO_BLOCK_SIZE     3
+#define NBD_CMD_READ            0
+#define NBD_CMD_WRITE           1
+#define NBD_CMD_DISC            2
+#define NBD_CMD_FLUSH           3
+#define NBD_CMD_TRIM            4
+#define NBD_EIO                 5
+#define NBD_EINVAL              22
+#define NBD_ENOSPC              28
+
+/* Data types */
+typedef struct NbdServer_s {
+    w25qxx_PortTypeDef port;
+    w25qxx_HandleTypeDef w25qxx_Handle;
+    w25qxx_CacheTypeDef w25qxx_Cache;
+    uint32_t capacity;
+    const char *exportName;
+    uint16_t transmissionFlags;
+    uint8_t *buf; // Request payload
+} NbdServer_t;
+
+/* Private variables */
+static volatile sig_atomic_t stopRequest;
+
+static void Usage(void);
+static void Nbd_Stop(int signalNumber);
+static bool Nbd_Handshake(NbdServer_t *server, int client);
+static bool Nbd_OptionReply(int client, uint32_t option, uint32_t replyType, const void *data, uint32_t length);
+static bool Nbd_InfoReply(NbdServer_t *server, int client, uint32_t option);
+static void Nbd_Transmission(NbdServer_t *server, int client);
+static bool Nbd_SimpleReply(int client, uint32_t error, uint64_t cookie, const void *data, uint32_t length);
+static uint32_t Nbd_Error(NbdServer_t *server);
+static bool Socket_Read(int client, void *data, size_t length);
+static bool Socket_Write(int client, const void *data, size_t length);
+static bool Socket_Discard(int client, size_t length);
+
+int main(int argc, char *argv[])
+{
+    static NbdServer_t server;
+    const char *target = NBD_DEVICE_DEFAULT;
+    uint32_t speed = NBD_SPEED_DEFAULT, simMB = NBD_SIM_MB_DEFAULT, cacheLines = W25QXX_CACHE_LINES_DEFAULT;
+    uint8_t simDevice = 0;
+    struct sockaddr_un socketAddress;
+    struct sigaction stopAction;
+    int option, listener, client;
+
+    server.exportName = NBD_EXPORT_DEFAULT;
+    while ((option = getopt(argc, argv, "d:s:m:C:n:h")) != -1)
+    {
+        switch (option)
+        {
+        case 'd':
+            target = optarg;
+            break;
+
+        case 's':
+            speed = (uint32_t) strtoul(optarg, NULL, 0);
+            break;
+
+        case 'm':
+            simMB = (uint32_t) strtoul(optarg, NULL, 0);
+            break;
+
+        case 'C':
+            cacheLines = (uint32_t) strtoul(optarg, NULL, 0);
+            break;
+
+        case 'n':
+            server.exportName = optarg;
+            break;
+
+        default:
+            Usage();
+            return 2;
+        }
+    }
+    if ((optind + 1 != argc) || (strlen(argv[optind]) >= sizeof(socketAddress.sun_path)))
+    {
+        Usage();
+        return 2;
+    }
+    for (uint8_t device = W25Q80; device <= W25Q128; device++)
+    {
+        if (simMB == (1u << (device - W25Q80)))
+            simDevice = device;
+    }
+
+    /* Device */
+    if (!w25qxx_PortOpen(&server.port, target, speed, simDevice))
+    {
+        fprintf(stderr, "Can't open %s\n", target);
+        w25qxx_PortClose(&server.port);
+        return 1;
+    }
+    w25qxx_PortLink(&server.port, &server.w25qxx_Handle, NULL);
+    if ((w25qxx_Init(&server.w25qxx_Handle) != W25QXX_ERROR_NONE) ||
+        (w25qxx_CacheInit(&server.w25qxx_Cache, &server.w25qxx_Handle, cacheLines) != W25QXX_ERROR_NONE))
+    {
+        fprintf(stderr, "Device init failed\n");
+        w25qxx_PortClose(&server.port);
+        return 1;
+    }
+    server.capacity = W25QXX_PAGE_SIZE * server.w25qxx_Handle.numberOfPages;
+    server.transmissionFlags = NBD_FLAG_HAS_FLAGS | NBD_FLAG_SEND_FLUSH | NBD_FLAG_SEND_TRIM;
+    server.buf = malloc(NBD_REQUEST_MAX);
+
+    /* Socket */
+    memset(&socketAddress, 0, sizeof(socketAddress));
+    socketAddress.sun_family = AF_UNIX;
+    strcpy(socketAddress.sun_path, argv[optind]);
+    unlink(socketAddress.sun_path);
+    listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if ((server.buf == NULL) || (listener < 0) ||
+        (bind(listener, (struct sockaddr *) &socketAddress, sizeof(socketAddress)) < 0) || (listen(listener, 1) < 0))
+    {
+        perror(socketAddress.sun_path);
+        w25qxx_CacheDeInit(&server.w25qxx_Cache);
+        w25qxx_PortClose(&server.port);
+        return 1;
+    }
+
+    /* Blocking calls return on a stop signal, the cache is flushed before exit */
+    memset(&stopAction, 0, sizeof(stopAction));
+    stopAction.sa_handler = Nbd_Stop;
+    sigaction(SIGINT, &stopAction, NULL);
+    sigaction(SIGTERM, &stopAction, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    fprintf(stderr, "Serving %u bytes as '%s' on %s\n", server.capacity, server.exportName, socketAddress.sun_path);
+    while (!stopRequest)
+    {
+        client = accept(listener, NULL, NULL);
+        if (client < 0)
+            continue;
+
+        if (Nbd_Handshake(&server, client))
+            Nbd_Transmission(&server, client);
+        close(client);
+
+        if (w25qxx_CacheFlush(&server.w25qxx_Cache) != W25QXX_ERROR_NONE)
+            w25qxx_ResetError(&server.w25qxx_Handle);
+        fprintf(stderr, "Client done: %u hits, %u misses, %u write-backs, %u sectors trimmed by %u erases\n",
+                server.w25qxx_Cache.stats.hits, server.w25qxx_Cache.stats.misses,
+                server.w25qxx_Cache.stats.writeBacks, server.w25qxx_Cache.stats.trimmedSectors,
+                server.w25qxx_Cache.stats.eraseInstructions);
+    }
+
+    close(listener);
+    unlink(socketAddress.sun_path);
+    w25qxx_CacheFlush(&server.w25qxx_Cache);
+    w25qxx_CacheDeInit(&server.w25qxx_Cache);
+    free(server.buf);
+    w25qxx_PortClose(&server.port);
+
+    return 0;
+}
+
+/**
+ * @section Private functions
+ */
+static void Usage(void)
+{
+    fprintf(stderr,
+            "Usage: w25qxx-nbd [options] SOCKET\n"
+            "Serves the flash as a network block device on a Unix socket, e.g.\n"
+            "  nbd-client -unix SOCKET /dev/nbd0 -N " NBD_EXPORT_DEFAULT "\n"
+            "Options:\n"
+            "  -d DEVICE  spidev node or sim:IMAGE for the file-backed chip (default " NBD_DEVICE_DEFAULT ")\n"
+            "  -s HZ      SPI clock (default %u)\n"
+            "  -m MB      capacity of a new sim image (default %u)\n"
+            "  -C LINES   number of cached 4KB sectors (default %u)\n"
+            "  -n NAME    export name (default " NBD_EXPORT_DEFAULT ")\n",
+            NBD_SPEED_DEFAULT, NBD_SIM_MB_DEFAULT, W25QXX_CACHE_LINES_DEFAULT);
+}
+
+static void Nbd_Stop(int signalNumber)
+{
+    (void) signalNumber;
+
+    stopRequest = 1;
+}
+
+static bool Nbd_Handshake(NbdServer_t *server, int client)
+{
+    struct __attribute__((packed)) {
+        uint64_t magic;
+        uint64_t optionMagic;
+        uint16_t flags;
+    } greeting = {htobe64(NBD_MAGIC), htobe64(NBD_OPTION_MAGIC),
+                  htobe16(NBD_FLAG_FIXED_NEWSTYLE | NBD_FLAG_NO_ZEROES)};
+    struct __attribute__((packed)) {
+        uint64_t magic;
+        uint32_t option;
+        uint32_t length;
+    } request;
+    struct __attribute__((packed)) {
+        uint64_t size;
+        uint16_t flags;
+    } exportInfo;
+    uint8_t zeroes[124] = {0};
+    uint32_t clientFlags, nameLength;
+
+    if (!Socket_Write(client, &greeting, sizeof(greeting)) || !Socket_Read(client, &clientFlags, sizeof(clientFlags)))
+        return false;
+    clientFlags = be32toh(clientFlags);
+    if ((clientFlags & NBD_FLAG_FIXED_NEWSTYLE) == 0)
+        return false;
+
+    while (Socket_Read(client, &request, sizeof(request)))
+    {
+        request.option = be32toh(request.option);
+        request.length = be32toh(request.length);
+        if ((be64toh(request.magic) != NBD_OPTION_MAGIC) || (request.length > NBD_REQUEST_MAX))
+            return false;
+
+        switch (request.option)
+        {
+        case NBD_OPT_EXPORT_NAME:
+            /* Old style end of negotiation, any name is accepted */
+            if (!Socket_Discard(client, request.length))
+                return false;
+            exportInfo.size = htobe64(server->capacity);
+            exportInfo.flags = htobe16(server->transmissionFlags);
+            if (!Socket_Write(client, &exportInfo, sizeof(exportInfo)))
+                return false;
+            if ((clientFlags & NBD_FLAG_NO_ZEROES) == 0)
+                return Socket_Write(client, zeroes, sizeof(zeroes));
+            return true;
+
+        case NBD_OPT_ABORT:
+            Socket_Discard(client, request.length);
+            Nbd_OptionReply(client, request.option, NBD_REP_ACK, NULL, 0);
+            return false;
+
+        case NBD_OPT_LIST:
+            nameLength = (uint32_t) strlen(server->exportName);
+            memcpy(server->buf + sizeof(nameLength), server->exportName, nameLength);
+            nameLength = htobe32(nameLength);
+            memcpy(server->buf, &nameLength, sizeof(nameLength));
+            if (!Socket_Discard(client, request.length) ||
+                !Nbd_OptionReply(client, request.option, NBD_REP_SERVER, server->buf,
+                                 sizeof(nameLength) + (uint32_t) strlen(server->exportName)) ||
+                !Nbd_OptionReply(client, request.option, NBD_REP_ACK, NULL, 0))
+                return false;
+            break;
+
+        case NBD_OPT_INFO:
+        case NBD_OPT_GO:
+            /* Single export, the requested name and info types are not checked */
+            if (!Socket_Discard(client, request.length) || !Nbd_InfoReply(server, client, request.option))
+                return false;
+            if (request.option == NBD_OPT_GO)
+                return true;
+            break;
+
+        default:
+            if (!Socket_Discard(client, request.length) ||
+                !Nbd_OptionReply(client, request.option, NBD_REP_ERR_UNSUP, NULL, 0))
+                return false;
+            break;
+        }
+    }
+
+    return false;
+}
+
+static bool Nbd_OptionReply(int client, uint32_t option, uint32_t replyType, const void *data, uint32_t length)
+{
+    struct __attribute__((packed)) {
+        uint64_t magic;
+        uint32_t option;
+        uint32_t replyType;
+        uint32_t length;
+    } reply = {htobe64(NBD_REPLY_OPTION_MAGIC), htobe32(option), htobe32(replyType), htobe32(length)};
+
+    if (!Socket_Write(client, &reply, sizeof(reply)))
+        return false;
+
+    return (length == 0) || Socket_Write(client, data, length);
+}
+
+static bool Nbd_InfoReply(NbdServer_t *server, int client, uint32_t option)
+{
+    struct __attribute__((packed)) {
+        uint16_t type;
+        uint64_t size;
+        uint16_t flags;
+    } exportInfo = {htobe16(NBD_INFO_EXPORT), htobe64(server->capacity), htobe16(server->transmissionFlags)};
+    struct __attribute__((packed)) {
+        uint16_t type;
+        uint32_t minimum;
+        uint32_t preferred;
+        uint32_t maximum;
+    } blockSizeInfo = {htobe16(NBD_INFO_BLOCK_SIZE), htobe32(1), htobe32(W25QXX_SECTOR_SIZE_4KB),
+                       htobe32(NBD_REQUEST_MAX)};
+
+    /* Preferred block size of a sector avoids the read-modify-write */
+    return Nbd_OptionReply(client, option, NBD_REP_INFO, &exportInfo, sizeof(exportInfo)) &&
+           Nbd_OptionReply(client, option, NBD_REP_INFO, &blockSizeInfo, sizeof(blockSizeInfo)) &&
+           Nbd_OptionReply(client, option, NBD_REP_ACK, NULL, 0);
+}
+
+static void Nbd_Transmission(NbdServer_t *server, int client)
+{
+    struct __attribute__((packed)) {
+        uint32_t magic;
+        uint16_t flags;
+        uint16_t type;
+        uint64_t cookie;
+        uint64_t offset;
+        uint32_t length;
+    } request;
+    uint32_t error;
+    uint64_t offset;
+
+    while (!stopRequest && Socket_Read(client, &request, sizeof(request)))
+    {
+        if (be32toh(request.magic) != NBD_REQUEST_MAGIC)
+            return;
+        request.type = be16toh(request.type);
+        request.length = be32toh(request.length);
+        offset = be64toh(request.offset);
+
+        error = 0;
+        if ((request.length > NBD_REQUEST_MAX) || (offset > server->capacity) ||
+            (request.length > server->capacity - offset))
+            error = (request.type == NBD_CMD_WRITE) ? NBD_ENOSPC : NBD_EINVAL;
+
+        switch (request.type)
+        {
+        case NBD_CMD_READ:
+            if ((error == 0) && (w25qxx_CacheRead(&server->w25qxx_Cache, server->buf, request.length,
+                                                  (uint32_t) offset) != W25QXX_ERROR_NONE))
+                error = Nbd_Error(server);
+            if (!Nbd_SimpleReply(client, error, request.cookie, server->buf, (error == 0) ? request.length : 0))
+                return;
+            break;
+
+        case NBD_CMD_WRITE:
+            /* Payload is consumed even if the request is refused */
+            if (request.length > NBD_REQUEST_MAX)
+                return;
+            if (!Socket_Read(client, server->buf, request.length))
+                return;
+            if ((error == 0) && (w25qxx_CacheWrite(&server->w25qxx_Cache, server->buf, request.length,
+                                                   (uint32_t) offset) != W25QXX_ERROR_NONE))
+                error = Nbd_Error(server);
+            if (!Nbd_SimpleReply(client, error, request.cookie, NULL, 0))
+                return;
+            break;
+
+        case NBD_CMD_DISC:
+            return;
+
+        case NBD_CMD_FLUSH:
+            if (w25qxx_CacheFlush(&server->w25qxx_Cache) != W25QXX_ERROR_NONE)
+                error = Nbd_Error(server);
+            if (!Nbd_SimpleReply(client, error, request.cookie, NULL, 0))
+                return;
+            break;
+
+        case NBD_CMD_TRIM:
+            if ((error == 0) &&
+                (w25qxx_CacheTrim(&server->w25qxx_Cache, (uint32_t) offset, request.length) != W25QXX_ERROR_NONE))
+                error = Nbd_Error(server);
+            if (!Nbd_SimpleReply(client, error, request.cookie, NULL, 0))
+                return;
+            break;
+
+        default:
+            if (!Nbd_SimpleReply(client, NBD_EINVAL, request.cookie, NULL, 0))
+                return;
+            break;
+        }
+    }
+}
+
+static bool Nbd_SimpleReply(int client, uint32_t error, uint64_t cookie, const void *data, uint32_t length)
+{
+    struct __attribute__((packed)) {
+        uint32_t magic;
+        uint32_t error;
+        uint64_t cookie;
+    } reply = {htobe32(NBD_SIMPLE_REPLY_MAGIC), htobe32(error), cookie};
+
+    if (!Socket_Write(client, &reply, sizeof(reply)))
+        return false;
+
+    return (length == 0) || Socket_Write(client, data, length);
+}
+
+static uint32_t Nbd_Error(NbdServer_t *server)
+{
+    /* Error is reported to the client, the device stays in service */
+    fprintf(stderr, "Device error %u, last status %u\n", server->w25qxx_Handle.error, server->w25qxx_Handle.status);
+    w25qxx_ResetError(&server->w25qxx_Handle);
+
+    return NBD_EIO;
+}
+
+static bool Socket_Read(int client, void *data, size_t length)
+{
+    uint8_t *pData = data;
+    ssize_t received;
+
+    while (length != 0)
+    {
+        received = recv(client, pData, length, 0);
+        if (received <= 0)
+            return false;
+        pData += received;
+        length -= (size_t) received;
+    }
+
+    return true;
+}
+
+static bool Socket_Write(int client, const void *data, size_t length)
+{
+    const uint8_t *pData = data;
+    ssize_t sent;
+
+    while (length != 0)
+    {
+        sent = send(client, pData, length, 0);
+        if (sent <= 0)
+            return false;
+        pData += sent;
+        length -= (size_t) sent;
+    }
+
+    return true;
+}
+
+static bool Socket_Discard(int client, size_t length)
+{
+    uint8_t scratch[256];
+    size_t chunk;
+
+    while (length != 0)
+    {
+        chunk = (length < sizeof(scratch)) ? length : sizeof(scratch);
+        if (!Socket_Read(client, scratch, chunk))
+            return false;
+        length -= chunk;
+    }
+
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,730 @@
+#include "w25qxx_Port.h"
+#include "w25qxx_Update.h"
+#include <getopt.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <time.h>
+
+/* Configuration */
+#define TOOL_DEVICE_DEFAULT     "/dev/spidev0.0"
+#define TOOL_SPEED_DEFAULT      20000000 // [Hz]
+#define TOOL_CHUNK_KB_DEFAULT   64
+#define TOOL_CHUNK_KB_MAX       4096
+#define TOOL_SIM_MB_DEFAULT     16
+#define TOOL_PIPE_SLOTS         4 // Chunks in flight between the file thread and the SPI thread
+#define TOOL_PROGRESS_PERIOD_MS 250
+
+/* Data types */
+typedef struct ToolPipe_s {
+    pthread_mutex_t mutex;
+    pthread_cond_t changed;
+    uint8_t *slot[TOOL_PIPE_SLOTS];
+    uint32_t length[TOOL_PIPE_SLOTS];
+    uint32_t head; // Oldest filled slot
+    uint32_t count; // Number of filled slots
+    bool closed; // Producer has no more data
+    bool failed; // Either side gave up, the other one stops too
+} ToolPipe_t;
+
+typedef struct Tool_s {
+    w25qxx_PortTypeDef port;
+    w25qxx_HandleTypeDef w25qxx_Handle;
+    w25qxx_UpdateTypeDef w25qxx_Update;
+    uint32_t capacity;
+    uint32_t chunkSize;
+    uint8_t *flashBuf; // SPI side scratch chunk
+
+    FILE *file;
+    uint32_t fileLength; // Bytes to move through the pipe
+    uint32_t fileCRC; // CRC-32 of the file side, computed by the file thread
+    ToolPipe_t pipe;
+
+    struct {
+        const char *label;
+        uint32_t start;
+        uint32_t last;
+    } progress;
+} Tool_t;
+
+/* Private variables */
+static uint32_t crcTable[256];
+
+static void Usage(void);
+static bool Tool_Open(Tool_t *tool, const char *target, uint32_t speed, uint8_t simDevice, bool verbose);
+static void Tool_Close(Tool_t *tool);
+static int Tool_Info(Tool_t *tool);
+static int Tool_Dump(Tool_t *tool, const char *path, uint32_t address, uint32_t length);
+static int Tool_Program(Tool_t *tool, const char *path, uint32_t address);
+static int Tool_Verify(Tool_t *tool, const char *path, uint32_t address);
+static int Tool_Erase(Tool_t *tool, uint32_t address, uint32_t length, bool chip);
+static bool Tool_OpenInput(Tool_t *tool, const char *path, uint32_t address);
+static bool Tool_Check(Tool_t *tool, const char *operation);
+static void *Tool_FileReader(void *argument);
+static void *Tool_FileWriter(void *argument);
+static void Progress_Start(Tool_t *tool, const char *label);
+static void Progress_Update(Tool_t *tool, uint32_t done, uint32_t total);
+static void Progress_End(Tool_t *tool, uint32_t total);
+static bool Pipe_Init(ToolPipe_t *pipe, uint32_t chunkSize);
+static void Pipe_DeInit(ToolPipe_t *pipe);
+static uint8_t *Pipe_Reserve(ToolPipe_t *pipe);
+static void Pipe_Commit(ToolPipe_t *pipe, uint32_t length);
+static uint8_t *Pipe_Peek(ToolPipe_t *pipe, uint32_t *length);
+static void Pipe_Release(ToolPipe_t *pipe);
+static void Pipe_Close(ToolPipe_t *pipe, bool failed);
+static bool Pipe_Failed(ToolPipe_t *pipe);
+static void CRC32_Init(void);
+static uint32_t CRC32_Update(uint32_t crc, const uint8_t *pBuffer, uint32_t bufSize);
+static const char *ErrorString(w25qxx_Error_t error);
+
+int main(int argc, char *argv[])
+{
+    static Tool_t tool;
+    const char *target = TOOL_DEVICE_DEFAULT, *command;
+    uint32_t speed = TOOL_SPEED_DEFAULT, chunkKB = TOOL_CHUNK_KB_DEFAULT, simMB = TOOL_SIM_MB_DEFAULT;
+    uint32_t address = 0, length = 0;
+    uint8_t simDevice = 0;
+    bool verbose = false;
+    int option, result;
+
+    while ((option = getopt(argc, argv, "d:s:c:m:vh")) != -1)
+    {
+        switch (option)
+        {
+        case 'd':
+            target = optarg;
+            break;
+
+        case 's':
+            speed = (uint32_t) strtoul(optarg, NULL, 0);
+            break;
+
+        case 'c':
+            chunkKB = (uint32_t) strtoul(optarg, NULL, 0);
+            break;
+
+        case 'm':
+            simMB = (uint32_t) strtoul(optarg, NULL, 0);
+            break;
+
+        case 'v':
+            verbose = true;
+            break;
+
+        default:
+            Usage();
+            return 2;
+        }
+    }
+    if (optind >= argc)
+    {
+        Usage();
+        return 2;
+    }
+    command = argv[optind++];
+
+    /* Chunks are whole sectors, the updater works sector by sector */
+    if ((chunkKB == 0) || (chunkKB > TOOL_CHUNK_KB_MAX) || (W25QXX_KB_TO_BYTE(chunkKB) % W25QXX_SECTOR_SIZE_4KB))
+    {
+        fprintf(stderr, "Chunk size must be a multiple of 4KB up to %uKB\n", TOOL_CHUNK_KB_MAX);
+        return 2;
+    }
+    for (uint8_t device = W25Q80; device <= W25Q128; device++)
+    {
+        if (simMB == (1u << (device - W25Q80)))
+            simDevice = device;
+    }
+    if (simDevice == 0)
+    {
+        fprintf(stderr, "Simulated chip size must be 1, 2, 4, 8 or 16 MB\n");
+        return 2;
+    }
+
+    CRC32_Init();
+    tool.chunkSize = W25QXX_KB_TO_BYTE(chunkKB);
+    if (!Tool_Open(&tool, target, speed, simDevice, verbose))
+    {
+        Tool_Close(&tool);
+        return 1;
+    }
+
+    if (strcmp(command, "info") == 0)
+    {
+        result = Tool_Info(&tool);
+    }
+    else if ((strcmp(command, "dump") == 0) && (optind < argc))
+    {
+        address = (optind + 1 < argc) ? (uint32_t) strtoul(argv[optind + 1], NULL, 0) : 0;
+        length = (optind + 2 < argc) ? (uint32_t) strtoul(argv[optind + 2], NULL, 0) : 0;
+        result = Tool_Dump(&tool, argv[optind], address, length);
+    }
+    else if ((strcmp(command, "program") == 0) && (optind < argc))
+    {
+        address = (optind + 1 < argc) ? (uint32_t) strtoul(argv[optind + 1], NULL, 0) : 0;
+        result = Tool_Program(&tool, argv[optind], address);
+    }
+    else if ((strcmp(command, "verify") == 0) && (optind < argc))
+    {
+        address = (optind + 1 < argc) ? (uint32_t) strtoul(argv[optind + 1], NULL, 0) : 0;
+        result = Tool_Verify(&tool, argv[optind], address);
+    }
+    else if ((strcmp(command, "erase") == 0) && ((optind == argc) || (optind + 2 == argc)))
+    {
+        address = (optind < argc) ? (uint32_t) strtoul(argv[optind], NULL, 0) : 0;
+        length = (optind < argc) ? (uint32_t) strtoul(argv[optind + 1], NULL, 0) : 0;
+        result = Tool_Erase(&tool, address, length, optind >= argc);
+    }
+    else
+    {
+        Usage();
+        result = 2;
+    }
+
+    Tool_Close(&tool);
+
+    return result;
+}
+
+/**
+ * @section Private functions
+ */
+static void Usage(void)
+{
+    fprintf(stderr,
+            "Usage: w25qxx-tool [options] command [arguments]\n"
+            "Commands:\n"
+            "  info                            device ID, capacity and status registers\n"
+            "  dump FILE [ADDRESS [LENGTH]]    flash to file, whole chip by default\n"
+            "  program FILE [ADDRESS]          file to flash (unchanged sectors are skipped), then verify\n"
+            "  verify FILE [ADDRESS]           compare CRC-32 of the file and of the flash, chunk by chunk\n"
+            "  erase [ADDRESS LENGTH]          erase range (4KB aligned), whole chip by default\n"
+            "Options:\n"
+            "  -d DEVICE  spidev node or sim:IMAGE for the file-backed chip (default " TOOL_DEVICE_DEFAULT ")\n"
+            "  -s HZ      SPI clock (default %u)\n"
+            "  -c KB      transfer chunk, multiple of 4 (default %u)\n"
+            "  -m MB      capacity of a new sim image (default %u)\n"
+            "  -v         driver debug messages\n",
+            TOOL_SPEED_DEFAULT, TOOL_CHUNK_KB_DEFAULT, TOOL_SIM_MB_DEFAULT);
+}
+
+static bool Tool_Open(Tool_t *tool, const char *target, uint32_t speed, uint8_t simDevice, bool verbose)
+{
+    if (!w25qxx_PortOpen(&tool->port, target, speed, simDevice))
+    {
+        fprintf(stderr, "Can't open %s\n", target);
+        return false;
+    }
+    w25qxx_PortLink(&tool->port, &tool->w25qxx_Handle, verbose ? w25qxx_Print : NULL);
+
+    w25qxx_Init(&tool->w25qxx_Handle);
+    if (!Tool_Check(tool, "init"))
+        return false;
+    w25qxx_UpdateInit(&tool->w25qxx_Update, &tool->w25qxx_Handle);
+    tool->capacity = W25QXX_PAGE_SIZE * tool->w25qxx_Handle.numberOfPages;
+
+    tool->flashBuf = malloc(tool->chunkSize);
+    if ((tool->flashBuf == NULL) || !Pipe_Init(&tool->pipe, tool->chunkSize))
+    {
+        fprintf(stderr, "Out of memory\n");
+        return false;
+    }
+
+    return true;
+}
+
+static void Tool_Close(Tool_t *tool)
+{
+    if (tool->file != NULL)
+        fclose(tool->file);
+    tool->file = NULL;
+    Pipe_DeInit(&tool->pipe);
+    free(tool->flashBuf);
+    tool->flashBuf = NULL;
+    w25qxx_PortClose(&tool->port);
+}
+
+static int Tool_Info(Tool_t *tool)
+{
+    uint8_t statusRegister;
+
+    printf("Device:      %s\n", (tool->port.type == W25QXX_PORT_SIM) ? "simulated" : "spidev");
+    printf("ID:          %02X %02X\n", tool->w25qxx_Handle.ID[0], tool->w25qxx_Handle.ID[1]);
+    printf("Capacity:    %u bytes (%u pages, %u sectors)\n", tool->capacity, tool->w25qxx_Handle.numberOfPages,
+           tool->capacity / W25QXX_SECTOR_SIZE_4KB);
+
+    for (uint8_t i = 1; i <= 3; i++)
+    {
+        if (w25qxx_ReadStatus(&tool->w25qxx_Handle, i, &statusRegister) != W25QXX_ERROR_NONE)
+        {
+            Tool_Check(tool, "read status");
+            return 1;
+        }
+        printf("SR%u:         %02X\n", i, statusRegister);
+    }
+
+    return 0;
+}
+
+static int Tool_Dump(Tool_t *tool, const char *path, uint32_t address, uint32_t length)
+{
+    pthread_t writer;
+    uint32_t done = 0, chunk, crc = 0;
+    uint8_t *slot;
+
+    if (length == 0)
+        length = (address < tool->capacity) ? (tool->capacity - address) : 0;
+    if ((address >= tool->capacity) || (length > tool->capacity - address))
+    {
+        fprintf(stderr, "Range is out of the device\n");
+        return 1;
+    }
+
+    tool->file = fopen(path, "wb");
+    if (tool->file == NULL)
+    {
+        perror(path);
+        return 1;
+    }
+    if (pthread_create(&writer, NULL, Tool_FileWriter, tool) != 0)
+        return 1;
+
+    /* SPI reads the next chunk while the writer thread stores the previous one */
+    Progress_Start(tool, "dump");
+    while ((done < length) && ((slot = Pipe_Reserve(&tool->pipe)) != NULL))
+    {
+        chunk = ((length - done) < tool->chunkSize) ? (length - done) : tool->chunkSize;
+        if (w25qxx_ReadStream(&tool->w25qxx_Handle, slot, chunk, address + done, W25QXX_FASTREAD) !=
+            W25QXX_ERROR_NONE)
+            break;
+        crc = CRC32_Update(crc, slot, chunk);
+        Pipe_Commit(&tool->pipe, chunk);
+        done += chunk;
+        Progress_Update(tool, done, length);
+    }
+    Pipe_Close(&tool->pipe, done != length);
+    pthread_join(writer, NULL);
+
+    if (!Tool_Check(tool, "read") || Pipe_Failed(&tool->pipe))
+        return 1;
+    Progress_End(tool, length);
+    printf("CRC-32:      %08X\n", crc);
+
+    return 0;
+}
+
+static int Tool_Program(Tool_t *tool, const char *path, uint32_t address)
+{
+    pthread_t reader;
+    uint32_t done = 0, chunk, crc = 0;
+    const uint8_t *slot;
+
+    if (address % W25QXX_SECTOR_SIZE_4KB)
+    {
+        fprintf(stderr, "Address must be 4KB aligned\n");
+        return 1;
+    }
+    if (!Tool_OpenInput(tool, path, address))
+        return 1;
+    if (pthread_create(&reader, NULL, Tool_FileReader, tool) != 0)
+        return 1;
+
+    /* Reader thread loads the next chunk while this one is programmed and read back */
+    Progress_Start(tool, "program");
+    while ((slot = Pipe_Peek(&tool->pipe, &chunk)) != NULL)
+    {
+        if ((w25qxx_UpdateImage(&tool->w25qxx_Update, slot, chunk, address + done) != W25QXX_ERROR_NONE) ||
+            (w25qxx_ReadStream(&tool->w25qxx_Handle, tool->flashBuf, chunk, address + done, W25QXX_FASTREAD) !=
+             W25QXX_ERROR_NONE))
+        {
+            Pipe_Close(&tool->pipe, true);
+            break;
+        }
+        crc = CRC32_Update(crc, tool->flashBuf, chunk);
+        Pipe_Release(&tool->pipe);
+        done += chunk;
+        Progress_Update(tool, done, tool->fileLength);
+    }
+    pthread_join(reader, NULL);
+
+    if (!Tool_Check(tool, "program") || Pipe_Failed(&tool->pipe))
+        return 1;
+    Progress_End(tool, done);
+    printf("Sectors:     %u unchanged, %u programmed, %u erased\n", tool->w25qxx_Update.stats.sectorsUnchanged,
+           tool->w25qxx_Update.stats.sectorsProgrammed, tool->w25qxx_Update.stats.sectorsErased);
+    printf("CRC-32:      file %08X, flash %08X\n", tool->fileCRC, crc);
+    if (crc != tool->fileCRC)
+    {
+        fprintf(stderr, "Verification failed\n");
+        return 1;
+    }
+
+    return 0;
+}
+
+static int Tool_Verify(Tool_t *tool, const char *path, uint32_t address)
+{
+    pthread_t reader;
+    uint32_t done = 0, chunk, crc = 0, mismatches = 0;
+    const uint8_t *slot;
+
+    if (!Tool_OpenInput(tool, path, address))
+        return 1;
+    if (pthread_create(&reader, NULL, Tool_FileReader, tool) != 0)
+        return 1;
+
+    /* Chunk checksums point to the damaged area without a byte compare */
+    Progress_Start(tool, "verify");
+    while ((slot = Pipe_Peek(&tool->pipe, &chunk)) != NULL)
+    {
+        if (w25qxx_ReadStream(&tool->w25qxx_Handle, tool->flashBuf, chunk, address + done, W25QXX_FASTREAD) !=
+            W25QXX_ERROR_NONE)
+        {
+            Pipe_Close(&tool->pipe, true);
+            break;
+        }
+        crc = CRC32_Update(crc, tool->flashBuf, chunk);
+        if (CRC32_Update(0, tool->flashBuf, chunk) != CRC32_Update(0, slot, chunk))
+        {
+            if (mismatches++ == 0)
+                fprintf(stderr, "\nFirst mismatch in chunk 0x%08X-0x%08X\n", address + done,
+                        address + done + chunk - 1);
+        }
+        Pipe_Release(&tool->pipe);
+        done += chunk;
+        Progress_Update(tool, done, tool->fileLength);
+    }
+    pthread_join(reader, NULL);
+
+    if (!Tool_Check(tool, "read") || Pipe_Failed(&tool->pipe))
+        return 1;
+    Progress_End(tool, done);
+    printf("CRC-32:      file %08X, flash %08X\n", tool->fileCRC, crc);
+    if ((crc != tool->fileCRC) || (mismatches != 0))
+    {
+        fprintf(stderr, "Verification failed, %u chunk(s) differ\n", mismatches);
+        return 1;
+    }
+
+    return 0;
+}
+
+static int Tool_Erase(Tool_t *tool, uint32_t address, uint32_t length, bool chip)
+{
+    w25qxx_EraseInstruction_t eraseInstruction;
+    uint32_t done = 0, eraseSize;
+
+    if (chip)
+    {
+        Progress_Start(tool, "chip erase");
+        if (w25qxx_Erase(&tool->w25qxx_Handle, W25QXX_CHIP_ERASE, 0, W25QXX_WAIT_BUSY) != W25QXX_ERROR_NONE)
+        {
+            Tool_Check(tool, "erase");
+            return 1;
+        }
+        Progress_End(tool, tool->capacity);
+
+        return 0;
+    }
+
+    if ((address % W25QXX_SECTOR_SIZE_4KB) || (length % W25QXX_SECTOR_SIZE_4KB) || (length == 0))
+    {
+        fprintf(stderr, "Address and length must be 4KB aligned\n");
+        return 1;
+    }
+    if ((address >= tool->capacity) || (length > tool->capacity - address))
+    {
+        fprintf(stderr, "Range is out of the device\n");
+        return 1;
+    }
+
+    /* Largest aligned erase unit first */
+    Progress_Start(tool, "erase");
+    while (done < length)
+    {
+        if ((((address + done) % W25QXX_BLOCK_SIZE_64KB) == 0) && ((length - done) >= W25QXX_BLOCK_SIZE_64KB))
+        {
+            eraseInstruction = W25QXX_BLOCK_ERASE_64KB;
+            eraseSize = W25QXX_BLOCK_SIZE_64KB;
+        }
+        else
+        {
+            eraseInstruction = W25QXX_SECTOR_ERASE_4KB;
+            eraseSize = W25QXX_SECTOR_SIZE_4KB;
+        }
+        if (w25qxx_Erase(&tool->w25qxx_Handle, eraseInstruction, address + done, W25QXX_WAIT_BUSY) !=
+            W25QXX_ERROR_NONE)
+        {
+            Tool_Check(tool, "erase");
+            return 1;
+        }
+        done += eraseSize;
+        Progress_Update(tool, done, length);
+    }
+    Progress_End(tool, length);
+
+    return 0;
+}
+
+static bool Tool_OpenInput(Tool_t *tool, const char *path, uint32_t address)
+{
+    struct stat fileStat;
+
+    tool->file = fopen(path, "rb");
+    if ((tool->file == NULL) || (fstat(fileno(tool->file), &fileStat) < 0))
+    {
+        perror(path);
+        return false;
+    }
+    if ((address >= tool->capacity) || ((uint64_t) fileStat.st_size > (uint64_t) (tool->capacity - address)))
+    {
+        fprintf(stderr, "File doesn't fit the device at 0x%08X\n", address);
+        return false;
+    }
+    tool->fileLength = (uint32_t) fileStat.st_size;
+
+    return true;
+}
+
+static bool Tool_Check(Tool_t *tool, const char *operation)
+{
+    if (tool->w25qxx_Handle.error == W25QXX_ERROR_NONE)
+        return true;
+
+    fprintf(stderr, "\n%s failed: %s error\n", operation, ErrorString(tool->w25qxx_Handle.error));
+
+    return false;
+}
+
+static void *Tool_FileReader(void *argument)
+{
+    Tool_t *tool = argument;
+    uint32_t done = 0, chunk;
+    uint8_t *slot;
+
+    tool->fileCRC = 0;
+    while ((done < tool->fileLength) && ((slot = Pipe_Reserve(&tool->pipe)) != NULL))
+    {
+        chunk = ((tool->fileLength - done) < tool->chunkSize) ? (tool->fileLength - done) : tool->chunkSize;
+        if (fread(slot, 1, chunk, tool->file) != chunk)
+        {
+            perror("read");
+            break;
+        }
+        tool->fileCRC = CRC32_Update(tool->fileCRC, slot, chunk);
+        Pipe_Commit(&tool->pipe, chunk);
+        done += chunk;
+    }
+    Pipe_Close(&tool->pipe, done != tool->fileLength);
+
+    return NULL;
+}
+
+static void *Tool_FileWriter(void *argument)
+{
+    Tool_t *tool = argument;
+    uint32_t chunk;
+    const uint8_t *slot;
+
+    while ((slot = Pipe_Peek(&tool->pipe, &chunk)) != NULL)
+    {
+        if (fwrite(slot, 1, chunk, tool->file) != chunk)
+        {
+            perror("write");
+            Pipe_Close(&tool->pipe, true);
+            break;
+        }
+        Pipe_Release(&tool->pipe);
+    }
+    if (fflush(tool->file) != 0)
+        Pipe_Close(&tool->pipe, true);
+
+    return NULL;
+}
+
+static void Progress_Start(Tool_t *tool, const char *label)
+{
+    tool->progress.label = label;
+    tool->progress.start = w25qxx_Now();
+    tool->progress.last = tool->progress.start;
+}
+
+static void Progress_Update(Tool_t *tool, uint32_t done, uint32_t total)
+{
+    uint32_t now = w25qxx_Now(), elapsed = now - tool->progress.start;
+
+    if ((now - tool->progress.last < TOOL_PROGRESS_PERIOD_MS) || (elapsed == 0))
+        return;
+    tool->progress.last = now;
+
+    fprintf(stderr, "\r%s: %u/%u KB, %.2f MB/s ", tool->progress.label, done / 1024u, total / 1024u,
+            (double) done / 1048576.0 * 1000.0 / (double) elapsed);
+}
+
+static void Progress_End(Tool_t *tool, uint32_t total)
+{
+    uint32_t elapsed = w25qxx_Now() - tool->progress.start;
+
+    if (elapsed == 0)
+        elapsed = 1;
+
+    fprintf(stderr, "\r%s: %u KB in %.3f s, %.2f MB/s\n", tool->progress.label, total / 1024u,
+            (double) elapsed / 1000.0, (double) total / 1048576.0 * 1000.0 / (double) elapsed);
+}
+
+static bool Pipe_Init(ToolPipe_t *pipe, uint32_t chunkSize)
+{
+    memset(pipe, 0, sizeof(*pipe));
+    pthread_mutex_init(&pipe->mutex, NULL);
+    pthread_cond_init(&pipe->changed, NULL);
+
+    for (uint32_t i = 0; i < TOOL_PIPE_SLOTS; i++)
+    {
+        pipe->slot[i] = malloc(chunkSize);
+        if (pipe->slot[i] == NULL)
+            return false;
+    }
+
+    return true;
+}
+
+static void Pipe_DeInit(ToolPipe_t *pipe)
+{
+    for (uint32_t i = 0; i < TOOL_PIPE_SLOTS; i++)
+    {
+        free(pipe->slot[i]);
+        pipe->slot[i] = NULL;
+    }
+}
+
+static uint8_t *Pipe_Reserve(ToolPipe_t *pipe)
+{
+    uint8_t *slot = NULL;
+
+    pthread_mutex_lock(&pipe->mutex);
+    while ((pipe->count == TOOL_PIPE_SLOTS) && !pipe->failed)
+        pthread_cond_wait(&pipe->changed, &pipe->mutex);
+    if (!pipe->failed)
+        slot = pipe->slot[(pipe->head + pipe->count) % TOOL_PIPE_SLOTS];
+    pthread_mutex_unlock(&pipe->mutex);
+
+    return slot;
+}
+
+static void Pipe_Commit(ToolPipe_t *pipe, uint32_t length)
+{
+    pthread_mutex_lock(&pipe->mutex);
+    pipe->length[(pipe->head + pipe->count) % TOOL_PIPE_SLOTS] = length;
+    pipe->count++;
+    pthread_cond_broadcast(&pipe->changed);
+    pthread_mutex_unlock(&pipe->mutex);
+}
+
+static uint8_t *Pipe_Peek(ToolPipe_t *pipe, uint32_t *length)
+{
+    uint8_t *slot = NULL;
+
+    pthread_mutex_lock(&pipe->mutex);
+    while ((pipe->count == 0) && !pipe->closed && !pipe->failed)
+        pthread_cond_wait(&pipe->changed, &pipe->mutex);
+    if ((pipe->count != 0) && !pipe->failed)
+    {
+        slot = pipe->slot[pipe->head];
+        *length = pipe->length[pipe->head];
+    }
+    pthread_mutex_unlock(&pipe->mutex);
+
+    return slot;
+}
+
+static void Pipe_Release(ToolPipe_t *pipe)
+{
+    pthread_mutex_lock(&pipe->mutex);
+    pipe->head = (pipe->head + 1) % TOOL_PIPE_SLOTS;
+    pipe->count--;
+    pthread_cond_broadcast(&pipe->changed);
+    pthread_mutex_unlock(&pipe->mutex);
+}
+
+static void Pipe_Close(ToolPipe_t *pipe, bool failed)
+{
+    pthread_mutex_lock(&pipe->mutex);
+    pipe->closed = true;
+    if (failed)
+        pipe->failed = true;
+    pthread_cond_broadcast(&pipe->changed);
+    pthread_mutex_unlock(&pipe->mutex);
+}
+
+static bool Pipe_Failed(ToolPipe_t *pipe)
+{
+    bool failed;
+
+    pthread_mutex_lock(&pipe->mutex);
+    failed = pipe->failed;
+    pthread_mutex_unlock(&pipe->mutex);
+
+    return failed;
+}
+
+static void CRC32_Init(void)
+{
+    uint32_t crc;
+
+    for (uint32_t i = 0; i < 256; i++)
+    {
+        crc = i;
+        for (uint8_t bit = 0; bit < 8; bit++)
+            crc = (crc & 1u) ? ((crc >> 1) ^ 0xEDB88320u) : (crc >> 1);
+        crcTable[i] = crc;
+    }
+}
+
+static uint32_t CRC32_Update(uint32_t crc, const uint8_t *pBuffer, uint32_t bufSize)
+{
+    crc = ~crc;
+    while (bufSize--)
+        crc = crcTable[(crc ^ *pBuffer++) & 0xffu] ^ (crc >> 8);
+
+    return ~crc;
+}
+
+static const char *ErrorString(w25qxx_Error_t error)
+{
+    switch (error)
+    {
+    case W25QXX_ERROR_NONE:
+        return "no";
+
+    case W25QXX_ERROR_PLATFORM:
+        return "platform";
+
+    case W25QXX_ERROR_ID:
+        return "unexpected ID";
+
+    case W25QXX_ERROR_STATUS:
+        return "status match";
+
+    case W25QXX_ERROR_ARGUMENT:
+        return "argument";
+
+    case W25QXX_ERROR_ADDRESS:
+        return "address";
+
+    case W25QXX_ERROR_SPI:
+        return "spi";
+
+    case W25QXX_ERROR_TIMEOUT:
+        return "timeout";
+
+    case W25QXX_ERROR_CHECKSUM:
+        return "checksum";
+
+    case W25QXX_ERROR_INSTRUCTION:
+        return "instruction";
+
+    case W25QXX_ERROR_VERIFY:
+        return "verify";
+    }
+
+    return "unknown";
+}
\ No newline at end of file
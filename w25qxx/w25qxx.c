@@ -1,932 +1,2579 @@
-#include "w25qxx.h"
-
-/* Macro */
-#define TOGGLE_BIT(REG, BIT)                ((REG) ^= (BIT))
-#define SET_BIT(REG, BIT)                   ((REG) |= (BIT))
-#define CLEAR_BIT(REG, BIT)                 ((REG) &= ~(BIT))
-#define READ_BIT(REG, BIT)                  ((REG) & (BIT))
-#define CLEAR_REG(REG)                      ((REG) = (0x0))
-#define WRITE_REG(REG, VAL)                 ((REG) = (VAL))
-#define READ_REG(REG)                       ((REG))
-#define MODIFY_REG(REG, CLEARMASK, SETMASK) WRITE_REG((REG), (((READ_REG(REG)) & (~(CLEARMASK))) | (SETMASK)))
-#define W25QXX_ADDRESS_BYTES_SWAP(ADDRESS)                            \
-    do                                                                \
-    {                                                                 \
-        w25qxx_Handle->addressBytes[0] = (uint8_t) ((ADDRESS) >> 16); \
-        w25qxx_Handle->addressBytes[1] = (uint8_t) ((ADDRESS) >> 8);  \
-        w25qxx_Handle->addressBytes[2] = (uint8_t) ((ADDRESS) >> 0);  \
-    }                                                                 \
-    while (0)
-#define W25QXX_ERROR_SET(W25QXX_ERROR)                       \
-    do                                                       \
-    {                                                        \
-        if (w25qxx_Handle->interface.cs_set != NULL)         \
-            w25qxx_Handle->interface.cs_set(W25QXX_CS_HIGH); \
-        return w25qxx_Handle->error = (W25QXX_ERROR);        \
-    }                                                        \
-    while (0)
-#define W25QXX_ERROR_CHECK                             \
-    do                                                 \
-    {                                                  \
-        if (w25qxx_Handle->error != W25QXX_ERROR_NONE) \
-            W25QXX_ERROR_SET(w25qxx_Handle->error);    \
-    }                                                  \
-    while (0)
-#define W25QXX_BEGIN_TRANSMIT(DATA_SOURCE, SIZE, TIMEOUT)                                                           \
-    do                                                                                                              \
-    {                                                                                                               \
-        if (w25qxx_Handle->interface.transmit(w25qxx_Handle->interface.handle, (DATA_SOURCE), (SIZE), (TIMEOUT)) != \
-            W25QXX_TRANSFER_SUCCESS)                                                                                \
-            W25QXX_ERROR_SET(W25QXX_ERROR_SPI);                                                                     \
-    }                                                                                                               \
-    while (0)
-#define W25QXX_BEGIN_RECEIVE(DATA_DESTINATION, SIZE, TIMEOUT)                                             \
-    do                                                                                                    \
-    {                                                                                                     \
-        if (w25qxx_Handle->interface.receive(w25qxx_Handle->interface.handle, (DATA_DESTINATION), (SIZE), \
-                                             (TIMEOUT)) != W25QXX_TRANSFER_SUCCESS)                       \
-            W25QXX_ERROR_SET(W25QXX_ERROR_SPI);                                                           \
-    }                                                                                                     \
-    while (0)
-
-/* Instruction Set */
-#define W25QXX_CMD_WRITE_ENABLE              0x06
-#define W25QXX_CMD_VOLATILE_SR_WRITE_ENABLE  0x50
-#define W25QXX_CMD_WRITE_DISABLE             0x04
-#define W25QXX_CMD_RELEASE_POWER_DOWN        0xAB
-#define W25QXX_CMD_MANUFACTURER_DEVICE_ID    0x90
-#define W25QXX_CMD_JEDEC_ID                  0x9F
-#define W25QXX_CMD_READ_UNIQUE_ID            0x4B
-#define W25QXX_CMD_READ_DATA                 0x03
-#define W25QXX_CMD_FAST_READ                 0x0B
-#define W25QXX_CMD_PAGE_PROGRAM              0x02
-#define W25QXX_CMD_SECTOR_ERASE_4KB          0x20
-#define W25QXX_CMD_BLOCK_ERASE_32KB          0x52
-#define W25QXX_CMD_BLOCK_ERASE_64KB          0xD8
-#define W25QXX_CMD_CHIP_ERASE                0xC7
-#define W25QXX_CMD_READ_STATUS_REGISTER1     0x05
-#define W25QXX_CMD_WRITE_STATUS_REGISTER1    0x01
-#define W25QXX_CMD_READ_STATUS_REGISTER2     0x35
-#define W25QXX_CMD_WRITE_STATUS_REGISTER2    0x31
-#define W25QXX_CMD_READ_STATUS_REGISTER3     0x15
-#define W25QXX_CMD_WRITE_STATUS_REGISTER3    0x11
-#define W25QXX_CMD_READ_SFDP_REGISTER        0x5A
-#define W25QXX_CMD_ERASE_SECURITY_REGISTER   0x44
-#define W25QXX_CMD_PROGRAM_SECURITY_REGISTER 0x42
-#define W25QXX_CMD_READ_SECURITY_REGISTER    0x48
-#define W25QXX_CMD_GLOBAL_BLOCK_LOCK         0x7E
-#define W25QXX_CMD_GLOBAL_BLOCK_UNLOCK       0x98
-#define W25QXX_CMD_READ_BLOCK_LOCK           0x3D
-#define W25QXX_CMD_INDIVIDUAL_BLOCK_LOCK     0x36
-#define W25QXX_CMD_INDIVIDUAL_BLOCK_UNLOCK   0x39
-#define W25QXX_CMD_ERASE_PROGRAM_SUSPEND     0x75
-#define W25QXX_CMD_ERASE_PROGRAM_RESUME      0x7A
-#define W25QXX_CMD_POWER_DOWN                0xB9
-#define W25QXX_CMD_ENABLE_RESET              0x66
-#define W25QXX_CMD_RESET_DEVICE              0x99
-
-/* Timings [ms] */
-#define W25QXX_PAGE_PROGRAM_TIME          3
-#define W25QXX_WRITE_STATUS_REGISTER_TIME 15
-#define W25QXX_SECTOR_ERASE_TIME_4KB      400
-#define W25QXX_BLOCK_ERASE_TIME_32KB      1600
-#define W25QXX_BLOCK_ERASE_TIME_64KB      2000
-
-enum w25qxx_ChipEraseTime {
-    CETIME_W25Q80 = 12000,
-    CETIME_W25Q16 = 25000,
-    CETIME_W25Q32 = 50000,
-    CETIME_W25Q64 = 100000,
-    CETIME_W25Q128 = 200000
-};
-
-/* Timeouts [ms] */
-#define W25QXX_TX_TIMEOUT       100
-#define W25QXX_RX_TIMEOUT       100
-#define W25QXX_RESPONSE_TIMEOUT 100
-
-// static w25qxx_Error_t w25qxx_PowerDown(w25qxx_HandleTypeDef *w25qxx_Handle);
-static w25qxx_Error_t w25qxx_ReleasePowerDown(w25qxx_HandleTypeDef *w25qxx_Handle);
-static w25qxx_Error_t w25qxx_ResetDevice(w25qxx_HandleTypeDef *w25qxx_Handle);
-static w25qxx_Error_t w25qxx_ReadID(w25qxx_HandleTypeDef *w25qxx_Handle);
-static w25qxx_Error_t w25qxx_WriteEnable(w25qxx_HandleTypeDef *w25qxx_Handle);
-// static w25qxx_Error_t w25qxx_WriteDisable(w25qxx_HandleTypeDef *w25qxx_Handle);
-static w25qxx_Error_t w25qxx_StatusUpdate(w25qxx_HandleTypeDef *w25qxx_Handle, w25qxx_Status_t statusCheck,
-                                          w25qxx_Status_t statusSet);
-static void Print(w25qxx_HandleTypeDef *w25qxx_Handle, const char *message);
-static uint16_t ModBus_CRC(const uint8_t *pBuffer, uint16_t bufSize);
-
-w25qxx_Error_t w25qxx_Init(w25qxx_HandleTypeDef *w25qxx_Handle)
-{
-    /* Avoid dereferencing the null handle */
-    if (w25qxx_Handle == NULL)
-        return W25QXX_ERROR_ARGUMENT;
-
-    if (w25qxx_StatusUpdate(w25qxx_Handle, W25QXX_STATUS_RESET, W25QXX_STATUS_INIT) != W25QXX_ERROR_NONE)
-        W25QXX_ERROR_SET(w25qxx_Handle->error);
-
-    /* Check platform functions */
-    if (w25qxx_Handle->interface.receive == NULL)
-        W25QXX_ERROR_SET(W25QXX_ERROR_PLATFORM);
-    if (w25qxx_Handle->interface.transmit == NULL)
-        W25QXX_ERROR_SET(W25QXX_ERROR_PLATFORM);
-    if (w25qxx_Handle->interface.cs_set == NULL)
-        W25QXX_ERROR_SET(W25QXX_ERROR_PLATFORM);
-    if (w25qxx_Handle->interface.delay == NULL)
-        W25QXX_ERROR_SET(W25QXX_ERROR_PLATFORM);
-
-    /* Start operation */
-    w25qxx_Handle->interface.cs_set(W25QXX_CS_HIGH);
-    w25qxx_Delay(100);
-    w25qxx_ReleasePowerDown(w25qxx_Handle);
-    w25qxx_ResetDevice(w25qxx_Handle);
-
-    /* Get the Manufacturer ID and Device ID */
-    w25qxx_ReadID(w25qxx_Handle);
-    w25qxx_Delay(10);
-    
-    return w25qxx_StatusUpdate(w25qxx_Handle, W25QXX_STATUS_INIT, W25QXX_STATUS_READY);
-}
-
-w25qxx_Error_t w25qxx_Write(w25qxx_HandleTypeDef *w25qxx_Handle, const uint8_t *buf, uint16_t dataLength,
-                            uint32_t address, w25qxx_CRC_t trailingCRC, w25qxx_WaitForTask_t waitForTask)
-{
-    /* Avoid dereferencing the null handle */
-    if (w25qxx_Handle == NULL)
-        return W25QXX_ERROR_ARGUMENT;
-
-    if (w25qxx_StatusUpdate(w25qxx_Handle, W25QXX_STATUS_READY, W25QXX_STATUS_WRITE) != W25QXX_ERROR_NONE)
-        W25QXX_ERROR_SET(w25qxx_Handle->error);
-
-    /* Argument guards */
-    if (buf == NULL)
-        W25QXX_ERROR_SET(W25QXX_ERROR_ARGUMENT);
-    if (dataLength == 0)
-        W25QXX_ERROR_SET(W25QXX_ERROR_ARGUMENT);
-    w25qxx_Handle->frameLength = dataLength;
-    if (trailingCRC == W25QXX_CRC)
-        w25qxx_Handle->frameLength += sizeof(w25qxx_Handle->CRC16);
-    if (w25qxx_Handle->frameLength > W25QXX_PAGE_SIZE)
-        W25QXX_ERROR_SET(W25QXX_ERROR_ARGUMENT);
-    if ((address % W25QXX_PAGE_SIZE) != 0)
-        W25QXX_ERROR_SET(W25QXX_ERROR_ADDRESS);
-    if (address > (W25QXX_PAGE_SIZE * (w25qxx_Handle->numberOfPages - 1)))
-        W25QXX_ERROR_SET(W25QXX_ERROR_ADDRESS);
-
-    /* Checksum calculate */
-    if (trailingCRC == W25QXX_CRC)
-        w25qxx_Handle->CRC16 = ModBus_CRC(buf, dataLength);
-
-    /* Command */
-    w25qxx_WriteEnable(w25qxx_Handle);
-    W25QXX_ERROR_CHECK;
-    w25qxx_Handle->CMD = W25QXX_CMD_PAGE_PROGRAM;
-    w25qxx_Handle->interface.cs_set(W25QXX_CS_LOW);
-    W25QXX_BEGIN_TRANSMIT(&w25qxx_Handle->CMD, sizeof(w25qxx_Handle->CMD), W25QXX_TX_TIMEOUT);
-
-    /* A23-A0 - Start address of the desired page */
-    W25QXX_ADDRESS_BYTES_SWAP(address);
-    W25QXX_BEGIN_TRANSMIT(w25qxx_Handle->addressBytes, sizeof(w25qxx_Handle->addressBytes), W25QXX_TX_TIMEOUT);
-
-    /* Data */
-    W25QXX_BEGIN_TRANSMIT((uint8_t *) buf, dataLength, W25QXX_TX_TIMEOUT);
-
-    /* Checksum */
-    if (trailingCRC == W25QXX_CRC)
-        W25QXX_BEGIN_TRANSMIT((uint8_t *) &w25qxx_Handle->CRC16, sizeof(w25qxx_Handle->CRC16), W25QXX_TX_TIMEOUT);
-    w25qxx_Handle->interface.cs_set(W25QXX_CS_HIGH);
-
-    /* Task wait */
-    switch (waitForTask)
-    {
-    case W25QXX_WAIT_NO:
-        break;
-
-    case W25QXX_WAIT_DELAY:
-        w25qxx_Delay(W25QXX_PAGE_PROGRAM_TIME);
-        break;
-
-    case W25QXX_WAIT_BUSY:
-        if (w25qxx_BusyCheck(w25qxx_Handle, W25QXX_PAGE_PROGRAM_TIME) != W25QXX_STATUS_READY)
-            W25QXX_ERROR_SET(W25QXX_ERROR_TIMEOUT);
-        break;
-
-    default:
-        W25QXX_ERROR_SET(W25QXX_ERROR_ARGUMENT);
-        break;
-    }
-
-    return w25qxx_StatusUpdate(w25qxx_Handle, W25QXX_STATUS_WRITE, W25QXX_STATUS_READY);
-}
-
-w25qxx_Error_t w25qxx_Read(w25qxx_HandleTypeDef *w25qxx_Handle, uint8_t *buf, uint16_t dataLength, uint32_t address,
-                           w25qxx_CRC_t trailingCRC, w25qxx_FastRead_t fastRead)
-{
-    /* Avoid dereferencing the null handle */
-    if (w25qxx_Handle == NULL)
-        return W25QXX_ERROR_ARGUMENT;
-
-    if (w25qxx_StatusUpdate(w25qxx_Handle, W25QXX_STATUS_READY, W25QXX_STATUS_READ) != W25QXX_ERROR_NONE)
-        W25QXX_ERROR_SET(w25qxx_Handle->error);
-
-    /* Argument guards */
-    if (buf == NULL)
-        W25QXX_ERROR_SET(W25QXX_ERROR_ARGUMENT);
-    if (dataLength == 0)
-        W25QXX_ERROR_SET(W25QXX_ERROR_ARGUMENT);
-    w25qxx_Handle->frameLength = dataLength;
-    if (trailingCRC == W25QXX_CRC)
-        w25qxx_Handle->frameLength += sizeof(w25qxx_Handle->CRC16);
-    if (w25qxx_Handle->frameLength > W25QXX_PAGE_SIZE)
-        W25QXX_ERROR_SET(W25QXX_ERROR_ARGUMENT);
-    if ((address % W25QXX_PAGE_SIZE) != 0)
-        W25QXX_ERROR_SET(W25QXX_ERROR_ADDRESS);
-    if (address > (W25QXX_PAGE_SIZE * (w25qxx_Handle->numberOfPages - 1)))
-        W25QXX_ERROR_SET(W25QXX_ERROR_ADDRESS);
-
-    /* Command */
-    w25qxx_Handle->CMD = (fastRead == W25QXX_FASTREAD) ? W25QXX_CMD_FAST_READ : W25QXX_CMD_READ_DATA;
-    w25qxx_Handle->interface.cs_set(W25QXX_CS_LOW);
-    W25QXX_BEGIN_TRANSMIT(&w25qxx_Handle->CMD, sizeof(w25qxx_Handle->CMD), W25QXX_TX_TIMEOUT);
-
-    /* A23-A0 - Start address of the desired page */
-    W25QXX_ADDRESS_BYTES_SWAP(address);
-    W25QXX_BEGIN_TRANSMIT(w25qxx_Handle->addressBytes, sizeof(w25qxx_Handle->addressBytes), W25QXX_TX_TIMEOUT);
-
-    /* 8 dummy clocks */
-    if (fastRead == W25QXX_FASTREAD)
-        W25QXX_BEGIN_TRANSMIT(&w25qxx_Handle->CMD, sizeof(w25qxx_Handle->CMD), W25QXX_TX_TIMEOUT);
-
-    /* Data receive */
-    W25QXX_BEGIN_RECEIVE(w25qxx_Handle->frameBuf, w25qxx_Handle->frameLength, W25QXX_RX_TIMEOUT);
-    w25qxx_Handle->interface.cs_set(W25QXX_CS_HIGH);
-
-    /* Checksum compare */
-    if (trailingCRC == W25QXX_CRC)
-    {
-        w25qxx_Handle->CRC16 = ModBus_CRC(w25qxx_Handle->frameBuf, dataLength);
-        if (memcmp(&w25qxx_Handle->frameBuf[dataLength], &w25qxx_Handle->CRC16, sizeof(w25qxx_Handle->CRC16)) != 0)
-            W25QXX_ERROR_SET(W25QXX_ERROR_CHECKSUM);
-    }
-
-    /* Copy received data without checksum to the destination buffer */
-    memcpy(buf, w25qxx_Handle->frameBuf, dataLength);
-
-    return w25qxx_StatusUpdate(w25qxx_Handle, W25QXX_STATUS_READ, W25QXX_STATUS_READY);
-}
-
-w25qxx_Error_t w25qxx_Erase(w25qxx_HandleTypeDef *w25qxx_Handle, w25qxx_EraseInstruction_t eraseInstruction,
-                            uint32_t address, w25qxx_WaitForTask_t waitForTask)
-{
-    uint32_t chipEraseTimeout = 0;
-
-    /* Avoid dereferencing the null handle */
-    if (w25qxx_Handle == NULL)
-        return W25QXX_ERROR_ARGUMENT;
-
-    if (w25qxx_StatusUpdate(w25qxx_Handle, W25QXX_STATUS_READY, W25QXX_STATUS_ERASE) != W25QXX_ERROR_NONE)
-        W25QXX_ERROR_SET(w25qxx_Handle->error);
-
-    switch (eraseInstruction)
-    {
-    case W25QXX_SECTOR_ERASE_4KB:
-        if ((address % W25QXX_SECTOR_SIZE_4KB) != 0)
-            W25QXX_ERROR_SET(W25QXX_ERROR_ADDRESS);
-        if (address > ((W25QXX_PAGE_SIZE * w25qxx_Handle->numberOfPages) - W25QXX_SECTOR_SIZE_4KB))
-            W25QXX_ERROR_SET(W25QXX_ERROR_ADDRESS);
-
-        /* Command */
-        w25qxx_WriteEnable(w25qxx_Handle);
-        W25QXX_ERROR_CHECK;
-        w25qxx_Handle->CMD = W25QXX_CMD_SECTOR_ERASE_4KB;
-        w25qxx_Handle->interface.cs_set(W25QXX_CS_LOW);
-        W25QXX_BEGIN_TRANSMIT(&w25qxx_Handle->CMD, sizeof(w25qxx_Handle->CMD), W25QXX_TX_TIMEOUT);
-
-        /* A23-A0 - Start address of the desired page */
-        W25QXX_ADDRESS_BYTES_SWAP(address);
-        W25QXX_BEGIN_TRANSMIT(w25qxx_Handle->addressBytes, sizeof(w25qxx_Handle->addressBytes), W25QXX_TX_TIMEOUT);
-        w25qxx_Handle->interface.cs_set(W25QXX_CS_HIGH);
-
-        /* Task wait */
-        switch (waitForTask)
-        {
-        case W25QXX_WAIT_NO:
-            break;
-
-        case W25QXX_WAIT_DELAY:
-            w25qxx_Delay(W25QXX_SECTOR_ERASE_TIME_4KB);
-            break;
-
-        case W25QXX_WAIT_BUSY:
-            if (w25qxx_BusyCheck(w25qxx_Handle, W25QXX_SECTOR_ERASE_TIME_4KB) != W25QXX_STATUS_READY)
-                W25QXX_ERROR_SET(W25QXX_ERROR_TIMEOUT);
-            break;
-
-        default:
-            W25QXX_ERROR_SET(W25QXX_ERROR_ARGUMENT);
-            break;
-        }
-        break;
-
-    case W25QXX_BLOCK_ERASE_32KB:
-        if ((address % W25QXX_BLOCK_SIZE_32KB) != 0)
-            W25QXX_ERROR_SET(W25QXX_ERROR_ADDRESS);
-        if (address > ((W25QXX_PAGE_SIZE * w25qxx_Handle->numberOfPages) - W25QXX_BLOCK_SIZE_32KB))
-            W25QXX_ERROR_SET(W25QXX_ERROR_ADDRESS);
-
-        /* Command */
-        w25qxx_WriteEnable(w25qxx_Handle);
-        W25QXX_ERROR_CHECK;
-        w25qxx_Handle->CMD = W25QXX_CMD_BLOCK_ERASE_32KB;
-        w25qxx_Handle->interface.cs_set(W25QXX_CS_LOW);
-        W25QXX_BEGIN_TRANSMIT(&w25qxx_Handle->CMD, sizeof(w25qxx_Handle->CMD), W25QXX_TX_TIMEOUT);
-
-        /* A23-A0 - Start address of the desired page */
-        W25QXX_ADDRESS_BYTES_SWAP(address);
-        W25QXX_BEGIN_TRANSMIT(w25qxx_Handle->addressBytes, sizeof(w25qxx_Handle->addressBytes), W25QXX_TX_TIMEOUT);
-        w25qxx_Handle->interface.cs_set(W25QXX_CS_HIGH);
-
-        /* Task wait */
-        switch (waitForTask)
-        {
-        case W25QXX_WAIT_NO:
-            break;
-
-        case W25QXX_WAIT_DELAY:
-            w25qxx_Delay(W25QXX_BLOCK_ERASE_TIME_32KB);
-            break;
-
-        case W25QXX_WAIT_BUSY:
-            if (w25qxx_BusyCheck(w25qxx_Handle, W25QXX_BLOCK_ERASE_TIME_32KB) != W25QXX_STATUS_READY)
-                W25QXX_ERROR_SET(W25QXX_ERROR_TIMEOUT);
-            break;
-
-        default:
-            W25QXX_ERROR_SET(W25QXX_ERROR_ARGUMENT);
-            break;
-        }
-        break;
-
-    case W25QXX_BLOCK_ERASE_64KB:
-        if ((address % W25QXX_BLOCK_SIZE_64KB) != 0)
-            W25QXX_ERROR_SET(W25QXX_ERROR_ADDRESS);
-        if (address > ((W25QXX_PAGE_SIZE * w25qxx_Handle->numberOfPages) - W25QXX_BLOCK_SIZE_64KB))
-            W25QXX_ERROR_SET(W25QXX_ERROR_ADDRESS);
-
-        /* Command */
-        w25qxx_WriteEnable(w25qxx_Handle);
-        W25QXX_ERROR_CHECK;
-        w25qxx_Handle->CMD = W25QXX_CMD_BLOCK_ERASE_64KB;
-        w25qxx_Handle->interface.cs_set(W25QXX_CS_LOW);
-        W25QXX_BEGIN_TRANSMIT(&w25qxx_Handle->CMD, sizeof(w25qxx_Handle->CMD), W25QXX_TX_TIMEOUT);
-
-        /* A23-A0 - Start address of the desired page */
-        W25QXX_ADDRESS_BYTES_SWAP(address);
-        W25QXX_BEGIN_TRANSMIT(w25qxx_Handle->addressBytes, sizeof(w25qxx_Handle->addressBytes), W25QXX_TX_TIMEOUT);
-        w25qxx_Handle->interface.cs_set(W25QXX_CS_HIGH);
-
-        /* Task wait */
-        switch (waitForTask)
-        {
-        case W25QXX_WAIT_NO:
-            break;
-
-        case W25QXX_WAIT_DELAY:
-            w25qxx_Delay(W25QXX_BLOCK_ERASE_TIME_64KB);
-            break;
-
-        case W25QXX_WAIT_BUSY:
-            if (w25qxx_BusyCheck(w25qxx_Handle, W25QXX_BLOCK_ERASE_TIME_64KB) != W25QXX_STATUS_READY)
-                W25QXX_ERROR_SET(W25QXX_ERROR_TIMEOUT);
-            break;
-
-        default:
-            W25QXX_ERROR_SET(W25QXX_ERROR_ARGUMENT);
-            break;
-        }
-        break;
-
-    case W25QXX_CHIP_ERASE:
-        if (address != 0)
-            W25QXX_ERROR_SET(W25QXX_ERROR_ADDRESS);
-
-        /* Choose the right timeout */
-        switch (w25qxx_Handle->ID[1])
-        {
-        case W25Q80:
-            chipEraseTimeout = CETIME_W25Q80;
-            break;
-
-        case W25Q16:
-            chipEraseTimeout = CETIME_W25Q16;
-            break;
-
-        case W25Q32:
-            chipEraseTimeout = CETIME_W25Q32;
-            break;
-
-        case W25Q64:
-            chipEraseTimeout = CETIME_W25Q64;
-            break;
-
-        case W25Q128:
-            chipEraseTimeout = CETIME_W25Q128;
-            break;
-        }
-
-        /* Command */
-        w25qxx_WriteEnable(w25qxx_Handle);
-        W25QXX_ERROR_CHECK;
-        w25qxx_Handle->CMD = W25QXX_CMD_CHIP_ERASE;
-        w25qxx_Handle->interface.cs_set(W25QXX_CS_LOW);
-        W25QXX_BEGIN_TRANSMIT(&w25qxx_Handle->CMD, sizeof(w25qxx_Handle->CMD), W25QXX_TX_TIMEOUT);
-        w25qxx_Handle->interface.cs_set(W25QXX_CS_HIGH);
-
-        /* Task wait */
-        switch (waitForTask)
-        {
-        case W25QXX_WAIT_NO:
-            break;
-
-        case W25QXX_WAIT_DELAY:
-            w25qxx_Delay(chipEraseTimeout);
-            break;
-
-        case W25QXX_WAIT_BUSY:
-            if (w25qxx_BusyCheck(w25qxx_Handle, chipEraseTimeout) != W25QXX_STATUS_READY)
-                W25QXX_ERROR_SET(W25QXX_ERROR_TIMEOUT);
-            break;
-
-        default:
-            W25QXX_ERROR_SET(W25QXX_ERROR_ARGUMENT);
-            break;
-        }
-        break;
-
-    default:
-        W25QXX_ERROR_SET(W25QXX_ERROR_INSTRUCTION);
-        break;
-    }
-
-    return w25qxx_StatusUpdate(w25qxx_Handle, W25QXX_STATUS_ERASE, W25QXX_STATUS_READY);
-}
-
-w25qxx_Error_t w25qxx_WriteStatus(w25qxx_HandleTypeDef *w25qxx_Handle, uint8_t statusRegisterx,
-                                  w25qxx_SR_Behaviour_t statusRegisterBehaviour)
-{
-    /* Avoid dereferencing the null handle */
-    if (w25qxx_Handle == NULL)
-        return W25QXX_ERROR_ARGUMENT;
-
-    if (w25qxx_StatusUpdate(w25qxx_Handle, W25QXX_STATUS_READY, W25QXX_STATUS_WRITE_SR) != W25QXX_ERROR_NONE)
-        W25QXX_ERROR_SET(w25qxx_Handle->error);
-
-    /* Argument guards */
-    if ((statusRegisterx < 1u) || (statusRegisterx > 3u))
-        W25QXX_ERROR_SET(W25QXX_ERROR_ARGUMENT);
-
-    /* Command 1 */
-    w25qxx_Handle->CMD =
-        (statusRegisterBehaviour == W25QXX_SR_VOLATILE) ? W25QXX_CMD_VOLATILE_SR_WRITE_ENABLE : W25QXX_CMD_WRITE_ENABLE;
-    w25qxx_Handle->interface.cs_set(W25QXX_CS_LOW);
-    W25QXX_BEGIN_TRANSMIT(&w25qxx_Handle->CMD, sizeof(w25qxx_Handle->CMD), W25QXX_TX_TIMEOUT);
-    w25qxx_Handle->interface.cs_set(W25QXX_CS_HIGH);
-
-    /* Command 2 */
-    switch (statusRegisterx)
-    {
-    case 1u:
-        w25qxx_Handle->CMD = W25QXX_CMD_WRITE_STATUS_REGISTER1;
-        break;
-
-    case 2u:
-        w25qxx_Handle->CMD = W25QXX_CMD_WRITE_STATUS_REGISTER2;
-        break;
-
-    case 3u:
-        w25qxx_Handle->CMD = W25QXX_CMD_WRITE_STATUS_REGISTER3;
-        break;
-    }
-    w25qxx_Handle->interface.cs_set(W25QXX_CS_LOW);
-    W25QXX_BEGIN_TRANSMIT(&w25qxx_Handle->CMD, sizeof(w25qxx_Handle->CMD), W25QXX_TX_TIMEOUT);
-
-    /* Status write */
-    W25QXX_BEGIN_TRANSMIT(&w25qxx_Handle->statusRegister, sizeof(w25qxx_Handle->statusRegister), W25QXX_TX_TIMEOUT);
-    w25qxx_Handle->interface.cs_set(W25QXX_CS_HIGH);
-
-    /* Task wait */
-    if (statusRegisterBehaviour != W25QXX_SR_VOLATILE)
-    {
-        if (w25qxx_BusyCheck(w25qxx_Handle, W25QXX_WRITE_STATUS_REGISTER_TIME) != W25QXX_STATUS_READY)
-            W25QXX_ERROR_SET(W25QXX_ERROR_TIMEOUT);
-    }
-
-    return w25qxx_StatusUpdate(w25qxx_Handle, W25QXX_STATUS_WRITE_SR, W25QXX_STATUS_READY);
-}
-
-w25qxx_Error_t w25qxx_ReadStatus(w25qxx_HandleTypeDef *w25qxx_Handle, uint8_t statusRegisterx)
-{
-    /* Avoid dereferencing the null handle */
-    if (w25qxx_Handle == NULL)
-        return W25QXX_ERROR_ARGUMENT;
-
-    if (w25qxx_StatusUpdate(w25qxx_Handle, W25QXX_STATUS_READY, W25QXX_STATUS_READ_SR) != W25QXX_ERROR_NONE)
-        W25QXX_ERROR_SET(w25qxx_Handle->error);
-
-    /* Argument guards */
-    if ((statusRegisterx < 1u) || (statusRegisterx > 3u))
-        W25QXX_ERROR_SET(W25QXX_ERROR_ARGUMENT);
-
-    /* Command */
-    switch (statusRegisterx)
-    {
-    case 1u:
-        w25qxx_Handle->CMD = W25QXX_CMD_READ_STATUS_REGISTER1;
-        break;
-
-    case 2u:
-        w25qxx_Handle->CMD = W25QXX_CMD_READ_STATUS_REGISTER2;
-        break;
-
-    case 3u:
-        w25qxx_Handle->CMD = W25QXX_CMD_READ_STATUS_REGISTER3;
-        break;
-    }
-    w25qxx_Handle->interface.cs_set(W25QXX_CS_LOW);
-    W25QXX_BEGIN_TRANSMIT(&w25qxx_Handle->CMD, sizeof(w25qxx_Handle->CMD), W25QXX_TX_TIMEOUT);
-
-    /* Status read */
-    W25QXX_BEGIN_RECEIVE(&w25qxx_Handle->statusRegister, sizeof(w25qxx_Handle->statusRegister), W25QXX_RX_TIMEOUT);
-    w25qxx_Handle->interface.cs_set(W25QXX_CS_HIGH);
-
-    return w25qxx_StatusUpdate(w25qxx_Handle, W25QXX_STATUS_READ_SR, W25QXX_STATUS_READY);
-}
-
-w25qxx_Error_t w25qxx_ResetError(w25qxx_HandleTypeDef *w25qxx_Handle)
-{
-    /* Avoid dereferencing the null handle */
-    if (w25qxx_Handle == NULL)
-        return W25QXX_ERROR_ARGUMENT;
-
-    /* Existing errors check */
-    if (w25qxx_Handle->error == W25QXX_ERROR_NONE)
-        return w25qxx_Handle->error;
-
-    /* Reset error */
-    w25qxx_Handle->error = W25QXX_ERROR_NONE;
-
-    /* Try to get response from device */
-    if (w25qxx_BusyCheck(w25qxx_Handle, W25QXX_RESPONSE_TIMEOUT) != W25QXX_STATUS_READY)
-        W25QXX_ERROR_SET(W25QXX_ERROR_TIMEOUT);
-
-    return w25qxx_StatusUpdate(w25qxx_Handle, w25qxx_Handle->status, W25QXX_STATUS_READY);
-}
-
-w25qxx_Status_t w25qxx_BusyCheck(w25qxx_HandleTypeDef *w25qxx_Handle, uint32_t timeout)
-{
-    uint32_t delayActual;
-
-    /* Avoid dereferencing the null handle */
-    if (w25qxx_Handle == NULL)
-        return W25QXX_STATUS_UNDEFINED;
-
-    /* Existing errors check */
-    if (w25qxx_Handle->error != W25QXX_ERROR_NONE)
-        return W25QXX_STATUS_UNDEFINED;
-
-    /* Command */
-    w25qxx_Handle->CMD = W25QXX_CMD_READ_STATUS_REGISTER1;
-    w25qxx_Handle->interface.cs_set(W25QXX_CS_LOW);
-    if (w25qxx_Handle->interface.transmit(w25qxx_Handle->interface.handle, &w25qxx_Handle->CMD,
-                                          sizeof(w25qxx_Handle->CMD), W25QXX_TX_TIMEOUT) != W25QXX_TRANSFER_SUCCESS)
-    {
-        w25qxx_Handle->error = W25QXX_ERROR_SPI;
-        w25qxx_Handle->interface.cs_set(W25QXX_CS_HIGH);
-
-        return W25QXX_STATUS_UNDEFINED;
-    }
-
-    /* Start polling */
-    while (true)
-    {
-        /* Get status register 1 data */
-        if (w25qxx_Handle->interface.receive(w25qxx_Handle->interface.handle, &w25qxx_Handle->statusRegister,
-                                             sizeof(w25qxx_Handle->statusRegister),
-                                             W25QXX_RX_TIMEOUT) != W25QXX_TRANSFER_SUCCESS)
-        {
-            w25qxx_Handle->error = W25QXX_ERROR_SPI;
-            w25qxx_Handle->interface.cs_set(W25QXX_CS_HIGH);
-
-            return W25QXX_STATUS_UNDEFINED;
-        }
-
-        /* Get busy bit state */
-        if (!READ_BIT(w25qxx_Handle->statusRegister, 1u << 0))
-        {
-            w25qxx_Handle->interface.cs_set(W25QXX_CS_HIGH);
-
-            return W25QXX_STATUS_READY;
-        }
-
-        /* Timeout handling */
-        if (timeout == 0)
-        {
-            w25qxx_Handle->interface.cs_set(W25QXX_CS_HIGH);
-
-            return W25QXX_STATUS_BUSY;
-        }
-        delayActual = w25qxx_Delay(1);
-        if ((delayActual == 0) || (timeout < delayActual))
-        {
-            timeout = 0;
-            continue;
-        }
-        else
-        {
-            timeout -= delayActual;
-            continue;
-        }
-    }
-}
-
-/**
- * @section Private functions
- */
-// static w25qxx_Error_t w25qxx_PowerDown(w25qxx_HandleTypeDef *w25qxx_Handle)
-// {
-//     /* Avoid dereferencing the null handle */
-//     if (w25qxx_Handle == NULL)
-//         return W25QXX_ERROR_ARGUMENT;
-
-// /* Existing errors check */
-// if (w25qxx_Handle->error != W25QXX_ERROR_NONE)
-//     return w25qxx_Handle->error;
-
-// /* Command */
-// w25qxx_Handle->CMD = W25QXX_CMD_POWER_DOWN;
-// w25qxx_Handle->interface.cs_set(W25QXX_CS_LOW);
-// W25QXX_BEGIN_TRANSMIT(&w25qxx_Handle->CMD, sizeof(w25qxx_Handle->CMD), W25QXX_TX_TIMEOUT);
-// w25qxx_Handle->interface.cs_set(W25QXX_CS_HIGH);
-// w25qxx_Delay(1);
-
-// return w25qxx_Handle->error;
-// }
-
-static w25qxx_Error_t w25qxx_ReleasePowerDown(w25qxx_HandleTypeDef *w25qxx_Handle)
-{
-    /* Avoid dereferencing the null handle */
-    if (w25qxx_Handle == NULL)
-        return W25QXX_ERROR_ARGUMENT;
-
-    /* Existing errors check */
-    if (w25qxx_Handle->error != W25QXX_ERROR_NONE)
-        return w25qxx_Handle->error;
-
-    /* Command */
-    w25qxx_Handle->CMD = W25QXX_CMD_RELEASE_POWER_DOWN;
-    w25qxx_Handle->interface.cs_set(W25QXX_CS_LOW);
-    W25QXX_BEGIN_TRANSMIT(&w25qxx_Handle->CMD, sizeof(w25qxx_Handle->CMD), W25QXX_TX_TIMEOUT);
-    w25qxx_Handle->interface.cs_set(W25QXX_CS_HIGH);
-    w25qxx_Delay(1);
-
-    return w25qxx_Handle->error;
-}
-
-static w25qxx_Error_t w25qxx_ResetDevice(w25qxx_HandleTypeDef *w25qxx_Handle)
-{
-    /* Avoid dereferencing the null handle */
-    if (w25qxx_Handle == NULL)
-        return W25QXX_ERROR_ARGUMENT;
-
-    /* Existing errors check */
-    if (w25qxx_Handle->error != W25QXX_ERROR_NONE)
-        return w25qxx_Handle->error;
-
-    /* Command 1 */
-    w25qxx_Handle->CMD = W25QXX_CMD_ENABLE_RESET;
-    w25qxx_Handle->interface.cs_set(W25QXX_CS_LOW);
-    W25QXX_BEGIN_TRANSMIT(&w25qxx_Handle->CMD, sizeof(w25qxx_Handle->CMD), W25QXX_TX_TIMEOUT);
-    w25qxx_Handle->interface.cs_set(W25QXX_CS_HIGH);
-
-    /* Command 2 */
-    w25qxx_Handle->CMD = W25QXX_CMD_RESET_DEVICE;
-    w25qxx_Handle->interface.cs_set(W25QXX_CS_LOW);
-    W25QXX_BEGIN_TRANSMIT(&w25qxx_Handle->CMD, sizeof(w25qxx_Handle->CMD), W25QXX_TX_TIMEOUT);
-    w25qxx_Handle->interface.cs_set(W25QXX_CS_HIGH);
-    w25qxx_Delay(1);
-
-    return w25qxx_Handle->error;
-}
-
-static w25qxx_Error_t w25qxx_ReadID(w25qxx_HandleTypeDef *w25qxx_Handle)
-{
-    char capacityString[30];
-
-    /* Avoid dereferencing the null handle */
-    if (w25qxx_Handle == NULL)
-        return W25QXX_ERROR_ARGUMENT;
-
-    /* Existing errors check */
-    if (w25qxx_Handle->error != W25QXX_ERROR_NONE)
-        return w25qxx_Handle->error;
-
-    /* Command */
-    w25qxx_Handle->CMD = W25QXX_CMD_MANUFACTURER_DEVICE_ID;
-    w25qxx_Handle->interface.cs_set(W25QXX_CS_LOW);
-    W25QXX_BEGIN_TRANSMIT(&w25qxx_Handle->CMD, sizeof(w25qxx_Handle->CMD), W25QXX_TX_TIMEOUT);
-
-    /* 24-bit address (A23-A0) of 000000h */
-    W25QXX_ADDRESS_BYTES_SWAP((uint32_t) 0);
-    W25QXX_BEGIN_TRANSMIT(w25qxx_Handle->addressBytes, sizeof(w25qxx_Handle->addressBytes), W25QXX_TX_TIMEOUT);
-
-    /* Get Manufacturer ID and Device ID */
-    W25QXX_BEGIN_RECEIVE(w25qxx_Handle->ID, sizeof(w25qxx_Handle->ID), W25QXX_RX_TIMEOUT);
-    w25qxx_Handle->interface.cs_set(W25QXX_CS_HIGH);
-
-    /* Check if we work with Winbond Serial Flash device */
-    Print(w25qxx_Handle, "Manufacturer: ");
-    switch (w25qxx_Handle->ID[0])
-    {
-    case W25QXX_MANUFACTURER_ID:
-        Print(w25qxx_Handle, "Winbond\n");
-        break;
-
-    default:
-        Print(w25qxx_Handle, "undefined\n");
-        W25QXX_ERROR_SET(W25QXX_ERROR_ID);
-    }
-
-    /* Determine device and number of pages */
-    Print(w25qxx_Handle, "Device: ");
-    switch (w25qxx_Handle->ID[1])
-    {
-    case W25Q80:
-        Print(w25qxx_Handle, "W25Q80");
-        w25qxx_Handle->numberOfPages = 8 * (W25QXX_KB_TO_BYTE(1) * W25QXX_KB_TO_BYTE(1) / W25QXX_PAGE_SIZE / 8);
-        break;
-
-    case W25Q16:
-        Print(w25qxx_Handle, "W25Q16");
-        w25qxx_Handle->numberOfPages = 16 * (W25QXX_KB_TO_BYTE(1) * W25QXX_KB_TO_BYTE(1) / W25QXX_PAGE_SIZE / 8);
-        break;
-
-    case W25Q32:
-        Print(w25qxx_Handle, "W25Q32");
-        w25qxx_Handle->numberOfPages = 32 * (W25QXX_KB_TO_BYTE(1) * W25QXX_KB_TO_BYTE(1) / W25QXX_PAGE_SIZE / 8);
-        break;
-
-    case W25Q64:
-        Print(w25qxx_Handle, "W25Q64");
-        w25qxx_Handle->numberOfPages = 64 * (W25QXX_KB_TO_BYTE(1) * W25QXX_KB_TO_BYTE(1) / W25QXX_PAGE_SIZE / 8);
-        break;
-
-    case W25Q128:
-        Print(w25qxx_Handle, "W25Q128");
-        w25qxx_Handle->numberOfPages = 128 * (W25QXX_KB_TO_BYTE(1) * W25QXX_KB_TO_BYTE(1) / W25QXX_PAGE_SIZE / 8);
-        break;
-
-    /* Unsupported device */
-    default:
-        Print(w25qxx_Handle, "undefined\n");
-        W25QXX_ERROR_SET(W25QXX_ERROR_ID);
-    }
-    snprintf(capacityString, sizeof(capacityString), " (%uMbit in %u pages)\n",
-             (w25qxx_Handle->numberOfPages * W25QXX_PAGE_SIZE * 8 / 1024 / 1024), w25qxx_Handle->numberOfPages);
-    Print(w25qxx_Handle, capacityString);
-
-    return w25qxx_Handle->error;
-}
-
-static w25qxx_Error_t w25qxx_WriteEnable(w25qxx_HandleTypeDef *w25qxx_Handle)
-{
-    /* Avoid dereferencing the null handle */
-    if (w25qxx_Handle == NULL)
-        return W25QXX_ERROR_ARGUMENT;
-
-    /* Existing errors check */
-    if (w25qxx_Handle->error != W25QXX_ERROR_NONE)
-        return w25qxx_Handle->error;
-
-    /* Command */
-    w25qxx_Handle->CMD = W25QXX_CMD_WRITE_ENABLE;
-    w25qxx_Handle->interface.cs_set(W25QXX_CS_LOW);
-    W25QXX_BEGIN_TRANSMIT(&w25qxx_Handle->CMD, sizeof(w25qxx_Handle->CMD), W25QXX_TX_TIMEOUT);
-    w25qxx_Handle->interface.cs_set(W25QXX_CS_HIGH);
-
-    return w25qxx_Handle->error;
-}
-
-// static w25qxx_Error_t w25qxx_WriteDisable(w25qxx_HandleTypeDef *w25qxx_Handle)
-// {
-//     /* Avoid dereferencing the null handle */
-//     if (w25qxx_Handle == NULL)
-//         return W25QXX_ERROR_ARGUMENT;
-
-// /* Existing errors check */
-// if (w25qxx_Handle->error != W25QXX_ERROR_NONE)
-//     return w25qxx_Handle->error;
-
-// /* Command */
-// w25qxx_Handle->CMD = W25QXX_CMD_WRITE_DISABLE;
-// w25qxx_Handle->interface.cs_set(W25QXX_CS_LOW);
-// W25QXX_BEGIN_TRANSMIT(&w25qxx_Handle->CMD, sizeof(w25qxx_Handle->CMD), W25QXX_TX_TIMEOUT);
-// w25qxx_Handle->interface.cs_set(W25QXX_CS_HIGH);
-
-// return w25qxx_Handle->error;
-// }
-
-static w25qxx_Error_t w25qxx_StatusUpdate(w25qxx_HandleTypeDef *w25qxx_Handle, w25qxx_Status_t statusCheck,
-                                          w25qxx_Status_t statusSet)
-{
-    /* Avoid dereferencing the null handle */
-    if (w25qxx_Handle == NULL)
-        return W25QXX_ERROR_ARGUMENT;
-
-    /* Existing errors check */
-    if (w25qxx_Handle->error != W25QXX_ERROR_NONE)
-        return w25qxx_Handle->error;
-
-    /* Actual status check */
-    if (w25qxx_Handle->status != statusCheck)
-        W25QXX_ERROR_SET(W25QXX_ERROR_STATUS);
-
-    /* Status update */
-    w25qxx_Handle->status = statusSet;
-
-    /* Debug trace */
-    Print(w25qxx_Handle, "Status update: ");
-    switch (w25qxx_Handle->status)
-    {
-    case W25QXX_STATUS_RESET:
-        Print(w25qxx_Handle, "reset\n");
-        break;
-
-    case W25QXX_STATUS_INIT:
-        Print(w25qxx_Handle, "init\n");
-        break;
-
-    case W25QXX_STATUS_WRITE:
-        Print(w25qxx_Handle, "write\n");
-        break;
-
-    case W25QXX_STATUS_READ:
-        Print(w25qxx_Handle, "read\n");
-        break;
-
-    case W25QXX_STATUS_ERASE:
-        Print(w25qxx_Handle, "erase\n");
-        break;
-
-    case W25QXX_STATUS_WRITE_SR:
-        Print(w25qxx_Handle, "write status register\n");
-        break;
-
-    case W25QXX_STATUS_READ_SR:
-        Print(w25qxx_Handle, "read status register\n");
-        break;
-
-    case W25QXX_STATUS_BUSY:
-        Print(w25qxx_Handle, "busy\n");
-        break;
-
-    case W25QXX_STATUS_READY:
-        Print(w25qxx_Handle, "ready\n");
-        break;
-
-    case W25QXX_STATUS_UNDEFINED:
-        Print(w25qxx_Handle, "undefined\n");
-        break;
-    }
-
-    return w25qxx_Handle->error;
-}
-
-static void Print(w25qxx_HandleTypeDef *w25qxx_Handle, const char *message)
-{
-    /* Avoid dereferencing the null handle */
-    if (w25qxx_Handle == NULL)
-        return;
-
-    if (message != NULL)
-        if (w25qxx_Handle->interface.print != NULL)
-            w25qxx_Handle->interface.print(message);
-}
-
-static uint16_t ModBus_CRC(const uint8_t *pBuffer, uint16_t bufSize)
-{
-    uint16_t CRC16 = 0xffff;
-    uint16_t i, j;
-
-    for (i = 0; i < bufSize; i++)
-    {
-        CRC16 ^= pBuffer[i];
-
-        for (j = 0; j < 8; j++)
-            if (CRC16 & 1)
-                CRC16 = (CRC16 >> 1) ^ 0xA001;
-            else
-                CRC16 = (CRC16 >> 1);
-    }
-
-    return CRC16;
+#include "w25qxx.h"
+
+/* Macro */
+#define TOGGLE_BIT(REG, BIT)                ((REG) ^= (BIT))
+#define SET_BIT(REG, BIT)                   ((REG) |= (BIT))
+#define CLEAR_BIT(REG, BIT)                 ((REG) &= ~(BIT))
+#define READ_BIT(REG, BIT)                  ((REG) & (BIT))
+#define CLEAR_REG(REG)                      ((REG) = (0x0))
+#define WRITE_REG(REG, VAL)                 ((REG) = (VAL))
+#define READ_REG(REG)                       ((REG))
+#define MODIFY_REG(REG, CLEARMASK, SETMASK) WRITE_REG((REG), (((READ_REG(REG)) & (~(CLEARMASK))) | (SETMASK)))
+#ifdef W25QXX_PART
+#define W25QXX_HANDLE_PAGES W25QXX_NUMBER_OF_PAGES
+#else
+#define W25QXX_HANDLE_PAGES (w25qxx_Handle->numberOfPages)
+#endif
+#define W25QXX_ADDRESS_BYTES_SWAP(ADDRESS)             \
+    do                                                 \
+    {                                                  \
+        addressBytes[0] = (uint8_t) ((ADDRESS) >> 16); \
+        addressBytes[1] = (uint8_t) ((ADDRESS) >> 8);  \
+        addressBytes[2] = (uint8_t) ((ADDRESS) >> 0);  \
+    }                                                  \
+    while (0)
+#define W25QXX_CS_SET(NEW_STATE)                                                                       \
+    do                                                                                                 \
+    {                                                                                                  \
+        if (w25qxx_Handle->interface.cs_set_context != NULL)                                           \
+            w25qxx_Handle->interface.cs_set_context(w25qxx_Handle->interface.cs_context, (NEW_STATE)); \
+        else if (w25qxx_Handle->interface.cs_set != NULL)                                              \
+            w25qxx_Handle->interface.cs_set(NEW_STATE);                                                \
+    }                                                                                                  \
+    while (0)
+#define W25QXX_LOCK                                                              \
+    do                                                                           \
+    {                                                                            \
+        if (w25qxx_Handle->interface.lock != NULL)                               \
+            w25qxx_Handle->interface.lock(w25qxx_Handle->interface.lockContext); \
+        if (w25qxx_Handle->async.stage != W25QXX_ASYNC_IDLE)                     \
+            w25qxx_AsyncFinishLocked(w25qxx_Handle);                             \
+    }                                                                            \
+    while (0)
+#define W25QXX_UNLOCK                                                              \
+    do                                                                             \
+    {                                                                              \
+        if (w25qxx_Handle->interface.unlock != NULL)                               \
+            w25qxx_Handle->interface.unlock(w25qxx_Handle->interface.lockContext); \
+    }                                                                              \
+    while (0)
+#define W25QXX_LAZY_INIT                                                            \
+    do                                                                              \
+    {                                                                               \
+        if (w25qxx_Handle->lazyInit && (w25qxx_Handle->error == W25QXX_ERROR_NONE)) \
+            w25qxx_InitDeferredLocked(w25qxx_Handle);                               \
+    }                                                                               \
+    while (0)
+#define W25QXX_WAKE                                                                         \
+    do                                                                                      \
+    {                                                                                       \
+        if (w25qxx_Handle->powerDown.active && (w25qxx_Handle->error == W25QXX_ERROR_NONE)) \
+            w25qxx_WakeLocked(w25qxx_Handle);                                               \
+        if (w25qxx_Handle->interface.tick != NULL)                                          \
+            w25qxx_Handle->powerDown.lastAccess = w25qxx_Handle->interface.tick();          \
+    }                                                                                       \
+    while (0)
+#define W25QXX_ERROR_SET(W25QXX_ERROR)                \
+    do                                                \
+    {                                                 \
+        W25QXX_CS_SET(W25QXX_CS_HIGH);                \
+        return w25qxx_Handle->error = (W25QXX_ERROR); \
+    }                                                 \
+    while (0)
+#define W25QXX_ERROR_CHECK                             \
+    do                                                 \
+    {                                                  \
+        if (w25qxx_Handle->error != W25QXX_ERROR_NONE) \
+            W25QXX_ERROR_SET(w25qxx_Handle->error);    \
+    }                                                  \
+    while (0)
+#define W25QXX_BEGIN_TRANSMIT(DATA_SOURCE, SIZE, TIMEOUT)                                                           \
+    do                                                                                                              \
+    {                                                                                                               \
+        if (w25qxx_Handle->interface.transmit(w25qxx_Handle->interface.handle, (DATA_SOURCE), (SIZE), (TIMEOUT)) != \
+            W25QXX_TRANSFER_SUCCESS)                                                                                \
+            W25QXX_ERROR_SET(W25QXX_ERROR_SPI);                                                                     \
+    }                                                                                                               \
+    while (0)
+#define W25QXX_BEGIN_RECEIVE(DATA_DESTINATION, SIZE, TIMEOUT)                                             \
+    do                                                                                                    \
+    {                                                                                                     \
+        if (w25qxx_Handle->interface.receive(w25qxx_Handle->interface.handle, (DATA_DESTINATION), (SIZE), \
+                                             (TIMEOUT)) != W25QXX_TRANSFER_SUCCESS)                       \
+            W25QXX_ERROR_SET(W25QXX_ERROR_SPI);                                                           \
+    }                                                                                                     \
+    while (0)
+#define W25QXX_BEGIN_TRANSMIT_QUAD(DATA_SOURCE, SIZE, TIMEOUT)                                             \
+    do                                                                                                     \
+    {                                                                                                      \
+        if (w25qxx_Handle->interface.transmit_quad(w25qxx_Handle->interface.handle, (DATA_SOURCE), (SIZE), \
+                                                   (TIMEOUT)) != W25QXX_TRANSFER_SUCCESS)                  \
+            W25QXX_ERROR_SET(W25QXX_ERROR_SPI);                                                            \
+    }                                                                                                      \
+    while (0)
+#define W25QXX_BEGIN_RECEIVE_QUAD(DATA_DESTINATION, SIZE, TIMEOUT)                                             \
+    do                                                                                                         \
+    {                                                                                                          \
+        if (w25qxx_Handle->interface.receive_quad(w25qxx_Handle->interface.handle, (DATA_DESTINATION), (SIZE), \
+                                                  (TIMEOUT)) != W25QXX_TRANSFER_SUCCESS)                       \
+            W25QXX_ERROR_SET(W25QXX_ERROR_SPI);                                                                \
+    }                                                                                                          \
+    while (0)
+
+/* Instruction Set */
+#define W25QXX_CMD_WRITE_ENABLE              0x06
+#define W25QXX_CMD_VOLATILE_SR_WRITE_ENABLE  0x50
+#define W25QXX_CMD_WRITE_DISABLE             0x04
+#define W25QXX_CMD_RELEASE_POWER_DOWN        0xAB
+#define W25QXX_CMD_MANUFACTURER_DEVICE_ID    0x90
+#define W25QXX_CMD_JEDEC_ID                  0x9F
+#define W25QXX_CMD_READ_UNIQUE_ID            0x4B
+#define W25QXX_CMD_READ_DATA                 0x03
+#define W25QXX_CMD_FAST_READ                 0x0B
+#define W25QXX_CMD_FAST_READ_QUAD_IO         0xEB
+#define W25QXX_CMD_PAGE_PROGRAM              0x02
+#define W25QXX_CMD_QUAD_PAGE_PROGRAM         0x32
+#define W25QXX_CMD_SECTOR_ERASE_4KB          0x20
+#define W25QXX_CMD_BLOCK_ERASE_32KB          0x52
+#define W25QXX_CMD_BLOCK_ERASE_64KB          0xD8
+#define W25QXX_CMD_CHIP_ERASE                0xC7
+#define W25QXX_CMD_READ_STATUS_REGISTER1     0x05
+#define W25QXX_CMD_WRITE_STATUS_REGISTER1    0x01
+#define W25QXX_CMD_READ_STATUS_REGISTER2     0x35
+#define W25QXX_CMD_WRITE_STATUS_REGISTER2    0x31
+#define W25QXX_CMD_READ_STATUS_REGISTER3     0x15
+#define W25QXX_CMD_WRITE_STATUS_REGISTER3    0x11
+#define W25QXX_CMD_READ_SFDP_REGISTER        0x5A
+#define W25QXX_CMD_ERASE_SECURITY_REGISTER   0x44
+#define W25QXX_CMD_PROGRAM_SECURITY_REGISTER 0x42
+#define W25QXX_CMD_READ_SECURITY_REGISTER    0x48
+#define W25QXX_CMD_GLOBAL_BLOCK_LOCK         0x7E
+#define W25QXX_CMD_GLOBAL_BLOCK_UNLOCK       0x98
+#define W25QXX_CMD_READ_BLOCK_LOCK           0x3D
+#define W25QXX_CMD_INDIVIDUAL_BLOCK_LOCK     0x36
+#define W25QXX_CMD_INDIVIDUAL_BLOCK_UNLOCK   0x39
+#define W25QXX_CMD_ERASE_PROGRAM_SUSPEND     0x75
+#define W25QXX_CMD_ERASE_PROGRAM_RESUME      0x7A
+#define W25QXX_CMD_POWER_DOWN                0xB9
+#define W25QXX_CMD_SET_BURST_WITH_WRAP       0x77
+#define W25QXX_CMD_ENABLE_RESET              0x66
+#define W25QXX_CMD_RESET_DEVICE              0x99
+
+/* Register bits */
+#define W25QXX_SR1_WRITABLE            0xFC // BUSY and WEL are not written
+#define W25QXX_SR2_WRITABLE            0x7F // SUS is not written
+#define W25QXX_SR3_WRITABLE            0xFF
+#define W25QXX_SR2_QUAD_ENABLE         (1u << 1)
+#define W25QXX_CONTINUOUS_READ_MODE    0x20 // M5-4 = 10, the next access begins with the address
+#define W25QXX_CONTINUOUS_READ_RESET   0xFF // M7-0 of the mode reset sequence
+#define W25QXX_CONTINUOUS_READ_DUMMIES 2 // 4 dummy clocks of Fast Read Quad I/O
+#define W25QXX_BURST_READ_MODE         0x00 // M5-4 != 10, the next access begins with the instruction
+#define W25QXX_BURST_WRAP_DISABLE      0x10 // W4 = 1
+#define W25QXX_BURST_WRAP_DUMMIES      3 // 24 dummy bits before W7-0
+#define W25QXX_VERIFY_RETRIES          1 // Page programs repeated by `w25qxx_WriteVerify()` on mismatch
+
+/* Timeouts [ms] */
+#define W25QXX_TX_TIMEOUT       100
+#define W25QXX_RX_TIMEOUT       100
+#define W25QXX_RESPONSE_TIMEOUT 100
+#define W25QXX_ASYNC_POLL       100 // Poll period of the transfer in flight [us]
+
+static w25qxx_Error_t w25qxx_InitLocked(w25qxx_HandleTypeDef *w25qxx_Handle);
+static w25qxx_Error_t w25qxx_InitFastLocked(w25qxx_HandleTypeDef *w25qxx_Handle, w25qxx_Defer_t defer);
+static w25qxx_Error_t w25qxx_InitDeferredLocked(w25qxx_HandleTypeDef *w25qxx_Handle);
+static w25qxx_Error_t w25qxx_WriteLocked(w25qxx_HandleTypeDef *w25qxx_Handle, const uint8_t *buf, uint16_t dataLength,
+                                         uint32_t address, w25qxx_CRC_t trailingCRC, w25qxx_WaitForTask_t waitForTask);
+static w25qxx_Error_t w25qxx_WriteVerifyLocked(w25qxx_HandleTypeDef *w25qxx_Handle, const uint8_t *buf,
+                                               uint16_t dataLength, uint32_t address, w25qxx_CRC_t trailingCRC,
+                                               uint16_t *mismatchOffset);
+static w25qxx_Error_t w25qxx_WriteVLocked(w25qxx_HandleTypeDef *w25qxx_Handle, const w25qxx_IoVec_t *iov,
+                                          uint16_t iovCount, uint32_t address, w25qxx_WaitForTask_t waitForTask);
+static w25qxx_Error_t w25qxx_SetWriteBusWidthLocked(w25qxx_HandleTypeDef *w25qxx_Handle, w25qxx_BusWidth_t busWidth);
+static w25qxx_Error_t w25qxx_ReadLocked(w25qxx_HandleTypeDef *w25qxx_Handle, uint8_t *buf, uint16_t dataLength,
+                                        uint32_t address, w25qxx_CRC_t trailingCRC, w25qxx_FastRead_t fastRead);
+static w25qxx_Error_t w25qxx_ReadStreamLocked(w25qxx_HandleTypeDef *w25qxx_Handle, uint8_t *buf, uint32_t dataLength,
+                                              uint32_t address, w25qxx_FastRead_t fastRead);
+static w25qxx_Error_t w25qxx_ReadVLocked(w25qxx_HandleTypeDef *w25qxx_Handle, const w25qxx_IoVec_t *iov,
+                                         uint16_t iovCount, uint32_t address, w25qxx_FastRead_t fastRead);
+static w25qxx_Error_t w25qxx_ReadBatchLocked(w25qxx_HandleTypeDef *w25qxx_Handle, w25qxx_ReadRequest_t *requests,
+                                             uint16_t numberOfRequests, w25qxx_FastRead_t fastRead);
+static w25qxx_Error_t w25qxx_WriteAsyncLocked(w25qxx_HandleTypeDef *w25qxx_Handle, const uint8_t *buf,
+                                              uint16_t dataLength, uint32_t address, w25qxx_CRC_t trailingCRC,
+                                              w25qxx_async_complete_fp complete, void *context);
+static w25qxx_Error_t w25qxx_ReadAsyncLocked(w25qxx_HandleTypeDef *w25qxx_Handle, uint8_t *buf, uint16_t dataLength,
+                                             uint32_t address, w25qxx_CRC_t trailingCRC, w25qxx_FastRead_t fastRead,
+                                             w25qxx_async_complete_fp complete, void *context);
+static w25qxx_Error_t w25qxx_AsyncFinishLocked(w25qxx_HandleTypeDef *w25qxx_Handle);
+static w25qxx_Error_t w25qxx_ContinuousReadBeginLocked(w25qxx_HandleTypeDef *w25qxx_Handle);
+static w25qxx_Error_t w25qxx_ContinuousReadLocked(w25qxx_HandleTypeDef *w25qxx_Handle, uint8_t *buf,
+                                                  uint16_t dataLength, uint32_t address);
+static w25qxx_Error_t w25qxx_ContinuousReadEndLocked(w25qxx_HandleTypeDef *w25qxx_Handle);
+static w25qxx_Error_t w25qxx_SetBurstWrapLocked(w25qxx_HandleTypeDef *w25qxx_Handle, w25qxx_BurstWrap_t burstWrap);
+static w25qxx_Error_t w25qxx_ReadBurstLocked(w25qxx_HandleTypeDef *w25qxx_Handle, uint8_t *buf, uint16_t dataLength,
+                                             uint32_t address);
+static w25qxx_Error_t w25qxx_EraseLocked(w25qxx_HandleTypeDef *w25qxx_Handle,
+                                         w25qxx_EraseInstruction_t eraseInstruction, uint32_t address,
+                                         w25qxx_WaitForTask_t waitForTask);
+static w25qxx_Error_t w25qxx_WriteStatusLocked(w25qxx_HandleTypeDef *w25qxx_Handle, uint8_t statusRegisterx,
+                                               uint8_t value, w25qxx_SR_Behaviour_t statusRegisterBehaviour);
+static w25qxx_Error_t w25qxx_ReadStatusLocked(w25qxx_HandleTypeDef *w25qxx_Handle, uint8_t statusRegisterx,
+                                              uint8_t *value);
+static w25qxx_Error_t w25qxx_ResetErrorLocked(w25qxx_HandleTypeDef *w25qxx_Handle);
+static w25qxx_Status_t w25qxx_BusyCheckLocked(w25qxx_HandleTypeDef *w25qxx_Handle, uint32_t timeout);
+static w25qxx_Error_t w25qxx_PowerDownLocked(w25qxx_HandleTypeDef *w25qxx_Handle);
+static w25qxx_Error_t w25qxx_PowerServiceLocked(w25qxx_HandleTypeDef *w25qxx_Handle);
+static w25qxx_Error_t w25qxx_WakeLocked(w25qxx_HandleTypeDef *w25qxx_Handle);
+static w25qxx_Error_t w25qxx_ReleasePowerDown(w25qxx_HandleTypeDef *w25qxx_Handle);
+static w25qxx_Error_t w25qxx_ResetDevice(w25qxx_HandleTypeDef *w25qxx_Handle);
+static w25qxx_Error_t w25qxx_ContinuousReadReset(w25qxx_HandleTypeDef *w25qxx_Handle);
+static w25qxx_Error_t w25qxx_QuadCheck(w25qxx_HandleTypeDef *w25qxx_Handle);
+static w25qxx_Error_t w25qxx_BurstWrapSend(w25qxx_HandleTypeDef *w25qxx_Handle, uint8_t wrapBits);
+static w25qxx_Error_t w25qxx_IoVecLength(w25qxx_HandleTypeDef *w25qxx_Handle, const w25qxx_IoVec_t *iov,
+                                         uint16_t iovCount, uint32_t *dataLength);
+static w25qxx_Error_t w25qxx_VerifyFrame(w25qxx_HandleTypeDef *w25qxx_Handle, const uint8_t *buf, uint16_t dataLength,
+                                         uint32_t address, w25qxx_CRC_t trailingCRC, uint16_t *mismatchOffset,
+                                         bool *programmable);
+static w25qxx_Error_t w25qxx_StatusShadowRead(w25qxx_HandleTypeDef *w25qxx_Handle, uint8_t statusRegisterx);
+static w25qxx_Error_t w25qxx_ReadID(w25qxx_HandleTypeDef *w25qxx_Handle);
+static w25qxx_Error_t w25qxx_WriteEnable(w25qxx_HandleTypeDef *w25qxx_Handle);
+// static w25qxx_Error_t w25qxx_WriteDisable(w25qxx_HandleTypeDef *w25qxx_Handle);
+static w25qxx_Error_t w25qxx_StatusUpdate(w25qxx_HandleTypeDef *w25qxx_Handle, w25qxx_Status_t statusCheck,
+                                          w25qxx_Status_t statusSet);
+static void Print(w25qxx_HandleTypeDef *w25qxx_Handle, const char *message);
+static void DelayUs(w25qxx_HandleTypeDef *w25qxx_Handle, uint32_t us);
+
+w25qxx_Error_t w25qxx_Init(w25qxx_HandleTypeDef *w25qxx_Handle)
+{
+    w25qxx_Error_t error;
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    W25QXX_LOCK;
+    error = w25qxx_InitLocked(w25qxx_Handle);
+    W25QXX_UNLOCK;
+
+    return error;
+}
+
+w25qxx_Error_t w25qxx_InitFast(w25qxx_HandleTypeDef *w25qxx_Handle, w25qxx_Defer_t defer)
+{
+    w25qxx_Error_t error;
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    W25QXX_LOCK;
+    error = w25qxx_InitFastLocked(w25qxx_Handle, defer);
+    W25QXX_UNLOCK;
+
+    return error;
+}
+
+w25qxx_Error_t w25qxx_Write(w25qxx_HandleTypeDef *w25qxx_Handle, const uint8_t *buf, uint16_t dataLength,
+                            uint32_t address, w25qxx_CRC_t trailingCRC, w25qxx_WaitForTask_t waitForTask)
+{
+    w25qxx_Error_t error;
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    W25QXX_LOCK;
+    W25QXX_LAZY_INIT;
+    W25QXX_WAKE;
+    error = w25qxx_WriteLocked(w25qxx_Handle, buf, dataLength, address, trailingCRC, waitForTask);
+    W25QXX_UNLOCK;
+
+    return error;
+}
+
+w25qxx_Error_t w25qxx_WriteVerify(w25qxx_HandleTypeDef *w25qxx_Handle, const uint8_t *buf, uint16_t dataLength,
+                                  uint32_t address, w25qxx_CRC_t trailingCRC, uint16_t *mismatchOffset)
+{
+    w25qxx_Error_t error;
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    W25QXX_LOCK;
+    W25QXX_LAZY_INIT;
+    W25QXX_WAKE;
+    error = w25qxx_WriteVerifyLocked(w25qxx_Handle, buf, dataLength, address, trailingCRC, mismatchOffset);
+    W25QXX_UNLOCK;
+
+    return error;
+}
+
+w25qxx_Error_t w25qxx_WriteV(w25qxx_HandleTypeDef *w25qxx_Handle, const w25qxx_IoVec_t *iov, uint16_t iovCount,
+                             uint32_t address, w25qxx_WaitForTask_t waitForTask)
+{
+    w25qxx_Error_t error;
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    W25QXX_LOCK;
+    W25QXX_LAZY_INIT;
+    W25QXX_WAKE;
+    error = w25qxx_WriteVLocked(w25qxx_Handle, iov, iovCount, address, waitForTask);
+    W25QXX_UNLOCK;
+
+    return error;
+}
+
+w25qxx_Error_t w25qxx_SetWriteBusWidth(w25qxx_HandleTypeDef *w25qxx_Handle, w25qxx_BusWidth_t busWidth)
+{
+    w25qxx_Error_t error;
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    W25QXX_LOCK;
+    W25QXX_LAZY_INIT;
+    W25QXX_WAKE;
+    error = w25qxx_SetWriteBusWidthLocked(w25qxx_Handle, busWidth);
+    W25QXX_UNLOCK;
+
+    return error;
+}
+
+w25qxx_Error_t w25qxx_Read(w25qxx_HandleTypeDef *w25qxx_Handle, uint8_t *buf, uint16_t dataLength, uint32_t address,
+                           w25qxx_CRC_t trailingCRC, w25qxx_FastRead_t fastRead)
+{
+    w25qxx_Error_t error;
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    W25QXX_LOCK;
+    W25QXX_LAZY_INIT;
+    W25QXX_WAKE;
+    error = w25qxx_ReadLocked(w25qxx_Handle, buf, dataLength, address, trailingCRC, fastRead);
+    W25QXX_UNLOCK;
+
+    return error;
+}
+
+w25qxx_Error_t w25qxx_ReadStream(w25qxx_HandleTypeDef *w25qxx_Handle, uint8_t *buf, uint32_t dataLength,
+                                 uint32_t address, w25qxx_FastRead_t fastRead)
+{
+    w25qxx_Error_t error;
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    W25QXX_LOCK;
+    W25QXX_LAZY_INIT;
+    W25QXX_WAKE;
+    error = w25qxx_ReadStreamLocked(w25qxx_Handle, buf, dataLength, address, fastRead);
+    W25QXX_UNLOCK;
+
+    return error;
+}
+
+w25qxx_Error_t w25qxx_ReadV(w25qxx_HandleTypeDef *w25qxx_Handle, const w25qxx_IoVec_t *iov, uint16_t iovCount,
+                            uint32_t address, w25qxx_FastRead_t fastRead)
+{
+    w25qxx_Error_t error;
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    W25QXX_LOCK;
+    W25QXX_LAZY_INIT;
+    W25QXX_WAKE;
+    error = w25qxx_ReadVLocked(w25qxx_Handle, iov, iovCount, address, fastRead);
+    W25QXX_UNLOCK;
+
+    return error;
+}
+
+w25qxx_Error_t w25qxx_ReadBatch(w25qxx_HandleTypeDef *w25qxx_Handle, w25qxx_ReadRequest_t *requests,
+                                uint16_t numberOfRequests, w25qxx_FastRead_t fastRead)
+{
+    w25qxx_Error_t error;
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    W25QXX_LOCK;
+    W25QXX_LAZY_INIT;
+    W25QXX_WAKE;
+    error = w25qxx_ReadBatchLocked(w25qxx_Handle, requests, numberOfRequests, fastRead);
+    W25QXX_UNLOCK;
+
+    return error;
+}
+
+w25qxx_Error_t w25qxx_WriteAsync(w25qxx_HandleTypeDef *w25qxx_Handle, const uint8_t *buf, uint16_t dataLength,
+                                 uint32_t address, w25qxx_CRC_t trailingCRC, w25qxx_async_complete_fp complete,
+                                 void *context)
+{
+    w25qxx_Error_t error;
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    W25QXX_LOCK;
+    W25QXX_LAZY_INIT;
+    W25QXX_WAKE;
+    error = w25qxx_WriteAsyncLocked(w25qxx_Handle, buf, dataLength, address, trailingCRC, complete, context);
+    W25QXX_UNLOCK;
+
+    return error;
+}
+
+w25qxx_Error_t w25qxx_ReadAsync(w25qxx_HandleTypeDef *w25qxx_Handle, uint8_t *buf, uint16_t dataLength,
+                                uint32_t address, w25qxx_CRC_t trailingCRC, w25qxx_FastRead_t fastRead,
+                                w25qxx_async_complete_fp complete, void *context)
+{
+    w25qxx_Error_t error;
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    W25QXX_LOCK;
+    W25QXX_LAZY_INIT;
+    W25QXX_WAKE;
+    error = w25qxx_ReadAsyncLocked(w25qxx_Handle, buf, dataLength, address, trailingCRC, fastRead, complete, context);
+    W25QXX_UNLOCK;
+
+    return error;
+}
+
+w25qxx_Error_t w25qxx_AsyncFinish(w25qxx_HandleTypeDef *w25qxx_Handle)
+{
+    w25qxx_Error_t error;
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    /* Transfer in flight is finished by the lock */
+    W25QXX_LOCK;
+    error = w25qxx_Handle->error;
+    W25QXX_UNLOCK;
+
+    return error;
+}
+
+void w25qxx_TransferComplete(w25qxx_HandleTypeDef *w25qxx_Handle, w25qxx_Transfer_Status_t transferStatus)
+{
+    w25qxx_async_complete_fp complete;
+    w25qxx_Error_t error;
+    uint16_t CRC16;
+    void *context;
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return;
+
+    /* Spurious completion */
+    if ((w25qxx_Handle->async.stage == W25QXX_ASYNC_IDLE) || (w25qxx_Handle->async.stage == W25QXX_ASYNC_DONE))
+        return;
+
+    if (transferStatus != W25QXX_TRANSFER_SUCCESS)
+        w25qxx_Handle->async.error = W25QXX_ERROR_SPI;
+    else if ((w25qxx_Handle->async.stage == W25QXX_ASYNC_DATA) && (w25qxx_Handle->async.trailingCRC == W25QXX_CRC))
+    {
+        /* Checksum is clocked out within the same frame */
+        w25qxx_Handle->async.stage = W25QXX_ASYNC_CRC;
+        if (w25qxx_Handle->status == W25QXX_STATUS_WRITE)
+            transferStatus = w25qxx_Handle->interface.transmit_async(w25qxx_Handle->interface.handle,
+                                                                     (uint8_t *) &w25qxx_Handle->async.CRC16,
+                                                                     sizeof(w25qxx_Handle->async.CRC16), w25qxx_Handle);
+        else
+            transferStatus = w25qxx_Handle->interface.receive_async(w25qxx_Handle->interface.handle,
+                                                                    (uint8_t *) &w25qxx_Handle->async.CRC16,
+                                                                    sizeof(w25qxx_Handle->async.CRC16), w25qxx_Handle);
+        if (transferStatus == W25QXX_TRANSFER_SUCCESS)
+            return;
+        w25qxx_Handle->async.error = W25QXX_ERROR_SPI;
+    }
+    else if ((w25qxx_Handle->status == W25QXX_STATUS_READ) && (w25qxx_Handle->async.trailingCRC == W25QXX_CRC))
+    {
+        /* Checksum compare */
+        CRC16 = w25qxx_CRC16(w25qxx_Handle->async.buf, w25qxx_Handle->async.dataLength);
+        if (memcmp(&w25qxx_Handle->async.CRC16, &CRC16, sizeof(CRC16)) != 0)
+            w25qxx_Handle->async.error = W25QXX_ERROR_CHECKSUM;
+    }
+
+    /* Frame is transferred, the result is published by the stage, /CS and the status are left to the task context
+     * (`w25qxx_AsyncFinishLocked()`) */
+    complete = w25qxx_Handle->async.complete;
+    context = w25qxx_Handle->async.context;
+    error = w25qxx_Handle->async.error;
+    w25qxx_Handle->async.stage = W25QXX_ASYNC_DONE;
+    if (complete != NULL)
+        complete(context, error);
+}
+
+w25qxx_Error_t w25qxx_ContinuousReadBegin(w25qxx_HandleTypeDef *w25qxx_Handle)
+{
+    w25qxx_Error_t error;
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    W25QXX_LOCK;
+    W25QXX_LAZY_INIT;
+    W25QXX_WAKE;
+    error = w25qxx_ContinuousReadBeginLocked(w25qxx_Handle);
+    W25QXX_UNLOCK;
+
+    return error;
+}
+
+w25qxx_Error_t w25qxx_ContinuousRead(w25qxx_HandleTypeDef *w25qxx_Handle, uint8_t *buf, uint16_t dataLength,
+                                     uint32_t address)
+{
+    w25qxx_Error_t error;
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    W25QXX_LOCK;
+    error = w25qxx_ContinuousReadLocked(w25qxx_Handle, buf, dataLength, address);
+    W25QXX_UNLOCK;
+
+    return error;
+}
+
+w25qxx_Error_t w25qxx_ContinuousReadEnd(w25qxx_HandleTypeDef *w25qxx_Handle)
+{
+    w25qxx_Error_t error;
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    W25QXX_LOCK;
+    error = w25qxx_ContinuousReadEndLocked(w25qxx_Handle);
+    W25QXX_UNLOCK;
+
+    return error;
+}
+
+w25qxx_Error_t w25qxx_SetBurstWrap(w25qxx_HandleTypeDef *w25qxx_Handle, w25qxx_BurstWrap_t burstWrap)
+{
+    w25qxx_Error_t error;
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    W25QXX_LOCK;
+    W25QXX_LAZY_INIT;
+    W25QXX_WAKE;
+    error = w25qxx_SetBurstWrapLocked(w25qxx_Handle, burstWrap);
+    W25QXX_UNLOCK;
+
+    return error;
+}
+
+w25qxx_Error_t w25qxx_ReadBurst(w25qxx_HandleTypeDef *w25qxx_Handle, uint8_t *buf, uint16_t dataLength,
+                                uint32_t address)
+{
+    w25qxx_Error_t error;
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    W25QXX_LOCK;
+    W25QXX_LAZY_INIT;
+    W25QXX_WAKE;
+    error = w25qxx_ReadBurstLocked(w25qxx_Handle, buf, dataLength, address);
+    W25QXX_UNLOCK;
+
+    return error;
+}
+
+w25qxx_Error_t w25qxx_Erase(w25qxx_HandleTypeDef *w25qxx_Handle, w25qxx_EraseInstruction_t eraseInstruction,
+                            uint32_t address, w25qxx_WaitForTask_t waitForTask)
+{
+    w25qxx_Error_t error;
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    W25QXX_LOCK;
+    W25QXX_LAZY_INIT;
+    W25QXX_WAKE;
+    error = w25qxx_EraseLocked(w25qxx_Handle, eraseInstruction, address, waitForTask);
+    W25QXX_UNLOCK;
+
+    return error;
+}
+
+w25qxx_Error_t w25qxx_WriteStatus(w25qxx_HandleTypeDef *w25qxx_Handle, uint8_t statusRegisterx, uint8_t value,
+                                  w25qxx_SR_Behaviour_t statusRegisterBehaviour)
+{
+    w25qxx_Error_t error;
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    W25QXX_LOCK;
+    W25QXX_LAZY_INIT;
+    W25QXX_WAKE;
+    error = w25qxx_WriteStatusLocked(w25qxx_Handle, statusRegisterx, value, statusRegisterBehaviour);
+    W25QXX_UNLOCK;
+
+    return error;
+}
+
+w25qxx_Error_t w25qxx_ReadStatus(w25qxx_HandleTypeDef *w25qxx_Handle, uint8_t statusRegisterx, uint8_t *value)
+{
+    w25qxx_Error_t error;
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    W25QXX_LOCK;
+    W25QXX_LAZY_INIT;
+    W25QXX_WAKE;
+    error = w25qxx_ReadStatusLocked(w25qxx_Handle, statusRegisterx, value);
+    W25QXX_UNLOCK;
+
+    return error;
+}
+
+w25qxx_Error_t w25qxx_ResetError(w25qxx_HandleTypeDef *w25qxx_Handle)
+{
+    w25qxx_Error_t error;
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    W25QXX_LOCK;
+    error = w25qxx_ResetErrorLocked(w25qxx_Handle);
+    W25QXX_UNLOCK;
+
+    return error;
+}
+
+w25qxx_Status_t w25qxx_BusyCheck(w25qxx_HandleTypeDef *w25qxx_Handle, uint32_t timeout)
+{
+    w25qxx_Status_t status;
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_STATUS_UNDEFINED;
+
+    W25QXX_LOCK;
+    W25QXX_LAZY_INIT;
+    W25QXX_WAKE;
+    status = w25qxx_BusyCheckLocked(w25qxx_Handle, timeout);
+    W25QXX_UNLOCK;
+
+    return status;
+}
+
+w25qxx_Error_t w25qxx_PowerDown(w25qxx_HandleTypeDef *w25qxx_Handle)
+{
+    w25qxx_Error_t error;
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    W25QXX_LOCK;
+    error = w25qxx_PowerDownLocked(w25qxx_Handle);
+    W25QXX_UNLOCK;
+
+    return error;
+}
+
+w25qxx_Error_t w25qxx_PowerService(w25qxx_HandleTypeDef *w25qxx_Handle)
+{
+    w25qxx_Error_t error;
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    W25QXX_LOCK;
+    error = w25qxx_PowerServiceLocked(w25qxx_Handle);
+    W25QXX_UNLOCK;
+
+    return error;
+}
+
+uint16_t w25qxx_CRC16(const uint8_t *pBuffer, uint16_t bufSize)
+{
+    uint16_t CRC16 = 0xffff;
+    uint16_t i, j;
+
+    for (i = 0; i < bufSize; i++)
+    {
+        CRC16 ^= pBuffer[i];
+
+        for (j = 0; j < 8; j++)
+            if (CRC16 & 1)
+                CRC16 = (CRC16 >> 1) ^ 0xA001;
+            else
+                CRC16 = (CRC16 >> 1);
+    }
+
+    return CRC16;
+}
+
+/**
+ * @section Private functions
+ */
+static w25qxx_Error_t w25qxx_InitLocked(w25qxx_HandleTypeDef *w25qxx_Handle)
+{
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    if (w25qxx_StatusUpdate(w25qxx_Handle, W25QXX_STATUS_RESET, W25QXX_STATUS_INIT) != W25QXX_ERROR_NONE)
+        W25QXX_ERROR_SET(w25qxx_Handle->error);
+
+    /* Check platform functions */
+    if (w25qxx_Handle->interface.receive == NULL)
+        W25QXX_ERROR_SET(W25QXX_ERROR_PLATFORM);
+    if (w25qxx_Handle->interface.transmit == NULL)
+        W25QXX_ERROR_SET(W25QXX_ERROR_PLATFORM);
+    if ((w25qxx_Handle->interface.cs_set == NULL) && (w25qxx_Handle->interface.cs_set_context == NULL))
+        W25QXX_ERROR_SET(W25QXX_ERROR_PLATFORM);
+    if (w25qxx_Handle->interface.delay == NULL)
+        W25QXX_ERROR_SET(W25QXX_ERROR_PLATFORM);
+
+    /* Start operation */
+    w25qxx_Handle->lazyInit = false;
+    w25qxx_Handle->powerDown.active = false;
+    memset(&w25qxx_Handle->statusShadow, 0, sizeof(w25qxx_Handle->statusShadow));
+    W25QXX_CS_SET(W25QXX_CS_HIGH);
+    w25qxx_Delay(100);
+    w25qxx_ContinuousReadReset(w25qxx_Handle);
+    w25qxx_ReleasePowerDown(w25qxx_Handle);
+    w25qxx_ResetDevice(w25qxx_Handle);
+
+    /* Get the Manufacturer ID and Device ID */
+    w25qxx_ReadID(w25qxx_Handle);
+    w25qxx_Delay(10);
+    
+    return w25qxx_StatusUpdate(w25qxx_Handle, W25QXX_STATUS_INIT, W25QXX_STATUS_READY);
+}
+
+static w25qxx_Error_t w25qxx_InitFastLocked(w25qxx_HandleTypeDef *w25qxx_Handle, w25qxx_Defer_t defer)
+{
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    if (w25qxx_StatusUpdate(w25qxx_Handle, W25QXX_STATUS_RESET, W25QXX_STATUS_INIT) != W25QXX_ERROR_NONE)
+        W25QXX_ERROR_SET(w25qxx_Handle->error);
+
+    /* Check platform functions */
+    if (w25qxx_Handle->interface.receive == NULL)
+        W25QXX_ERROR_SET(W25QXX_ERROR_PLATFORM);
+    if (w25qxx_Handle->interface.transmit == NULL)
+        W25QXX_ERROR_SET(W25QXX_ERROR_PLATFORM);
+    if ((w25qxx_Handle->interface.cs_set == NULL) && (w25qxx_Handle->interface.cs_set_context == NULL))
+        W25QXX_ERROR_SET(W25QXX_ERROR_PLATFORM);
+    if (w25qxx_Handle->interface.delay == NULL)
+        W25QXX_ERROR_SET(W25QXX_ERROR_PLATFORM);
+
+#ifdef W25QXX_PART
+    w25qxx_Handle->numberOfPages = W25QXX_NUMBER_OF_PAGES;
+#endif
+    w25qxx_Handle->lazyInit = true;
+    w25qxx_Handle->powerDown.active = false;
+
+    /* Device is not reset if idle, volatile content of the previous session may be left */
+    memset(&w25qxx_Handle->statusShadow, 0, sizeof(w25qxx_Handle->statusShadow));
+    w25qxx_Handle->statusShadow.volatileWritten = 0x07;
+    if (defer == W25QXX_DEFER)
+        return w25qxx_Handle->error;
+
+    return w25qxx_InitDeferredLocked(w25qxx_Handle);
+}
+
+static w25qxx_Error_t w25qxx_InitDeferredLocked(w25qxx_HandleTypeDef *w25qxx_Handle)
+{
+    uint8_t CMD, statusRegister[2];
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    /* Warm MCU reset may leave the device in continuous read mode, where instructions are taken as address */
+    W25QXX_CS_SET(W25QXX_CS_HIGH);
+    w25qxx_ContinuousReadReset(w25qxx_Handle);
+    W25QXX_ERROR_CHECK;
+
+    /* Start operation, the device needs only tRES1 to leave the power-down */
+    w25qxx_ReleasePowerDown(w25qxx_Handle);
+    W25QXX_ERROR_CHECK;
+
+    /* Reset is needed only if the previous session left an operation in progress or suspended */
+    CMD = W25QXX_CMD_READ_STATUS_REGISTER1;
+    W25QXX_CS_SET(W25QXX_CS_LOW);
+    W25QXX_BEGIN_TRANSMIT(&CMD, sizeof(CMD), W25QXX_TX_TIMEOUT);
+    W25QXX_BEGIN_RECEIVE(&statusRegister[0], sizeof(statusRegister[0]), W25QXX_RX_TIMEOUT);
+    W25QXX_CS_SET(W25QXX_CS_HIGH);
+    CMD = W25QXX_CMD_READ_STATUS_REGISTER2;
+    W25QXX_CS_SET(W25QXX_CS_LOW);
+    W25QXX_BEGIN_TRANSMIT(&CMD, sizeof(CMD), W25QXX_TX_TIMEOUT);
+    W25QXX_BEGIN_RECEIVE(&statusRegister[1], sizeof(statusRegister[1]), W25QXX_RX_TIMEOUT);
+    W25QXX_CS_SET(W25QXX_CS_HIGH);
+    if (READ_BIT(statusRegister[0], 1u << 0) || READ_BIT(statusRegister[1], 1u << 7))
+        w25qxx_ResetDevice(w25qxx_Handle);
+
+    /* Burst wrap left by the previous session would break linear quad reads */
+    if (w25qxx_Handle->interface.transmit_quad != NULL)
+        w25qxx_BurstWrapSend(w25qxx_Handle, W25QXX_BURST_WRAP_DISABLE);
+    w25qxx_Handle->burstWrap = W25QXX_WRAP_NO;
+
+    /* Get the Manufacturer ID and Device ID */
+    w25qxx_ReadID(w25qxx_Handle);
+    W25QXX_ERROR_CHECK;
+    w25qxx_Handle->lazyInit = false;
+
+    return w25qxx_StatusUpdate(w25qxx_Handle, W25QXX_STATUS_INIT, W25QXX_STATUS_READY);
+}
+
+static w25qxx_Error_t w25qxx_WriteLocked(w25qxx_HandleTypeDef *w25qxx_Handle, const uint8_t *buf, uint16_t dataLength,
+                                         uint32_t address, w25qxx_CRC_t trailingCRC, w25qxx_WaitForTask_t waitForTask)
+{
+    uint16_t frameLength, CRC16 = 0;
+    uint8_t CMD, addressBytes[3];
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    if (w25qxx_StatusUpdate(w25qxx_Handle, W25QXX_STATUS_READY, W25QXX_STATUS_WRITE) != W25QXX_ERROR_NONE)
+        W25QXX_ERROR_SET(w25qxx_Handle->error);
+
+    /* Argument guards */
+    if (buf == NULL)
+        W25QXX_ERROR_SET(W25QXX_ERROR_ARGUMENT);
+    if (dataLength == 0)
+        W25QXX_ERROR_SET(W25QXX_ERROR_ARGUMENT);
+    frameLength = dataLength;
+    if (trailingCRC == W25QXX_CRC)
+        frameLength += sizeof(CRC16);
+    if (frameLength > W25QXX_PAGE_SIZE)
+        W25QXX_ERROR_SET(W25QXX_ERROR_ARGUMENT);
+    if ((address % W25QXX_PAGE_SIZE) != 0)
+        W25QXX_ERROR_SET(W25QXX_ERROR_ADDRESS);
+    if (address > (W25QXX_PAGE_SIZE * (W25QXX_HANDLE_PAGES - 1)))
+        W25QXX_ERROR_SET(W25QXX_ERROR_ADDRESS);
+
+    /* Checksum calculate */
+    if (trailingCRC == W25QXX_CRC)
+        CRC16 = w25qxx_CRC16(buf, dataLength);
+
+    /* Command */
+    w25qxx_WriteEnable(w25qxx_Handle);
+    W25QXX_ERROR_CHECK;
+    CMD = (w25qxx_Handle->writeBusWidth == W25QXX_BUS_QUAD) ? W25QXX_CMD_QUAD_PAGE_PROGRAM : W25QXX_CMD_PAGE_PROGRAM;
+    W25QXX_CS_SET(W25QXX_CS_LOW);
+    W25QXX_BEGIN_TRANSMIT(&CMD, sizeof(CMD), W25QXX_TX_TIMEOUT);
+
+    /* A23-A0 - Start address of the desired page */
+    W25QXX_ADDRESS_BYTES_SWAP(address);
+    W25QXX_BEGIN_TRANSMIT(addressBytes, sizeof(addressBytes), W25QXX_TX_TIMEOUT);
+
+    /* Data and checksum, on IO0-IO3 in case of Quad Input Page Program */
+    if (w25qxx_Handle->writeBusWidth == W25QXX_BUS_QUAD)
+    {
+        W25QXX_BEGIN_TRANSMIT_QUAD((uint8_t *) buf, dataLength, W25QXX_TX_TIMEOUT);
+        if (trailingCRC == W25QXX_CRC)
+            W25QXX_BEGIN_TRANSMIT_QUAD((uint8_t *) &CRC16, sizeof(CRC16), W25QXX_TX_TIMEOUT);
+    }
+    else
+    {
+        W25QXX_BEGIN_TRANSMIT((uint8_t *) buf, dataLength, W25QXX_TX_TIMEOUT);
+        if (trailingCRC == W25QXX_CRC)
+            W25QXX_BEGIN_TRANSMIT((uint8_t *) &CRC16, sizeof(CRC16), W25QXX_TX_TIMEOUT);
+    }
+    W25QXX_CS_SET(W25QXX_CS_HIGH);
+
+    /* Task wait */
+    switch (waitForTask)
+    {
+    case W25QXX_WAIT_NO:
+        break;
+
+    case W25QXX_WAIT_DELAY:
+        w25qxx_Delay(W25QXX_PAGE_PROGRAM_TIME);
+        break;
+
+    case W25QXX_WAIT_BUSY:
+        if (w25qxx_BusyCheckLocked(w25qxx_Handle, W25QXX_PAGE_PROGRAM_TIME) != W25QXX_STATUS_READY)
+            W25QXX_ERROR_SET(W25QXX_ERROR_TIMEOUT);
+        break;
+
+    default:
+        W25QXX_ERROR_SET(W25QXX_ERROR_ARGUMENT);
+        break;
+    }
+
+    return w25qxx_StatusUpdate(w25qxx_Handle, W25QXX_STATUS_WRITE, W25QXX_STATUS_READY);
+}
+
+static w25qxx_Error_t w25qxx_WriteVerifyLocked(w25qxx_HandleTypeDef *w25qxx_Handle, const uint8_t *buf,
+                                               uint16_t dataLength, uint32_t address, w25qxx_CRC_t trailingCRC,
+                                               uint16_t *mismatchOffset)
+{
+    uint16_t frameLength, offset = 0;
+    uint8_t attempt;
+    bool programmable = false;
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    frameLength = dataLength;
+    if (trailingCRC == W25QXX_CRC)
+        frameLength += sizeof(uint16_t);
+
+    for (attempt = 0; attempt <= W25QXX_VERIFY_RETRIES; attempt++)
+    {
+        /* Argument guards are done by the page program */
+        if (w25qxx_WriteLocked(w25qxx_Handle, buf, dataLength, address, trailingCRC, W25QXX_WAIT_BUSY) !=
+            W25QXX_ERROR_NONE)
+            return w25qxx_Handle->error;
+        if (w25qxx_VerifyFrame(w25qxx_Handle, buf, dataLength, address, trailingCRC, &offset, &programmable) !=
+            W25QXX_ERROR_NONE)
+            return w25qxx_Handle->error;
+        if (offset == frameLength)
+            return w25qxx_Handle->error;
+
+        /* Page program can't turn 0 back to 1, the retry is useless on a page that was not erased */
+        if (!programmable)
+            break;
+    }
+    if (mismatchOffset != NULL)
+        *mismatchOffset = offset;
+
+    return w25qxx_Handle->error = W25QXX_ERROR_VERIFY;
+}
+
+static w25qxx_Error_t w25qxx_WriteVLocked(w25qxx_HandleTypeDef *w25qxx_Handle, const w25qxx_IoVec_t *iov,
+                                          uint16_t iovCount, uint32_t address, w25qxx_WaitForTask_t waitForTask)
+{
+    uint32_t dataLength, offset = 0;
+    uint16_t index = 0, pageLength, chunkLength, remaining;
+    uint8_t CMD, addressBytes[3];
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    if (w25qxx_StatusUpdate(w25qxx_Handle, W25QXX_STATUS_READY, W25QXX_STATUS_WRITE) != W25QXX_ERROR_NONE)
+        W25QXX_ERROR_SET(w25qxx_Handle->error);
+
+    /* Argument guards */
+    if (w25qxx_IoVecLength(w25qxx_Handle, iov, iovCount, &dataLength) != W25QXX_ERROR_NONE)
+        return w25qxx_Handle->error;
+    if (((uint64_t) address + dataLength) > ((uint64_t) W25QXX_PAGE_SIZE * W25QXX_HANDLE_PAGES))
+        W25QXX_ERROR_SET(W25QXX_ERROR_ADDRESS);
+    if (waitForTask > W25QXX_WAIT_BUSY)
+        W25QXX_ERROR_SET(W25QXX_ERROR_ARGUMENT);
+
+    while (dataLength > 0)
+    {
+        /* Page program wraps within the page, so the range is split at page boundaries */
+        pageLength = (uint16_t) (W25QXX_PAGE_SIZE - (address % W25QXX_PAGE_SIZE));
+        if (pageLength > dataLength)
+            pageLength = (uint16_t) dataLength;
+
+        /* Command */
+        w25qxx_WriteEnable(w25qxx_Handle);
+        W25QXX_ERROR_CHECK;
+        CMD =
+            (w25qxx_Handle->writeBusWidth == W25QXX_BUS_QUAD) ? W25QXX_CMD_QUAD_PAGE_PROGRAM : W25QXX_CMD_PAGE_PROGRAM;
+        W25QXX_CS_SET(W25QXX_CS_LOW);
+        W25QXX_BEGIN_TRANSMIT(&CMD, sizeof(CMD), W25QXX_TX_TIMEOUT);
+
+        /* A23-A0 - Start address within the page */
+        W25QXX_ADDRESS_BYTES_SWAP(address);
+        W25QXX_BEGIN_TRANSMIT(addressBytes, sizeof(addressBytes), W25QXX_TX_TIMEOUT);
+
+        /* Data gathered from the buffers within the same frame */
+        for (remaining = pageLength; remaining > 0; remaining -= chunkLength)
+        {
+            /* Next buffer, empty ones are skipped */
+            while (offset == iov[index].length)
+            {
+                index++;
+                offset = 0;
+            }
+            chunkLength = remaining;
+            if ((iov[index].length - offset) < remaining)
+                chunkLength = (uint16_t) (iov[index].length - offset);
+            if (w25qxx_Handle->writeBusWidth == W25QXX_BUS_QUAD)
+                W25QXX_BEGIN_TRANSMIT_QUAD((uint8_t *) iov[index].buf + offset, chunkLength, W25QXX_TX_TIMEOUT);
+            else
+                W25QXX_BEGIN_TRANSMIT((uint8_t *) iov[index].buf + offset, chunkLength, W25QXX_TX_TIMEOUT);
+            offset += chunkLength;
+        }
+        W25QXX_CS_SET(W25QXX_CS_HIGH);
+        address += pageLength;
+        dataLength -= pageLength;
+
+        /* Task wait, the next page program is not accepted while busy */
+        if ((dataLength > 0) || (waitForTask == W25QXX_WAIT_BUSY))
+        {
+            if (w25qxx_BusyCheckLocked(w25qxx_Handle, W25QXX_PAGE_PROGRAM_TIME) != W25QXX_STATUS_READY)
+                W25QXX_ERROR_SET(W25QXX_ERROR_TIMEOUT);
+        }
+        else if (waitForTask == W25QXX_WAIT_DELAY)
+            w25qxx_Delay(W25QXX_PAGE_PROGRAM_TIME);
+    }
+
+    return w25qxx_StatusUpdate(w25qxx_Handle, W25QXX_STATUS_WRITE, W25QXX_STATUS_READY);
+}
+
+static w25qxx_Error_t w25qxx_SetWriteBusWidthLocked(w25qxx_HandleTypeDef *w25qxx_Handle, w25qxx_BusWidth_t busWidth)
+{
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    /* Existing errors check */
+    if (w25qxx_Handle->error != W25QXX_ERROR_NONE)
+        return w25qxx_Handle->error;
+
+    /* Argument guards */
+    switch (busWidth)
+    {
+    case W25QXX_BUS_SINGLE:
+        break;
+
+    case W25QXX_BUS_QUAD:
+        /* Quad bus and QE bit are checked once here instead of each page program */
+        if (w25qxx_QuadCheck(w25qxx_Handle) != W25QXX_ERROR_NONE)
+            return w25qxx_Handle->error;
+        break;
+
+    default:
+        W25QXX_ERROR_SET(W25QXX_ERROR_ARGUMENT);
+        break;
+    }
+    w25qxx_Handle->writeBusWidth = busWidth;
+
+    return w25qxx_Handle->error;
+}
+
+static w25qxx_Error_t w25qxx_ReadLocked(w25qxx_HandleTypeDef *w25qxx_Handle, uint8_t *buf, uint16_t dataLength,
+                                        uint32_t address, w25qxx_CRC_t trailingCRC, w25qxx_FastRead_t fastRead)
+{
+    uint16_t frameLength, CRC16, receivedCRC16;
+    uint8_t CMD, addressBytes[3];
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    if (w25qxx_StatusUpdate(w25qxx_Handle, W25QXX_STATUS_READY, W25QXX_STATUS_READ) != W25QXX_ERROR_NONE)
+        W25QXX_ERROR_SET(w25qxx_Handle->error);
+
+    /* Argument guards */
+    if (buf == NULL)
+        W25QXX_ERROR_SET(W25QXX_ERROR_ARGUMENT);
+    if (dataLength == 0)
+        W25QXX_ERROR_SET(W25QXX_ERROR_ARGUMENT);
+    frameLength = dataLength;
+    if (trailingCRC == W25QXX_CRC)
+        frameLength += sizeof(CRC16);
+    if (frameLength > W25QXX_PAGE_SIZE)
+        W25QXX_ERROR_SET(W25QXX_ERROR_ARGUMENT);
+    if ((address % W25QXX_PAGE_SIZE) != 0)
+        W25QXX_ERROR_SET(W25QXX_ERROR_ADDRESS);
+    if (address > (W25QXX_PAGE_SIZE * (W25QXX_HANDLE_PAGES - 1)))
+        W25QXX_ERROR_SET(W25QXX_ERROR_ADDRESS);
+
+    /* Command */
+    CMD = (fastRead == W25QXX_FASTREAD) ? W25QXX_CMD_FAST_READ : W25QXX_CMD_READ_DATA;
+    W25QXX_CS_SET(W25QXX_CS_LOW);
+    W25QXX_BEGIN_TRANSMIT(&CMD, sizeof(CMD), W25QXX_TX_TIMEOUT);
+
+    /* A23-A0 - Start address of the desired page */
+    W25QXX_ADDRESS_BYTES_SWAP(address);
+    W25QXX_BEGIN_TRANSMIT(addressBytes, sizeof(addressBytes), W25QXX_TX_TIMEOUT);
+
+    /* 8 dummy clocks */
+    if (fastRead == W25QXX_FASTREAD)
+        W25QXX_BEGIN_TRANSMIT(&CMD, sizeof(CMD), W25QXX_TX_TIMEOUT);
+
+    /* Data receive straight to the destination buffer, checksum is clocked out within the same frame */
+    W25QXX_BEGIN_RECEIVE(buf, dataLength, W25QXX_RX_TIMEOUT);
+    if (trailingCRC == W25QXX_CRC)
+        W25QXX_BEGIN_RECEIVE((uint8_t *) &receivedCRC16, sizeof(receivedCRC16), W25QXX_RX_TIMEOUT);
+    W25QXX_CS_SET(W25QXX_CS_HIGH);
+
+    /* Checksum compare */
+    if (trailingCRC == W25QXX_CRC)
+    {
+        CRC16 = w25qxx_CRC16(buf, dataLength);
+        if (memcmp(&receivedCRC16, &CRC16, sizeof(CRC16)) != 0)
+            W25QXX_ERROR_SET(W25QXX_ERROR_CHECKSUM);
+    }
+
+    return w25qxx_StatusUpdate(w25qxx_Handle, W25QXX_STATUS_READ, W25QXX_STATUS_READY);
+}
+
+static w25qxx_Error_t w25qxx_ReadStreamLocked(w25qxx_HandleTypeDef *w25qxx_Handle, uint8_t *buf, uint32_t dataLength,
+                                              uint32_t address, w25qxx_FastRead_t fastRead)
+{
+    uint16_t chunkLength;
+    uint8_t CMD, addressBytes[3];
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    if (w25qxx_StatusUpdate(w25qxx_Handle, W25QXX_STATUS_READY, W25QXX_STATUS_READ) != W25QXX_ERROR_NONE)
+        W25QXX_ERROR_SET(w25qxx_Handle->error);
+
+    /* Argument guards */
+    if (buf == NULL)
+        W25QXX_ERROR_SET(W25QXX_ERROR_ARGUMENT);
+    if (dataLength == 0)
+        W25QXX_ERROR_SET(W25QXX_ERROR_ARGUMENT);
+    if (((uint64_t) address + dataLength) > ((uint64_t) W25QXX_PAGE_SIZE * W25QXX_HANDLE_PAGES))
+        W25QXX_ERROR_SET(W25QXX_ERROR_ADDRESS);
+
+    /* Command */
+    CMD = (fastRead == W25QXX_FASTREAD) ? W25QXX_CMD_FAST_READ : W25QXX_CMD_READ_DATA;
+    W25QXX_CS_SET(W25QXX_CS_LOW);
+    W25QXX_BEGIN_TRANSMIT(&CMD, sizeof(CMD), W25QXX_TX_TIMEOUT);
+
+    /* A23-A0 - Start address, any byte */
+    W25QXX_ADDRESS_BYTES_SWAP(address);
+    W25QXX_BEGIN_TRANSMIT(addressBytes, sizeof(addressBytes), W25QXX_TX_TIMEOUT);
+
+    /* 8 dummy clocks */
+    if (fastRead == W25QXX_FASTREAD)
+        W25QXX_BEGIN_TRANSMIT(&CMD, sizeof(CMD), W25QXX_TX_TIMEOUT);
+
+    /* Data receive, the address is incremented by device across page boundaries */
+    while (dataLength > 0)
+    {
+        chunkLength = (dataLength > UINT16_MAX) ? UINT16_MAX : (uint16_t) dataLength;
+        W25QXX_BEGIN_RECEIVE(buf, chunkLength, W25QXX_RX_TIMEOUT);
+        buf += chunkLength;
+        dataLength -= chunkLength;
+    }
+    W25QXX_CS_SET(W25QXX_CS_HIGH);
+
+    return w25qxx_StatusUpdate(w25qxx_Handle, W25QXX_STATUS_READ, W25QXX_STATUS_READY);
+}
+
+static w25qxx_Error_t w25qxx_ReadVLocked(w25qxx_HandleTypeDef *w25qxx_Handle, const w25qxx_IoVec_t *iov,
+                                         uint16_t iovCount, uint32_t address, w25qxx_FastRead_t fastRead)
+{
+    uint32_t dataLength, offset;
+    uint16_t index, chunkLength;
+    uint8_t CMD, addressBytes[3];
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    if (w25qxx_StatusUpdate(w25qxx_Handle, W25QXX_STATUS_READY, W25QXX_STATUS_READ) != W25QXX_ERROR_NONE)
+        W25QXX_ERROR_SET(w25qxx_Handle->error);
+
+    /* Argument guards */
+    if (w25qxx_IoVecLength(w25qxx_Handle, iov, iovCount, &dataLength) != W25QXX_ERROR_NONE)
+        return w25qxx_Handle->error;
+    if (((uint64_t) address + dataLength) > ((uint64_t) W25QXX_PAGE_SIZE * W25QXX_HANDLE_PAGES))
+        W25QXX_ERROR_SET(W25QXX_ERROR_ADDRESS);
+
+    /* Command */
+    CMD = (fastRead == W25QXX_FASTREAD) ? W25QXX_CMD_FAST_READ : W25QXX_CMD_READ_DATA;
+    W25QXX_CS_SET(W25QXX_CS_LOW);
+    W25QXX_BEGIN_TRANSMIT(&CMD, sizeof(CMD), W25QXX_TX_TIMEOUT);
+
+    /* A23-A0 - Start address, any byte */
+    W25QXX_ADDRESS_BYTES_SWAP(address);
+    W25QXX_BEGIN_TRANSMIT(addressBytes, sizeof(addressBytes), W25QXX_TX_TIMEOUT);
+
+    /* 8 dummy clocks */
+    if (fastRead == W25QXX_FASTREAD)
+        W25QXX_BEGIN_TRANSMIT(&CMD, sizeof(CMD), W25QXX_TX_TIMEOUT);
+
+    /* Data scattered to the buffers within the same frame */
+    for (index = 0; index < iovCount; index++)
+    {
+        for (offset = 0; offset < iov[index].length; offset += chunkLength)
+        {
+            chunkLength = (iov[index].length - offset > UINT16_MAX) ? UINT16_MAX
+                                                                     : (uint16_t) (iov[index].length - offset);
+            W25QXX_BEGIN_RECEIVE((uint8_t *) iov[index].buf + offset, chunkLength, W25QXX_RX_TIMEOUT);
+        }
+    }
+    W25QXX_CS_SET(W25QXX_CS_HIGH);
+
+    return w25qxx_StatusUpdate(w25qxx_Handle, W25QXX_STATUS_READ, W25QXX_STATUS_READY);
+}
+
+static w25qxx_Error_t w25qxx_ReadBatchLocked(w25qxx_HandleTypeDef *w25qxx_Handle, w25qxx_ReadRequest_t *requests,
+                                             uint16_t numberOfRequests, w25qxx_FastRead_t fastRead)
+{
+    w25qxx_ReadRequest_t request;
+    uint32_t next = 0;
+    uint16_t i, j;
+    uint8_t CMD, addressBytes[3], gap[W25QXX_BATCH_GAP_MAX];
+    bool selected = false;
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    if (w25qxx_StatusUpdate(w25qxx_Handle, W25QXX_STATUS_READY, W25QXX_STATUS_READ) != W25QXX_ERROR_NONE)
+        W25QXX_ERROR_SET(w25qxx_Handle->error);
+
+    /* Argument guards */
+    if ((requests == NULL) || (numberOfRequests == 0))
+        W25QXX_ERROR_SET(W25QXX_ERROR_ARGUMENT);
+    for (i = 0; i < numberOfRequests; i++)
+    {
+        if ((requests[i].buf == NULL) && (requests[i].length != 0))
+            W25QXX_ERROR_SET(W25QXX_ERROR_ARGUMENT);
+        if (((uint64_t) requests[i].address + requests[i].length) >
+            ((uint64_t) W25QXX_PAGE_SIZE * W25QXX_HANDLE_PAGES))
+            W25QXX_ERROR_SET(W25QXX_ERROR_ADDRESS);
+    }
+
+    /* Ascending addresses, insertion sort keeps the order of equal ones */
+    for (i = 1; i < numberOfRequests; i++)
+    {
+        request = requests[i];
+        for (j = i; (j > 0) && (requests[j - 1].address > request.address); j--)
+            requests[j] = requests[j - 1];
+        requests[j] = request;
+    }
+
+    for (i = 0; i < numberOfRequests; i++)
+    {
+        if (requests[i].length == 0)
+            continue;
+
+        /* The device only counts up, a range behind or far ahead of the next address starts a new instruction */
+        if (selected && ((requests[i].address < next) || ((requests[i].address - next) > W25QXX_BATCH_GAP_MAX)))
+        {
+            W25QXX_CS_SET(W25QXX_CS_HIGH);
+            selected = false;
+        }
+
+        if (!selected)
+        {
+            /* Command */
+            CMD = (fastRead == W25QXX_FASTREAD) ? W25QXX_CMD_FAST_READ : W25QXX_CMD_READ_DATA;
+            W25QXX_CS_SET(W25QXX_CS_LOW);
+            W25QXX_BEGIN_TRANSMIT(&CMD, sizeof(CMD), W25QXX_TX_TIMEOUT);
+
+            /* A23-A0 - Start address, any byte */
+            W25QXX_ADDRESS_BYTES_SWAP(requests[i].address);
+            W25QXX_BEGIN_TRANSMIT(addressBytes, sizeof(addressBytes), W25QXX_TX_TIMEOUT);
+
+            /* 8 dummy clocks */
+            if (fastRead == W25QXX_FASTREAD)
+                W25QXX_BEGIN_TRANSMIT(&CMD, sizeof(CMD), W25QXX_TX_TIMEOUT);
+            selected = true;
+        }
+        else if (requests[i].address > next)
+        {
+            /* Gap is cheaper than the instruction and address of a new read */
+            W25QXX_BEGIN_RECEIVE(gap, (uint16_t) (requests[i].address - next), W25QXX_RX_TIMEOUT);
+        }
+
+        /* Data */
+        W25QXX_BEGIN_RECEIVE(requests[i].buf, requests[i].length, W25QXX_RX_TIMEOUT);
+        next = requests[i].address + requests[i].length;
+    }
+    W25QXX_CS_SET(W25QXX_CS_HIGH);
+
+    return w25qxx_StatusUpdate(w25qxx_Handle, W25QXX_STATUS_READ, W25QXX_STATUS_READY);
+}
+
+static w25qxx_Error_t w25qxx_WriteAsyncLocked(w25qxx_HandleTypeDef *w25qxx_Handle, const uint8_t *buf,
+                                              uint16_t dataLength, uint32_t address, w25qxx_CRC_t trailingCRC,
+                                              w25qxx_async_complete_fp complete, void *context)
+{
+    uint16_t frameLength;
+    uint8_t CMD, addressBytes[3];
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    if (w25qxx_StatusUpdate(w25qxx_Handle, W25QXX_STATUS_READY, W25QXX_STATUS_WRITE) != W25QXX_ERROR_NONE)
+        W25QXX_ERROR_SET(w25qxx_Handle->error);
+
+    /* Check platform functions */
+    if ((w25qxx_Handle->interface.transmit_async == NULL) || (w25qxx_Handle->interface.abort_async == NULL))
+        W25QXX_ERROR_SET(W25QXX_ERROR_PLATFORM);
+
+    /* Argument guards */
+    if (buf == NULL)
+        W25QXX_ERROR_SET(W25QXX_ERROR_ARGUMENT);
+    if (dataLength == 0)
+        W25QXX_ERROR_SET(W25QXX_ERROR_ARGUMENT);
+    frameLength = dataLength;
+    if (trailingCRC == W25QXX_CRC)
+        frameLength += sizeof(w25qxx_Handle->async.CRC16);
+    if (frameLength > W25QXX_PAGE_SIZE)
+        W25QXX_ERROR_SET(W25QXX_ERROR_ARGUMENT);
+    if ((address % W25QXX_PAGE_SIZE) != 0)
+        W25QXX_ERROR_SET(W25QXX_ERROR_ADDRESS);
+    if (address > (W25QXX_PAGE_SIZE * (W25QXX_HANDLE_PAGES - 1)))
+        W25QXX_ERROR_SET(W25QXX_ERROR_ADDRESS);
+
+    /* Transfer context, checksum is sent from the handle after the data */
+    w25qxx_Handle->async.complete = complete;
+    w25qxx_Handle->async.context = context;
+    w25qxx_Handle->async.buf = (uint8_t *) buf;
+    w25qxx_Handle->async.dataLength = dataLength;
+    w25qxx_Handle->async.trailingCRC = trailingCRC;
+    w25qxx_Handle->async.error = W25QXX_ERROR_NONE;
+    if (trailingCRC == W25QXX_CRC)
+        w25qxx_Handle->async.CRC16 = w25qxx_CRC16(buf, dataLength);
+
+    /* Command */
+    w25qxx_WriteEnable(w25qxx_Handle);
+    W25QXX_ERROR_CHECK;
+    CMD = W25QXX_CMD_PAGE_PROGRAM;
+    W25QXX_CS_SET(W25QXX_CS_LOW);
+    W25QXX_BEGIN_TRANSMIT(&CMD, sizeof(CMD), W25QXX_TX_TIMEOUT);
+
+    /* A23-A0 - Start address of the desired page */
+    W25QXX_ADDRESS_BYTES_SWAP(address);
+    W25QXX_BEGIN_TRANSMIT(addressBytes, sizeof(addressBytes), W25QXX_TX_TIMEOUT);
+
+    /* Data, the rest of the frame is driven by `w25qxx_TransferComplete()` */
+    w25qxx_Handle->async.stage = W25QXX_ASYNC_DATA;
+    if (w25qxx_Handle->interface.transmit_async(w25qxx_Handle->interface.handle, buf, dataLength, w25qxx_Handle) !=
+        W25QXX_TRANSFER_SUCCESS)
+    {
+        w25qxx_Handle->async.stage = W25QXX_ASYNC_IDLE;
+        W25QXX_ERROR_SET(W25QXX_ERROR_SPI);
+    }
+
+    return W25QXX_ERROR_NONE;
+}
+
+static w25qxx_Error_t w25qxx_ReadAsyncLocked(w25qxx_HandleTypeDef *w25qxx_Handle, uint8_t *buf, uint16_t dataLength,
+                                             uint32_t address, w25qxx_CRC_t trailingCRC, w25qxx_FastRead_t fastRead,
+                                             w25qxx_async_complete_fp complete, void *context)
+{
+    uint16_t frameLength;
+    uint8_t CMD, addressBytes[3];
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    if (w25qxx_StatusUpdate(w25qxx_Handle, W25QXX_STATUS_READY, W25QXX_STATUS_READ) != W25QXX_ERROR_NONE)
+        W25QXX_ERROR_SET(w25qxx_Handle->error);
+
+    /* Check platform functions */
+    if ((w25qxx_Handle->interface.receive_async == NULL) || (w25qxx_Handle->interface.abort_async == NULL))
+        W25QXX_ERROR_SET(W25QXX_ERROR_PLATFORM);
+
+    /* Argument guards */
+    if (buf == NULL)
+        W25QXX_ERROR_SET(W25QXX_ERROR_ARGUMENT);
+    if (dataLength == 0)
+        W25QXX_ERROR_SET(W25QXX_ERROR_ARGUMENT);
+    frameLength = dataLength;
+    if (trailingCRC == W25QXX_CRC)
+        frameLength += sizeof(w25qxx_Handle->async.CRC16);
+    if (frameLength > W25QXX_PAGE_SIZE)
+        W25QXX_ERROR_SET(W25QXX_ERROR_ARGUMENT);
+    if ((address % W25QXX_PAGE_SIZE) != 0)
+        W25QXX_ERROR_SET(W25QXX_ERROR_ADDRESS);
+    if (address > (W25QXX_PAGE_SIZE * (W25QXX_HANDLE_PAGES - 1)))
+        W25QXX_ERROR_SET(W25QXX_ERROR_ADDRESS);
+
+    /* Transfer context */
+    w25qxx_Handle->async.complete = complete;
+    w25qxx_Handle->async.context = context;
+    w25qxx_Handle->async.buf = buf;
+    w25qxx_Handle->async.dataLength = dataLength;
+    w25qxx_Handle->async.trailingCRC = trailingCRC;
+    w25qxx_Handle->async.error = W25QXX_ERROR_NONE;
+
+    /* Command */
+    CMD = (fastRead == W25QXX_FASTREAD) ? W25QXX_CMD_FAST_READ : W25QXX_CMD_READ_DATA;
+    W25QXX_CS_SET(W25QXX_CS_LOW);
+    W25QXX_BEGIN_TRANSMIT(&CMD, sizeof(CMD), W25QXX_TX_TIMEOUT);
+
+    /* A23-A0 - Start address of the desired page */
+    W25QXX_ADDRESS_BYTES_SWAP(address);
+    W25QXX_BEGIN_TRANSMIT(addressBytes, sizeof(addressBytes), W25QXX_TX_TIMEOUT);
+
+    /* 8 dummy clocks */
+    if (fastRead == W25QXX_FASTREAD)
+        W25QXX_BEGIN_TRANSMIT(&CMD, sizeof(CMD), W25QXX_TX_TIMEOUT);
+
+    /* Data, the rest of the frame is driven by `w25qxx_TransferComplete()` */
+    w25qxx_Handle->async.stage = W25QXX_ASYNC_DATA;
+    if (w25qxx_Handle->interface.receive_async(w25qxx_Handle->interface.handle, buf, dataLength, w25qxx_Handle) !=
+        W25QXX_TRANSFER_SUCCESS)
+    {
+        w25qxx_Handle->async.stage = W25QXX_ASYNC_IDLE;
+        W25QXX_ERROR_SET(W25QXX_ERROR_SPI);
+    }
+
+    return W25QXX_ERROR_NONE;
+}
+
+static w25qxx_Error_t w25qxx_AsyncFinishLocked(w25qxx_HandleTypeDef *w25qxx_Handle)
+{
+    uint32_t start = 0, elapsed = 0;
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    /* No transfer in flight */
+    if (w25qxx_Handle->async.stage == W25QXX_ASYNC_IDLE)
+        return w25qxx_Handle->error;
+
+    /* The frame is owned until its data phase ends, /CS stays low meanwhile */
+    if (w25qxx_Handle->interface.tick != NULL)
+        start = w25qxx_Handle->interface.tick();
+    while (w25qxx_Handle->async.stage != W25QXX_ASYNC_DONE)
+    {
+        if (elapsed >= (W25QXX_TX_TIMEOUT * 1000))
+        {
+            /* Stopped channel signals nothing, a late completion can't end the next transfer */
+            w25qxx_Handle->interface.abort_async(w25qxx_Handle->interface.handle);
+            w25qxx_Handle->async.stage = W25QXX_ASYNC_IDLE;
+            W25QXX_ERROR_SET(W25QXX_ERROR_TIMEOUT);
+        }
+        DelayUs(w25qxx_Handle, W25QXX_ASYNC_POLL);
+
+        /* Elapsed time [us] by the tick, otherwise by the delay actually used */
+        if (w25qxx_Handle->interface.tick != NULL)
+            elapsed = (w25qxx_Handle->interface.tick() - start) * 1000;
+        else
+            elapsed += (w25qxx_Handle->interface.delay_us != NULL) ? W25QXX_ASYNC_POLL : 1000;
+    }
+
+    /* Frame end in the task context, the page program starts here */
+    W25QXX_CS_SET(W25QXX_CS_HIGH);
+    w25qxx_Handle->async.stage = W25QXX_ASYNC_IDLE;
+    if (w25qxx_Handle->async.error != W25QXX_ERROR_NONE)
+        W25QXX_ERROR_SET(w25qxx_Handle->async.error);
+
+    return w25qxx_StatusUpdate(w25qxx_Handle, w25qxx_Handle->status, W25QXX_STATUS_READY);
+}
+
+static w25qxx_Error_t w25qxx_ContinuousReadBeginLocked(w25qxx_HandleTypeDef *w25qxx_Handle)
+{
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    /* Quad bus and QE bit check */
+    if (w25qxx_QuadCheck(w25qxx_Handle) != W25QXX_ERROR_NONE)
+        return w25qxx_Handle->error;
+
+    /* The first read of the session carries the instruction */
+    w25qxx_Handle->continuousRead = false;
+
+    return w25qxx_StatusUpdate(w25qxx_Handle, W25QXX_STATUS_READY, W25QXX_STATUS_CONTINUOUS_READ);
+}
+
+static w25qxx_Error_t w25qxx_ContinuousReadLocked(w25qxx_HandleTypeDef *w25qxx_Handle, uint8_t *buf,
+                                                  uint16_t dataLength, uint32_t address)
+{
+    uint8_t CMD, addressBytes[3], mode = W25QXX_CONTINUOUS_READ_MODE, dummy[W25QXX_CONTINUOUS_READ_DUMMIES];
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    /* Existing errors check */
+    if (w25qxx_Handle->error != W25QXX_ERROR_NONE)
+        return w25qxx_Handle->error;
+    if (w25qxx_Handle->status != W25QXX_STATUS_CONTINUOUS_READ)
+        W25QXX_ERROR_SET(W25QXX_ERROR_STATUS);
+
+    /* Argument guards */
+    if (buf == NULL)
+        W25QXX_ERROR_SET(W25QXX_ERROR_ARGUMENT);
+    if (dataLength == 0)
+        W25QXX_ERROR_SET(W25QXX_ERROR_ARGUMENT);
+    if (address > (W25QXX_PAGE_SIZE * W25QXX_HANDLE_PAGES - dataLength))
+        W25QXX_ERROR_SET(W25QXX_ERROR_ADDRESS);
+
+    /* Command, only the first read of the session */
+    W25QXX_CS_SET(W25QXX_CS_LOW);
+    if (!w25qxx_Handle->continuousRead)
+    {
+        CMD = W25QXX_CMD_FAST_READ_QUAD_IO;
+        W25QXX_BEGIN_TRANSMIT(&CMD, sizeof(CMD), W25QXX_TX_TIMEOUT);
+    }
+
+    /* A23-A0 and M7-0 on IO0-IO3, mode bits keep the device in continuous read mode */
+    W25QXX_ADDRESS_BYTES_SWAP(address);
+    W25QXX_BEGIN_TRANSMIT_QUAD(addressBytes, sizeof(addressBytes), W25QXX_TX_TIMEOUT);
+    W25QXX_BEGIN_TRANSMIT_QUAD(&mode, sizeof(mode), W25QXX_TX_TIMEOUT);
+    w25qxx_Handle->continuousRead = true;
+
+    /* 4 dummy clocks, IO0-IO3 are released */
+    W25QXX_BEGIN_RECEIVE_QUAD(dummy, sizeof(dummy), W25QXX_RX_TIMEOUT);
+
+    /* Data */
+    W25QXX_BEGIN_RECEIVE_QUAD(buf, dataLength, W25QXX_RX_TIMEOUT);
+    W25QXX_CS_SET(W25QXX_CS_HIGH);
+
+    return w25qxx_Handle->error;
+}
+
+static w25qxx_Error_t w25qxx_ContinuousReadEndLocked(w25qxx_HandleTypeDef *w25qxx_Handle)
+{
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    /* Existing errors check */
+    if (w25qxx_Handle->error != W25QXX_ERROR_NONE)
+        return w25qxx_Handle->error;
+    if (w25qxx_Handle->status != W25QXX_STATUS_CONTINUOUS_READ)
+        W25QXX_ERROR_SET(W25QXX_ERROR_STATUS);
+
+    /* Device accepts instructions again after the mode reset */
+    if (w25qxx_ContinuousReadReset(w25qxx_Handle) != W25QXX_ERROR_NONE)
+        return w25qxx_Handle->error;
+
+    return w25qxx_StatusUpdate(w25qxx_Handle, W25QXX_STATUS_CONTINUOUS_READ, W25QXX_STATUS_READY);
+}
+
+static w25qxx_Error_t w25qxx_SetBurstWrapLocked(w25qxx_HandleTypeDef *w25qxx_Handle, w25qxx_BurstWrap_t burstWrap)
+{
+    uint8_t wrapBits;
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    /* Wrap bits are a volatile configuration register, sent like a status write */
+    if (w25qxx_StatusUpdate(w25qxx_Handle, W25QXX_STATUS_READY, W25QXX_STATUS_WRITE_SR) != W25QXX_ERROR_NONE)
+        W25QXX_ERROR_SET(w25qxx_Handle->error);
+
+    /* Argument guards, W6-5 select the wrap length and W4 = 0 enables it */
+    switch (burstWrap)
+    {
+    case W25QXX_WRAP_NO:
+        wrapBits = W25QXX_BURST_WRAP_DISABLE;
+        break;
+
+    case W25QXX_WRAP_8:
+        wrapBits = 0x00;
+        break;
+
+    case W25QXX_WRAP_16:
+        wrapBits = 0x20;
+        break;
+
+    case W25QXX_WRAP_32:
+        wrapBits = 0x40;
+        break;
+
+    case W25QXX_WRAP_64:
+        wrapBits = 0x60;
+        break;
+
+    default:
+        W25QXX_ERROR_SET(W25QXX_ERROR_ARGUMENT);
+        break;
+    }
+
+    /* Quad bus and QE bit check */
+    if (w25qxx_QuadCheck(w25qxx_Handle) != W25QXX_ERROR_NONE)
+        return w25qxx_Handle->error;
+
+    if (w25qxx_BurstWrapSend(w25qxx_Handle, wrapBits) != W25QXX_ERROR_NONE)
+        return w25qxx_Handle->error;
+    w25qxx_Handle->burstWrap = burstWrap;
+
+    return w25qxx_StatusUpdate(w25qxx_Handle, W25QXX_STATUS_WRITE_SR, W25QXX_STATUS_READY);
+}
+
+static w25qxx_Error_t w25qxx_ReadBurstLocked(w25qxx_HandleTypeDef *w25qxx_Handle, uint8_t *buf, uint16_t dataLength,
+                                             uint32_t address)
+{
+    uint8_t CMD, addressBytes[3], mode = W25QXX_BURST_READ_MODE, dummy[W25QXX_CONTINUOUS_READ_DUMMIES];
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    if (w25qxx_StatusUpdate(w25qxx_Handle, W25QXX_STATUS_READY, W25QXX_STATUS_READ) != W25QXX_ERROR_NONE)
+        W25QXX_ERROR_SET(w25qxx_Handle->error);
+
+    /* Argument guards */
+    if (buf == NULL)
+        W25QXX_ERROR_SET(W25QXX_ERROR_ARGUMENT);
+    if (dataLength == 0)
+        W25QXX_ERROR_SET(W25QXX_ERROR_ARGUMENT);
+    if (w25qxx_Handle->burstWrap == W25QXX_WRAP_NO)
+        W25QXX_ERROR_SET(W25QXX_ERROR_INSTRUCTION);
+    if (address > (W25QXX_PAGE_SIZE * W25QXX_HANDLE_PAGES - 1u))
+        W25QXX_ERROR_SET(W25QXX_ERROR_ADDRESS);
+
+    /* Command */
+    CMD = W25QXX_CMD_FAST_READ_QUAD_IO;
+    W25QXX_CS_SET(W25QXX_CS_LOW);
+    W25QXX_BEGIN_TRANSMIT(&CMD, sizeof(CMD), W25QXX_TX_TIMEOUT);
+
+    /* A23-A0 and M7-0 on IO0-IO3, the device wraps to the line start after its last byte */
+    W25QXX_ADDRESS_BYTES_SWAP(address);
+    W25QXX_BEGIN_TRANSMIT_QUAD(addressBytes, sizeof(addressBytes), W25QXX_TX_TIMEOUT);
+    W25QXX_BEGIN_TRANSMIT_QUAD(&mode, sizeof(mode), W25QXX_TX_TIMEOUT);
+
+    /* 4 dummy clocks, IO0-IO3 are released */
+    W25QXX_BEGIN_RECEIVE_QUAD(dummy, sizeof(dummy), W25QXX_RX_TIMEOUT);
+
+    /* Data */
+    W25QXX_BEGIN_RECEIVE_QUAD(buf, dataLength, W25QXX_RX_TIMEOUT);
+    W25QXX_CS_SET(W25QXX_CS_HIGH);
+
+    return w25qxx_StatusUpdate(w25qxx_Handle, W25QXX_STATUS_READ, W25QXX_STATUS_READY);
+}
+
+static w25qxx_Error_t w25qxx_EraseLocked(w25qxx_HandleTypeDef *w25qxx_Handle,
+                                         w25qxx_EraseInstruction_t eraseInstruction, uint32_t address,
+                                         w25qxx_WaitForTask_t waitForTask)
+{
+    uint32_t chipEraseTimeout = 0;
+    uint8_t CMD, addressBytes[3];
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    if (w25qxx_StatusUpdate(w25qxx_Handle, W25QXX_STATUS_READY, W25QXX_STATUS_ERASE) != W25QXX_ERROR_NONE)
+        W25QXX_ERROR_SET(w25qxx_Handle->error);
+
+    switch (eraseInstruction)
+    {
+    case W25QXX_SECTOR_ERASE_4KB:
+        if ((address % W25QXX_SECTOR_SIZE_4KB) != 0)
+            W25QXX_ERROR_SET(W25QXX_ERROR_ADDRESS);
+        if (address > ((W25QXX_PAGE_SIZE * W25QXX_HANDLE_PAGES) - W25QXX_SECTOR_SIZE_4KB))
+            W25QXX_ERROR_SET(W25QXX_ERROR_ADDRESS);
+
+        /* Command */
+        w25qxx_WriteEnable(w25qxx_Handle);
+        W25QXX_ERROR_CHECK;
+        CMD = W25QXX_CMD_SECTOR_ERASE_4KB;
+        W25QXX_CS_SET(W25QXX_CS_LOW);
+        W25QXX_BEGIN_TRANSMIT(&CMD, sizeof(CMD), W25QXX_TX_TIMEOUT);
+
+        /* A23-A0 - Start address of the desired page */
+        W25QXX_ADDRESS_BYTES_SWAP(address);
+        W25QXX_BEGIN_TRANSMIT(addressBytes, sizeof(addressBytes), W25QXX_TX_TIMEOUT);
+        W25QXX_CS_SET(W25QXX_CS_HIGH);
+
+        /* Task wait */
+        switch (waitForTask)
+        {
+        case W25QXX_WAIT_NO:
+            break;
+
+        case W25QXX_WAIT_DELAY:
+            w25qxx_Delay(W25QXX_SECTOR_ERASE_TIME_4KB);
+            break;
+
+        case W25QXX_WAIT_BUSY:
+            if (w25qxx_BusyCheckLocked(w25qxx_Handle, W25QXX_SECTOR_ERASE_TIME_4KB) != W25QXX_STATUS_READY)
+                W25QXX_ERROR_SET(W25QXX_ERROR_TIMEOUT);
+            break;
+
+        default:
+            W25QXX_ERROR_SET(W25QXX_ERROR_ARGUMENT);
+            break;
+        }
+        break;
+
+    case W25QXX_BLOCK_ERASE_32KB:
+        if ((address % W25QXX_BLOCK_SIZE_32KB) != 0)
+            W25QXX_ERROR_SET(W25QXX_ERROR_ADDRESS);
+        if (address > ((W25QXX_PAGE_SIZE * W25QXX_HANDLE_PAGES) - W25QXX_BLOCK_SIZE_32KB))
+            W25QXX_ERROR_SET(W25QXX_ERROR_ADDRESS);
+
+        /* Command */
+        w25qxx_WriteEnable(w25qxx_Handle);
+        W25QXX_ERROR_CHECK;
+        CMD = W25QXX_CMD_BLOCK_ERASE_32KB;
+        W25QXX_CS_SET(W25QXX_CS_LOW);
+        W25QXX_BEGIN_TRANSMIT(&CMD, sizeof(CMD), W25QXX_TX_TIMEOUT);
+
+        /* A23-A0 - Start address of the desired page */
+        W25QXX_ADDRESS_BYTES_SWAP(address);
+        W25QXX_BEGIN_TRANSMIT(addressBytes, sizeof(addressBytes), W25QXX_TX_TIMEOUT);
+        W25QXX_CS_SET(W25QXX_CS_HIGH);
+
+        /* Task wait */
+        switch (waitForTask)
+        {
+        case W25QXX_WAIT_NO:
+            break;
+
+        case W25QXX_WAIT_DELAY:
+            w25qxx_Delay(W25QXX_BLOCK_ERASE_TIME_32KB);
+            break;
+
+        case W25QXX_WAIT_BUSY:
+            if (w25qxx_BusyCheckLocked(w25qxx_Handle, W25QXX_BLOCK_ERASE_TIME_32KB) != W25QXX_STATUS_READY)
+                W25QXX_ERROR_SET(W25QXX_ERROR_TIMEOUT);
+            break;
+
+        default:
+            W25QXX_ERROR_SET(W25QXX_ERROR_ARGUMENT);
+            break;
+        }
+        break;
+
+    case W25QXX_BLOCK_ERASE_64KB:
+        if ((address % W25QXX_BLOCK_SIZE_64KB) != 0)
+            W25QXX_ERROR_SET(W25QXX_ERROR_ADDRESS);
+        if (address > ((W25QXX_PAGE_SIZE * W25QXX_HANDLE_PAGES) - W25QXX_BLOCK_SIZE_64KB))
+            W25QXX_ERROR_SET(W25QXX_ERROR_ADDRESS);
+
+        /* Command */
+        w25qxx_WriteEnable(w25qxx_Handle);
+        W25QXX_ERROR_CHECK;
+        CMD = W25QXX_CMD_BLOCK_ERASE_64KB;
+        W25QXX_CS_SET(W25QXX_CS_LOW);
+        W25QXX_BEGIN_TRANSMIT(&CMD, sizeof(CMD), W25QXX_TX_TIMEOUT);
+
+        /* A23-A0 - Start address of the desired page */
+        W25QXX_ADDRESS_BYTES_SWAP(address);
+        W25QXX_BEGIN_TRANSMIT(addressBytes, sizeof(addressBytes), W25QXX_TX_TIMEOUT);
+        W25QXX_CS_SET(W25QXX_CS_HIGH);
+
+        /* Task wait */
+        switch (waitForTask)
+        {
+        case W25QXX_WAIT_NO:
+            break;
+
+        case W25QXX_WAIT_DELAY:
+            w25qxx_Delay(W25QXX_BLOCK_ERASE_TIME_64KB);
+            break;
+
+        case W25QXX_WAIT_BUSY:
+            if (w25qxx_BusyCheckLocked(w25qxx_Handle, W25QXX_BLOCK_ERASE_TIME_64KB) != W25QXX_STATUS_READY)
+                W25QXX_ERROR_SET(W25QXX_ERROR_TIMEOUT);
+            break;
+
+        default:
+            W25QXX_ERROR_SET(W25QXX_ERROR_ARGUMENT);
+            break;
+        }
+        break;
+
+    case W25QXX_CHIP_ERASE:
+        if (address != 0)
+            W25QXX_ERROR_SET(W25QXX_ERROR_ADDRESS);
+
+        /* Device is known since init, its ID selects the timeout */
+#ifdef W25QXX_PART
+        chipEraseTimeout = W25QXX_CHIP_ERASE_TIME;
+#else
+        chipEraseTimeout = W25QXX_DEVICE_CHIP_ERASE_TIME(w25qxx_Handle->ID[1]);
+#endif
+
+        /* Command */
+        w25qxx_WriteEnable(w25qxx_Handle);
+        W25QXX_ERROR_CHECK;
+        CMD = W25QXX_CMD_CHIP_ERASE;
+        W25QXX_CS_SET(W25QXX_CS_LOW);
+        W25QXX_BEGIN_TRANSMIT(&CMD, sizeof(CMD), W25QXX_TX_TIMEOUT);
+        W25QXX_CS_SET(W25QXX_CS_HIGH);
+
+        /* Task wait */
+        switch (waitForTask)
+        {
+        case W25QXX_WAIT_NO:
+            break;
+
+        case W25QXX_WAIT_DELAY:
+            w25qxx_Delay(chipEraseTimeout);
+            break;
+
+        case W25QXX_WAIT_BUSY:
+            if (w25qxx_BusyCheckLocked(w25qxx_Handle, chipEraseTimeout) != W25QXX_STATUS_READY)
+                W25QXX_ERROR_SET(W25QXX_ERROR_TIMEOUT);
+            break;
+
+        default:
+            W25QXX_ERROR_SET(W25QXX_ERROR_ARGUMENT);
+            break;
+        }
+        break;
+
+    default:
+        W25QXX_ERROR_SET(W25QXX_ERROR_INSTRUCTION);
+        break;
+    }
+
+    return w25qxx_StatusUpdate(w25qxx_Handle, W25QXX_STATUS_ERASE, W25QXX_STATUS_READY);
+}
+
+static w25qxx_Error_t w25qxx_WriteStatusLocked(w25qxx_HandleTypeDef *w25qxx_Handle, uint8_t statusRegisterx,
+                                               uint8_t value, w25qxx_SR_Behaviour_t statusRegisterBehaviour)
+{
+    static const uint8_t writableBits[3] = {W25QXX_SR1_WRITABLE, W25QXX_SR2_WRITABLE, W25QXX_SR3_WRITABLE};
+    uint8_t CMD = 0;
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    if (w25qxx_StatusUpdate(w25qxx_Handle, W25QXX_STATUS_READY, W25QXX_STATUS_WRITE_SR) != W25QXX_ERROR_NONE)
+        W25QXX_ERROR_SET(w25qxx_Handle->error);
+
+    /* Argument guards */
+    if ((statusRegisterx < 1u) || (statusRegisterx > 3u))
+        W25QXX_ERROR_SET(W25QXX_ERROR_ARGUMENT);
+
+    /* Unchanged register is not written, non-volatile write takes up to 15ms and wears the register cells */
+    if (!READ_BIT(w25qxx_Handle->statusShadow.valid, 1u << (statusRegisterx - 1u)))
+    {
+        if (w25qxx_StatusShadowRead(w25qxx_Handle, statusRegisterx) != W25QXX_ERROR_NONE)
+            return w25qxx_Handle->error;
+    }
+    if (!((w25qxx_Handle->statusShadow.value[statusRegisterx - 1u] ^ value) &
+          writableBits[statusRegisterx - 1u]) &&
+        ((statusRegisterBehaviour == W25QXX_SR_VOLATILE) ||
+         !READ_BIT(w25qxx_Handle->statusShadow.volatileWritten, 1u << (statusRegisterx - 1u))))
+    {
+        w25qxx_Handle->statusShadow.skippedWrites++;
+        return w25qxx_StatusUpdate(w25qxx_Handle, W25QXX_STATUS_WRITE_SR, W25QXX_STATUS_READY);
+    }
+
+    /* Command 1 */
+    CMD =
+        (statusRegisterBehaviour == W25QXX_SR_VOLATILE) ? W25QXX_CMD_VOLATILE_SR_WRITE_ENABLE : W25QXX_CMD_WRITE_ENABLE;
+    W25QXX_CS_SET(W25QXX_CS_LOW);
+    W25QXX_BEGIN_TRANSMIT(&CMD, sizeof(CMD), W25QXX_TX_TIMEOUT);
+    W25QXX_CS_SET(W25QXX_CS_HIGH);
+
+    /* Command 2 */
+    switch (statusRegisterx)
+    {
+    case 1u:
+        CMD = W25QXX_CMD_WRITE_STATUS_REGISTER1;
+        break;
+
+    case 2u:
+        CMD = W25QXX_CMD_WRITE_STATUS_REGISTER2;
+        break;
+
+    case 3u:
+        CMD = W25QXX_CMD_WRITE_STATUS_REGISTER3;
+        break;
+    }
+    W25QXX_CS_SET(W25QXX_CS_LOW);
+    W25QXX_BEGIN_TRANSMIT(&CMD, sizeof(CMD), W25QXX_TX_TIMEOUT);
+
+    /* Status write */
+    W25QXX_BEGIN_TRANSMIT(&value, sizeof(value), W25QXX_TX_TIMEOUT);
+    W25QXX_CS_SET(W25QXX_CS_HIGH);
+
+    /* Task wait */
+    if (statusRegisterBehaviour != W25QXX_SR_VOLATILE)
+    {
+        if (w25qxx_BusyCheckLocked(w25qxx_Handle, W25QXX_WRITE_STATUS_REGISTER_TIME) != W25QXX_STATUS_READY)
+            W25QXX_ERROR_SET(W25QXX_ERROR_TIMEOUT);
+        CLEAR_BIT(w25qxx_Handle->statusShadow.volatileWritten, 1u << (statusRegisterx - 1u));
+    }
+    else
+        SET_BIT(w25qxx_Handle->statusShadow.volatileWritten, 1u << (statusRegisterx - 1u));
+
+    /* Protected register ignores the write, the shadow holds what the device has taken */
+    if (w25qxx_StatusShadowRead(w25qxx_Handle, statusRegisterx) != W25QXX_ERROR_NONE)
+        return w25qxx_Handle->error;
+
+    /* Quad Input Page Program is ignored by the device without QE bit, the taken value decides */
+    if ((statusRegisterx == 2u) && !READ_BIT(w25qxx_Handle->statusShadow.value[1], W25QXX_SR2_QUAD_ENABLE))
+        w25qxx_Handle->writeBusWidth = W25QXX_BUS_SINGLE;
+
+    return w25qxx_StatusUpdate(w25qxx_Handle, W25QXX_STATUS_WRITE_SR, W25QXX_STATUS_READY);
+}
+
+static w25qxx_Error_t w25qxx_ReadStatusLocked(w25qxx_HandleTypeDef *w25qxx_Handle, uint8_t statusRegisterx,
+                                              uint8_t *value)
+{
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    if (w25qxx_StatusUpdate(w25qxx_Handle, W25QXX_STATUS_READY, W25QXX_STATUS_READ_SR) != W25QXX_ERROR_NONE)
+        W25QXX_ERROR_SET(w25qxx_Handle->error);
+
+    /* Argument guards */
+    if ((statusRegisterx < 1u) || (statusRegisterx > 3u))
+        W25QXX_ERROR_SET(W25QXX_ERROR_ARGUMENT);
+    if (value == NULL)
+        W25QXX_ERROR_SET(W25QXX_ERROR_ARGUMENT);
+
+    /* Status read, BUSY/WEL/SUS may change any time, so the device is always read */
+    if (w25qxx_StatusShadowRead(w25qxx_Handle, statusRegisterx) != W25QXX_ERROR_NONE)
+        return w25qxx_Handle->error;
+    *value = w25qxx_Handle->statusShadow.value[statusRegisterx - 1u];
+
+    return w25qxx_StatusUpdate(w25qxx_Handle, W25QXX_STATUS_READ_SR, W25QXX_STATUS_READY);
+}
+
+static w25qxx_Error_t w25qxx_ResetErrorLocked(w25qxx_HandleTypeDef *w25qxx_Handle)
+{
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    /* Existing errors check */
+    if (w25qxx_Handle->error == W25QXX_ERROR_NONE)
+        return w25qxx_Handle->error;
+
+    /* Reset error, interrupted status write leaves the register unknown */
+    w25qxx_Handle->error = W25QXX_ERROR_NONE;
+    w25qxx_Handle->statusShadow.valid = 0;
+
+    /* Deferred initialization is retried on the next access */
+    if (w25qxx_Handle->lazyInit)
+        return w25qxx_Handle->error;
+
+    /* Sleeping device does not respond, device in continuous read mode ignores instructions */
+    if (w25qxx_Handle->powerDown.active)
+        w25qxx_WakeLocked(w25qxx_Handle);
+    if ((w25qxx_Handle->status == W25QXX_STATUS_CONTINUOUS_READ) &&
+        (w25qxx_ContinuousReadReset(w25qxx_Handle) == W25QXX_ERROR_NONE))
+        w25qxx_Handle->status = W25QXX_STATUS_READY;
+
+    /* Try to get response from device */
+    if (w25qxx_BusyCheckLocked(w25qxx_Handle, W25QXX_RESPONSE_TIMEOUT) != W25QXX_STATUS_READY)
+        W25QXX_ERROR_SET(W25QXX_ERROR_TIMEOUT);
+
+    return w25qxx_StatusUpdate(w25qxx_Handle, w25qxx_Handle->status, W25QXX_STATUS_READY);
+}
+
+static w25qxx_Status_t w25qxx_BusyCheckLocked(w25qxx_HandleTypeDef *w25qxx_Handle, uint32_t timeout)
+{
+    uint32_t delayActual;
+    uint8_t CMD = W25QXX_CMD_READ_STATUS_REGISTER1, statusRegister;
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_STATUS_UNDEFINED;
+
+    /* Existing errors check */
+    if (w25qxx_Handle->error != W25QXX_ERROR_NONE)
+        return W25QXX_STATUS_UNDEFINED;
+
+    /* Device in continuous read mode takes the instruction as address bits */
+    if (w25qxx_Handle->status == W25QXX_STATUS_CONTINUOUS_READ)
+        return W25QXX_STATUS_UNDEFINED;
+
+    /* Start polling, chip is deselected between polls to keep the bus available for other devices */
+    while (true)
+    {
+        /* Command */
+        W25QXX_CS_SET(W25QXX_CS_LOW);
+        if (w25qxx_Handle->interface.transmit(w25qxx_Handle->interface.handle, &CMD, sizeof(CMD), W25QXX_TX_TIMEOUT) !=
+            W25QXX_TRANSFER_SUCCESS)
+        {
+            w25qxx_Handle->error = W25QXX_ERROR_SPI;
+            W25QXX_CS_SET(W25QXX_CS_HIGH);
+
+            return W25QXX_STATUS_UNDEFINED;
+        }
+
+        /* Get status register 1 data */
+        if (w25qxx_Handle->interface.receive(w25qxx_Handle->interface.handle, &statusRegister, sizeof(statusRegister),
+                                             W25QXX_RX_TIMEOUT) != W25QXX_TRANSFER_SUCCESS)
+        {
+            w25qxx_Handle->error = W25QXX_ERROR_SPI;
+            W25QXX_CS_SET(W25QXX_CS_HIGH);
+
+            return W25QXX_STATUS_UNDEFINED;
+        }
+        W25QXX_CS_SET(W25QXX_CS_HIGH);
+
+        /* Get busy bit state */
+        if (!READ_BIT(statusRegister, 1u << 0))
+            return W25QXX_STATUS_READY;
+
+        /* Timeout handling */
+        if (timeout == 0)
+            return W25QXX_STATUS_BUSY;
+        delayActual = w25qxx_Delay(1);
+        if ((delayActual == 0) || (timeout < delayActual))
+        {
+            timeout = 0;
+            continue;
+        }
+        else
+        {
+            timeout -= delayActual;
+            continue;
+        }
+    }
+}
+
+static w25qxx_Error_t w25qxx_PowerDownLocked(w25qxx_HandleTypeDef *w25qxx_Handle)
+{
+    uint8_t CMD;
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    /* Existing errors check */
+    if (w25qxx_Handle->error != W25QXX_ERROR_NONE)
+        return w25qxx_Handle->error;
+    if (w25qxx_Handle->status != W25QXX_STATUS_READY)
+        W25QXX_ERROR_SET(W25QXX_ERROR_STATUS);
+    if (w25qxx_Handle->powerDown.active)
+        return w25qxx_Handle->error;
+
+    /* Command */
+    CMD = W25QXX_CMD_POWER_DOWN;
+    W25QXX_CS_SET(W25QXX_CS_LOW);
+    W25QXX_BEGIN_TRANSMIT(&CMD, sizeof(CMD), W25QXX_TX_TIMEOUT);
+    W25QXX_CS_SET(W25QXX_CS_HIGH);
+    DelayUs(w25qxx_Handle, W25QXX_POWER_DOWN_TIME);
+
+    w25qxx_Handle->powerDown.active = true;
+    w25qxx_Handle->powerDown.entries++;
+    if (w25qxx_Handle->interface.tick != NULL)
+        w25qxx_Handle->powerDown.enterTick = w25qxx_Handle->interface.tick();
+
+    return w25qxx_Handle->error;
+}
+
+static w25qxx_Error_t w25qxx_PowerServiceLocked(w25qxx_HandleTypeDef *w25qxx_Handle)
+{
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    /* Nothing to do if sleeping already, not enabled, not initialized or in error */
+    if (w25qxx_Handle->powerDown.active || (w25qxx_Handle->powerDown.idleTime == 0) ||
+        (w25qxx_Handle->interface.tick == NULL) || w25qxx_Handle->lazyInit ||
+        (w25qxx_Handle->status != W25QXX_STATUS_READY) || (w25qxx_Handle->error != W25QXX_ERROR_NONE))
+        return w25qxx_Handle->error;
+
+    /* Idle time check, then the device has to complete the last program/erase */
+    if ((w25qxx_Handle->interface.tick() - w25qxx_Handle->powerDown.lastAccess) < w25qxx_Handle->powerDown.idleTime)
+        return w25qxx_Handle->error;
+    if (w25qxx_BusyCheckLocked(w25qxx_Handle, 0) != W25QXX_STATUS_READY)
+        return w25qxx_Handle->error;
+
+    return w25qxx_PowerDownLocked(w25qxx_Handle);
+}
+
+static w25qxx_Error_t w25qxx_WakeLocked(w25qxx_HandleTypeDef *w25qxx_Handle)
+{
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    /* Device accepts instructions after tRES1 */
+    if (w25qxx_ReleasePowerDown(w25qxx_Handle) != W25QXX_ERROR_NONE)
+        return w25qxx_Handle->error;
+
+    w25qxx_Handle->powerDown.active = false;
+    w25qxx_Handle->powerDown.wakeups++;
+    if (w25qxx_Handle->interface.tick != NULL)
+        w25qxx_Handle->powerDown.sleepTime += w25qxx_Handle->interface.tick() - w25qxx_Handle->powerDown.enterTick;
+
+    return w25qxx_Handle->error;
+}
+
+static w25qxx_Error_t w25qxx_ReleasePowerDown(w25qxx_HandleTypeDef *w25qxx_Handle)
+{
+    uint8_t CMD;
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    /* Existing errors check */
+    if (w25qxx_Handle->error != W25QXX_ERROR_NONE)
+        return w25qxx_Handle->error;
+
+    /* Command */
+    CMD = W25QXX_CMD_RELEASE_POWER_DOWN;
+    W25QXX_CS_SET(W25QXX_CS_LOW);
+    W25QXX_BEGIN_TRANSMIT(&CMD, sizeof(CMD), W25QXX_TX_TIMEOUT);
+    W25QXX_CS_SET(W25QXX_CS_HIGH);
+    DelayUs(w25qxx_Handle, W25QXX_RELEASE_POWER_DOWN_TIME);
+
+    return w25qxx_Handle->error;
+}
+
+static w25qxx_Error_t w25qxx_ResetDevice(w25qxx_HandleTypeDef *w25qxx_Handle)
+{
+    uint8_t CMD;
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    /* Existing errors check */
+    if (w25qxx_Handle->error != W25QXX_ERROR_NONE)
+        return w25qxx_Handle->error;
+
+    /* Command 1 */
+    CMD = W25QXX_CMD_ENABLE_RESET;
+    W25QXX_CS_SET(W25QXX_CS_LOW);
+    W25QXX_BEGIN_TRANSMIT(&CMD, sizeof(CMD), W25QXX_TX_TIMEOUT);
+    W25QXX_CS_SET(W25QXX_CS_HIGH);
+
+    /* Command 2 */
+    CMD = W25QXX_CMD_RESET_DEVICE;
+    W25QXX_CS_SET(W25QXX_CS_LOW);
+    W25QXX_BEGIN_TRANSMIT(&CMD, sizeof(CMD), W25QXX_TX_TIMEOUT);
+    W25QXX_CS_SET(W25QXX_CS_HIGH);
+    DelayUs(w25qxx_Handle, W25QXX_RESET_TIME);
+
+    /* Volatile status bits are reloaded from the non-volatile ones */
+    w25qxx_Handle->statusShadow.valid = 0;
+    w25qxx_Handle->statusShadow.volatileWritten = 0;
+    w25qxx_Handle->burstWrap = W25QXX_WRAP_NO;
+
+    return w25qxx_Handle->error;
+}
+
+static w25qxx_Error_t w25qxx_ContinuousReadReset(w25qxx_HandleTypeDef *w25qxx_Handle)
+{
+    uint8_t modeReset[4];
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    /* Continuous read mode is not available without quad bus */
+    if (w25qxx_Handle->interface.transmit_quad == NULL)
+        return w25qxx_Handle->error;
+
+    /* 8 clocks with IO0-IO3 high, M7-0 does not match the mode bits and the device leaves the mode */
+    memset(modeReset, W25QXX_CONTINUOUS_READ_RESET, sizeof(modeReset));
+    W25QXX_CS_SET(W25QXX_CS_LOW);
+    W25QXX_BEGIN_TRANSMIT_QUAD(modeReset, sizeof(modeReset), W25QXX_TX_TIMEOUT);
+    W25QXX_CS_SET(W25QXX_CS_HIGH);
+    w25qxx_Handle->continuousRead = false;
+
+    return w25qxx_Handle->error;
+}
+
+static w25qxx_Error_t w25qxx_BurstWrapSend(w25qxx_HandleTypeDef *w25qxx_Handle, uint8_t wrapBits)
+{
+    uint8_t CMD = W25QXX_CMD_SET_BURST_WITH_WRAP, frame[W25QXX_BURST_WRAP_DUMMIES + 1];
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    /* Existing errors check */
+    if (w25qxx_Handle->error != W25QXX_ERROR_NONE)
+        return w25qxx_Handle->error;
+
+    /* Instruction, then 24 dummy bits and W7-0 on IO0-IO3 */
+    memset(frame, 0, sizeof(frame));
+    frame[W25QXX_BURST_WRAP_DUMMIES] = wrapBits;
+    W25QXX_CS_SET(W25QXX_CS_LOW);
+    W25QXX_BEGIN_TRANSMIT(&CMD, sizeof(CMD), W25QXX_TX_TIMEOUT);
+    W25QXX_BEGIN_TRANSMIT_QUAD(frame, sizeof(frame), W25QXX_TX_TIMEOUT);
+    W25QXX_CS_SET(W25QXX_CS_HIGH);
+
+    return w25qxx_Handle->error;
+}
+
+static w25qxx_Error_t w25qxx_IoVecLength(w25qxx_HandleTypeDef *w25qxx_Handle, const w25qxx_IoVec_t *iov,
+                                         uint16_t iovCount, uint32_t *dataLength)
+{
+    uint16_t index;
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    /* Empty buffers are allowed, an empty range is not */
+    *dataLength = 0;
+    if ((iov == NULL) || (iovCount == 0))
+        W25QXX_ERROR_SET(W25QXX_ERROR_ARGUMENT);
+    for (index = 0; index < iovCount; index++)
+    {
+        if ((iov[index].buf == NULL) && (iov[index].length != 0))
+            W25QXX_ERROR_SET(W25QXX_ERROR_ARGUMENT);
+        if (iov[index].length > (W25QXX_PAGE_SIZE * W25QXX_HANDLE_PAGES - *dataLength))
+            W25QXX_ERROR_SET(W25QXX_ERROR_ADDRESS);
+        *dataLength += iov[index].length;
+    }
+    if (*dataLength == 0)
+        W25QXX_ERROR_SET(W25QXX_ERROR_ARGUMENT);
+
+    return w25qxx_Handle->error;
+}
+
+static w25qxx_Error_t w25qxx_VerifyFrame(w25qxx_HandleTypeDef *w25qxx_Handle, const uint8_t *buf, uint16_t dataLength,
+                                         uint32_t address, w25qxx_CRC_t trailingCRC, uint16_t *mismatchOffset,
+                                         bool *programmable)
+{
+    uint16_t frameLength, chunkLength, i, CRC16 = 0;
+    uint8_t CMD, addressBytes[3], chunk[W25QXX_VERIFY_CHUNK_SIZE], expected;
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    if (w25qxx_StatusUpdate(w25qxx_Handle, W25QXX_STATUS_READY, W25QXX_STATUS_READ) != W25QXX_ERROR_NONE)
+        W25QXX_ERROR_SET(w25qxx_Handle->error);
+
+    /* The same frame as the page program has sent */
+    frameLength = dataLength;
+    if (trailingCRC == W25QXX_CRC)
+    {
+        CRC16 = w25qxx_CRC16(buf, dataLength);
+        frameLength += sizeof(CRC16);
+    }
+
+    /* Command */
+    CMD = W25QXX_CMD_READ_DATA;
+    W25QXX_CS_SET(W25QXX_CS_LOW);
+    W25QXX_BEGIN_TRANSMIT(&CMD, sizeof(CMD), W25QXX_TX_TIMEOUT);
+
+    /* A23-A0 - Start address of the desired page */
+    W25QXX_ADDRESS_BYTES_SWAP(address);
+    W25QXX_BEGIN_TRANSMIT(addressBytes, sizeof(addressBytes), W25QXX_TX_TIMEOUT);
+
+    /* Data compare chunk by chunk within the same frame, the first mismatch ends the read */
+    for (*mismatchOffset = 0; *mismatchOffset < frameLength; *mismatchOffset += chunkLength)
+    {
+        chunkLength = frameLength - *mismatchOffset;
+        if (chunkLength > sizeof(chunk))
+            chunkLength = sizeof(chunk);
+        W25QXX_BEGIN_RECEIVE(chunk, chunkLength, W25QXX_RX_TIMEOUT);
+
+        for (i = 0; i < chunkLength; i++)
+        {
+            expected = (*mismatchOffset + i < dataLength) ? buf[*mismatchOffset + i]
+                                                          : ((uint8_t *) &CRC16)[*mismatchOffset + i - dataLength];
+            if (chunk[i] != expected)
+            {
+                *mismatchOffset += i;
+                *programmable = ((chunk[i] & expected) == expected);
+                W25QXX_CS_SET(W25QXX_CS_HIGH);
+
+                return w25qxx_StatusUpdate(w25qxx_Handle, W25QXX_STATUS_READ, W25QXX_STATUS_READY);
+            }
+        }
+    }
+    W25QXX_CS_SET(W25QXX_CS_HIGH);
+
+    return w25qxx_StatusUpdate(w25qxx_Handle, W25QXX_STATUS_READ, W25QXX_STATUS_READY);
+}
+
+static w25qxx_Error_t w25qxx_QuadCheck(w25qxx_HandleTypeDef *w25qxx_Handle)
+{
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    /* Check platform functions */
+    if (w25qxx_Handle->interface.receive_quad == NULL)
+        W25QXX_ERROR_SET(W25QXX_ERROR_PLATFORM);
+    if (w25qxx_Handle->interface.transmit_quad == NULL)
+        W25QXX_ERROR_SET(W25QXX_ERROR_PLATFORM);
+
+    /* Quad instructions are ignored by the device while QE bit is cleared, SR2 is read once after reset */
+    if (!READ_BIT(w25qxx_Handle->statusShadow.valid, 1u << 1))
+    {
+        if (w25qxx_StatusShadowRead(w25qxx_Handle, 2u) != W25QXX_ERROR_NONE)
+            return w25qxx_Handle->error;
+    }
+    if (!READ_BIT(w25qxx_Handle->statusShadow.value[1], W25QXX_SR2_QUAD_ENABLE))
+        W25QXX_ERROR_SET(W25QXX_ERROR_INSTRUCTION);
+
+    return w25qxx_Handle->error;
+}
+
+static w25qxx_Error_t w25qxx_StatusShadowRead(w25qxx_HandleTypeDef *w25qxx_Handle, uint8_t statusRegisterx)
+{
+    uint8_t CMD = 0;
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    /* Existing errors check */
+    if (w25qxx_Handle->error != W25QXX_ERROR_NONE)
+        return w25qxx_Handle->error;
+
+    /* Command */
+    switch (statusRegisterx)
+    {
+    case 1u:
+        CMD = W25QXX_CMD_READ_STATUS_REGISTER1;
+        break;
+
+    case 2u:
+        CMD = W25QXX_CMD_READ_STATUS_REGISTER2;
+        break;
+
+    case 3u:
+        CMD = W25QXX_CMD_READ_STATUS_REGISTER3;
+        break;
+
+    default:
+        W25QXX_ERROR_SET(W25QXX_ERROR_ARGUMENT);
+        break;
+    }
+    W25QXX_CS_SET(W25QXX_CS_LOW);
+    W25QXX_BEGIN_TRANSMIT(&CMD, sizeof(CMD), W25QXX_TX_TIMEOUT);
+
+    /* Status read */
+    W25QXX_BEGIN_RECEIVE(&w25qxx_Handle->statusShadow.value[statusRegisterx - 1u],
+                         sizeof(w25qxx_Handle->statusShadow.value[statusRegisterx - 1u]), W25QXX_RX_TIMEOUT);
+    W25QXX_CS_SET(W25QXX_CS_HIGH);
+    SET_BIT(w25qxx_Handle->statusShadow.valid, 1u << (statusRegisterx - 1u));
+
+    return w25qxx_Handle->error;
+}
+
+static w25qxx_Error_t w25qxx_ReadID(w25qxx_HandleTypeDef *w25qxx_Handle)
+{
+#ifndef W25QXX_PART
+    char capacityString[30];
+#endif
+    uint8_t CMD, addressBytes[3];
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    /* Existing errors check */
+    if (w25qxx_Handle->error != W25QXX_ERROR_NONE)
+        return w25qxx_Handle->error;
+
+    /* Command */
+    CMD = W25QXX_CMD_MANUFACTURER_DEVICE_ID;
+    W25QXX_CS_SET(W25QXX_CS_LOW);
+    W25QXX_BEGIN_TRANSMIT(&CMD, sizeof(CMD), W25QXX_TX_TIMEOUT);
+
+    /* 24-bit address (A23-A0) of 000000h */
+    W25QXX_ADDRESS_BYTES_SWAP((uint32_t) 0);
+    W25QXX_BEGIN_TRANSMIT(addressBytes, sizeof(addressBytes), W25QXX_TX_TIMEOUT);
+
+    /* Get Manufacturer ID and Device ID */
+    W25QXX_BEGIN_RECEIVE(w25qxx_Handle->ID, sizeof(w25qxx_Handle->ID), W25QXX_RX_TIMEOUT);
+    W25QXX_CS_SET(W25QXX_CS_HIGH);
+
+#ifdef W25QXX_PART
+    /* Part is known at build time, only verify it */
+    if ((w25qxx_Handle->ID[0] != W25QXX_MANUFACTURER_ID) || (w25qxx_Handle->ID[1] != W25QXX_PART))
+        W25QXX_ERROR_SET(W25QXX_ERROR_ID);
+    w25qxx_Handle->numberOfPages = W25QXX_NUMBER_OF_PAGES;
+#else
+    /* Check if we work with Winbond Serial Flash device */
+    Print(w25qxx_Handle, "Manufacturer: ");
+    switch (w25qxx_Handle->ID[0])
+    {
+    case W25QXX_MANUFACTURER_ID:
+        Print(w25qxx_Handle, "Winbond\n");
+        break;
+
+    default:
+        Print(w25qxx_Handle, "undefined\n");
+        W25QXX_ERROR_SET(W25QXX_ERROR_ID);
+    }
+
+    /* Determine device and number of pages */
+    Print(w25qxx_Handle, "Device: ");
+    switch (w25qxx_Handle->ID[1])
+    {
+    case W25Q80:
+        Print(w25qxx_Handle, "W25Q80");
+        w25qxx_Handle->numberOfPages = W25QXX_DEVICE_NUMBER_OF_PAGES(W25Q80);
+        break;
+
+    case W25Q16:
+        Print(w25qxx_Handle, "W25Q16");
+        w25qxx_Handle->numberOfPages = W25QXX_DEVICE_NUMBER_OF_PAGES(W25Q16);
+        break;
+
+    case W25Q32:
+        Print(w25qxx_Handle, "W25Q32");
+        w25qxx_Handle->numberOfPages = W25QXX_DEVICE_NUMBER_OF_PAGES(W25Q32);
+        break;
+
+    case W25Q64:
+        Print(w25qxx_Handle, "W25Q64");
+        w25qxx_Handle->numberOfPages = W25QXX_DEVICE_NUMBER_OF_PAGES(W25Q64);
+        break;
+
+    case W25Q128:
+        Print(w25qxx_Handle, "W25Q128");
+        w25qxx_Handle->numberOfPages = W25QXX_DEVICE_NUMBER_OF_PAGES(W25Q128);
+        break;
+
+    /* Unsupported device */
+    default:
+        Print(w25qxx_Handle, "undefined\n");
+        W25QXX_ERROR_SET(W25QXX_ERROR_ID);
+    }
+    snprintf(capacityString, sizeof(capacityString), " (%uMbit in %u pages)\n",
+             (w25qxx_Handle->numberOfPages * W25QXX_PAGE_SIZE * 8 / 1024 / 1024), w25qxx_Handle->numberOfPages);
+    Print(w25qxx_Handle, capacityString);
+#endif
+
+    return w25qxx_Handle->error;
+}
+
+static w25qxx_Error_t w25qxx_WriteEnable(w25qxx_HandleTypeDef *w25qxx_Handle)
+{
+    uint8_t CMD;
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    /* Existing errors check */
+    if (w25qxx_Handle->error != W25QXX_ERROR_NONE)
+        return w25qxx_Handle->error;
+
+    /* Command */
+    CMD = W25QXX_CMD_WRITE_ENABLE;
+    W25QXX_CS_SET(W25QXX_CS_LOW);
+    W25QXX_BEGIN_TRANSMIT(&CMD, sizeof(CMD), W25QXX_TX_TIMEOUT);
+    W25QXX_CS_SET(W25QXX_CS_HIGH);
+
+    return w25qxx_Handle->error;
+}
+
+// static w25qxx_Error_t w25qxx_WriteDisable(w25qxx_HandleTypeDef *w25qxx_Handle)
+// {
+//     /* Avoid dereferencing the null handle */
+//     if (w25qxx_Handle == NULL)
+//         return W25QXX_ERROR_ARGUMENT;
+
+// /* Existing errors check */
+// if (w25qxx_Handle->error != W25QXX_ERROR_NONE)
+//     return w25qxx_Handle->error;
+
+// /* Command */
+// CMD = W25QXX_CMD_WRITE_DISABLE;
+// W25QXX_CS_SET(W25QXX_CS_LOW);
+// W25QXX_BEGIN_TRANSMIT(&CMD, sizeof(CMD), W25QXX_TX_TIMEOUT);
+// W25QXX_CS_SET(W25QXX_CS_HIGH);
+
+// return w25qxx_Handle->error;
+// }
+
+static w25qxx_Error_t w25qxx_StatusUpdate(w25qxx_HandleTypeDef *w25qxx_Handle, w25qxx_Status_t statusCheck,
+                                          w25qxx_Status_t statusSet)
+{
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    /* Existing errors check */
+    if (w25qxx_Handle->error != W25QXX_ERROR_NONE)
+        return w25qxx_Handle->error;
+
+    /* Actual status check */
+    if (w25qxx_Handle->status != statusCheck)
+        W25QXX_ERROR_SET(W25QXX_ERROR_STATUS);
+
+    /* Status update */
+    w25qxx_Handle->status = statusSet;
+
+    /* Debug trace */
+    Print(w25qxx_Handle, "Status update: ");
+    switch (w25qxx_Handle->status)
+    {
+    case W25QXX_STATUS_RESET:
+        Print(w25qxx_Handle, "reset\n");
+        break;
+
+    case W25QXX_STATUS_INIT:
+        Print(w25qxx_Handle, "init\n");
+        break;
+
+    case W25QXX_STATUS_WRITE:
+        Print(w25qxx_Handle, "write\n");
+        break;
+
+    case W25QXX_STATUS_READ:
+        Print(w25qxx_Handle, "read\n");
+        break;
+
+    case W25QXX_STATUS_ERASE:
+        Print(w25qxx_Handle, "erase\n");
+        break;
+
+    case W25QXX_STATUS_WRITE_SR:
+        Print(w25qxx_Handle, "write status register\n");
+        break;
+
+    case W25QXX_STATUS_READ_SR:
+        Print(w25qxx_Handle, "read status register\n");
+        break;
+
+    case W25QXX_STATUS_CONTINUOUS_READ:
+        Print(w25qxx_Handle, "continuous read\n");
+        break;
+
+    case W25QXX_STATUS_BUSY:
+        Print(w25qxx_Handle, "busy\n");
+        break;
+
+    case W25QXX_STATUS_READY:
+        Print(w25qxx_Handle, "ready\n");
+        break;
+
+    case W25QXX_STATUS_UNDEFINED:
+        Print(w25qxx_Handle, "undefined\n");
+        break;
+    }
+
+    return w25qxx_Handle->error;
+}
+
+static void Print(w25qxx_HandleTypeDef *w25qxx_Handle, const char *message)
+{
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return;
+
+    if (message != NULL)
+        if (w25qxx_Handle->interface.print != NULL)
+            w25qxx_Handle->interface.print(message);
+}
+
+static void DelayUs(w25qxx_HandleTypeDef *w25qxx_Handle, uint32_t us)
+{
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Handle == NULL)
+        return;
+
+    if (w25qxx_Handle->interface.delay_us != NULL)
+        w25qxx_Handle->interface.delay_us(us);
+    else
+        w25qxx_Delay(1);
 }
\ No newline at end of file
@@ -1,181 +1,513 @@
-#pragma once
-
-#include "w25qxx_Interface.h"
-
-/* Macro */
-#define W25QXX_PAGE_TO_SECTOR(PAGE)         ((PAGE) / (W25QXX_SECTOR_SIZE_4KB / W25QXX_PAGE_SIZE))
-#define W25QXX_PAGE_TO_BLOCK_32KB(PAGE)     ((PAGE) / (W25QXX_BLOCK_SIZE_32KB / W25QXX_PAGE_SIZE))
-#define W25QXX_PAGE_TO_BLOCK_64KB(PAGE)     ((PAGE) / (W25QXX_BLOCK_SIZE_64KB / W25QXX_PAGE_SIZE))
-#define W25QXX_PAGE_TO_ADDRESS(PAGE)        ((uint32_t) (PAGE) * (W25QXX_PAGE_SIZE))
-#define W25QXX_SECTOR_TO_ADDRESS(SECTOR)    ((uint32_t) (SECTOR) * W25QXX_SECTOR_SIZE_4KB)
-#define W25QXX_BLOCK_32KB_TO_ADDRESS(BLOCK) ((uint32_t) (BLOCK) * W25QXX_BLOCK_SIZE_32KB)
-#define W25QXX_BLOCK_64KB_TO_ADDRESS(BLOCK) ((uint32_t) (BLOCK) * W25QXX_BLOCK_SIZE_64KB)
-#define W25QXX_KB_TO_BYTE(KB)               ((uint32_t) (KB) * 1024)
-
-/* Device constants */
-#define W25QXX_MANUFACTURER_ID 0xEF
-#define W25QXX_PAGE_SIZE       256
-#define W25QXX_SECTOR_SIZE_4KB (W25QXX_KB_TO_BYTE(4))
-#define W25QXX_BLOCK_SIZE_32KB (W25QXX_KB_TO_BYTE(32))
-#define W25QXX_BLOCK_SIZE_64KB (W25QXX_KB_TO_BYTE(64))
-
-enum w25qxx_Device_e { W25Q80 = 0x13, W25Q16, W25Q32, W25Q64, W25Q128 };
-
-/* Data types */
-typedef enum w25qxx_WaitForTask_e { W25QXX_WAIT_NO, W25QXX_WAIT_DELAY, W25QXX_WAIT_BUSY } w25qxx_WaitForTask_t;
-
-typedef enum w25qxx_CRC_e { W25QXX_CRC_NO, W25QXX_CRC } w25qxx_CRC_t;
-
-typedef enum w25qxx_FastRead_e { W25QXX_FASTREAD_NO, W25QXX_FASTREAD } w25qxx_FastRead_t;
-
-typedef enum w25qxx_SR_Behaviour_e { W25QXX_SR_NONVOLATILE, W25QXX_SR_VOLATILE } w25qxx_SR_Behaviour_t;
-
-typedef enum w25qxx_EraseInstruction_e {
-    W25QXX_SECTOR_ERASE_4KB,
-    W25QXX_BLOCK_ERASE_32KB,
-    W25QXX_BLOCK_ERASE_64KB,
-    W25QXX_CHIP_ERASE
-} w25qxx_EraseInstruction_t;
-
-typedef enum w25qxx_Status_e {
-    W25QXX_STATUS_RESET,
-    W25QXX_STATUS_INIT,
-    W25QXX_STATUS_WRITE,
-    W25QXX_STATUS_READ,
-    W25QXX_STATUS_ERASE,
-    W25QXX_STATUS_WRITE_SR,
-    W25QXX_STATUS_READ_SR,
-    W25QXX_STATUS_BUSY,
-    W25QXX_STATUS_READY,
-    W25QXX_STATUS_UNDEFINED
-} w25qxx_Status_t;
-
-typedef enum w25qxx_Error_e {
-    W25QXX_ERROR_NONE,
-    W25QXX_ERROR_PLATFORM,
-    W25QXX_ERROR_ID,
-    W25QXX_ERROR_STATUS,
-    W25QXX_ERROR_ARGUMENT,
-    W25QXX_ERROR_ADDRESS,
-    W25QXX_ERROR_SPI,
-    W25QXX_ERROR_TIMEOUT,
-    W25QXX_ERROR_CHECKSUM,
-    W25QXX_ERROR_INSTRUCTION
-} w25qxx_Error_t;
-
-typedef w25qxx_Transfer_Status_t (*w25qxx_rx_fp)(void *handle, uint8_t *pDataRx, uint16_t size, uint32_t timeout);
-typedef w25qxx_Transfer_Status_t (*w25qxx_tx_fp)(void *handle, const uint8_t *pDataTx, uint16_t size, uint32_t timeout);
-typedef void (*w25qxx_cs_fp)(w25qxx_CS_State_t newState);
-typedef void (*w25qxx_print_fp)(const char *message);
-typedef uint32_t (*w25qxx_delay_fp)(uint32_t ms);
-
-typedef struct w25qxx_HandleTypeDef_s {
-    struct {
-        w25qxx_rx_fp receive; // Pointer to the platform SPI receive function
-        w25qxx_tx_fp transmit; // Pointer to the platform SPI transmit function
-        w25qxx_cs_fp cs_set; // Pointer to the platform chip select set function
-        w25qxx_delay_fp delay; // Pointer to the platform delay function
-
-        /* Optional (force `NULL` if not used) */
-        w25qxx_print_fp print; // Pointer to the function that will print debug messages
-        void *handle; // Pointer to the SPI handle be used in rx/tx function
-    } interface;
-
-    w25qxx_Status_t status;
-    w25qxx_Error_t error;
-    uint32_t numberOfPages;
-    uint16_t frameLength;
-    uint16_t CRC16;
-    uint8_t frameBuf[W25QXX_PAGE_SIZE];
-    uint8_t ID[2];
-    uint8_t statusRegister;
-    uint8_t CMD;
-    uint8_t addressBytes[3];
-} w25qxx_HandleTypeDef;
-
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-/**
- * @brief Checks if the device is available and determines the number of pages
- * @param w25qxx_Handle pointer to the device handle structure
- * @return `w25qxx_Handle->error`
- */
-w25qxx_Error_t w25qxx_Init(w25qxx_HandleTypeDef *w25qxx_Handle);
-
-/**
- * @brief Writes data to w25qxx from external buffer
- * @param w25qxx_Handle pointer to the device handle structure
- * @param buf pointer to external buffer, that contains the data to send
- * @param dataLength number of bytes to write (<= 254 in case of trailingCRC)
- * @param address page address to write (multiple of 256 bytes)
- * @param trailingCRC insert or not insert CRC at the end of frame
- * @param waitForTask the way to ensure that operation is completed
- * @return `w25qxx_Handle->error`
- */
-w25qxx_Error_t w25qxx_Write(w25qxx_HandleTypeDef *w25qxx_Handle, const uint8_t *buf, uint16_t dataLength,
-                            uint32_t address, w25qxx_CRC_t trailingCRC, w25qxx_WaitForTask_t waitForTask);
-
-/**
- * @brief Reads data from w25qxx to external buffer
- * @param w25qxx_Handle pointer to the device handle structure
- * @param buf pointer to external buffer, that will contain the received data
- * @param dataLength number of bytes to read (<= 254 in case of trailingCRC)
- * @param address page address to read (multiple of 256 bytes)
- * @param trailingCRC compare or not compare CRC at the end of frame
- * @param fastRead set true if SPIclk > 50MHz
- * @return `w25qxx_Handle->error`
- */
-w25qxx_Error_t w25qxx_Read(w25qxx_HandleTypeDef *w25qxx_Handle, uint8_t *buf, uint16_t dataLength, uint32_t address,
-                           w25qxx_CRC_t trailingCRC, w25qxx_FastRead_t fastRead);
-
-/**
- * @brief Begins erase operation of sector, block or whole memory array
- * @param w25qxx_Handle pointer to the device handle structure
- * @param eraseInstruction pages groups to be erased
- * @param address start address of page, sector or block to be erased
- * @param waitForTask the way to ensure that operation is completed
- * @note Address has to be 0 in case of chip erase
- * @return `w25qxx_Handle->error`
- */
-w25qxx_Error_t w25qxx_Erase(w25qxx_HandleTypeDef *w25qxx_Handle, w25qxx_EraseInstruction_t eraseInstruction,
-                            uint32_t address, w25qxx_WaitForTask_t waitForTask);
-
-/**
- * @brief Writes a status byte from handle to device itself
- * @param w25qxx_Handle pointer to the device handle structure
- * @param statusRegisterx device target status register(1-3)
- * @param statusRegisterBehaviour keep or not the status register content after device reset
- * @return `w25qxx_Handle->error`
- */
-w25qxx_Error_t w25qxx_WriteStatus(w25qxx_HandleTypeDef *w25qxx_Handle, uint8_t statusRegisterx,
-                                  w25qxx_SR_Behaviour_t statusRegisterBehaviour);
-
-/**
- * @brief Reads a status byte from device to its handle
- * @param w25qxx_Handle pointer to the device handle structure
- * @param statusRegisterx device target status register(1-3)
- * @return `w25qxx_Handle->error`
- */
-w25qxx_Error_t w25qxx_ReadStatus(w25qxx_HandleTypeDef *w25qxx_Handle, uint8_t statusRegisterx);
-
-/**
- * @brief Resets any device errors within handle
- * @param w25qxx_Handle pointer to the device handle structure
- * @return `w25qxx_Handle->error`
- */
-w25qxx_Error_t w25qxx_ResetError(w25qxx_HandleTypeDef *w25qxx_Handle);
-
-/**
- * @brief Reads status register 1 and returns device status
- * @param w25qxx_Handle pointer to the device handle structure
- * @param timeout timeout duration to wait for ready flag [ms]
- * @return Device status `W25QXX_STATUS_READY`/`W25QXX_STATUS_BUSY` or `W25QXX_STATUS_UNDEFINED`
- * @note If no `timeout` provided, then instant device ready/busy status returned
- */
-w25qxx_Status_t w25qxx_BusyCheck(w25qxx_HandleTypeDef *w25qxx_Handle, uint32_t timeout);
-
-#ifdef __cplusplus
-}
+#pragma once
+
+#include "w25qxx_Interface.h"
+
+/* Configuration */
+// W25QXX_PART - part fixed at build time (e.g. `-DW25QXX_PART=W25Q64`), the device ID read becomes a verification only
+#ifndef W25QXX_BATCH_GAP_MAX
+#define W25QXX_BATCH_GAP_MAX 4 // Largest gap of `w25qxx_ReadBatch()` clocked through, a new read costs 4-5 bytes
+#endif
+#ifndef W25QXX_VERIFY_CHUNK_SIZE
+#define W25QXX_VERIFY_CHUNK_SIZE 16 // Read-back chunk of `w25qxx_WriteVerify()`, taken from the stack
+#endif
+
+/* Macro */
+#define W25QXX_PAGE_TO_SECTOR(PAGE)         ((PAGE) / (W25QXX_SECTOR_SIZE_4KB / W25QXX_PAGE_SIZE))
+#define W25QXX_PAGE_TO_BLOCK_32KB(PAGE)     ((PAGE) / (W25QXX_BLOCK_SIZE_32KB / W25QXX_PAGE_SIZE))
+#define W25QXX_PAGE_TO_BLOCK_64KB(PAGE)     ((PAGE) / (W25QXX_BLOCK_SIZE_64KB / W25QXX_PAGE_SIZE))
+#define W25QXX_PAGE_TO_ADDRESS(PAGE)        ((uint32_t) (PAGE) * (W25QXX_PAGE_SIZE))
+#define W25QXX_SECTOR_TO_ADDRESS(SECTOR)    ((uint32_t) (SECTOR) * W25QXX_SECTOR_SIZE_4KB)
+#define W25QXX_BLOCK_32KB_TO_ADDRESS(BLOCK) ((uint32_t) (BLOCK) * W25QXX_BLOCK_SIZE_32KB)
+#define W25QXX_BLOCK_64KB_TO_ADDRESS(BLOCK) ((uint32_t) (BLOCK) * W25QXX_BLOCK_SIZE_64KB)
+#define W25QXX_KB_TO_BYTE(KB)               ((uint32_t) (KB) * 1024)
+
+/* Device constants */
+#define W25QXX_MANUFACTURER_ID 0xEF
+#define W25QXX_PAGE_SIZE       256
+#define W25QXX_SECTOR_SIZE_4KB (W25QXX_KB_TO_BYTE(4))
+#define W25QXX_BLOCK_SIZE_32KB (W25QXX_KB_TO_BYTE(32))
+#define W25QXX_BLOCK_SIZE_64KB (W25QXX_KB_TO_BYTE(64))
+
+/* Timings [ms] */
+#define W25QXX_PAGE_PROGRAM_TIME          3
+#define W25QXX_WRITE_STATUS_REGISTER_TIME 15
+#define W25QXX_SECTOR_ERASE_TIME_4KB      400
+#define W25QXX_BLOCK_ERASE_TIME_32KB      1600
+#define W25QXX_BLOCK_ERASE_TIME_64KB      2000
+
+/* Timings [us] */
+#define W25QXX_RELEASE_POWER_DOWN_TIME 3 // tRES1
+#define W25QXX_RESET_TIME              30 // tRST
+#define W25QXX_POWER_DOWN_TIME         3 // tDP
+
+enum w25qxx_Device_e { W25Q80 = 0x13, W25Q16, W25Q32, W25Q64, W25Q128 };
+
+/* Device geometry */
+#define W25QXX_DEVICE_NUMBER_OF_PAGES(DEVICE) \
+    ((uint32_t) (W25QXX_KB_TO_BYTE(1) * W25QXX_KB_TO_BYTE(1) / W25QXX_PAGE_SIZE / 8) << ((DEVICE) - W25Q80 + 3))
+#define W25QXX_DEVICE_CHIP_ERASE_TIME(DEVICE) \
+    (((DEVICE) == W25Q80) ? (uint32_t) 12000 : ((uint32_t) 25000 << ((DEVICE) - W25Q16))) // [ms]
+#ifdef W25QXX_PART
+#define W25QXX_NUMBER_OF_PAGES W25QXX_DEVICE_NUMBER_OF_PAGES(W25QXX_PART)
+#define W25QXX_CHIP_ERASE_TIME W25QXX_DEVICE_CHIP_ERASE_TIME(W25QXX_PART)
+#endif
+
+/* Data types */
+typedef enum w25qxx_WaitForTask_e { W25QXX_WAIT_NO, W25QXX_WAIT_DELAY, W25QXX_WAIT_BUSY } w25qxx_WaitForTask_t;
+
+typedef enum w25qxx_CRC_e { W25QXX_CRC_NO, W25QXX_CRC } w25qxx_CRC_t;
+
+typedef enum w25qxx_FastRead_e { W25QXX_FASTREAD_NO, W25QXX_FASTREAD } w25qxx_FastRead_t;
+
+typedef enum w25qxx_BusWidth_e { W25QXX_BUS_SINGLE, W25QXX_BUS_QUAD } w25qxx_BusWidth_t;
+
+typedef enum w25qxx_BurstWrap_e {
+    W25QXX_WRAP_NO = 0,
+    W25QXX_WRAP_8 = 8,
+    W25QXX_WRAP_16 = 16,
+    W25QXX_WRAP_32 = 32,
+    W25QXX_WRAP_64 = 64
+} w25qxx_BurstWrap_t;
+
+typedef enum w25qxx_AsyncStage_e {
+    W25QXX_ASYNC_IDLE,
+    W25QXX_ASYNC_DATA,
+    W25QXX_ASYNC_CRC,
+    W25QXX_ASYNC_DONE // Frame transferred, /CS is still low until the task context finishes it
+} w25qxx_AsyncStage_t;
+
+typedef enum w25qxx_Defer_e { W25QXX_DEFER_NO, W25QXX_DEFER } w25qxx_Defer_t;
+
+typedef enum w25qxx_SR_Behaviour_e { W25QXX_SR_NONVOLATILE, W25QXX_SR_VOLATILE } w25qxx_SR_Behaviour_t;
+
+typedef enum w25qxx_EraseInstruction_e {
+    W25QXX_SECTOR_ERASE_4KB,
+    W25QXX_BLOCK_ERASE_32KB,
+    W25QXX_BLOCK_ERASE_64KB,
+    W25QXX_CHIP_ERASE
+} w25qxx_EraseInstruction_t;
+
+typedef enum w25qxx_Status_e {
+    W25QXX_STATUS_RESET,
+    W25QXX_STATUS_INIT,
+    W25QXX_STATUS_WRITE,
+    W25QXX_STATUS_READ,
+    W25QXX_STATUS_ERASE,
+    W25QXX_STATUS_WRITE_SR,
+    W25QXX_STATUS_READ_SR,
+    W25QXX_STATUS_CONTINUOUS_READ,
+    W25QXX_STATUS_BUSY,
+    W25QXX_STATUS_READY,
+    W25QXX_STATUS_UNDEFINED
+} w25qxx_Status_t;
+
+typedef enum w25qxx_Error_e {
+    W25QXX_ERROR_NONE,
+    W25QXX_ERROR_PLATFORM,
+    W25QXX_ERROR_ID,
+    W25QXX_ERROR_STATUS,
+    W25QXX_ERROR_ARGUMENT,
+    W25QXX_ERROR_ADDRESS,
+    W25QXX_ERROR_SPI,
+    W25QXX_ERROR_TIMEOUT,
+    W25QXX_ERROR_CHECKSUM,
+    W25QXX_ERROR_INSTRUCTION,
+    W25QXX_ERROR_VERIFY
+} w25qxx_Error_t;
+
+typedef struct w25qxx_IoVec_s {
+    void *buf; // Pointer to the memory buffer, the data source in case of write
+    uint32_t length; // Number of bytes of the buffer
+} w25qxx_IoVec_t;
+
+typedef struct w25qxx_ReadRequest_s {
+    uint32_t address; // Start address, any byte
+    uint8_t *buf; // Pointer to the destination buffer
+    uint16_t length; // Number of bytes to read
+} w25qxx_ReadRequest_t;
+
+typedef w25qxx_Transfer_Status_t (*w25qxx_rx_fp)(void *handle, uint8_t *pDataRx, uint16_t size, uint32_t timeout);
+typedef w25qxx_Transfer_Status_t (*w25qxx_tx_fp)(void *handle, const uint8_t *pDataTx, uint16_t size, uint32_t timeout);
+typedef void (*w25qxx_cs_fp)(w25qxx_CS_State_t newState);
+typedef void (*w25qxx_cs_context_fp)(void *context, w25qxx_CS_State_t newState);
+typedef void (*w25qxx_print_fp)(const char *message);
+typedef uint32_t (*w25qxx_delay_fp)(uint32_t ms);
+typedef void (*w25qxx_lock_fp)(void *context);
+typedef uint32_t (*w25qxx_tick_fp)(void);
+typedef w25qxx_Transfer_Status_t (*w25qxx_rx_async_fp)(void *handle, uint8_t *pDataRx, uint16_t size, void *owner);
+typedef w25qxx_Transfer_Status_t (*w25qxx_tx_async_fp)(void *handle, const uint8_t *pDataTx, uint16_t size,
+                                                        void *owner);
+typedef void (*w25qxx_abort_async_fp)(void *handle);
+typedef void (*w25qxx_async_complete_fp)(void *context, w25qxx_Error_t error);
+
+typedef struct w25qxx_HandleTypeDef_s {
+    struct {
+        w25qxx_rx_fp receive; // Pointer to the platform SPI receive function
+        w25qxx_tx_fp transmit; // Pointer to the platform SPI transmit function
+        w25qxx_cs_fp cs_set; // Pointer to the platform chip select set function (`NULL` if `cs_set_context` used)
+        w25qxx_delay_fp delay; // Pointer to the platform delay function
+
+        /* Optional (force `NULL` if not used) */
+        w25qxx_print_fp print; // Pointer to the function that will print debug messages
+        void *handle; // Pointer to the SPI handle be used in rx/tx function
+        w25qxx_cs_context_fp cs_set_context; // Context-aware chip select function, replaces `cs_set` if provided
+        void *cs_context; // Pointer to the chip select context be used in `cs_set_context` function
+        w25qxx_lock_fp lock; // Pointer to the function that takes the device ownership (e.g. mutex take)
+        w25qxx_lock_fp unlock; // Pointer to the function that releases the device ownership
+        void *lockContext; // Pointer to the lock object be used in lock/unlock function
+        w25qxx_delay_fp delay_us; // Pointer to the platform microsecond delay function, 1ms delay is used if `NULL`
+        w25qxx_tick_fp tick; // Pointer to the function that returns the millisecond tick (e.g. for idle time tracking)
+        w25qxx_rx_async_fp receive_async; // Pointer to the function that starts the SPI receive (e.g. DMA)
+        w25qxx_tx_async_fp transmit_async; // Pointer to the function that starts the SPI transmit (e.g. DMA)
+        w25qxx_abort_async_fp abort_async; // Pointer to the function that stops the async transfer for good
+        w25qxx_rx_fp receive_quad; // Pointer to the function that receives on IO0-IO3 (quad bus capability)
+        w25qxx_tx_fp transmit_quad; // Pointer to the function that transmits on IO0-IO3 (quad bus capability)
+    } interface;
+
+    w25qxx_Status_t status;
+    w25qxx_Error_t error;
+    uint32_t numberOfPages;
+    uint8_t ID[2];
+    bool lazyInit; // Device initialization is deferred until the first access
+    bool continuousRead; // Device is in the continuous read mode, it expects the address without instruction
+    w25qxx_BusWidth_t writeBusWidth; // Data bus width of the page program, set by `w25qxx_SetWriteBusWidth()`
+    w25qxx_BurstWrap_t burstWrap; // Wrap length of Fast Read Quad I/O, set by `w25qxx_SetBurstWrap()`
+
+    struct {
+        uint8_t value[3]; // SR1-SR3 content last read from the device
+        uint8_t valid; // Bit x-1 is set while SRx value is up to date, cleared by device reset and errors
+        uint8_t volatileWritten; // Bit x-1 is set if SRx was written as volatile, non-volatile content may differ
+        uint32_t skippedWrites; // Status writes skipped because the register already held the value
+    } statusShadow;
+
+    struct {
+        uint32_t idleTime; // Idle time before `w25qxx_PowerService()` puts the device to sleep [ms], 0 if not used
+        bool active; // Device is in the power-down mode, it is woken up by the next access
+        uint32_t lastAccess; // Tick of the last access
+        uint32_t enterTick; // Tick of the last power-down
+        uint32_t entries; // Number of power-downs
+        uint32_t wakeups; // Number of wakeups on access
+        uint32_t sleepTime; // Total time spent in the power-down [ms]
+    } powerDown;
+
+    struct {
+        volatile w25qxx_AsyncStage_t stage; // Stage of the transfer in flight
+        volatile w25qxx_Error_t error; // Result of the transfer, written by the completion before the stage
+        w25qxx_async_complete_fp complete;
+        void *context;
+        uint8_t *buf;
+        uint16_t dataLength;
+        w25qxx_CRC_t trailingCRC;
+        uint16_t CRC16; // Trailing CRC to send or the received one
+    } async;
+} w25qxx_HandleTypeDef;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Checks if the device is available and determines the number of pages
+ * @param w25qxx_Handle pointer to the device handle structure
+ * @return `w25qxx_Handle->error`
+ */
+w25qxx_Error_t w25qxx_Init(w25qxx_HandleTypeDef *w25qxx_Handle);
+
+/**
+ * @brief Initializes the device using datasheet timings instead of the fixed startup delays of `w25qxx_Init()`
+ * @param w25qxx_Handle pointer to the device handle structure
+ * @param defer initialize the device now or on its first access
+ * @note The device reset is skipped if no operation is in progress or suspended.
+ * The supply has to be stable for tVSL before the call. In case of deferred initialization `numberOfPages` is valid
+ * after the first access (immediately if `W25QXX_PART` is defined)
+ * @return `w25qxx_Handle->error`
+ */
+w25qxx_Error_t w25qxx_InitFast(w25qxx_HandleTypeDef *w25qxx_Handle, w25qxx_Defer_t defer);
+
+/**
+ * @brief Writes data to w25qxx from external buffer
+ * @param w25qxx_Handle pointer to the device handle structure
+ * @param buf pointer to external buffer, that contains the data to send
+ * @param dataLength number of bytes to write (<= 254 in case of trailingCRC)
+ * @param address page address to write (multiple of 256 bytes)
+ * @param trailingCRC insert or not insert CRC at the end of frame
+ * @param waitForTask the way to ensure that operation is completed
+ * @return `w25qxx_Handle->error`
+ */
+w25qxx_Error_t w25qxx_Write(w25qxx_HandleTypeDef *w25qxx_Handle, const uint8_t *buf, uint16_t dataLength,
+                            uint32_t address, w25qxx_CRC_t trailingCRC, w25qxx_WaitForTask_t waitForTask);
+
+/**
+ * @brief Writes data like `w25qxx_Write()` and verifies the frame by reading it back in small chunks
+ * @param w25qxx_Handle pointer to the device handle structure
+ * @param buf pointer to external buffer, that contains the data to send
+ * @param dataLength number of bytes to write (<= 254 in case of trailingCRC)
+ * @param address page address to write (multiple of 256 bytes)
+ * @param trailingCRC insert or not insert CRC at the end of frame
+ * @param mismatchOffset frame offset of the first differing byte in case of `W25QXX_ERROR_VERIFY`, `NULL` if not used
+ * @note The page is programmed once more on mismatch if its bits can still be programmed (1 -> 0). Read-back takes
+ * `W25QXX_VERIFY_CHUNK_SIZE` bytes of stack instead of a second frame buffer
+ * @return `w25qxx_Handle->error`, `W25QXX_ERROR_VERIFY` if the frame still differs
+ */
+w25qxx_Error_t w25qxx_WriteVerify(w25qxx_HandleTypeDef *w25qxx_Handle, const uint8_t *buf, uint16_t dataLength,
+                                  uint32_t address, w25qxx_CRC_t trailingCRC, uint16_t *mismatchOffset);
+
+/**
+ * @brief Writes several buffers to a contiguous range starting from any address, one page program per page
+ * @param w25qxx_Handle pointer to the device handle structure
+ * @param iov array of buffers written in order
+ * @param iovCount number of buffers
+ * @param address start address to write
+ * @param waitForTask the way to ensure that the last page program is completed
+ * @note The range must be erased. Pages but the last one are always completed by busy check, no checksum is
+ * involved (put `w25qxx_CRC16()` of the record into its own buffer)
+ * @return `w25qxx_Handle->error`
+ */
+w25qxx_Error_t w25qxx_WriteV(w25qxx_HandleTypeDef *w25qxx_Handle, const w25qxx_IoVec_t *iov, uint16_t iovCount,
+                             uint32_t address, w25qxx_WaitForTask_t waitForTask);
+
+/**
+ * @brief Selects the page program instruction used by `w25qxx_Write()`
+ * @param w25qxx_Handle pointer to the device handle structure
+ * @param busWidth `W25QXX_BUS_SINGLE` - Page Program (02h), `W25QXX_BUS_QUAD` - Quad Input Page Program (32h),
+ * the last one requires quad interface functions and QE bit set
+ * @note Clearing QE bit by `w25qxx_WriteStatus()` falls back to the single line. `w25qxx_WriteAsync()` always uses
+ * the single line
+ * @return `w25qxx_Handle->error`
+ */
+w25qxx_Error_t w25qxx_SetWriteBusWidth(w25qxx_HandleTypeDef *w25qxx_Handle, w25qxx_BusWidth_t busWidth);
+
+/**
+ * @brief Reads data from w25qxx to external buffer
+ * @param w25qxx_Handle pointer to the device handle structure
+ * @param buf pointer to external buffer, that will contain the received data
+ * @param dataLength number of bytes to read (<= 254 in case of trailingCRC)
+ * @param address page address to read (multiple of 256 bytes)
+ * @param trailingCRC compare or not compare CRC at the end of frame
+ * @param fastRead set true if SPIclk > 50MHz
+ * @note In case of `W25QXX_ERROR_CHECKSUM` the buffer is not cleared, it holds the unverified data as received
+ * (e.g. 0xFF of an erased page) for diagnostics only
+ * @return `w25qxx_Handle->error`
+ */
+w25qxx_Error_t w25qxx_Read(w25qxx_HandleTypeDef *w25qxx_Handle, uint8_t *buf, uint16_t dataLength, uint32_t address,
+                           w25qxx_CRC_t trailingCRC, w25qxx_FastRead_t fastRead);
+
+/**
+ * @brief Reads any number of bytes starting from any address with a single read instruction
+ * @param w25qxx_Handle pointer to the device handle structure
+ * @param buf pointer to external buffer, that will contain the received data
+ * @param dataLength number of bytes to read
+ * @param address start address to read
+ * @param fastRead set true if SPIclk > 50MHz
+ * @note No checksum is involved, use `w25qxx_CRC16()` to check frames within the received data
+ * @return `w25qxx_Handle->error`
+ */
+w25qxx_Error_t w25qxx_ReadStream(w25qxx_HandleTypeDef *w25qxx_Handle, uint8_t *buf, uint32_t dataLength,
+                                 uint32_t address, w25qxx_FastRead_t fastRead);
+
+/**
+ * @brief Reads a contiguous range starting from any address into several buffers with a single read instruction
+ * @param w25qxx_Handle pointer to the device handle structure
+ * @param iov array of buffers filled in order
+ * @param iovCount number of buffers
+ * @param address start address to read
+ * @param fastRead set true if SPIclk > 50MHz
+ * @return `w25qxx_Handle->error`
+ */
+w25qxx_Error_t w25qxx_ReadV(w25qxx_HandleTypeDef *w25qxx_Handle, const w25qxx_IoVec_t *iov, uint16_t iovCount,
+                            uint32_t address, w25qxx_FastRead_t fastRead);
+
+/**
+ * @brief Reads a batch of small ranges (e.g. index lookups) with as few read instructions as possible
+ * @param w25qxx_Handle pointer to the device handle structure
+ * @param requests array of ranges, each one is read into its own buffer
+ * @param numberOfRequests number of ranges
+ * @param fastRead set true if SPIclk > 50MHz
+ * @note The array is sorted by address in place. Ranges at most `W25QXX_BATCH_GAP_MAX` bytes apart are read by the
+ * same instruction with the gap clocked through, overlapping ranges start a new one
+ * @return `w25qxx_Handle->error`
+ */
+w25qxx_Error_t w25qxx_ReadBatch(w25qxx_HandleTypeDef *w25qxx_Handle, w25qxx_ReadRequest_t *requests,
+                                uint16_t numberOfRequests, w25qxx_FastRead_t fastRead);
+
+/**
+ * @brief Starts the page program, data is sent by `interface.transmit_async` without blocking the CPU
+ * @param w25qxx_Handle pointer to the device handle structure
+ * @param buf pointer to external buffer, it must stay valid until `complete` is called
+ * @param dataLength number of bytes to write (<= 254 in case of trailingCRC)
+ * @param address page address to write (multiple of 256 bytes)
+ * @param trailingCRC insert or not insert CRC at the end of frame
+ * @param complete function called (e.g. from ISR) when the frame is sent, it must not call the driver
+ * @param context pointer to the user data be used in `complete` function
+ * @note The handle stays owned by the transfer: `w25qxx_AsyncFinish()` or any other call on the handle waits for it,
+ * releases /CS in the task context and starts the page program. Requires `interface.abort_async` as well
+ * @return `w25qxx_Handle->error`, `complete` is not called if the operation has not started
+ */
+w25qxx_Error_t w25qxx_WriteAsync(w25qxx_HandleTypeDef *w25qxx_Handle, const uint8_t *buf, uint16_t dataLength,
+                                 uint32_t address, w25qxx_CRC_t trailingCRC, w25qxx_async_complete_fp complete,
+                                 void *context);
+
+/**
+ * @brief Starts the page read, data is received by `interface.receive_async` without blocking the CPU
+ * @param w25qxx_Handle pointer to the device handle structure
+ * @param buf pointer to external buffer, it must stay valid until `complete` is called
+ * @param dataLength number of bytes to read (<= 254 in case of trailingCRC)
+ * @param address page address to read (multiple of 256 bytes)
+ * @param trailingCRC compare or not compare CRC at the end of frame
+ * @param fastRead set true if SPIclk > 50MHz
+ * @param complete function called (e.g. from ISR) when the data is received and checked, it must not call the driver
+ * @param context pointer to the user data be used in `complete` function
+ * @note The handle stays owned by the transfer: `w25qxx_AsyncFinish()` or any other call on the handle waits for it
+ * and releases /CS in the task context. Checksum error leaves the unverified data in the buffer as `w25qxx_Read()`.
+ * Requires `interface.abort_async` as well
+ * @return `w25qxx_Handle->error`, `complete` is not called if the operation has not started
+ */
+w25qxx_Error_t w25qxx_ReadAsync(w25qxx_HandleTypeDef *w25qxx_Handle, uint8_t *buf, uint16_t dataLength,
+                                uint32_t address, w25qxx_CRC_t trailingCRC, w25qxx_FastRead_t fastRead,
+                                w25qxx_async_complete_fp complete, void *context);
+
+/**
+ * @brief Ends the transfer started by `w25qxx_WriteAsync()`/`w25qxx_ReadAsync()`, call it from the task context
+ * @param w25qxx_Handle pointer to the device handle structure
+ * @note Waits for the data phase, /CS goes high here, so the bus of `w25qxx_BusAttach()` is released by the caller.
+ * The transfer that is not complete within the timeout is stopped by `interface.abort_async`
+ * @return `w25qxx_Handle->error`, the result of the transfer
+ */
+w25qxx_Error_t w25qxx_AsyncFinish(w25qxx_HandleTypeDef *w25qxx_Handle);
+
+/**
+ * @brief Advances the transfer in flight, call it from the platform transfer complete handler (e.g. DMA ISR)
+ * @param w25qxx_Handle pointer to the device handle structure passed as `owner` to the async function
+ * @param transferStatus result of the finished transfer
+ * @note Only the handle is touched, /CS is left low for `w25qxx_AsyncFinish()`
+ */
+void w25qxx_TransferComplete(w25qxx_HandleTypeDef *w25qxx_Handle, w25qxx_Transfer_Status_t transferStatus);
+
+/**
+ * @brief Starts the continuous read session, requires quad interface functions and QE bit set
+ * @param w25qxx_Handle pointer to the device handle structure
+ * @note Only `w25qxx_ContinuousRead()` is allowed until `w25qxx_ContinuousReadEnd()` (or `w25qxx_ResetError()`)
+ * @return `w25qxx_Handle->error`
+ */
+w25qxx_Error_t w25qxx_ContinuousReadBegin(w25qxx_HandleTypeDef *w25qxx_Handle);
+
+/**
+ * @brief Reads data by Fast Read Quad I/O with continuous read mode bits set, all reads of the session but the
+ * first one are sent without the instruction byte
+ * @param w25qxx_Handle pointer to the device handle structure
+ * @param buf pointer to external buffer, that will contain the received data
+ * @param dataLength number of bytes to read
+ * @param address any address to read from
+ * @return `w25qxx_Handle->error`
+ */
+w25qxx_Error_t w25qxx_ContinuousRead(w25qxx_HandleTypeDef *w25qxx_Handle, uint8_t *buf, uint16_t dataLength,
+                                     uint32_t address);
+
+/**
+ * @brief Leaves the continuous read mode by the mode reset sequence and ends the session
+ * @param w25qxx_Handle pointer to the device handle structure
+ * @return `w25qxx_Handle->error`
+ */
+w25qxx_Error_t w25qxx_ContinuousReadEnd(w25qxx_HandleTypeDef *w25qxx_Handle);
+
+/**
+ * @brief Sets the wrap length of Fast Read Quad I/O by Set Burst with Wrap, requires quad interface functions and QE
+ * bit set
+ * @param w25qxx_Handle pointer to the device handle structure
+ * @param burstWrap wrap length of 8/16/32/64 bytes, `W25QXX_WRAP_NO` to read linearly again
+ * @note Reads of the continuous read session wrap as well, device reset turns the wrap off
+ * @return `w25qxx_Handle->error`
+ */
+w25qxx_Error_t w25qxx_SetBurstWrap(w25qxx_HandleTypeDef *w25qxx_Handle, w25qxx_BurstWrap_t burstWrap);
+
+/**
+ * @brief Reads a line critical byte first by Fast Read Quad I/O, the data wraps around within the aligned line of
+ * `burstWrap` bytes (e.g. for a cache line fill)
+ * @param w25qxx_Handle pointer to the device handle structure
+ * @param buf pointer to external buffer, that will contain the received data
+ * @param dataLength number of bytes to read, usually `burstWrap`
+ * @param address any address within the line, the first byte received
+ * @note `w25qxx_SetBurstWrap()` has to be called first
+ * @return `w25qxx_Handle->error`
+ */
+w25qxx_Error_t w25qxx_ReadBurst(w25qxx_HandleTypeDef *w25qxx_Handle, uint8_t *buf, uint16_t dataLength,
+                                uint32_t address);
+
+/**
+ * @brief Begins erase operation of sector, block or whole memory array
+ * @param w25qxx_Handle pointer to the device handle structure
+ * @param eraseInstruction pages groups to be erased
+ * @param address start address of page, sector or block to be erased
+ * @param waitForTask the way to ensure that operation is completed
+ * @note Address has to be 0 in case of chip erase
+ * @return `w25qxx_Handle->error`
+ */
+w25qxx_Error_t w25qxx_Erase(w25qxx_HandleTypeDef *w25qxx_Handle, w25qxx_EraseInstruction_t eraseInstruction,
+                            uint32_t address, w25qxx_WaitForTask_t waitForTask);
+
+/**
+ * @brief Writes a status byte to the device
+ * @param w25qxx_Handle pointer to the device handle structure
+ * @param statusRegisterx device target status register(1-3)
+ * @param value new content of the status register
+ * @param statusRegisterBehaviour keep or not the status register content after device reset
+ * @note Write is skipped if the register already holds the value (`statusShadow`), the register is read once after
+ * device reset for that. Written register is read back into the shadow
+ * @return `w25qxx_Handle->error`
+ */
+w25qxx_Error_t w25qxx_WriteStatus(w25qxx_HandleTypeDef *w25qxx_Handle, uint8_t statusRegisterx, uint8_t value,
+                                  w25qxx_SR_Behaviour_t statusRegisterBehaviour);
+
+/**
+ * @brief Reads a status byte from the device
+ * @param w25qxx_Handle pointer to the device handle structure
+ * @param statusRegisterx device target status register(1-3)
+ * @param value pointer to the received content of the status register
+ * @return `w25qxx_Handle->error`
+ */
+w25qxx_Error_t w25qxx_ReadStatus(w25qxx_HandleTypeDef *w25qxx_Handle, uint8_t statusRegisterx, uint8_t *value);
+
+/**
+ * @brief Resets any device errors within handle
+ * @param w25qxx_Handle pointer to the device handle structure
+ * @return `w25qxx_Handle->error`
+ */
+w25qxx_Error_t w25qxx_ResetError(w25qxx_HandleTypeDef *w25qxx_Handle);
+
+/**
+ * @brief Reads status register 1 and returns device status
+ * @param w25qxx_Handle pointer to the device handle structure
+ * @param timeout timeout duration to wait for ready flag [ms]
+ * @return Device status `W25QXX_STATUS_READY`/`W25QXX_STATUS_BUSY` or `W25QXX_STATUS_UNDEFINED`
+ * @note If no `timeout` provided, then instant device ready/busy status returned. During the continuous read session
+ * `W25QXX_STATUS_UNDEFINED` is returned without sending the instruction
+ */
+w25qxx_Status_t w25qxx_BusyCheck(w25qxx_HandleTypeDef *w25qxx_Handle, uint32_t timeout);
+
+/**
+ * @brief Puts the device into the deep power-down mode, the next access wakes it up automatically
+ * @param w25qxx_Handle pointer to the device handle structure
+ * @note The instruction is not accepted while a program/erase is in progress
+ * @return `w25qxx_Handle->error`
+ */
+w25qxx_Error_t w25qxx_PowerDown(w25qxx_HandleTypeDef *w25qxx_Handle);
+
+/**
+ * @brief Puts the device into the deep power-down mode after `powerDown.idleTime` without access
+ * @param w25qxx_Handle pointer to the device handle structure
+ * @note Call it periodically (e.g. from the idle task), `interface.tick` is required
+ * @return `w25qxx_Handle->error`
+ */
+w25qxx_Error_t w25qxx_PowerService(w25qxx_HandleTypeDef *w25qxx_Handle);
+
+/**
+ * @brief Calculates ModBus CRC of the buffer, the same one is used as trailing CRC of a frame
+ * @param pBuffer pointer to the data
+ * @param bufSize number of bytes
+ * @return CRC16 value
+ */
+uint16_t w25qxx_CRC16(const uint8_t *pBuffer, uint16_t bufSize);
+
+#ifdef __cplusplus
+}
 #endif
\ No newline at end of file
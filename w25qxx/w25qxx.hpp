@@ -0,0 +1,563 @@
+#pragma once
+
+#include "w25qxx.h"
+#include <stddef.h>
+
+#if defined(__has_include)
+#if __has_include(<span>) && (__cplusplus > 201703L)
+#include <span>
+#define W25QXX_STD_SPAN
+#endif
+#endif
+
+namespace w25qxx
+{
+
+/* Data types */
+#ifdef W25QXX_STD_SPAN
+template <class T> using Span = std::span<T>;
+#else
+/**
+ * @brief Minimal `std::span` replacement for C++17 and freestanding toolchains (e.g. avr-gcc)
+ */
+template <class T> class Span
+{
+  public:
+    constexpr Span() : pData(nullptr), dataSize(0) {}
+    constexpr Span(T *pointer, size_t count) : pData(pointer), dataSize(count) {}
+    template <size_t N> constexpr Span(T (&array)[N]) : pData(array), dataSize(N) {}
+    template <class U> constexpr Span(const Span<U> &other) : pData(other.data()), dataSize(other.size()) {}
+
+    constexpr T *data() const { return pData; }
+    constexpr size_t size() const { return dataSize; }
+    constexpr T *begin() const { return pData; }
+    constexpr T *end() const { return pData + dataSize; }
+    constexpr T &operator[](size_t index) const { return pData[index]; }
+
+  private:
+    T *pData;
+    size_t dataSize;
+};
+#endif
+
+/**
+ * @brief Geometry and timings of the part known at compile time
+ * @tparam Part device ID (`W25Q80`...`W25Q128`)
+ */
+template <uint8_t Part> struct Geometry
+{
+    static_assert((Part >= W25Q80) && (Part <= W25Q128), "Unsupported device");
+
+    static constexpr uint32_t numberOfPages = W25QXX_DEVICE_NUMBER_OF_PAGES(Part);
+    static constexpr uint32_t capacity = W25QXX_PAGE_TO_ADDRESS(numberOfPages);
+    static constexpr uint32_t chipEraseTime = W25QXX_DEVICE_CHIP_ERASE_TIME(Part); // [ms]
+};
+
+/**
+ * @brief Calculates ModBus CRC of the buffer, the same one is used as trailing CRC by the C driver
+ * @param pBuffer pointer to the data
+ * @param bufSize number of bytes
+ * @return CRC16 value
+ */
+constexpr uint16_t CRC16(const uint8_t *pBuffer, size_t bufSize)
+{
+    uint16_t CRC = 0xffff;
+
+    for (size_t i = 0; i < bufSize; i++)
+    {
+        CRC ^= pBuffer[i];
+
+        for (uint8_t j = 0; j < 8; j++)
+            CRC = (CRC & 1) ? ((CRC >> 1) ^ 0xA001) : (CRC >> 1);
+    }
+
+    return CRC;
+}
+
+} // namespace w25qxx
+
+/**
+ * @brief Device bound to the platform at compile time, every platform call can be inlined
+ * @tparam Bus type with `static w25qxx_Transfer_Status_t transmit(const uint8_t *pDataTx, uint16_t size,
+ * uint32_t timeout)` and `static w25qxx_Transfer_Status_t receive(uint8_t *pDataRx, uint16_t size, uint32_t timeout)`
+ * @tparam Cs type with `static void set(w25qxx_CS_State_t newState)`
+ * @tparam Clock type with `static uint32_t delay(uint32_t ms)` returning the actual delay [ms]
+ * @tparam Part device ID (`W25Q80`...`W25Q128`), the ID read by `Init()` is only verified against it
+ * @note Behaviour matches the C driver: page-aligned write/read with optional trailing CRC and sticky error.
+ * No heap, no virtual calls, no function pointers
+ */
+template <class Bus, class Cs, class Clock, uint8_t Part = W25Q128> class W25qxx
+{
+  public:
+    using Geometry = w25qxx::Geometry<Part>;
+
+    static constexpr uint32_t numberOfPages = Geometry::numberOfPages;
+    static constexpr uint32_t capacity = Geometry::capacity;
+
+    /**
+     * @brief Wakes and resets the device, then checks its ID against `Part`
+     * @return `Error()`
+     */
+    w25qxx_Error_t Init()
+    {
+        if (status != W25QXX_STATUS_RESET)
+            return Fail(W25QXX_ERROR_STATUS);
+
+        /* Start operation */
+        Cs::set(W25QXX_CS_HIGH);
+        Clock::delay(100);
+        if (!Command(CMD_RELEASE_POWER_DOWN))
+            return error;
+        Clock::delay(1);
+        if (!Command(CMD_ENABLE_RESET) || !Command(CMD_RESET_DEVICE))
+            return error;
+        Clock::delay(1);
+
+        /* Get the Manufacturer ID and Device ID, 24-bit address (A23-A0) of 000000h */
+        if (!Begin(CMD_MANUFACTURER_DEVICE_ID, 0, false) || !Receive(ID, sizeof(ID)))
+            return error;
+        Cs::set(W25QXX_CS_HIGH);
+        if ((ID[0] != W25QXX_MANUFACTURER_ID) || (ID[1] != Part))
+            return Fail(W25QXX_ERROR_ID);
+        Clock::delay(10);
+
+        status = W25QXX_STATUS_READY;
+
+        return error;
+    }
+
+    /**
+     * @brief Writes data to the page
+     * @param data data to send (<= 254 bytes in case of trailingCRC)
+     * @param address page address to write (multiple of 256 bytes)
+     * @param trailingCRC insert or not insert CRC at the end of frame
+     * @param waitForTask the way to ensure that operation is completed
+     * @return `Error()`
+     */
+    w25qxx_Error_t Write(w25qxx::Span<const uint8_t> data, uint32_t address, w25qxx_CRC_t trailingCRC = W25QXX_CRC_NO,
+                         w25qxx_WaitForTask_t waitForTask = W25QXX_WAIT_BUSY)
+    {
+        uint16_t CRC16;
+
+        if (!Ready())
+            return error;
+
+        /* Argument guards */
+        if (!FrameCheck(data.data(), data.size(), address, trailingCRC))
+            return error;
+
+        /* Command */
+        if (!Command(CMD_WRITE_ENABLE) || !Begin(CMD_PAGE_PROGRAM, address, false))
+            return error;
+        if (!Transmit(data.data(), data.size()))
+            return error;
+
+        /* Checksum */
+        if (trailingCRC == W25QXX_CRC)
+        {
+            CRC16 = w25qxx::CRC16(data.data(), data.size());
+            if (!Transmit(reinterpret_cast<const uint8_t *>(&CRC16), sizeof(CRC16)))
+                return error;
+        }
+        Cs::set(W25QXX_CS_HIGH);
+
+        return Wait(waitForTask, W25QXX_PAGE_PROGRAM_TIME);
+    }
+
+    /**
+     * @brief Reads data from the page
+     * @param data destination (<= 254 bytes in case of trailingCRC)
+     * @param address page address to read (multiple of 256 bytes)
+     * @param trailingCRC compare or not compare CRC at the end of frame
+     * @param fastRead set true if SPIclk > 50MHz
+     * @note In case of `W25QXX_ERROR_CHECKSUM` the buffer is not cleared, it holds the unverified data as received
+     * (e.g. 0xFF of an erased page) for diagnostics only
+     * @return `Error()`
+     */
+    w25qxx_Error_t Read(w25qxx::Span<uint8_t> data, uint32_t address, w25qxx_CRC_t trailingCRC = W25QXX_CRC_NO,
+                        w25qxx_FastRead_t fastRead = W25QXX_FASTREAD_NO)
+    {
+        uint16_t receivedCRC16;
+
+        if (!Ready())
+            return error;
+
+        /* Argument guards */
+        if (!FrameCheck(data.data(), data.size(), address, trailingCRC))
+            return error;
+
+        /* Command */
+        if (!Begin(ReadInstruction(fastRead), address, fastRead == W25QXX_FASTREAD))
+            return error;
+        if (!Receive(data.data(), data.size()))
+            return error;
+        if ((trailingCRC == W25QXX_CRC) && !Receive(reinterpret_cast<uint8_t *>(&receivedCRC16), sizeof(receivedCRC16)))
+            return error;
+        Cs::set(W25QXX_CS_HIGH);
+
+        /* Checksum compare */
+        if ((trailingCRC == W25QXX_CRC) && (w25qxx::CRC16(data.data(), data.size()) != receivedCRC16))
+            return Fail(W25QXX_ERROR_CHECKSUM);
+
+        return error;
+    }
+
+    /**
+     * @brief Reads any number of bytes starting from any address with a single read instruction
+     * @param data destination
+     * @param address start address to read
+     * @param fastRead set true if SPIclk > 50MHz
+     * @return `Error()`
+     */
+    w25qxx_Error_t ReadStream(w25qxx::Span<uint8_t> data, uint32_t address,
+                              w25qxx_FastRead_t fastRead = W25QXX_FASTREAD_NO)
+    {
+        if (!Ready())
+            return error;
+
+        /* Argument guards */
+        if ((data.data() == nullptr) || (data.size() == 0))
+            return Fail(W25QXX_ERROR_ARGUMENT);
+        if ((address >= capacity) || (data.size() > (capacity - address)))
+            return Fail(W25QXX_ERROR_ADDRESS);
+
+        /* Command */
+        if (!Begin(ReadInstruction(fastRead), address, fastRead == W25QXX_FASTREAD))
+            return error;
+        if (!Receive(data.data(), data.size()))
+            return error;
+        Cs::set(W25QXX_CS_HIGH);
+
+        return error;
+    }
+
+    /**
+     * @brief Begins erase operation of sector, block or whole memory array
+     * @param eraseInstruction pages groups to be erased
+     * @param address start address of sector or block to be erased, 0 in case of chip erase
+     * @param waitForTask the way to ensure that operation is completed
+     * @return `Error()`
+     */
+    w25qxx_Error_t Erase(w25qxx_EraseInstruction_t eraseInstruction, uint32_t address,
+                         w25qxx_WaitForTask_t waitForTask = W25QXX_WAIT_BUSY)
+    {
+        uint32_t size, time;
+        uint8_t CMD;
+
+        if (!Ready())
+            return error;
+
+        switch (eraseInstruction)
+        {
+        case W25QXX_SECTOR_ERASE_4KB:
+            CMD = CMD_SECTOR_ERASE_4KB;
+            size = W25QXX_SECTOR_SIZE_4KB;
+            time = W25QXX_SECTOR_ERASE_TIME_4KB;
+            break;
+
+        case W25QXX_BLOCK_ERASE_32KB:
+            CMD = CMD_BLOCK_ERASE_32KB;
+            size = W25QXX_BLOCK_SIZE_32KB;
+            time = W25QXX_BLOCK_ERASE_TIME_32KB;
+            break;
+
+        case W25QXX_BLOCK_ERASE_64KB:
+            CMD = CMD_BLOCK_ERASE_64KB;
+            size = W25QXX_BLOCK_SIZE_64KB;
+            time = W25QXX_BLOCK_ERASE_TIME_64KB;
+            break;
+
+        case W25QXX_CHIP_ERASE:
+            if (address != 0)
+                return Fail(W25QXX_ERROR_ADDRESS);
+
+            if (!Command(CMD_WRITE_ENABLE) || !Command(CMD_CHIP_ERASE))
+                return error;
+
+            return Wait(waitForTask, Geometry::chipEraseTime);
+
+        default:
+            return Fail(W25QXX_ERROR_INSTRUCTION);
+        }
+
+        /* Address guards */
+        if (((address % size) != 0) || (address > (capacity - size)))
+            return Fail(W25QXX_ERROR_ADDRESS);
+
+        /* Command */
+        if (!Command(CMD_WRITE_ENABLE) || !Begin(CMD, address, false))
+            return error;
+        Cs::set(W25QXX_CS_HIGH);
+
+        return Wait(waitForTask, time);
+    }
+
+    /**
+     * @brief Writes a status register
+     * @param statusRegisterx device target status register(1-3)
+     * @param value new register content
+     * @param statusRegisterBehaviour keep or not the status register content after device reset
+     * @return `Error()`
+     */
+    w25qxx_Error_t WriteStatus(uint8_t statusRegisterx, uint8_t value,
+                               w25qxx_SR_Behaviour_t statusRegisterBehaviour = W25QXX_SR_NONVOLATILE)
+    {
+        static constexpr uint8_t instruction[] = {CMD_WRITE_STATUS_REGISTER1, CMD_WRITE_STATUS_REGISTER2,
+                                                  CMD_WRITE_STATUS_REGISTER3};
+        uint8_t frame[2];
+
+        if (!Ready())
+            return error;
+
+        /* Argument guards */
+        if ((statusRegisterx < 1u) || (statusRegisterx > 3u))
+            return Fail(W25QXX_ERROR_ARGUMENT);
+
+        /* Command */
+        if (!Command((statusRegisterBehaviour == W25QXX_SR_VOLATILE) ? CMD_VOLATILE_SR_WRITE_ENABLE
+                                                                     : CMD_WRITE_ENABLE))
+            return error;
+        frame[0] = instruction[statusRegisterx - 1u];
+        frame[1] = value;
+        Cs::set(W25QXX_CS_LOW);
+        if (!Transmit(frame, sizeof(frame)))
+            return error;
+        Cs::set(W25QXX_CS_HIGH);
+
+        /* Task wait */
+        if (statusRegisterBehaviour == W25QXX_SR_VOLATILE)
+            return error;
+
+        return Wait(W25QXX_WAIT_BUSY, W25QXX_WRITE_STATUS_REGISTER_TIME);
+    }
+
+    /**
+     * @brief Reads a status register
+     * @param statusRegisterx device target status register(1-3)
+     * @param value destination of the register content
+     * @return `Error()`
+     */
+    w25qxx_Error_t ReadStatus(uint8_t statusRegisterx, uint8_t &value)
+    {
+        static constexpr uint8_t instruction[] = {CMD_READ_STATUS_REGISTER1, CMD_READ_STATUS_REGISTER2,
+                                                  CMD_READ_STATUS_REGISTER3};
+
+        if (!Ready())
+            return error;
+
+        /* Argument guards */
+        if ((statusRegisterx < 1u) || (statusRegisterx > 3u))
+            return Fail(W25QXX_ERROR_ARGUMENT);
+
+        /* Command */
+        Cs::set(W25QXX_CS_LOW);
+        if (!Transmit(&instruction[statusRegisterx - 1u], 1) || !Receive(&value, sizeof(value)))
+            return error;
+        Cs::set(W25QXX_CS_HIGH);
+
+        return error;
+    }
+
+    /**
+     * @brief Reads status register 1 and returns device status
+     * @param timeout timeout duration to wait for ready flag [ms]
+     * @note If no `timeout` provided, then instant device ready/busy status returned
+     * @return Device status `W25QXX_STATUS_READY`/`W25QXX_STATUS_BUSY` or `W25QXX_STATUS_UNDEFINED`
+     */
+    w25qxx_Status_t BusyCheck(uint32_t timeout = 0)
+    {
+        static constexpr uint8_t CMD = CMD_READ_STATUS_REGISTER1;
+        uint32_t delayActual;
+        uint8_t statusRegister;
+
+        /* Existing errors check */
+        if (error != W25QXX_ERROR_NONE)
+            return W25QXX_STATUS_UNDEFINED;
+
+        /* Start polling, chip is deselected between polls to keep the bus available for other devices */
+        while (true)
+        {
+            Cs::set(W25QXX_CS_LOW);
+            if (!Transmit(&CMD, sizeof(CMD)) || !Receive(&statusRegister, sizeof(statusRegister)))
+                return W25QXX_STATUS_UNDEFINED;
+            Cs::set(W25QXX_CS_HIGH);
+
+            /* Get busy bit state */
+            if ((statusRegister & (1u << 0)) == 0)
+                return W25QXX_STATUS_READY;
+
+            /* Timeout handling */
+            if (timeout == 0)
+                return W25QXX_STATUS_BUSY;
+            delayActual = Clock::delay(1);
+            timeout = ((delayActual == 0) || (timeout < delayActual)) ? 0 : (timeout - delayActual);
+        }
+    }
+
+    /**
+     * @brief Resets the device error
+     * @return `Error()`
+     */
+    w25qxx_Error_t ResetError()
+    {
+        /* Existing errors check */
+        if (error == W25QXX_ERROR_NONE)
+            return error;
+
+        /* Try to get response from device */
+        error = W25QXX_ERROR_NONE;
+        if (BusyCheck(RESPONSE_TIMEOUT) != W25QXX_STATUS_READY)
+            return Fail(W25QXX_ERROR_TIMEOUT);
+
+        return error;
+    }
+
+    w25qxx_Error_t Error() const { return error; }
+    w25qxx_Status_t Status() const { return status; }
+    const uint8_t *DeviceID() const { return ID; }
+
+  private:
+    /* Instruction Set */
+    static constexpr uint8_t CMD_WRITE_ENABLE = 0x06;
+    static constexpr uint8_t CMD_VOLATILE_SR_WRITE_ENABLE = 0x50;
+    static constexpr uint8_t CMD_RELEASE_POWER_DOWN = 0xAB;
+    static constexpr uint8_t CMD_MANUFACTURER_DEVICE_ID = 0x90;
+    static constexpr uint8_t CMD_READ_DATA = 0x03;
+    static constexpr uint8_t CMD_FAST_READ = 0x0B;
+    static constexpr uint8_t CMD_PAGE_PROGRAM = 0x02;
+    static constexpr uint8_t CMD_SECTOR_ERASE_4KB = 0x20;
+    static constexpr uint8_t CMD_BLOCK_ERASE_32KB = 0x52;
+    static constexpr uint8_t CMD_BLOCK_ERASE_64KB = 0xD8;
+    static constexpr uint8_t CMD_CHIP_ERASE = 0xC7;
+    static constexpr uint8_t CMD_READ_STATUS_REGISTER1 = 0x05;
+    static constexpr uint8_t CMD_WRITE_STATUS_REGISTER1 = 0x01;
+    static constexpr uint8_t CMD_READ_STATUS_REGISTER2 = 0x35;
+    static constexpr uint8_t CMD_WRITE_STATUS_REGISTER2 = 0x31;
+    static constexpr uint8_t CMD_READ_STATUS_REGISTER3 = 0x15;
+    static constexpr uint8_t CMD_WRITE_STATUS_REGISTER3 = 0x11;
+    static constexpr uint8_t CMD_ENABLE_RESET = 0x66;
+    static constexpr uint8_t CMD_RESET_DEVICE = 0x99;
+
+    /* Timeouts [ms] */
+    static constexpr uint32_t TX_TIMEOUT = 100;
+    static constexpr uint32_t RX_TIMEOUT = 100;
+    static constexpr uint32_t RESPONSE_TIMEOUT = 100;
+
+    w25qxx_Status_t status = W25QXX_STATUS_RESET;
+    w25qxx_Error_t error = W25QXX_ERROR_NONE;
+    uint8_t ID[2] = {0, 0};
+
+    static constexpr uint8_t ReadInstruction(w25qxx_FastRead_t fastRead)
+    {
+        return (fastRead == W25QXX_FASTREAD) ? CMD_FAST_READ : CMD_READ_DATA;
+    }
+
+    w25qxx_Error_t Fail(w25qxx_Error_t newError)
+    {
+        Cs::set(W25QXX_CS_HIGH);
+
+        return error = newError;
+    }
+
+    bool Abort(w25qxx_Error_t newError)
+    {
+        Fail(newError);
+
+        return false;
+    }
+
+    bool Ready()
+    {
+        if (error != W25QXX_ERROR_NONE)
+            return false;
+        if (status != W25QXX_STATUS_READY)
+            return Abort(W25QXX_ERROR_STATUS);
+
+        return true;
+    }
+
+    bool FrameCheck(const uint8_t *buf, size_t dataLength, uint32_t address, w25qxx_CRC_t trailingCRC)
+    {
+        if ((buf == nullptr) || (dataLength == 0))
+            return Abort(W25QXX_ERROR_ARGUMENT);
+        if ((dataLength + ((trailingCRC == W25QXX_CRC) ? sizeof(uint16_t) : 0)) > W25QXX_PAGE_SIZE)
+            return Abort(W25QXX_ERROR_ARGUMENT);
+        if (((address % W25QXX_PAGE_SIZE) != 0) || (address > (W25QXX_PAGE_SIZE * (numberOfPages - 1))))
+            return Abort(W25QXX_ERROR_ADDRESS);
+
+        return true;
+    }
+
+    bool Transmit(const uint8_t *pDataTx, size_t size)
+    {
+        uint16_t chunkLength;
+
+        for (; size > 0; pDataTx += chunkLength, size -= chunkLength)
+        {
+            chunkLength = (size > UINT16_MAX) ? UINT16_MAX : static_cast<uint16_t>(size);
+            if (Bus::transmit(pDataTx, chunkLength, TX_TIMEOUT) != W25QXX_TRANSFER_SUCCESS)
+                return Abort(W25QXX_ERROR_SPI);
+        }
+
+        return true;
+    }
+
+    bool Receive(uint8_t *pDataRx, size_t size)
+    {
+        uint16_t chunkLength;
+
+        for (; size > 0; pDataRx += chunkLength, size -= chunkLength)
+        {
+            chunkLength = (size > UINT16_MAX) ? UINT16_MAX : static_cast<uint16_t>(size);
+            if (Bus::receive(pDataRx, chunkLength, RX_TIMEOUT) != W25QXX_TRANSFER_SUCCESS)
+                return Abort(W25QXX_ERROR_SPI);
+        }
+
+        return true;
+    }
+
+    /* Single byte instruction framed by chip select */
+    bool Command(uint8_t CMD)
+    {
+        Cs::set(W25QXX_CS_LOW);
+        if (!Transmit(&CMD, sizeof(CMD)))
+            return false;
+        Cs::set(W25QXX_CS_HIGH);
+
+        return true;
+    }
+
+    /* Instruction, A23-A0 and optional 8 dummy clocks in one transfer, chip stays selected */
+    bool Begin(uint8_t CMD, uint32_t address, bool dummy)
+    {
+        const uint8_t header[5] = {CMD, static_cast<uint8_t>(address >> 16), static_cast<uint8_t>(address >> 8),
+                                   static_cast<uint8_t>(address >> 0), CMD};
+
+        Cs::set(W25QXX_CS_LOW);
+
+        return Transmit(header, dummy ? 5 : 4);
+    }
+
+    w25qxx_Error_t Wait(w25qxx_WaitForTask_t waitForTask, uint32_t time)
+    {
+        switch (waitForTask)
+        {
+        case W25QXX_WAIT_NO:
+            break;
+
+        case W25QXX_WAIT_DELAY:
+            Clock::delay(time);
+            break;
+
+        case W25QXX_WAIT_BUSY:
+            if (BusyCheck(time) != W25QXX_STATUS_READY)
+                return (error != W25QXX_ERROR_NONE) ? error : Fail(W25QXX_ERROR_TIMEOUT);
+            break;
+
+        default:
+            return Fail(W25QXX_ERROR_ARGUMENT);
+        }
+
+        return error;
+    }
+};
\ No newline at end of file
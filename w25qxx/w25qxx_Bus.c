@@ -0,0 +1,74 @@
+#include "w25qxx_Bus.h"
+
+/**
+ * @brief Chip select hook of the attached device, serializes transactions on the shared bus
+ * @param context pointer to the bus device structure
+ * @param newState new CS pin state
+ */
+static void w25qxx_BusSelect(void *context, w25qxx_CS_State_t newState);
+
+w25qxx_Error_t w25qxx_BusAttach(w25qxx_BusTypeDef *w25qxx_Bus, w25qxx_BusDeviceTypeDef *w25qxx_BusDevice,
+                                w25qxx_cs_context_fp cs_set, void *cs_context, w25qxx_print_fp print)
+{
+    /* Avoid dereferencing the null handle */
+    if ((w25qxx_Bus == NULL) || (w25qxx_BusDevice == NULL))
+        return W25QXX_ERROR_ARGUMENT;
+
+    /* Argument guards */
+    if ((w25qxx_Bus->interface.receive == NULL) || (w25qxx_Bus->interface.transmit == NULL) || (cs_set == NULL))
+        return W25QXX_ERROR_PLATFORM;
+    if ((w25qxx_Bus->interface.lock == NULL) != (w25qxx_Bus->interface.unlock == NULL))
+        return W25QXX_ERROR_PLATFORM;
+
+    /* Set up handle fields to its default state */
+    memset(w25qxx_BusDevice, 0, sizeof(*w25qxx_BusDevice));
+    w25qxx_BusDevice->bus = w25qxx_Bus;
+    w25qxx_BusDevice->cs_set = cs_set;
+    w25qxx_BusDevice->cs_context = cs_context;
+
+    /* Link platform functions */
+    w25qxx_BusDevice->w25qxx_Handle.interface.handle = w25qxx_Bus->interface.handle;
+    w25qxx_BusDevice->w25qxx_Handle.interface.receive = w25qxx_Bus->interface.receive;
+    w25qxx_BusDevice->w25qxx_Handle.interface.transmit = w25qxx_Bus->interface.transmit;
+    w25qxx_BusDevice->w25qxx_Handle.interface.cs_set_context = w25qxx_BusSelect;
+    w25qxx_BusDevice->w25qxx_Handle.interface.cs_context = w25qxx_BusDevice;
+    w25qxx_BusDevice->w25qxx_Handle.interface.delay = w25qxx_Delay;
+    w25qxx_BusDevice->w25qxx_Handle.interface.print = print;
+
+    return w25qxx_BusDevice->w25qxx_Handle.error;
+}
+
+/**
+ * @section Private functions
+ */
+static void w25qxx_BusSelect(void *context, w25qxx_CS_State_t newState)
+{
+    w25qxx_BusDeviceTypeDef *w25qxx_BusDevice = context;
+    w25qxx_BusTypeDef *w25qxx_Bus = w25qxx_BusDevice->bus;
+
+    switch (newState)
+    {
+    case W25QXX_CS_LOW:
+        if (!w25qxx_BusDevice->selected)
+        {
+            if (w25qxx_Bus->interface.lock != NULL)
+                w25qxx_Bus->interface.lock(w25qxx_Bus->interface.lockContext);
+            w25qxx_BusDevice->selected = true;
+        }
+        w25qxx_BusDevice->cs_set(w25qxx_BusDevice->cs_context, W25QXX_CS_LOW);
+        break;
+
+    case W25QXX_CS_HIGH:
+        w25qxx_BusDevice->cs_set(w25qxx_BusDevice->cs_context, W25QXX_CS_HIGH);
+        if (w25qxx_BusDevice->selected)
+        {
+            w25qxx_BusDevice->selected = false;
+            if (w25qxx_Bus->interface.unlock != NULL)
+                w25qxx_Bus->interface.unlock(w25qxx_Bus->interface.lockContext);
+        }
+        break;
+
+    default:
+        break;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "w25qxx.h"
+
+/* Data types */
+typedef struct w25qxx_BusTypeDef_s {
+    struct {
+        w25qxx_rx_fp receive; // Pointer to the platform SPI receive function
+        w25qxx_tx_fp transmit; // Pointer to the platform SPI transmit function
+
+        /* Optional (force `NULL` if not used) */
+        void *handle; // Pointer to the SPI handle be used in rx/tx function
+        w25qxx_lock_fp lock; // Pointer to the function that takes the bus ownership
+        w25qxx_lock_fp unlock; // Pointer to the function that releases the bus ownership
+        void *lockContext; // Pointer to the lock object (e.g. mutex) be used in lock/unlock function
+    } interface;
+} w25qxx_BusTypeDef;
+
+typedef struct w25qxx_BusDeviceTypeDef_s {
+    w25qxx_HandleTypeDef w25qxx_Handle; // Device handle to be used with the regular driver API
+    w25qxx_BusTypeDef *bus;
+    w25qxx_cs_context_fp cs_set; // Board chip select function shared between devices
+    void *cs_context; // Device specific chip select descriptor (e.g. GPIO pin) passed to `cs_set`
+    bool selected;
+} w25qxx_BusDeviceTypeDef;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Links a device to the bus: SPI functions are taken from the bus, chip select from the device
+ * @param w25qxx_Bus pointer to the bus structure with initialized interface
+ * @param w25qxx_BusDevice pointer to the device structure
+ * @param cs_set board chip select function
+ * @param cs_context device specific chip select descriptor
+ * @param print pointer to the function that will print debug messages (may be `NULL`)
+ * @note Bus is locked while the device is selected, so every instruction is an atomic bus transaction.
+ * Call `w25qxx_Init(&w25qxx_BusDevice->w25qxx_Handle)` afterwards. An async transfer holds the bus until
+ * `w25qxx_AsyncFinish()`, call it from the task that started the transfer if the bus lock is owned (e.g. mutex)
+ * @return `w25qxx_Handle->error`
+ */
+w25qxx_Error_t w25qxx_BusAttach(w25qxx_BusTypeDef *w25qxx_Bus, w25qxx_BusDeviceTypeDef *w25qxx_BusDevice,
+                                w25qxx_cs_context_fp cs_set, void *cs_context, w25qxx_print_fp print);
+
+#ifdef __cplusplus
+}
+#endif
\ No newline at end of file
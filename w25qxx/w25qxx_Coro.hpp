@@ -0,0 +1,450 @@
+#pragma once
+
+#include "w25qxx.hpp"
+#include <atomic>
+#include <coroutine>
+#include <exception>
+
+namespace w25qxx
+{
+
+class Executor;
+
+/**
+ * @brief Suspended coroutine waiting for its resume condition, linked into the executor without heap
+ */
+class Waiter
+{
+  public:
+    virtual ~Waiter() = default;
+
+    /**
+     * @brief Checks the resume condition, called by the executor on every pass
+     * @return true if the coroutine can be resumed
+     */
+    virtual bool Poll() = 0;
+
+  private:
+    friend class Executor;
+
+    std::coroutine_handle<> handle;
+    Waiter *next = nullptr;
+};
+
+/**
+ * @brief Single-threaded cooperative executor, resumes coroutines whose waiters report ready
+ * @note Completion callbacks (e.g. DMA ISR) only set atomic flags, coroutines are always resumed from `Run()`
+ */
+class Executor
+{
+  public:
+    /**
+     * @param tick function that returns the millisecond tick, busy polls are limited to once per tick and
+     * timeouts are checked against it (force `nullptr` to poll on every pass without timeouts)
+     */
+    explicit Executor(w25qxx_tick_fp tick = nullptr) : now(tick) {}
+
+    /**
+     * @brief Links the suspended coroutine to the executor
+     * @param waiter resume condition, it must stay valid until the coroutine is resumed
+     * @param coroutine coroutine to resume
+     */
+    void Suspend(Waiter &waiter, std::coroutine_handle<> coroutine)
+    {
+        waiter.handle = coroutine;
+        waiter.next = nullptr;
+        if (tail != nullptr)
+            tail->next = &waiter;
+        else
+            head = &waiter;
+        tail = &waiter;
+    }
+
+    /**
+     * @brief Resumes the first ready coroutine
+     * @return true if any coroutine has been resumed
+     */
+    bool RunOnce()
+    {
+        Waiter *previous = nullptr;
+
+        for (Waiter *waiter = head; waiter != nullptr; previous = waiter, waiter = waiter->next)
+        {
+            if (!waiter->Poll())
+                continue;
+
+            /* Unlink before resume, the coroutine may suspend again on the same waiter */
+            if (previous != nullptr)
+                previous->next = waiter->next;
+            else
+                head = waiter->next;
+            if (tail == waiter)
+                tail = previous;
+            waiter->handle.resume();
+
+            return true;
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief Runs coroutines until all of them are done
+     * @param idle function called when no coroutine is ready (e.g. `__WFI`, `sched_yield`), may be `nullptr`
+     */
+    void Run(void (*idle)(void) = nullptr)
+    {
+        while (head != nullptr)
+        {
+            if (!RunOnce() && (idle != nullptr))
+                idle();
+        }
+    }
+
+    /**
+     * @return true if any coroutine is suspended on the executor
+     */
+    bool Pending() const { return (head != nullptr); }
+
+    /**
+     * @return Millisecond tick or 0 if no tick function is provided
+     */
+    uint32_t Now() const { return (now != nullptr) ? now() : 0; }
+
+    /**
+     * @return true if timeouts and poll ticks are available
+     */
+    bool HasTick() const { return (now != nullptr); }
+
+  private:
+    w25qxx_tick_fp now;
+    Waiter *head = nullptr;
+    Waiter *tail = nullptr;
+};
+
+/**
+ * @brief Coroutine returning `w25qxx_Error_t`, started by `Spawn()` or awaited by another task
+ * @note Frame is allocated by the compiler (heap unless elided), exceptions are not used
+ */
+class Task
+{
+  public:
+    struct promise_type
+    {
+        w25qxx_Error_t error = W25QXX_ERROR_NONE;
+        std::coroutine_handle<> continuation;
+
+        Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        auto final_suspend() noexcept
+        {
+            struct Final
+            {
+                bool await_ready() noexcept { return false; }
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> coroutine) noexcept
+                {
+                    std::coroutine_handle<> continuation = coroutine.promise().continuation;
+
+                    return (continuation) ? continuation : std::noop_coroutine();
+                }
+                void await_resume() noexcept {}
+            };
+
+            return Final{};
+        }
+        void return_value(w25qxx_Error_t value) { error = value; }
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    Task(Task &&other) noexcept : handle(other.handle) { other.handle = nullptr; }
+    Task(const Task &) = delete;
+    Task &operator=(const Task &) = delete;
+    ~Task()
+    {
+        if (handle)
+            handle.destroy();
+    }
+
+    /**
+     * @brief Schedules the task on the executor, the task object must stay valid until `Done()`
+     * @param executor executor to run the task
+     */
+    void Spawn(Executor &executor) { executor.Suspend(start, handle); }
+
+    /**
+     * @return true if the task has returned
+     */
+    bool Done() const { return !handle || handle.done(); }
+
+    /**
+     * @return Value returned by the task
+     */
+    w25qxx_Error_t Error() const { return handle ? handle.promise().error : W25QXX_ERROR_ARGUMENT; }
+
+    bool await_ready() const noexcept { return Done(); }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> continuation) noexcept
+    {
+        handle.promise().continuation = continuation;
+
+        return handle;
+    }
+    w25qxx_Error_t await_resume() const noexcept { return Error(); }
+
+  private:
+    class Start : public Waiter
+    {
+      public:
+        bool Poll() override { return true; }
+    };
+
+    explicit Task(std::coroutine_handle<promise_type> coroutine) : handle(coroutine) {}
+
+    std::coroutine_handle<promise_type> handle;
+    Start start;
+};
+
+/**
+ * @brief Address range to erase, both ends aligned to 4KB sector
+ */
+struct Range
+{
+    uint32_t address;
+    uint32_t length;
+};
+
+/**
+ * @brief Coroutine front-end of the C driver handle, operations suspend during transfers and busy waits
+ * @note Data phases run through `interface.transmit_async`/`interface.receive_async` when they are linked,
+ * otherwise through the blocking functions. Operations of the coroutines sharing one device are serialized,
+ * the device is held for the whole operation including the program/erase time
+ */
+class Flash
+{
+  public:
+    /**
+     * @param device initialized device handle
+     * @param scheduler executor that runs the coroutines using the device
+     */
+    Flash(w25qxx_HandleTypeDef &device, Executor &scheduler) : handle(device), executor(scheduler) {}
+
+    /**
+     * @brief Reads data of any length from any address
+     * @param address start address
+     * @param data destination buffer
+     * @param fastRead set `W25QXX_FASTREAD` if SPIclk > 50MHz
+     * @return `handle.error`
+     */
+    Task Read(uint32_t address, Span<uint8_t> data, w25qxx_FastRead_t fastRead = W25QXX_FASTREAD_NO)
+    {
+        uint32_t offset = 0, chunk;
+
+        co_await Acquire();
+        while ((offset < data.size()) && (handle.error == W25QXX_ERROR_NONE))
+        {
+            chunk = W25QXX_PAGE_SIZE - ((address + offset) % W25QXX_PAGE_SIZE);
+            if (chunk > (data.size() - offset))
+                chunk = data.size() - offset;
+
+            /* Page-aligned chunks are shipped by the async hook, the unaligned head is short */
+            if ((handle.interface.receive_async != nullptr) && (((address + offset) % W25QXX_PAGE_SIZE) == 0))
+                co_await Transfer(w25qxx_ReadAsync(&handle, data.data() + offset, (uint16_t) chunk, address + offset,
+                                                   W25QXX_CRC_NO, fastRead, TransferAwaiter::Complete, &transfer));
+            else
+                w25qxx_ReadStream(&handle, data.data() + offset, chunk, address + offset, fastRead);
+            offset += chunk;
+        }
+        Release();
+
+        co_return handle.error;
+    }
+
+    /**
+     * @brief Writes data to erased pages, the program time of each page is awaited without blocking
+     * @param address start page address (multiple of 256 bytes)
+     * @param data data to program
+     * @return `handle.error`
+     */
+    Task Write(uint32_t address, Span<const uint8_t> data)
+    {
+        uint32_t offset = 0, chunk;
+
+        co_await Acquire();
+        while ((offset < data.size()) && (handle.error == W25QXX_ERROR_NONE))
+        {
+            chunk = data.size() - offset;
+            if (chunk > W25QXX_PAGE_SIZE)
+                chunk = W25QXX_PAGE_SIZE;
+
+            if (handle.interface.transmit_async != nullptr)
+                co_await Transfer(w25qxx_WriteAsync(&handle, data.data() + offset, (uint16_t) chunk, address + offset,
+                                                    W25QXX_CRC_NO, TransferAwaiter::Complete, &transfer));
+            else
+                w25qxx_Write(&handle, data.data() + offset, (uint16_t) chunk, address + offset, W25QXX_CRC_NO,
+                             W25QXX_WAIT_NO);
+            co_await Busy(W25QXX_PAGE_PROGRAM_TIME);
+            offset += chunk;
+        }
+        Release();
+
+        co_return handle.error;
+    }
+
+    /**
+     * @brief Erases the range with the largest erase instructions the alignment allows
+     * @param range sector-aligned range
+     * @return `handle.error`
+     */
+    Task Erase(Range range)
+    {
+        w25qxx_EraseInstruction_t eraseInstruction;
+        uint32_t size, timeout;
+
+        if (((range.address % W25QXX_SECTOR_SIZE_4KB) != 0) || ((range.length % W25QXX_SECTOR_SIZE_4KB) != 0))
+            co_return W25QXX_ERROR_ADDRESS;
+
+        co_await Acquire();
+        while ((range.length != 0) && (handle.error == W25QXX_ERROR_NONE))
+        {
+            if (((range.address % W25QXX_BLOCK_SIZE_64KB) == 0) && (range.length >= W25QXX_BLOCK_SIZE_64KB))
+            {
+                eraseInstruction = W25QXX_BLOCK_ERASE_64KB;
+                size = W25QXX_BLOCK_SIZE_64KB;
+                timeout = W25QXX_BLOCK_ERASE_TIME_64KB;
+            }
+            else if (((range.address % W25QXX_BLOCK_SIZE_32KB) == 0) && (range.length >= W25QXX_BLOCK_SIZE_32KB))
+            {
+                eraseInstruction = W25QXX_BLOCK_ERASE_32KB;
+                size = W25QXX_BLOCK_SIZE_32KB;
+                timeout = W25QXX_BLOCK_ERASE_TIME_32KB;
+            }
+            else
+            {
+                eraseInstruction = W25QXX_SECTOR_ERASE_4KB;
+                size = W25QXX_SECTOR_SIZE_4KB;
+                timeout = W25QXX_SECTOR_ERASE_TIME_4KB;
+            }
+
+            if (w25qxx_Erase(&handle, eraseInstruction, range.address, W25QXX_WAIT_NO) == W25QXX_ERROR_NONE)
+                co_await Busy(timeout);
+            range.address += size;
+            range.length -= size;
+        }
+        Release();
+
+        co_return handle.error;
+    }
+
+  private:
+    struct State
+    {
+        std::atomic<bool> done{false};
+    };
+
+    /**
+     * @brief Awaits the exclusive use of the device
+     */
+    class AcquireAwaiter : public Waiter
+    {
+      public:
+        explicit AcquireAwaiter(Flash &owner) : flash(owner) {}
+
+        bool Poll() override { return !flash.owned; }
+        bool await_ready() { return Poll(); }
+        void await_suspend(std::coroutine_handle<> coroutine) { flash.executor.Suspend(*this, coroutine); }
+        void await_resume() { flash.owned = true; }
+
+      private:
+        Flash &flash;
+    };
+
+    /**
+     * @brief Awaits the async transfer started by the driver, resumes on its completion callback and finishes
+     * the frame from the executor
+     */
+    class TransferAwaiter : public Waiter
+    {
+      public:
+        TransferAwaiter(Flash &owner, w25qxx_Error_t result) : flash(owner), startError(result) {}
+
+        static void Complete(void *context, w25qxx_Error_t error)
+        {
+            auto *state = static_cast<State *>(context);
+
+            /* Error is kept by the handle and returned by the finish */
+            (void) error;
+            state->done.store(true, std::memory_order_release);
+        }
+
+        bool Poll() override { return flash.transfer.done.load(std::memory_order_acquire); }
+
+        /* Callback is not called if the transfer has not started */
+        bool await_ready() { return (startError != W25QXX_ERROR_NONE) || Poll(); }
+        void await_suspend(std::coroutine_handle<> coroutine) { flash.executor.Suspend(*this, coroutine); }
+        w25qxx_Error_t await_resume()
+        {
+            flash.transfer.done.store(false, std::memory_order_relaxed);
+
+            /* Completion only reports the data phase, /CS is released in the task context */
+            return (startError != W25QXX_ERROR_NONE) ? startError : w25qxx_AsyncFinish(&flash.handle);
+        }
+
+      private:
+        Flash &flash;
+        w25qxx_Error_t startError;
+    };
+
+    /**
+     * @brief Awaits the end of program/erase, BUSY bit is polled once per executor tick
+     */
+    class BusyAwaiter : public Waiter
+    {
+      public:
+        BusyAwaiter(Flash &owner, uint32_t limit)
+            : flash(owner), start(owner.executor.Now()), timeout(limit), lastPoll(start)
+        {
+        }
+
+        bool Poll() override
+        {
+            uint32_t now = flash.executor.Now();
+
+            if (flash.executor.HasTick() && (now == lastPoll))
+                return false;
+            lastPoll = now;
+
+            if (w25qxx_BusyCheck(&flash.handle, 0) != W25QXX_STATUS_BUSY)
+                return true;
+            if (flash.executor.HasTick() && ((now - start) > timeout))
+            {
+                timedOut = true;
+                return true;
+            }
+
+            return false;
+        }
+        bool await_ready() { return false; }
+        void await_suspend(std::coroutine_handle<> coroutine) { flash.executor.Suspend(*this, coroutine); }
+        void await_resume()
+        {
+            if (timedOut && (flash.handle.error == W25QXX_ERROR_NONE))
+                flash.handle.error = W25QXX_ERROR_TIMEOUT;
+        }
+
+      private:
+        Flash &flash;
+        uint32_t start, timeout, lastPoll;
+        bool timedOut = false;
+    };
+
+    AcquireAwaiter Acquire() { return AcquireAwaiter(*this); }
+    TransferAwaiter Transfer(w25qxx_Error_t startError) { return TransferAwaiter(*this, startError); }
+    BusyAwaiter Busy(uint32_t timeout) { return BusyAwaiter(*this, timeout); }
+    void Release() { owned = false; }
+
+    w25qxx_HandleTypeDef &handle;
+    Executor &executor;
+    State transfer;
+    bool owned = false;
+};
+
+} // namespace w25qxx
\ No newline at end of file
@@ -0,0 +1,178 @@
+#include "w25qxx_ErasePool.h"
+
+static bool SectorFifo_Push(w25qxx_SectorFifo_t *fifo, uint32_t sector);
+static uint32_t SectorFifo_Pop(w25qxx_SectorFifo_t *fifo);
+
+w25qxx_Error_t w25qxx_ErasePoolInit(w25qxx_ErasePoolTypeDef *w25qxx_ErasePool, w25qxx_HandleTypeDef *w25qxx_Handle)
+{
+    /* Avoid dereferencing the null handle */
+    if ((w25qxx_ErasePool == NULL) || (w25qxx_Handle == NULL))
+        return W25QXX_ERROR_ARGUMENT;
+
+    memset(w25qxx_ErasePool, 0, sizeof(*w25qxx_ErasePool));
+    w25qxx_ErasePool->w25qxx_Handle = w25qxx_Handle;
+    w25qxx_ErasePool->erasing = W25QXX_ERASE_POOL_NONE;
+
+    return w25qxx_Handle->error;
+}
+
+w25qxx_Error_t w25qxx_ErasePoolRelease(w25qxx_ErasePoolTypeDef *w25qxx_ErasePool, uint32_t sector)
+{
+    /* Avoid dereferencing the null handle */
+    if ((w25qxx_ErasePool == NULL) || (w25qxx_ErasePool->w25qxx_Handle == NULL))
+        return W25QXX_ERROR_ARGUMENT;
+
+    /* Argument guards */
+    if (W25QXX_SECTOR_TO_ADDRESS(sector) >= (W25QXX_PAGE_SIZE * w25qxx_ErasePool->w25qxx_Handle->numberOfPages))
+        return w25qxx_ErasePool->w25qxx_Handle->error = W25QXX_ERROR_ADDRESS;
+    if (!SectorFifo_Push(&w25qxx_ErasePool->dirty, sector))
+        return W25QXX_ERROR_ARGUMENT; // Pool state, the device is fine
+
+    return w25qxx_ErasePool->w25qxx_Handle->error;
+}
+
+w25qxx_Error_t w25qxx_ErasePoolService(w25qxx_ErasePoolTypeDef *w25qxx_ErasePool)
+{
+    w25qxx_HandleTypeDef *w25qxx_Handle;
+
+    /* Avoid dereferencing the null handle */
+    if ((w25qxx_ErasePool == NULL) || (w25qxx_ErasePool->w25qxx_Handle == NULL))
+        return W25QXX_ERROR_ARGUMENT;
+    w25qxx_Handle = w25qxx_ErasePool->w25qxx_Handle;
+
+    /* Collect the erase in progress */
+    if (w25qxx_ErasePool->erasing != W25QXX_ERASE_POOL_NONE)
+    {
+        if (w25qxx_BusyCheck(w25qxx_Handle, 0) != W25QXX_STATUS_READY)
+            return w25qxx_Handle->error;
+
+        SectorFifo_Push(&w25qxx_ErasePool->erased, w25qxx_ErasePool->erasing);
+        w25qxx_ErasePool->erasing = W25QXX_ERASE_POOL_NONE;
+        w25qxx_ErasePool->stats.erasedBackground++;
+    }
+
+    /* Idle device erases ahead until the high watermark */
+    if ((w25qxx_ErasePool->erased.count >= W25QXX_ERASE_POOL_HIGH_WATERMARK) || (w25qxx_ErasePool->dirty.count == 0))
+        return w25qxx_Handle->error;
+
+    w25qxx_ErasePool->erasing = SectorFifo_Pop(&w25qxx_ErasePool->dirty);
+    if (w25qxx_Erase(w25qxx_Handle, W25QXX_SECTOR_ERASE_4KB, W25QXX_SECTOR_TO_ADDRESS(w25qxx_ErasePool->erasing),
+                     W25QXX_WAIT_NO) != W25QXX_ERROR_NONE)
+    {
+        /* Sector is still dirty, it is retried once the error is reset */
+        SectorFifo_Push(&w25qxx_ErasePool->dirty, w25qxx_ErasePool->erasing);
+        w25qxx_ErasePool->erasing = W25QXX_ERASE_POOL_NONE;
+    }
+
+    return w25qxx_Handle->error;
+}
+
+bool w25qxx_ErasePoolLow(const w25qxx_ErasePoolTypeDef *w25qxx_ErasePool)
+{
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_ErasePool == NULL)
+        return false;
+
+    return (w25qxx_ErasePool->erased.count < W25QXX_ERASE_POOL_LOW_WATERMARK) &&
+           ((w25qxx_ErasePool->dirty.count != 0) || (w25qxx_ErasePool->erasing != W25QXX_ERASE_POOL_NONE));
+}
+
+w25qxx_Error_t w25qxx_ErasePoolSync(w25qxx_ErasePoolTypeDef *w25qxx_ErasePool)
+{
+    w25qxx_HandleTypeDef *w25qxx_Handle;
+
+    /* Avoid dereferencing the null handle */
+    if ((w25qxx_ErasePool == NULL) || (w25qxx_ErasePool->w25qxx_Handle == NULL))
+        return W25QXX_ERROR_ARGUMENT;
+    w25qxx_Handle = w25qxx_ErasePool->w25qxx_Handle;
+
+    /* Nothing in progress */
+    if (w25qxx_ErasePool->erasing == W25QXX_ERASE_POOL_NONE)
+        return w25qxx_Handle->error;
+
+    if (w25qxx_BusyCheck(w25qxx_Handle, W25QXX_SECTOR_ERASE_TIME_4KB) != W25QXX_STATUS_READY)
+    {
+        if (w25qxx_Handle->error == W25QXX_ERROR_NONE)
+            w25qxx_Handle->error = W25QXX_ERROR_TIMEOUT;
+
+        return w25qxx_Handle->error;
+    }
+    SectorFifo_Push(&w25qxx_ErasePool->erased, w25qxx_ErasePool->erasing);
+    w25qxx_ErasePool->erasing = W25QXX_ERASE_POOL_NONE;
+    w25qxx_ErasePool->stats.erasedBackground++;
+
+    return w25qxx_Handle->error;
+}
+
+w25qxx_Error_t w25qxx_ErasePoolAcquire(w25qxx_ErasePoolTypeDef *w25qxx_ErasePool, uint32_t *sector)
+{
+    w25qxx_HandleTypeDef *w25qxx_Handle;
+    uint32_t dirtySector;
+
+    /* Avoid dereferencing the null handle */
+    if ((w25qxx_ErasePool == NULL) || (w25qxx_ErasePool->w25qxx_Handle == NULL))
+        return W25QXX_ERROR_ARGUMENT;
+    w25qxx_Handle = w25qxx_ErasePool->w25qxx_Handle;
+
+    /* Argument guards */
+    if (sector == NULL)
+        return w25qxx_Handle->error = W25QXX_ERROR_ARGUMENT;
+    *sector = W25QXX_ERASE_POOL_NONE;
+
+    /* Device has to be ready for the writer anyway */
+    if ((w25qxx_ErasePool->erasing != W25QXX_ERASE_POOL_NONE) && (w25qxx_ErasePool->erased.count == 0))
+        w25qxx_ErasePool->stats.waited++;
+    if (w25qxx_ErasePoolSync(w25qxx_ErasePool) != W25QXX_ERROR_NONE)
+        return w25qxx_Handle->error;
+
+    /* Pool exhausted, erase within the writer context */
+    if (w25qxx_ErasePool->erased.count == 0)
+    {
+        if (w25qxx_ErasePool->dirty.count == 0)
+            return w25qxx_Handle->error;
+
+        w25qxx_ErasePool->stats.waited++;
+        dirtySector = SectorFifo_Pop(&w25qxx_ErasePool->dirty);
+        if (w25qxx_Erase(w25qxx_Handle, W25QXX_SECTOR_ERASE_4KB, W25QXX_SECTOR_TO_ADDRESS(dirtySector),
+                         W25QXX_WAIT_BUSY) != W25QXX_ERROR_NONE)
+        {
+            SectorFifo_Push(&w25qxx_ErasePool->dirty, dirtySector);
+            return w25qxx_Handle->error;
+        }
+        w25qxx_ErasePool->stats.erasedInline++;
+        SectorFifo_Push(&w25qxx_ErasePool->erased, dirtySector);
+    }
+
+    *sector = SectorFifo_Pop(&w25qxx_ErasePool->erased);
+    w25qxx_ErasePool->stats.acquired++;
+
+    return w25qxx_Handle->error;
+}
+
+/**
+ * @section Private functions
+ */
+static bool SectorFifo_Push(w25qxx_SectorFifo_t *fifo, uint32_t sector)
+{
+    if (fifo->count >= W25QXX_ERASE_POOL_SIZE)
+        return false;
+
+    fifo->sector[(fifo->head + fifo->count) % W25QXX_ERASE_POOL_SIZE] = sector;
+    fifo->count++;
+
+    return true;
+}
+
+static uint32_t SectorFifo_Pop(w25qxx_SectorFifo_t *fifo)
+{
+    uint32_t sector;
+
+    if (fifo->count == 0)
+        return W25QXX_ERASE_POOL_NONE;
+
+    sector = fifo->sector[fifo->head];
+    fifo->head = (fifo->head + 1) % W25QXX_ERASE_POOL_SIZE;
+    fifo->count--;
+
+    return sector;
+}
\ No newline at end of file
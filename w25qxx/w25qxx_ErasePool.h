@@ -0,0 +1,96 @@
+#pragma once
+
+#include "w25qxx.h"
+
+/* Configuration */
+#ifndef W25QXX_ERASE_POOL_SIZE
+#define W25QXX_ERASE_POOL_SIZE 32 // Maximum number of sectors tracked in each pool queue
+#endif
+#ifndef W25QXX_ERASE_POOL_LOW_WATERMARK
+#define W25QXX_ERASE_POOL_LOW_WATERMARK 4 // Pool is short of erased sectors below it, see `w25qxx_ErasePoolLow()`
+#endif
+#ifndef W25QXX_ERASE_POOL_HIGH_WATERMARK
+#define W25QXX_ERASE_POOL_HIGH_WATERMARK W25QXX_ERASE_POOL_SIZE // Background erase stops when this many are ready
+#endif
+
+/* Device constants */
+#define W25QXX_ERASE_POOL_NONE 0xFFFFFFFF
+
+/* Data types */
+typedef struct w25qxx_SectorFifo_s {
+    uint32_t sector[W25QXX_ERASE_POOL_SIZE];
+    uint16_t head;
+    uint16_t count;
+} w25qxx_SectorFifo_t;
+
+typedef struct w25qxx_ErasePoolTypeDef_s {
+    w25qxx_HandleTypeDef *w25qxx_Handle;
+    w25qxx_SectorFifo_t dirty; // Reclaimed sectors waiting for erase
+    w25qxx_SectorFifo_t erased; // Sectors ready to be programmed
+    uint32_t erasing; // Sector with erase in progress or `W25QXX_ERASE_POOL_NONE`
+
+    struct {
+        uint32_t acquired; // Number of sectors handed out to writers
+        uint32_t waited; // Number of times a writer had to wait for an erase
+        uint32_t erasedInline; // Number of erases performed within the writer context
+        uint32_t erasedBackground; // Number of erases performed during idle time
+    } stats;
+} w25qxx_ErasePoolTypeDef;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Links the pool to the device and resets its queues and statistics
+ * @param w25qxx_ErasePool pointer to the erase pool structure
+ * @param w25qxx_Handle pointer to the initialized device handle
+ * @return `w25qxx_Handle->error`
+ */
+w25qxx_Error_t w25qxx_ErasePoolInit(w25qxx_ErasePoolTypeDef *w25qxx_ErasePool, w25qxx_HandleTypeDef *w25qxx_Handle);
+
+/**
+ * @brief Returns a sector to the pool, it will be erased in background
+ * @param w25qxx_ErasePool pointer to the erase pool structure
+ * @param sector sector number to reclaim
+ * @note Full dirty queue is reported by the return value only, the device handle error is kept
+ * @return `W25QXX_ERROR_ARGUMENT` if the dirty queue is full, `w25qxx_Handle->error` otherwise
+ */
+w25qxx_Error_t w25qxx_ErasePoolRelease(w25qxx_ErasePoolTypeDef *w25qxx_ErasePool, uint32_t sector);
+
+/**
+ * @brief Idle time routine: completes finished erase and starts a new one without blocking
+ * @param w25qxx_ErasePool pointer to the erase pool structure
+ * @note New erase is started while dirty sectors are left and fewer than `W25QXX_ERASE_POOL_HIGH_WATERMARK` are ready
+ * @note Call `w25qxx_ErasePoolSync()` before any other instruction is sent to the device
+ * @return `w25qxx_Handle->error`
+ */
+w25qxx_Error_t w25qxx_ErasePoolService(w25qxx_ErasePoolTypeDef *w25qxx_ErasePool);
+
+/**
+ * @brief Tells whether the pool runs short of erased sectors
+ * @param w25qxx_ErasePool pointer to the erase pool structure
+ * @note Idle scheduler gives the service priority over other idle work while this holds
+ * @return true if fewer than `W25QXX_ERASE_POOL_LOW_WATERMARK` sectors are ready and more can be erased
+ */
+bool w25qxx_ErasePoolLow(const w25qxx_ErasePoolTypeDef *w25qxx_ErasePool);
+
+/**
+ * @brief Waits for the erase in progress, so the device can accept other instructions
+ * @param w25qxx_ErasePool pointer to the erase pool structure
+ * @return `w25qxx_Handle->error`
+ */
+w25qxx_Error_t w25qxx_ErasePoolSync(w25qxx_ErasePoolTypeDef *w25qxx_ErasePool);
+
+/**
+ * @brief Hands out an erased sector, erases one inline only if the pool is exhausted
+ * @param w25qxx_ErasePool pointer to the erase pool structure
+ * @param sector pointer to the sector number, `W25QXX_ERASE_POOL_NONE` if no sector is left
+ * @note Device is ready for programming when the function returns
+ * @return `w25qxx_Handle->error`
+ */
+w25qxx_Error_t w25qxx_ErasePoolAcquire(w25qxx_ErasePoolTypeDef *w25qxx_ErasePool, uint32_t *sector);
+
+#ifdef __cplusplus
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,464 @@
+#include "w25qxx_Ftl.h"
+#include <stddef.h>
+
+/* Macro */
+#define W25QXX_FTL_PAGES_PER_SECTOR (W25QXX_SECTOR_SIZE_4KB / W25QXX_PAGE_SIZE)
+#define W25QXX_FTL_PHYSICAL_TO_ADDRESS(PHYSICAL) W25QXX_SECTOR_TO_ADDRESS(w25qxx_FtlHandle->firstSector + (PHYSICAL))
+#define W25QXX_FTL_TABLE_TO_ADDRESS(TABLE) \
+    W25QXX_FTL_PHYSICAL_TO_ADDRESS(w25qxx_FtlHandle->numberOfSectors + (TABLE))
+#define W25QXX_FTL_ERASE_COUNT_UNKNOWN 0xFFFFFFFF
+#define W25QXX_FTL_COUNTS_PER_PAGE     ((W25QXX_PAGE_SIZE - sizeof(uint16_t)) / sizeof(uint32_t)) // CRC frame
+#define W25QXX_FTL_SNAPSHOT_PAGES      ((w25qxx_FtlHandle->numberOfSectors + W25QXX_FTL_COUNTS_PER_PAGE - 1) / \
+                                        W25QXX_FTL_COUNTS_PER_PAGE)
+#define W25QXX_FTL_JOURNAL_ENTRIES                                   \
+    ((W25QXX_FTL_PAGES_PER_SECTOR - 1 - W25QXX_FTL_SNAPSHOT_PAGES) * \
+     (W25QXX_PAGE_SIZE / sizeof(w25qxx_FtlTableEntry_t)))
+
+/* Table sector of 16 pages: header page, snapshot pages of 63 counters each, then the journal up to the sector end */
+#if ((W25QXX_FTL_MAX_SECTORS + 62) / 63) > (16 - 2)
+#error "W25QXX_FTL_MAX_SECTORS leaves no journal page in the table sector"
+#endif
+
+static w25qxx_Error_t w25qxx_FtlReadHeader(w25qxx_FtlHandleTypeDef *w25qxx_FtlHandle, uint16_t physicalSector,
+                                           w25qxx_FtlHeader_t *header, bool *valid);
+static w25qxx_Error_t w25qxx_FtlProgram(w25qxx_FtlHandleTypeDef *w25qxx_FtlHandle, uint16_t physicalSector,
+                                        const uint8_t *buf, uint16_t sourceSector, uint16_t logicalSector);
+static w25qxx_Error_t w25qxx_FtlStaticLeveling(w25qxx_FtlHandleTypeDef *w25qxx_FtlHandle);
+static w25qxx_Error_t w25qxx_FtlTableLoad(w25qxx_FtlHandleTypeDef *w25qxx_FtlHandle);
+static w25qxx_Error_t w25qxx_FtlTableLog(w25qxx_FtlHandleTypeDef *w25qxx_FtlHandle, uint16_t physicalSector);
+static w25qxx_Error_t w25qxx_FtlTableWrite(w25qxx_FtlHandleTypeDef *w25qxx_FtlHandle);
+static uint16_t w25qxx_FtlFindFree(w25qxx_FtlHandleTypeDef *w25qxx_FtlHandle, bool mostWorn);
+static bool IsErased(const uint8_t *pBuffer, uint16_t bufSize);
+
+w25qxx_Error_t w25qxx_FtlInit(w25qxx_FtlHandleTypeDef *w25qxx_FtlHandle, w25qxx_HandleTypeDef *w25qxx_Handle,
+                              uint32_t firstSector, uint16_t numberOfSectors)
+{
+    w25qxx_FtlHeader_t header, mappedHeader;
+    uint64_t eraseCountSum = 0;
+    uint16_t eraseCountKnown = 0;
+    uint16_t physical;
+    bool valid;
+
+    /* Avoid dereferencing the null handle */
+    if ((w25qxx_FtlHandle == NULL) || (w25qxx_Handle == NULL))
+        return W25QXX_ERROR_ARGUMENT;
+
+    /* Argument guards */
+    if ((numberOfSectors <= (W25QXX_FTL_SPARE_SECTORS + W25QXX_FTL_TABLE_SECTORS)) ||
+        (numberOfSectors > (W25QXX_FTL_MAX_SECTORS + W25QXX_FTL_TABLE_SECTORS)))
+        return w25qxx_Handle->error = W25QXX_ERROR_ARGUMENT;
+    if (W25QXX_SECTOR_TO_ADDRESS(firstSector + numberOfSectors) > (W25QXX_PAGE_SIZE * w25qxx_Handle->numberOfPages))
+        return w25qxx_Handle->error = W25QXX_ERROR_ADDRESS;
+
+    memset(w25qxx_FtlHandle, 0, sizeof(*w25qxx_FtlHandle));
+    w25qxx_FtlHandle->w25qxx_Handle = w25qxx_Handle;
+    w25qxx_FtlHandle->firstSector = firstSector;
+    w25qxx_FtlHandle->numberOfSectors = numberOfSectors - W25QXX_FTL_TABLE_SECTORS;
+    w25qxx_FtlHandle->numberOfLogicalSectors = w25qxx_FtlHandle->numberOfSectors - W25QXX_FTL_SPARE_SECTORS;
+    memset(w25qxx_FtlHandle->map, 0xff, sizeof(w25qxx_FtlHandle->map));
+    memset(w25qxx_FtlHandle->eraseCount, 0xff, sizeof(w25qxx_FtlHandle->eraseCount));
+
+    /* Erase counters of the table, journal entries are written before the erase, so they cover interrupted ones */
+    if (w25qxx_FtlTableLoad(w25qxx_FtlHandle) != W25QXX_ERROR_NONE)
+        return w25qxx_Handle->error;
+
+    /* Rebuild the map from sector headers, the most recent copy of a logical sector wins */
+    for (physical = 0; physical < w25qxx_FtlHandle->numberOfSectors; physical++)
+    {
+        if (w25qxx_FtlReadHeader(w25qxx_FtlHandle, physical, &header, &valid) != W25QXX_ERROR_NONE)
+            return w25qxx_Handle->error;
+        if (!valid)
+            continue;
+
+        if ((w25qxx_FtlHandle->eraseCount[physical] == W25QXX_FTL_ERASE_COUNT_UNKNOWN) ||
+            (w25qxx_FtlHandle->eraseCount[physical] < header.eraseCount))
+            w25qxx_FtlHandle->eraseCount[physical] = header.eraseCount;
+        if (header.sequence > w25qxx_FtlHandle->sequence)
+            w25qxx_FtlHandle->sequence = header.sequence;
+        if (header.logicalSector >= w25qxx_FtlHandle->numberOfLogicalSectors)
+            continue;
+
+        if (w25qxx_FtlHandle->map[header.logicalSector] != W25QXX_FTL_SECTOR_FREE)
+        {
+            if (w25qxx_FtlReadHeader(w25qxx_FtlHandle, w25qxx_FtlHandle->map[header.logicalSector], &mappedHeader,
+                                     &valid) != W25QXX_ERROR_NONE)
+                return w25qxx_Handle->error;
+            if (mappedHeader.sequence > header.sequence)
+                continue;
+        }
+        w25qxx_FtlHandle->map[header.logicalSector] = physical;
+    }
+
+    /* Without the table (region never erased or table lost) blank sectors inherit the average wear of the region */
+    for (physical = 0; physical < w25qxx_FtlHandle->numberOfSectors; physical++)
+    {
+        if (w25qxx_FtlHandle->eraseCount[physical] == W25QXX_FTL_ERASE_COUNT_UNKNOWN)
+            continue;
+        eraseCountSum += w25qxx_FtlHandle->eraseCount[physical];
+        eraseCountKnown++;
+    }
+    for (physical = 0; physical < w25qxx_FtlHandle->numberOfSectors; physical++)
+    {
+        if (w25qxx_FtlHandle->eraseCount[physical] == W25QXX_FTL_ERASE_COUNT_UNKNOWN)
+            w25qxx_FtlHandle->eraseCount[physical] = (eraseCountKnown != 0) ? (eraseCountSum / eraseCountKnown) : 0;
+    }
+
+    return w25qxx_Handle->error;
+}
+
+w25qxx_Error_t w25qxx_FtlWrite(w25qxx_FtlHandleTypeDef *w25qxx_FtlHandle, const uint8_t *buf, uint16_t logicalSector)
+{
+    uint16_t physical;
+
+    /* Avoid dereferencing the null handle */
+    if ((w25qxx_FtlHandle == NULL) || (w25qxx_FtlHandle->w25qxx_Handle == NULL))
+        return W25QXX_ERROR_ARGUMENT;
+
+    /* Argument guards */
+    if (buf == NULL)
+        return w25qxx_FtlHandle->w25qxx_Handle->error = W25QXX_ERROR_ARGUMENT;
+    if (logicalSector >= w25qxx_FtlHandle->numberOfLogicalSectors)
+        return w25qxx_FtlHandle->w25qxx_Handle->error = W25QXX_ERROR_ADDRESS;
+
+    /* Dynamic wear leveling: the least worn free sector receives new data */
+    physical = w25qxx_FtlFindFree(w25qxx_FtlHandle, false);
+    if (w25qxx_FtlProgram(w25qxx_FtlHandle, physical, buf, 0, logicalSector) != W25QXX_ERROR_NONE)
+        return w25qxx_FtlHandle->w25qxx_Handle->error;
+    w25qxx_FtlHandle->map[logicalSector] = physical;
+
+    return w25qxx_FtlStaticLeveling(w25qxx_FtlHandle);
+}
+
+w25qxx_Error_t w25qxx_FtlRead(w25qxx_FtlHandleTypeDef *w25qxx_FtlHandle, uint8_t *buf, uint16_t logicalSector)
+{
+    uint32_t address;
+    uint8_t page;
+
+    /* Avoid dereferencing the null handle */
+    if ((w25qxx_FtlHandle == NULL) || (w25qxx_FtlHandle->w25qxx_Handle == NULL))
+        return W25QXX_ERROR_ARGUMENT;
+
+    /* Argument guards */
+    if (buf == NULL)
+        return w25qxx_FtlHandle->w25qxx_Handle->error = W25QXX_ERROR_ARGUMENT;
+    if (logicalSector >= w25qxx_FtlHandle->numberOfLogicalSectors)
+        return w25qxx_FtlHandle->w25qxx_Handle->error = W25QXX_ERROR_ADDRESS;
+
+    /* Unmapped sector */
+    if (w25qxx_FtlHandle->map[logicalSector] == W25QXX_FTL_SECTOR_FREE)
+    {
+        memset(buf, 0xff, W25QXX_FTL_SECTOR_SIZE);
+
+        return w25qxx_FtlHandle->w25qxx_Handle->error;
+    }
+
+    /* Data pages follow the header page */
+    address = W25QXX_FTL_PHYSICAL_TO_ADDRESS(w25qxx_FtlHandle->map[logicalSector]);
+    for (page = 1; page < W25QXX_FTL_PAGES_PER_SECTOR; page++)
+    {
+        if (w25qxx_Read(w25qxx_FtlHandle->w25qxx_Handle, &buf[(page - 1) * W25QXX_PAGE_SIZE], W25QXX_PAGE_SIZE,
+                        address + W25QXX_PAGE_TO_ADDRESS(page), W25QXX_CRC_NO,
+                        W25QXX_FASTREAD_NO) != W25QXX_ERROR_NONE)
+            return w25qxx_FtlHandle->w25qxx_Handle->error;
+    }
+
+    return w25qxx_FtlHandle->w25qxx_Handle->error;
+}
+
+/**
+ * @section Private functions
+ */
+static w25qxx_Error_t w25qxx_FtlReadHeader(w25qxx_FtlHandleTypeDef *w25qxx_FtlHandle, uint16_t physicalSector,
+                                           w25qxx_FtlHeader_t *header, bool *valid)
+{
+    w25qxx_HandleTypeDef *w25qxx_Handle = w25qxx_FtlHandle->w25qxx_Handle;
+
+    *valid = false;
+    w25qxx_Read(w25qxx_Handle, (uint8_t *) header, sizeof(*header), W25QXX_FTL_PHYSICAL_TO_ADDRESS(physicalSector),
+                W25QXX_CRC, W25QXX_FASTREAD_NO);
+    switch (w25qxx_Handle->error)
+    {
+    case W25QXX_ERROR_NONE:
+        *valid = (header->magic == W25QXX_FTL_HEADER_MAGIC);
+        break;
+
+    /* Erased or interrupted header */
+    case W25QXX_ERROR_CHECKSUM:
+        w25qxx_ResetError(w25qxx_Handle);
+        break;
+
+    default:
+        break;
+    }
+
+    return w25qxx_Handle->error;
+}
+
+static w25qxx_Error_t w25qxx_FtlProgram(w25qxx_FtlHandleTypeDef *w25qxx_FtlHandle, uint16_t physicalSector,
+                                        const uint8_t *buf, uint16_t sourceSector, uint16_t logicalSector)
+{
+    w25qxx_HandleTypeDef *w25qxx_Handle = w25qxx_FtlHandle->w25qxx_Handle;
+    uint32_t address = W25QXX_FTL_PHYSICAL_TO_ADDRESS(physicalSector);
+    const uint8_t *pageData;
+    w25qxx_FtlHeader_t header;
+    uint8_t page;
+
+    /* Erase count is recorded first, a power loss during the erase can't lose it */
+    w25qxx_FtlHandle->eraseCount[physicalSector]++;
+    if (w25qxx_FtlTableLog(w25qxx_FtlHandle, physicalSector) != W25QXX_ERROR_NONE)
+        return w25qxx_Handle->error;
+    if (w25qxx_Erase(w25qxx_Handle, W25QXX_SECTOR_ERASE_4KB, address, W25QXX_WAIT_BUSY) != W25QXX_ERROR_NONE)
+        return w25qxx_Handle->error;
+
+    /* Data pages, erased ones are skipped */
+    for (page = 1; page < W25QXX_FTL_PAGES_PER_SECTOR; page++)
+    {
+        if (buf != NULL)
+        {
+            pageData = &buf[(page - 1) * W25QXX_PAGE_SIZE];
+        }
+        else
+        {
+            if (w25qxx_Read(w25qxx_Handle, w25qxx_FtlHandle->pageBuf, W25QXX_PAGE_SIZE,
+                            W25QXX_FTL_PHYSICAL_TO_ADDRESS(sourceSector) + W25QXX_PAGE_TO_ADDRESS(page), W25QXX_CRC_NO,
+                            W25QXX_FASTREAD_NO) != W25QXX_ERROR_NONE)
+                return w25qxx_Handle->error;
+            pageData = w25qxx_FtlHandle->pageBuf;
+        }
+        if (IsErased(pageData, W25QXX_PAGE_SIZE))
+            continue;
+
+        if (w25qxx_Write(w25qxx_Handle, pageData, W25QXX_PAGE_SIZE, address + W25QXX_PAGE_TO_ADDRESS(page),
+                         W25QXX_CRC_NO, W25QXX_WAIT_BUSY) != W25QXX_ERROR_NONE)
+            return w25qxx_Handle->error;
+    }
+
+    /* Header commits the sector */
+    header.magic = W25QXX_FTL_HEADER_MAGIC;
+    header.logicalSector = logicalSector;
+    header.eraseCount = w25qxx_FtlHandle->eraseCount[physicalSector];
+    header.sequence = ++w25qxx_FtlHandle->sequence;
+
+    return w25qxx_Write(w25qxx_Handle, (const uint8_t *) &header, sizeof(header), address, W25QXX_CRC,
+                        W25QXX_WAIT_BUSY);
+}
+
+static w25qxx_Error_t w25qxx_FtlStaticLeveling(w25qxx_FtlHandleTypeDef *w25qxx_FtlHandle)
+{
+    uint16_t logical, coldLogical = W25QXX_FTL_SECTOR_FREE;
+    uint16_t coldSector = W25QXX_FTL_SECTOR_FREE;
+    uint16_t wornSector;
+
+    /* Find the least worn sector that holds data */
+    for (logical = 0; logical < w25qxx_FtlHandle->numberOfLogicalSectors; logical++)
+    {
+        if (w25qxx_FtlHandle->map[logical] == W25QXX_FTL_SECTOR_FREE)
+            continue;
+        if ((coldSector == W25QXX_FTL_SECTOR_FREE) ||
+            (w25qxx_FtlHandle->eraseCount[w25qxx_FtlHandle->map[logical]] < w25qxx_FtlHandle->eraseCount[coldSector]))
+        {
+            coldSector = w25qxx_FtlHandle->map[logical];
+            coldLogical = logical;
+        }
+    }
+    if (coldSector == W25QXX_FTL_SECTOR_FREE)
+        return w25qxx_FtlHandle->w25qxx_Handle->error;
+
+    /* Move cold data to the most worn free sector, so the fresh one joins the free pool */
+    wornSector = w25qxx_FtlFindFree(w25qxx_FtlHandle, true);
+    if (w25qxx_FtlHandle->eraseCount[wornSector] <=
+        (w25qxx_FtlHandle->eraseCount[coldSector] + W25QXX_FTL_STATIC_THRESHOLD))
+        return w25qxx_FtlHandle->w25qxx_Handle->error;
+
+    if (w25qxx_FtlProgram(w25qxx_FtlHandle, wornSector, NULL, coldSector, coldLogical) != W25QXX_ERROR_NONE)
+        return w25qxx_FtlHandle->w25qxx_Handle->error;
+    w25qxx_FtlHandle->map[coldLogical] = wornSector;
+    w25qxx_FtlHandle->relocations++;
+
+    return w25qxx_FtlHandle->w25qxx_Handle->error;
+}
+
+static w25qxx_Error_t w25qxx_FtlTableLoad(w25qxx_FtlHandleTypeDef *w25qxx_FtlHandle)
+{
+    w25qxx_HandleTypeDef *w25qxx_Handle = w25qxx_FtlHandle->w25qxx_Handle;
+    w25qxx_FtlTableHeader_t header;
+    w25qxx_FtlTableEntry_t *entry;
+    uint32_t address;
+    uint16_t page, count, i;
+    uint8_t table;
+
+    /* The most recent complete table wins, its header is written last */
+    w25qxx_FtlHandle->table = W25QXX_FTL_TABLE_NONE;
+    for (table = 0; table < W25QXX_FTL_TABLE_SECTORS; table++)
+    {
+        w25qxx_Read(w25qxx_Handle, (uint8_t *) &header, sizeof(header), W25QXX_FTL_TABLE_TO_ADDRESS(table), W25QXX_CRC,
+                    W25QXX_FASTREAD_NO);
+        if (w25qxx_Handle->error == W25QXX_ERROR_CHECKSUM)
+        {
+            w25qxx_ResetError(w25qxx_Handle);
+            continue;
+        }
+        if (w25qxx_Handle->error != W25QXX_ERROR_NONE)
+            return w25qxx_Handle->error;
+        if ((header.magic != W25QXX_FTL_TABLE_MAGIC) || (header.numberOfSectors != w25qxx_FtlHandle->numberOfSectors))
+            continue;
+        if ((w25qxx_FtlHandle->table == W25QXX_FTL_TABLE_NONE) || (header.sequence > w25qxx_FtlHandle->tableSequence))
+        {
+            w25qxx_FtlHandle->table = table;
+            w25qxx_FtlHandle->tableSequence = header.sequence;
+        }
+    }
+    if (w25qxx_FtlHandle->table == W25QXX_FTL_TABLE_NONE)
+        return w25qxx_Handle->error;
+    address = W25QXX_FTL_TABLE_TO_ADDRESS(w25qxx_FtlHandle->table);
+
+    /* Snapshot, a damaged one leaves the counters to the sector headers and the next erase writes a new table */
+    for (page = 0; page < W25QXX_FTL_SNAPSHOT_PAGES; page++)
+    {
+        count = w25qxx_FtlHandle->numberOfSectors - page * W25QXX_FTL_COUNTS_PER_PAGE;
+        if (count > W25QXX_FTL_COUNTS_PER_PAGE)
+            count = W25QXX_FTL_COUNTS_PER_PAGE;
+        w25qxx_Read(w25qxx_Handle, (uint8_t *) &w25qxx_FtlHandle->eraseCount[page * W25QXX_FTL_COUNTS_PER_PAGE],
+                    count * sizeof(uint32_t), address + W25QXX_PAGE_TO_ADDRESS(1 + page), W25QXX_CRC,
+                    W25QXX_FASTREAD_NO);
+        if (w25qxx_Handle->error == W25QXX_ERROR_CHECKSUM)
+        {
+            w25qxx_ResetError(w25qxx_Handle);
+            memset(w25qxx_FtlHandle->eraseCount, 0xff, sizeof(w25qxx_FtlHandle->eraseCount));
+            w25qxx_FtlHandle->table = W25QXX_FTL_TABLE_NONE;
+
+            return w25qxx_Handle->error;
+        }
+        if (w25qxx_Handle->error != W25QXX_ERROR_NONE)
+            return w25qxx_Handle->error;
+    }
+
+    /* Journal replay up to the first erased entry, interrupted entries are skipped */
+    entry = (w25qxx_FtlTableEntry_t *) w25qxx_FtlHandle->pageBuf;
+    for (w25qxx_FtlHandle->tableEntries = 0; w25qxx_FtlHandle->tableEntries < W25QXX_FTL_JOURNAL_ENTRIES;
+         w25qxx_FtlHandle->tableEntries++)
+    {
+        i = w25qxx_FtlHandle->tableEntries % (W25QXX_PAGE_SIZE / sizeof(*entry));
+        if (i == 0)
+        {
+            page = 1 + W25QXX_FTL_SNAPSHOT_PAGES + w25qxx_FtlHandle->tableEntries / (W25QXX_PAGE_SIZE / sizeof(*entry));
+            if (w25qxx_ReadStream(w25qxx_Handle, w25qxx_FtlHandle->pageBuf, W25QXX_PAGE_SIZE,
+                                  address + W25QXX_PAGE_TO_ADDRESS(page), W25QXX_FASTREAD_NO) != W25QXX_ERROR_NONE)
+                return w25qxx_Handle->error;
+        }
+        if (IsErased((const uint8_t *) &entry[i], sizeof(*entry)))
+            break;
+        if ((w25qxx_CRC16((const uint8_t *) &entry[i], offsetof(w25qxx_FtlTableEntry_t, CRC16)) == entry[i].CRC16) &&
+            (entry[i].physicalSector < w25qxx_FtlHandle->numberOfSectors))
+            w25qxx_FtlHandle->eraseCount[entry[i].physicalSector] = entry[i].eraseCount;
+    }
+
+    return w25qxx_Handle->error;
+}
+
+static w25qxx_Error_t w25qxx_FtlTableLog(w25qxx_FtlHandleTypeDef *w25qxx_FtlHandle, uint16_t physicalSector)
+{
+    w25qxx_FtlTableEntry_t entry;
+    w25qxx_IoVec_t iov = {&entry, sizeof(entry)};
+    uint32_t address;
+
+    /* Full journal is folded into a new snapshot, which already holds the counter */
+    if ((w25qxx_FtlHandle->table == W25QXX_FTL_TABLE_NONE) ||
+        (w25qxx_FtlHandle->tableEntries >= W25QXX_FTL_JOURNAL_ENTRIES))
+        return w25qxx_FtlTableWrite(w25qxx_FtlHandle);
+
+    /* Entry is appended to the erased journal area, pages can be programmed once per byte */
+    entry.eraseCount = w25qxx_FtlHandle->eraseCount[physicalSector];
+    entry.physicalSector = physicalSector;
+    entry.CRC16 = w25qxx_CRC16((const uint8_t *) &entry, offsetof(w25qxx_FtlTableEntry_t, CRC16));
+    address = W25QXX_FTL_TABLE_TO_ADDRESS(w25qxx_FtlHandle->table) +
+              W25QXX_PAGE_TO_ADDRESS(1 + W25QXX_FTL_SNAPSHOT_PAGES) + w25qxx_FtlHandle->tableEntries * sizeof(entry);
+    if (w25qxx_WriteV(w25qxx_FtlHandle->w25qxx_Handle, &iov, 1, address, W25QXX_WAIT_BUSY) != W25QXX_ERROR_NONE)
+        return w25qxx_FtlHandle->w25qxx_Handle->error;
+    w25qxx_FtlHandle->tableEntries++;
+
+    return w25qxx_FtlHandle->w25qxx_Handle->error;
+}
+
+static w25qxx_Error_t w25qxx_FtlTableWrite(w25qxx_FtlHandleTypeDef *w25qxx_FtlHandle)
+{
+    w25qxx_HandleTypeDef *w25qxx_Handle = w25qxx_FtlHandle->w25qxx_Handle;
+    w25qxx_FtlTableHeader_t header;
+    uint32_t address;
+    uint16_t page, count;
+    uint8_t table;
+
+    /* The other table sector is rewritten, the current one stays valid until the new header is written */
+    table = 0;
+    if (w25qxx_FtlHandle->table != W25QXX_FTL_TABLE_NONE)
+        table = (w25qxx_FtlHandle->table + 1) % W25QXX_FTL_TABLE_SECTORS;
+    address = W25QXX_FTL_TABLE_TO_ADDRESS(table);
+    if (w25qxx_Erase(w25qxx_Handle, W25QXX_SECTOR_ERASE_4KB, address, W25QXX_WAIT_BUSY) != W25QXX_ERROR_NONE)
+        return w25qxx_Handle->error;
+
+    /* Snapshot */
+    for (page = 0; page < W25QXX_FTL_SNAPSHOT_PAGES; page++)
+    {
+        count = w25qxx_FtlHandle->numberOfSectors - page * W25QXX_FTL_COUNTS_PER_PAGE;
+        if (count > W25QXX_FTL_COUNTS_PER_PAGE)
+            count = W25QXX_FTL_COUNTS_PER_PAGE;
+        if (w25qxx_Write(w25qxx_Handle,
+                         (const uint8_t *) &w25qxx_FtlHandle->eraseCount[page * W25QXX_FTL_COUNTS_PER_PAGE],
+                         count * sizeof(uint32_t), address + W25QXX_PAGE_TO_ADDRESS(1 + page), W25QXX_CRC,
+                         W25QXX_WAIT_BUSY) != W25QXX_ERROR_NONE)
+            return w25qxx_Handle->error;
+    }
+
+    /* Header commits the table */
+    header.magic = W25QXX_FTL_TABLE_MAGIC;
+    header.numberOfSectors = w25qxx_FtlHandle->numberOfSectors;
+    header.sequence = w25qxx_FtlHandle->tableSequence + 1;
+    if (w25qxx_Write(w25qxx_Handle, (const uint8_t *) &header, sizeof(header), address, W25QXX_CRC,
+                     W25QXX_WAIT_BUSY) != W25QXX_ERROR_NONE)
+        return w25qxx_Handle->error;
+    w25qxx_FtlHandle->table = table;
+    w25qxx_FtlHandle->tableSequence = header.sequence;
+    w25qxx_FtlHandle->tableEntries = 0;
+
+    return w25qxx_Handle->error;
+}
+
+static uint16_t w25qxx_FtlFindFree(w25qxx_FtlHandleTypeDef *w25qxx_FtlHandle, bool mostWorn)
+{
+    uint8_t mapped[(W25QXX_FTL_MAX_SECTORS + 7) / 8];
+    uint16_t logical, physical, found = W25QXX_FTL_SECTOR_FREE;
+
+    /* Mapped sectors are marked in one pass over the map */
+    memset(mapped, 0, sizeof(mapped));
+    for (logical = 0; logical < w25qxx_FtlHandle->numberOfLogicalSectors; logical++)
+    {
+        if (w25qxx_FtlHandle->map[logical] != W25QXX_FTL_SECTOR_FREE)
+            mapped[w25qxx_FtlHandle->map[logical] / 8] |= (uint8_t) (1u << (w25qxx_FtlHandle->map[logical] % 8));
+    }
+
+    for (physical = 0; physical < w25qxx_FtlHandle->numberOfSectors; physical++)
+    {
+        if (mapped[physical / 8] & (1u << (physical % 8)))
+            continue;
+        if ((found == W25QXX_FTL_SECTOR_FREE) ||
+            (mostWorn ? (w25qxx_FtlHandle->eraseCount[physical] > w25qxx_FtlHandle->eraseCount[found])
+                      : (w25qxx_FtlHandle->eraseCount[physical] < w25qxx_FtlHandle->eraseCount[found])))
+            found = physical;
+    }
+
+    /* Spare sectors guarantee at least one free sector */
+    return found;
+}
+
+static bool IsErased(const uint8_t *pBuffer, uint16_t bufSize)
+{
+    uint16_t i;
+
+    for (i = 0; i < bufSize; i++)
+    {
+        if (pBuffer[i] != 0xff)
+            return false;
+    }
+
+    return true;
+}
\ No newline at end of file
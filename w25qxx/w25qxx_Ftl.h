@@ -0,0 +1,99 @@
+#pragma once
+
+#include "w25qxx.h"
+
+/* Configuration */
+#ifndef W25QXX_FTL_MAX_SECTORS
+#define W25QXX_FTL_MAX_SECTORS 256 // Maximum number of physical sectors managed by one FTL handle
+#endif
+#ifndef W25QXX_FTL_SPARE_SECTORS
+#define W25QXX_FTL_SPARE_SECTORS 4 // Physical sectors kept unmapped for dynamic wear leveling
+#endif
+#ifndef W25QXX_FTL_STATIC_THRESHOLD
+#define W25QXX_FTL_STATIC_THRESHOLD 64 // Erase count spread that triggers cold data relocation
+#endif
+
+/* Device constants */
+#define W25QXX_FTL_SECTOR_SIZE   (W25QXX_SECTOR_SIZE_4KB - W25QXX_PAGE_SIZE) // Payload of one logical sector
+#define W25QXX_FTL_SECTOR_FREE   0xFFFF
+#define W25QXX_FTL_HEADER_MAGIC  0x5746
+#define W25QXX_FTL_TABLE_MAGIC   0x5754
+#define W25QXX_FTL_TABLE_SECTORS 2 // Sectors at the region end holding the erase count table, rewritten in turns
+#define W25QXX_FTL_TABLE_NONE    0xFF
+
+/* Data types */
+typedef struct w25qxx_FtlHeader_s {
+    uint16_t magic;
+    uint16_t logicalSector;
+    uint32_t eraseCount;
+    uint32_t sequence;
+} w25qxx_FtlHeader_t;
+
+typedef struct w25qxx_FtlTableHeader_s {
+    uint16_t magic;
+    uint16_t numberOfSectors; // Number of data sectors the table was written for
+    uint32_t sequence;
+} w25qxx_FtlTableHeader_t;
+
+typedef struct w25qxx_FtlTableEntry_s {
+    uint32_t eraseCount;
+    uint16_t physicalSector;
+    uint16_t CRC16; // Checksum of the fields above, an interrupted entry is skipped
+} w25qxx_FtlTableEntry_t;
+
+typedef struct w25qxx_FtlHandleTypeDef_s {
+    w25qxx_HandleTypeDef *w25qxx_Handle; // Device that holds the FTL region
+    uint32_t firstSector; // First physical sector of the FTL region
+    uint16_t numberOfSectors; // Number of physical data sectors, the table sectors excluded
+    uint16_t numberOfLogicalSectors; // Number of logical sectors exposed to the user
+    uint32_t sequence; // Sequence number of the most recent sector header
+    uint32_t relocations; // Number of cold sectors moved by static wear leveling
+    uint16_t map[W25QXX_FTL_MAX_SECTORS]; // Logical to physical sector translation
+    uint32_t eraseCount[W25QXX_FTL_MAX_SECTORS]; // Erase counter of each physical sector
+    uint8_t table; // Table sector holding the counters, `W25QXX_FTL_TABLE_NONE` until the first erase
+    uint32_t tableSequence; // Sequence number of the table sector
+    uint16_t tableEntries; // Journal entries used within the table sector
+    uint8_t pageBuf[W25QXX_PAGE_SIZE];
+} w25qxx_FtlHandleTypeDef;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Scans the FTL region and rebuilds the sector map and erase counters
+ * @param w25qxx_FtlHandle pointer to the FTL handle structure
+ * @param w25qxx_Handle pointer to the initialized device handle
+ * @param firstSector first physical sector of the FTL region
+ * @param numberOfSectors number of physical sectors within the FTL region
+ * @note The first page of every data sector is reserved for the sector header. The last `W25QXX_FTL_TABLE_SECTORS`
+ * sectors hold the erase count table: a snapshot of all counters followed by a journal entry per erase, written
+ * before the erase starts, so an interrupted erase keeps the wear of its sector. Nothing is written by the call
+ * @return `w25qxx_Handle->error`
+ */
+w25qxx_Error_t w25qxx_FtlInit(w25qxx_FtlHandleTypeDef *w25qxx_FtlHandle, w25qxx_HandleTypeDef *w25qxx_Handle,
+                              uint32_t firstSector, uint16_t numberOfSectors);
+
+/**
+ * @brief Writes one logical sector from external buffer
+ * @param w25qxx_FtlHandle pointer to the FTL handle structure
+ * @param buf pointer to external buffer of `W25QXX_FTL_SECTOR_SIZE` bytes
+ * @param logicalSector logical sector to write
+ * @note Data is written to the least worn free physical sector, the old copy is released afterwards
+ * @return `w25qxx_Handle->error`
+ */
+w25qxx_Error_t w25qxx_FtlWrite(w25qxx_FtlHandleTypeDef *w25qxx_FtlHandle, const uint8_t *buf, uint16_t logicalSector);
+
+/**
+ * @brief Reads one logical sector to external buffer
+ * @param w25qxx_FtlHandle pointer to the FTL handle structure
+ * @param buf pointer to external buffer of `W25QXX_FTL_SECTOR_SIZE` bytes
+ * @param logicalSector logical sector to read
+ * @note Never written logical sector reads as erased (0xFF)
+ * @return `w25qxx_Handle->error`
+ */
+w25qxx_Error_t w25qxx_FtlRead(w25qxx_FtlHandleTypeDef *w25qxx_FtlHandle, uint8_t *buf, uint16_t logicalSector);
+
+#ifdef __cplusplus
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,333 @@
+#include "w25qxx_Mirror.h"
+
+#define W25QXX_MIRROR_OTHER(COPY) ((uint8_t) (((COPY) + 1) % W25QXX_MIRROR_COPIES))
+
+static w25qxx_Error_t w25qxx_MirrorSync(w25qxx_MirrorTypeDef *w25qxx_Mirror);
+static void w25qxx_MirrorReport(w25qxx_MirrorTypeDef *w25qxx_Mirror, uint8_t badCopy, uint32_t address);
+static w25qxx_Error_t w25qxx_MirrorRestore(w25qxx_MirrorTypeDef *w25qxx_Mirror, uint8_t badCopy,
+                                           uint32_t sectorAddress);
+static bool w25qxx_MirrorIsIdle(w25qxx_MirrorTypeDef *w25qxx_Mirror, uint8_t copy);
+static uint32_t w25qxx_MirrorEraseTime(w25qxx_EraseInstruction_t eraseInstruction);
+
+w25qxx_Error_t w25qxx_MirrorInit(w25qxx_MirrorTypeDef *w25qxx_Mirror, w25qxx_HandleTypeDef *w25qxx_Handle1,
+                                 w25qxx_HandleTypeDef *w25qxx_Handle2)
+{
+    /* Argument guards */
+    if ((w25qxx_Mirror == NULL) || (w25qxx_Handle1 == NULL) || (w25qxx_Handle2 == NULL))
+        return W25QXX_ERROR_ARGUMENT;
+    if (w25qxx_Handle1 == w25qxx_Handle2)
+        return W25QXX_ERROR_ARGUMENT;
+    if (w25qxx_Handle1->error != W25QXX_ERROR_NONE)
+        return w25qxx_Handle1->error;
+    if (w25qxx_Handle2->error != W25QXX_ERROR_NONE)
+        return w25qxx_Handle2->error;
+    if (w25qxx_Handle1->numberOfPages != w25qxx_Handle2->numberOfPages)
+        return W25QXX_ERROR_ID;
+
+    memset(w25qxx_Mirror, 0, sizeof(*w25qxx_Mirror));
+    w25qxx_Mirror->w25qxx_Handles[0] = w25qxx_Handle1;
+    w25qxx_Mirror->w25qxx_Handles[1] = w25qxx_Handle2;
+    w25qxx_Mirror->erase.copy = W25QXX_MIRROR_COPIES;
+
+    return W25QXX_ERROR_NONE;
+}
+
+w25qxx_Error_t w25qxx_MirrorWrite(w25qxx_MirrorTypeDef *w25qxx_Mirror, const uint8_t *buf, uint16_t dataLength,
+                                  uint32_t address, w25qxx_CRC_t trailingCRC)
+{
+    uint8_t copy;
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Mirror == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    if (w25qxx_MirrorSync(w25qxx_Mirror) != W25QXX_ERROR_NONE)
+        return w25qxx_Mirror->w25qxx_Handles[w25qxx_Mirror->erase.copy]->error;
+
+    /* Program both copies, then wait for both */
+    for (copy = 0; copy < W25QXX_MIRROR_COPIES; copy++)
+    {
+        if (w25qxx_Write(w25qxx_Mirror->w25qxx_Handles[copy], buf, dataLength, address, trailingCRC,
+                         W25QXX_WAIT_NO) != W25QXX_ERROR_NONE)
+            return w25qxx_Mirror->w25qxx_Handles[copy]->error;
+    }
+    for (copy = 0; copy < W25QXX_MIRROR_COPIES; copy++)
+    {
+        if (w25qxx_BusyCheck(w25qxx_Mirror->w25qxx_Handles[copy], W25QXX_PAGE_PROGRAM_TIME) != W25QXX_STATUS_READY)
+        {
+            if (w25qxx_Mirror->w25qxx_Handles[copy]->error == W25QXX_ERROR_NONE)
+                w25qxx_Mirror->w25qxx_Handles[copy]->error = W25QXX_ERROR_TIMEOUT;
+
+            return w25qxx_Mirror->w25qxx_Handles[copy]->error;
+        }
+    }
+
+    return W25QXX_ERROR_NONE;
+}
+
+w25qxx_Error_t w25qxx_MirrorRead(w25qxx_MirrorTypeDef *w25qxx_Mirror, uint8_t *buf, uint16_t dataLength,
+                                 uint32_t address, w25qxx_CRC_t trailingCRC, w25qxx_FastRead_t fastRead)
+{
+    uint8_t copy, other;
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Mirror == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    if (w25qxx_MirrorService(w25qxx_Mirror) != W25QXX_ERROR_NONE)
+        return w25qxx_Mirror->w25qxx_Handles[w25qxx_Mirror->erase.copy]->error;
+
+    /* Read balancing: alternate copies, skip the busy one */
+    copy = w25qxx_Mirror->readCopy;
+    other = W25QXX_MIRROR_OTHER(copy);
+    if (!w25qxx_MirrorIsIdle(w25qxx_Mirror, copy))
+    {
+        if (w25qxx_MirrorIsIdle(w25qxx_Mirror, other))
+        {
+            copy = other;
+            other = W25QXX_MIRROR_OTHER(copy);
+            w25qxx_Mirror->stats.redirected++;
+        }
+        else if (w25qxx_MirrorSync(w25qxx_Mirror) != W25QXX_ERROR_NONE)
+        {
+            return w25qxx_Mirror->w25qxx_Handles[w25qxx_Mirror->erase.copy]->error;
+        }
+    }
+    w25qxx_Mirror->readCopy = other;
+
+    w25qxx_Read(w25qxx_Mirror->w25qxx_Handles[copy], buf, dataLength, address, trailingCRC, fastRead);
+    switch (w25qxx_Mirror->w25qxx_Handles[copy]->error)
+    {
+    case W25QXX_ERROR_NONE:
+        w25qxx_Mirror->stats.reads[copy]++;
+
+        return W25QXX_ERROR_NONE;
+
+    case W25QXX_ERROR_CHECKSUM:
+        if (w25qxx_ResetError(w25qxx_Mirror->w25qxx_Handles[copy]) != W25QXX_ERROR_NONE)
+            return w25qxx_Mirror->w25qxx_Handles[copy]->error;
+        break;
+
+    default:
+        return w25qxx_Mirror->w25qxx_Handles[copy]->error;
+    }
+
+    /* Fall back to the mirror */
+    if (w25qxx_MirrorSync(w25qxx_Mirror) != W25QXX_ERROR_NONE)
+        return w25qxx_Mirror->w25qxx_Handles[w25qxx_Mirror->erase.copy]->error;
+    w25qxx_Read(w25qxx_Mirror->w25qxx_Handles[other], buf, dataLength, address, trailingCRC, fastRead);
+    switch (w25qxx_Mirror->w25qxx_Handles[other]->error)
+    {
+    case W25QXX_ERROR_NONE:
+        w25qxx_Mirror->stats.reads[other]++;
+        w25qxx_Mirror->stats.mismatches++;
+        break;
+
+    /* Both copies are corrupted or erased */
+    case W25QXX_ERROR_CHECKSUM:
+        if (w25qxx_ResetError(w25qxx_Mirror->w25qxx_Handles[other]) != W25QXX_ERROR_NONE)
+            return w25qxx_Mirror->w25qxx_Handles[other]->error;
+
+        return W25QXX_ERROR_CHECKSUM;
+
+    default:
+        return w25qxx_Mirror->w25qxx_Handles[other]->error;
+    }
+
+    w25qxx_MirrorReport(w25qxx_Mirror, copy, address);
+
+    return W25QXX_ERROR_NONE;
+}
+
+w25qxx_Error_t w25qxx_MirrorErase(w25qxx_MirrorTypeDef *w25qxx_Mirror, w25qxx_EraseInstruction_t eraseInstruction,
+                                  uint32_t address, w25qxx_WaitForTask_t waitForTask)
+{
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Mirror == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    /* Argument guards */
+    if (w25qxx_MirrorEraseTime(eraseInstruction) == 0)
+        return W25QXX_ERROR_INSTRUCTION;
+
+    if (w25qxx_MirrorSync(w25qxx_Mirror) != W25QXX_ERROR_NONE)
+        return w25qxx_Mirror->w25qxx_Handles[w25qxx_Mirror->erase.copy]->error;
+
+    /* The first copy, the second one follows when the first is done */
+    w25qxx_Mirror->erase.eraseInstruction = eraseInstruction;
+    w25qxx_Mirror->erase.address = address;
+    w25qxx_Mirror->erase.copy = 0;
+    if (w25qxx_Erase(w25qxx_Mirror->w25qxx_Handles[0], eraseInstruction, address, W25QXX_WAIT_NO) !=
+        W25QXX_ERROR_NONE)
+    {
+        w25qxx_Mirror->erase.copy = W25QXX_MIRROR_COPIES;
+
+        return w25qxx_Mirror->w25qxx_Handles[0]->error;
+    }
+
+    if (waitForTask == W25QXX_WAIT_NO)
+        return W25QXX_ERROR_NONE;
+
+    return w25qxx_MirrorSync(w25qxx_Mirror);
+}
+
+w25qxx_Error_t w25qxx_MirrorHeal(w25qxx_MirrorTypeDef *w25qxx_Mirror)
+{
+    w25qxx_Error_t error;
+    uint8_t last;
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Mirror == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    if (w25qxx_MirrorSync(w25qxx_Mirror) != W25QXX_ERROR_NONE)
+        return w25qxx_Mirror->w25qxx_Handles[w25qxx_Mirror->erase.copy]->error;
+
+    /* The newest report first, a failed one stays queued */
+    while (w25qxx_Mirror->heal.count > 0)
+    {
+        last = w25qxx_Mirror->heal.count - 1;
+        error = w25qxx_MirrorRestore(w25qxx_Mirror, w25qxx_Mirror->heal.copy[last],
+                                     w25qxx_Mirror->heal.sectorAddress[last]);
+        if (error != W25QXX_ERROR_NONE)
+            return error;
+        w25qxx_Mirror->heal.count--;
+    }
+
+    return W25QXX_ERROR_NONE;
+}
+
+w25qxx_Error_t w25qxx_MirrorService(w25qxx_MirrorTypeDef *w25qxx_Mirror)
+{
+    uint8_t copy;
+
+    /* Avoid dereferencing the null handle */
+    if (w25qxx_Mirror == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+
+    /* No erase in progress */
+    copy = w25qxx_Mirror->erase.copy;
+    if (copy >= W25QXX_MIRROR_COPIES)
+        return W25QXX_ERROR_NONE;
+
+    if (w25qxx_BusyCheck(w25qxx_Mirror->w25qxx_Handles[copy], 0) != W25QXX_STATUS_READY)
+        return w25qxx_Mirror->w25qxx_Handles[copy]->error;
+
+    /* Next copy */
+    w25qxx_Mirror->erase.copy = ++copy;
+    if (copy >= W25QXX_MIRROR_COPIES)
+        return W25QXX_ERROR_NONE;
+    if (w25qxx_Erase(w25qxx_Mirror->w25qxx_Handles[copy], w25qxx_Mirror->erase.eraseInstruction,
+                     w25qxx_Mirror->erase.address, W25QXX_WAIT_NO) != W25QXX_ERROR_NONE)
+        return w25qxx_Mirror->w25qxx_Handles[copy]->error;
+
+    return W25QXX_ERROR_NONE;
+}
+
+/**
+ * @section Private functions
+ */
+static w25qxx_Error_t w25qxx_MirrorSync(w25qxx_MirrorTypeDef *w25qxx_Mirror)
+{
+    w25qxx_HandleTypeDef *w25qxx_Handle;
+
+    while (w25qxx_Mirror->erase.copy < W25QXX_MIRROR_COPIES)
+    {
+        w25qxx_Handle = w25qxx_Mirror->w25qxx_Handles[w25qxx_Mirror->erase.copy];
+        if (w25qxx_BusyCheck(w25qxx_Handle, w25qxx_MirrorEraseTime(w25qxx_Mirror->erase.eraseInstruction)) !=
+            W25QXX_STATUS_READY)
+        {
+            if (w25qxx_Handle->error == W25QXX_ERROR_NONE)
+                w25qxx_Handle->error = W25QXX_ERROR_TIMEOUT;
+
+            return w25qxx_Handle->error;
+        }
+        if (w25qxx_MirrorService(w25qxx_Mirror) != W25QXX_ERROR_NONE)
+            return w25qxx_Mirror->w25qxx_Handles[w25qxx_Mirror->erase.copy]->error;
+    }
+
+    return W25QXX_ERROR_NONE;
+}
+
+static void w25qxx_MirrorReport(w25qxx_MirrorTypeDef *w25qxx_Mirror, uint8_t badCopy, uint32_t address)
+{
+    uint32_t sectorAddress = address - (address % W25QXX_SECTOR_SIZE_4KB);
+    uint8_t i;
+
+    /* Sector already reported */
+    for (i = 0; i < w25qxx_Mirror->heal.count; i++)
+    {
+        if ((w25qxx_Mirror->heal.sectorAddress[i] == sectorAddress) && (w25qxx_Mirror->heal.copy[i] == badCopy))
+            return;
+    }
+
+    /* Full queue drops the report, the next read of the sector reports it again */
+    if (w25qxx_Mirror->heal.count >= W25QXX_MIRROR_HEAL_QUEUE)
+        return;
+    w25qxx_Mirror->heal.sectorAddress[w25qxx_Mirror->heal.count] = sectorAddress;
+    w25qxx_Mirror->heal.copy[w25qxx_Mirror->heal.count] = badCopy;
+    w25qxx_Mirror->heal.count++;
+}
+
+static w25qxx_Error_t w25qxx_MirrorRestore(w25qxx_MirrorTypeDef *w25qxx_Mirror, uint8_t badCopy,
+                                           uint32_t sectorAddress)
+{
+    w25qxx_HandleTypeDef *w25qxx_HandleBad = w25qxx_Mirror->w25qxx_Handles[badCopy];
+    w25qxx_HandleTypeDef *w25qxx_HandleGood = w25qxx_Mirror->w25qxx_Handles[W25QXX_MIRROR_OTHER(badCopy)];
+    uint32_t pageAddress;
+    uint16_t i;
+
+    /* Whole sector is restored, since the minimal erase operation is 1 sector */
+    if (w25qxx_Erase(w25qxx_HandleBad, W25QXX_SECTOR_ERASE_4KB, sectorAddress, W25QXX_WAIT_BUSY) != W25QXX_ERROR_NONE)
+        return w25qxx_HandleBad->error;
+    for (pageAddress = sectorAddress; pageAddress < (sectorAddress + W25QXX_SECTOR_SIZE_4KB);
+         pageAddress += W25QXX_PAGE_SIZE)
+    {
+        if (w25qxx_Read(w25qxx_HandleGood, w25qxx_Mirror->pageBuf, W25QXX_PAGE_SIZE, pageAddress, W25QXX_CRC_NO,
+                        W25QXX_FASTREAD_NO) != W25QXX_ERROR_NONE)
+            return w25qxx_HandleGood->error;
+
+        /* Erased pages are skipped */
+        for (i = 0; i < W25QXX_PAGE_SIZE; i++)
+        {
+            if (w25qxx_Mirror->pageBuf[i] != 0xff)
+                break;
+        }
+        if (i == W25QXX_PAGE_SIZE)
+            continue;
+
+        if (w25qxx_Write(w25qxx_HandleBad, w25qxx_Mirror->pageBuf, W25QXX_PAGE_SIZE, pageAddress, W25QXX_CRC_NO,
+                         W25QXX_WAIT_BUSY) != W25QXX_ERROR_NONE)
+            return w25qxx_HandleBad->error;
+    }
+    w25qxx_Mirror->stats.healed++;
+
+    return W25QXX_ERROR_NONE;
+}
+
+static bool w25qxx_MirrorIsIdle(w25qxx_MirrorTypeDef *w25qxx_Mirror, uint8_t copy)
+{
+    if (w25qxx_Mirror->erase.copy == copy)
+        return false;
+
+    return (w25qxx_BusyCheck(w25qxx_Mirror->w25qxx_Handles[copy], 0) == W25QXX_STATUS_READY);
+}
+
+static uint32_t w25qxx_MirrorEraseTime(w25qxx_EraseInstruction_t eraseInstruction)
+{
+    switch (eraseInstruction)
+    {
+    case W25QXX_SECTOR_ERASE_4KB:
+        return W25QXX_SECTOR_ERASE_TIME_4KB;
+
+    case W25QXX_BLOCK_ERASE_32KB:
+        return W25QXX_BLOCK_ERASE_TIME_32KB;
+
+    case W25QXX_BLOCK_ERASE_64KB:
+        return W25QXX_BLOCK_ERASE_TIME_64KB;
+
+    /* Chip erase would leave no copy available for a long time */
+    default:
+        return 0;
+    }
+}
\ No newline at end of file
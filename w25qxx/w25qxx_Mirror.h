@@ -0,0 +1,111 @@
+#pragma once
+
+#include "w25qxx.h"
+
+/* Configuration */
+#ifndef W25QXX_MIRROR_HEAL_QUEUE
+#define W25QXX_MIRROR_HEAL_QUEUE 4 // Maximum number of damaged sectors waiting for `w25qxx_MirrorHeal()`
+#endif
+
+/* Device constants */
+#define W25QXX_MIRROR_COPIES 2
+
+/* Data types */
+typedef struct w25qxx_MirrorTypeDef_s {
+    w25qxx_HandleTypeDef *w25qxx_Handles[W25QXX_MIRROR_COPIES]; // Initialized devices holding identical data
+    uint8_t readCopy; // Copy preferred by the next read
+
+    struct {
+        w25qxx_EraseInstruction_t eraseInstruction;
+        uint32_t address;
+        uint8_t copy; // Copy being erased, `W25QXX_MIRROR_COPIES` if no erase in progress
+    } erase;
+
+    struct {
+        uint32_t sectorAddress[W25QXX_MIRROR_HEAL_QUEUE];
+        uint8_t copy[W25QXX_MIRROR_HEAL_QUEUE]; // Copy that failed the checksum
+        uint8_t count; // Number of sectors waiting for `w25qxx_MirrorHeal()`
+    } heal;
+
+    struct {
+        uint32_t reads[W25QXX_MIRROR_COPIES]; // Number of reads served by each copy
+        uint32_t redirected; // Number of reads moved to the other copy because of busy device
+        uint32_t mismatches; // Number of reads served by the other copy after checksum error
+        uint32_t healed; // Number of sectors restored from the other copy by `w25qxx_MirrorHeal()`
+    } stats;
+
+    uint8_t pageBuf[W25QXX_PAGE_SIZE];
+} w25qxx_MirrorTypeDef;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Builds a mirrored volume of two devices
+ * @param w25qxx_Mirror pointer to the mirrored volume structure
+ * @param w25qxx_Handle1 pointer to the first initialized device handle
+ * @param w25qxx_Handle2 pointer to the second initialized device handle
+ * @return `W25QXX_ERROR_NONE` or the error of the failed device
+ */
+w25qxx_Error_t w25qxx_MirrorInit(w25qxx_MirrorTypeDef *w25qxx_Mirror, w25qxx_HandleTypeDef *w25qxx_Handle1,
+                                 w25qxx_HandleTypeDef *w25qxx_Handle2);
+
+/**
+ * @brief Writes the same page to both copies, page program of the copies overlaps
+ * @param w25qxx_Mirror pointer to the mirrored volume structure
+ * @param buf pointer to external buffer, that contains the data to send
+ * @param dataLength number of bytes to write (<= 254 in case of trailingCRC)
+ * @param address page address to write (multiple of 256 bytes)
+ * @param trailingCRC insert or not insert CRC at the end of frame
+ * @return `W25QXX_ERROR_NONE` or the error of the failed device
+ */
+w25qxx_Error_t w25qxx_MirrorWrite(w25qxx_MirrorTypeDef *w25qxx_Mirror, const uint8_t *buf, uint16_t dataLength,
+                                  uint32_t address, w25qxx_CRC_t trailingCRC);
+
+/**
+ * @brief Reads a page from the idle copy, the other copy is used on checksum error
+ * @param w25qxx_Mirror pointer to the mirrored volume structure
+ * @param buf pointer to external buffer, that will contain the received data
+ * @param dataLength number of bytes to read (<= 254 in case of trailingCRC)
+ * @param address page address to read (multiple of 256 bytes)
+ * @param trailingCRC compare or not compare CRC at the end of frame
+ * @param fastRead set true if SPIclk > 50MHz
+ * @note `W25QXX_ERROR_CHECKSUM` is returned only if both copies are corrupted, device error is not set then.
+ * A copy failing the checksum is only reported in `heal`, nothing is written until `w25qxx_MirrorHeal()`
+ * @return `W25QXX_ERROR_NONE` or the error of the failed device
+ */
+w25qxx_Error_t w25qxx_MirrorRead(w25qxx_MirrorTypeDef *w25qxx_Mirror, uint8_t *buf, uint16_t dataLength,
+                                 uint32_t address, w25qxx_CRC_t trailingCRC, w25qxx_FastRead_t fastRead);
+
+/**
+ * @brief Erases sector or block on both copies one after another, so one copy is always available for reads
+ * @param w25qxx_Mirror pointer to the mirrored volume structure
+ * @param eraseInstruction pages groups to be erased
+ * @param address start address of sector or block to be erased
+ * @param waitForTask `W25QXX_WAIT_NO` to return right after the erase of the first copy started
+ * @note Erase of the second copy is started by `w25qxx_MirrorService()` or any other mirror function
+ * @return `W25QXX_ERROR_NONE` or the error of the failed device
+ */
+w25qxx_Error_t w25qxx_MirrorErase(w25qxx_MirrorTypeDef *w25qxx_Mirror, w25qxx_EraseInstruction_t eraseInstruction,
+                                  uint32_t address, w25qxx_WaitForTask_t waitForTask);
+
+/**
+ * @brief Restores the sectors reported by `w25qxx_MirrorRead()` from the other copy
+ * @param w25qxx_Mirror pointer to the mirrored volume structure
+ * @note Every sector is erased and programmed while the other copy keeps serving reads, call it from idle time.
+ * Sectors left by a failed device stay in `heal`
+ * @return `W25QXX_ERROR_NONE` or the error of the failed device
+ */
+w25qxx_Error_t w25qxx_MirrorHeal(w25qxx_MirrorTypeDef *w25qxx_Mirror);
+
+/**
+ * @brief Advances the erase in progress without blocking
+ * @param w25qxx_Mirror pointer to the mirrored volume structure
+ * @return `W25QXX_ERROR_NONE` or the error of the failed device
+ */
+w25qxx_Error_t w25qxx_MirrorService(w25qxx_MirrorTypeDef *w25qxx_Mirror);
+
+#ifdef __cplusplus
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,285 @@
+#include "w25qxx_Queue.h"
+
+#define W25QXX_QUEUE_FRAME_LENGTH(REQUEST) \
+    ((REQUEST)->dataLength + (((REQUEST)->trailingCRC == W25QXX_CRC) ? sizeof(uint16_t) : 0))
+#define W25QXX_QUEUE_EXPIRED(DEADLINE, NOW) (((DEADLINE) != 0) && ((int32_t) ((NOW) - (DEADLINE)) >= 0))
+
+static uint8_t w25qxx_QueueSchedule(w25qxx_QueueTypeDef *w25qxx_Queue, w25qxx_QueueRequestTypeDef **batch);
+static w25qxx_QueueRequestTypeDef *w25qxx_QueueSelect(w25qxx_QueueTypeDef *w25qxx_Queue);
+static void w25qxx_QueueUnlink(w25qxx_QueueTypeDef *w25qxx_Queue, w25qxx_QueueRequestTypeDef *request);
+static bool w25qxx_QueueIsMergeable(w25qxx_QueueTypeDef *w25qxx_Queue, w25qxx_QueueRequestTypeDef *request);
+static w25qxx_Error_t w25qxx_QueueExecute(w25qxx_QueueTypeDef *w25qxx_Queue, w25qxx_QueueRequestTypeDef *request);
+static void w25qxx_QueueExecuteMerged(w25qxx_QueueTypeDef *w25qxx_Queue, w25qxx_QueueRequestTypeDef **batch,
+                                      uint8_t count);
+
+w25qxx_Error_t w25qxx_QueueInit(w25qxx_QueueTypeDef *w25qxx_Queue, w25qxx_HandleTypeDef *w25qxx_Handle)
+{
+    /* Avoid dereferencing the null handle */
+    if ((w25qxx_Queue == NULL) || (w25qxx_Handle == NULL))
+        return W25QXX_ERROR_ARGUMENT;
+
+    /* Check OS functions */
+    if ((w25qxx_Queue->interface.lock == NULL) || (w25qxx_Queue->interface.unlock == NULL))
+        return W25QXX_ERROR_PLATFORM;
+    if ((w25qxx_Queue->interface.notify == NULL) || (w25qxx_Queue->interface.wait == NULL))
+        return W25QXX_ERROR_PLATFORM;
+
+    memset(w25qxx_Queue->pending, 0, sizeof(w25qxx_Queue->pending));
+    memset(&w25qxx_Queue->stats, 0, sizeof(w25qxx_Queue->stats));
+    w25qxx_Queue->position = 0;
+    w25qxx_Queue->w25qxx_Handle = w25qxx_Handle;
+
+    return w25qxx_Handle->error;
+}
+
+w25qxx_Error_t w25qxx_QueueSubmit(w25qxx_QueueTypeDef *w25qxx_Queue, w25qxx_QueueRequestTypeDef *request)
+{
+    /* Argument guards */
+    if ((w25qxx_Queue == NULL) || (w25qxx_Queue->w25qxx_Handle == NULL) || (request == NULL))
+        return W25QXX_ERROR_ARGUMENT;
+    if ((unsigned) request->operation >= W25QXX_QUEUE_CLASSES)
+        return W25QXX_ERROR_ARGUMENT;
+
+    request->error = W25QXX_ERROR_NONE;
+    request->done = false;
+    request->next = NULL;
+
+    w25qxx_Queue->interface.lock(w25qxx_Queue->interface.lockContext);
+    if (w25qxx_Queue->pending[request->operation].tail == NULL)
+        w25qxx_Queue->pending[request->operation].head = request;
+    else
+        w25qxx_Queue->pending[request->operation].tail->next = request;
+    w25qxx_Queue->pending[request->operation].tail = request;
+    w25qxx_Queue->stats.submitted[request->operation]++;
+    w25qxx_Queue->interface.unlock(w25qxx_Queue->interface.lockContext);
+
+    w25qxx_Queue->interface.notify(w25qxx_Queue->interface.notifyContext);
+
+    return W25QXX_ERROR_NONE;
+}
+
+uint32_t w25qxx_QueueProcess(w25qxx_QueueTypeDef *w25qxx_Queue, uint32_t timeout)
+{
+    w25qxx_QueueRequestTypeDef *batch[W25QXX_QUEUE_MERGE_PAGES];
+    w25qxx_QueueRequestTypeDef *request;
+    w25qxx_complete_fp complete;
+    uint32_t processed = 0;
+    uint8_t count, i;
+
+    /* Avoid dereferencing the null handle */
+    if ((w25qxx_Queue == NULL) || (w25qxx_Queue->w25qxx_Handle == NULL))
+        return 0;
+
+    /* Requests submitted before the wakeup are drained anyway, so the timeout result is not important */
+    w25qxx_Queue->interface.wait(w25qxx_Queue->interface.notifyContext, timeout);
+
+    while ((count = w25qxx_QueueSchedule(w25qxx_Queue, batch)) > 0)
+    {
+        if (count > 1)
+            w25qxx_QueueExecuteMerged(w25qxx_Queue, batch, count);
+        else
+            batch[0]->error = w25qxx_QueueExecute(w25qxx_Queue, batch[0]);
+
+        for (i = 0; i < count; i++)
+        {
+            request = batch[i];
+            if (request->error != W25QXX_ERROR_NONE)
+            {
+                /* Error belongs to the request, the device stays available for the next one */
+                w25qxx_ResetError(w25qxx_Queue->w25qxx_Handle);
+                w25qxx_Queue->stats.failed++;
+            }
+            if ((w25qxx_Queue->interface.now != NULL) &&
+                W25QXX_QUEUE_EXPIRED(request->deadline, w25qxx_Queue->interface.now()))
+                w25qxx_Queue->stats.late++;
+            w25qxx_Queue->stats.completed++;
+            processed++;
+
+            /* Request may be reused as soon as it is done */
+            complete = request->complete;
+            request->done = true;
+            if (complete != NULL)
+                complete(request);
+        }
+    }
+
+    return processed;
+}
+
+void w25qxx_QueueWorker(void *argument)
+{
+    /* Infinite loop */
+    for (;;)
+        w25qxx_QueueProcess((w25qxx_QueueTypeDef *) argument, W25QXX_QUEUE_WAIT_FOREVER);
+}
+
+/**
+ * @section Private functions
+ */
+static uint8_t w25qxx_QueueSchedule(w25qxx_QueueTypeDef *w25qxx_Queue, w25qxx_QueueRequestTypeDef **batch)
+{
+    w25qxx_QueueRequestTypeDef *request;
+    uint8_t count = 0;
+
+    w25qxx_Queue->interface.lock(w25qxx_Queue->interface.lockContext);
+    batch[0] = w25qxx_QueueSelect(w25qxx_Queue);
+    if (batch[0] != NULL)
+    {
+        w25qxx_QueueUnlink(w25qxx_Queue, batch[0]);
+        count = 1;
+
+        /* Pending reads of the following pages join the read instruction if few unused bytes are clocked out */
+        while ((count < W25QXX_QUEUE_MERGE_PAGES) && w25qxx_QueueIsMergeable(w25qxx_Queue, batch[count - 1]) &&
+               ((W25QXX_PAGE_SIZE - W25QXX_QUEUE_FRAME_LENGTH(batch[count - 1])) <= W25QXX_QUEUE_MERGE_GAP))
+        {
+            for (request = w25qxx_Queue->pending[W25QXX_QUEUE_READ].head; request != NULL; request = request->next)
+            {
+                if ((request->address == (batch[count - 1]->address + W25QXX_PAGE_SIZE)) &&
+                    (request->fastRead == batch[0]->fastRead) && w25qxx_QueueIsMergeable(w25qxx_Queue, request))
+                    break;
+            }
+            if (request == NULL)
+                break;
+
+            w25qxx_QueueUnlink(w25qxx_Queue, request);
+            batch[count++] = request;
+            w25qxx_Queue->stats.merged++;
+        }
+        w25qxx_Queue->position = batch[count - 1]->address;
+    }
+    w25qxx_Queue->interface.unlock(w25qxx_Queue->interface.lockContext);
+
+    return count;
+}
+
+static w25qxx_QueueRequestTypeDef *w25qxx_QueueSelect(w25qxx_QueueTypeDef *w25qxx_Queue)
+{
+    w25qxx_QueueRequestTypeDef *request, *selected = NULL, *lowest;
+    uint32_t now;
+    uint8_t priority;
+
+    /* Expired request goes first, the earliest deadline wins */
+    if (w25qxx_Queue->interface.now != NULL)
+    {
+        now = w25qxx_Queue->interface.now();
+        for (priority = 0; priority < W25QXX_QUEUE_CLASSES; priority++)
+        {
+            for (request = w25qxx_Queue->pending[priority].head; request != NULL; request = request->next)
+            {
+                if (!W25QXX_QUEUE_EXPIRED(request->deadline, now))
+                    continue;
+                if ((selected == NULL) || ((int32_t) (request->deadline - selected->deadline) < 0))
+                    selected = request;
+            }
+        }
+        if (selected != NULL)
+        {
+            w25qxx_Queue->stats.expired++;
+
+            return selected;
+        }
+    }
+
+    /* Highest class first, ascending address from the last served one, then wrap around */
+    for (priority = 0; priority < W25QXX_QUEUE_CLASSES; priority++)
+    {
+        lowest = w25qxx_Queue->pending[priority].head;
+        for (request = lowest; request != NULL; request = request->next)
+        {
+            if (request->address < lowest->address)
+                lowest = request;
+            if ((request->address >= w25qxx_Queue->position) &&
+                ((selected == NULL) || (request->address < selected->address)))
+                selected = request;
+        }
+        if (lowest != NULL)
+            return (selected != NULL) ? selected : lowest;
+    }
+
+    return NULL;
+}
+
+static void w25qxx_QueueUnlink(w25qxx_QueueTypeDef *w25qxx_Queue, w25qxx_QueueRequestTypeDef *request)
+{
+    w25qxx_QueueRequestTypeDef *previous = NULL, *current;
+
+    for (current = w25qxx_Queue->pending[request->operation].head; current != request; current = current->next)
+        previous = current;
+
+    if (previous == NULL)
+        w25qxx_Queue->pending[request->operation].head = request->next;
+    else
+        previous->next = request->next;
+    if (w25qxx_Queue->pending[request->operation].tail == request)
+        w25qxx_Queue->pending[request->operation].tail = previous;
+    request->next = NULL;
+}
+
+static bool w25qxx_QueueIsMergeable(w25qxx_QueueTypeDef *w25qxx_Queue, w25qxx_QueueRequestTypeDef *request)
+{
+    if ((request->operation != W25QXX_QUEUE_READ) || (request->buf == NULL) || (request->dataLength == 0))
+        return false;
+    if ((request->address % W25QXX_PAGE_SIZE) != 0)
+        return false;
+    if (W25QXX_QUEUE_FRAME_LENGTH(request) > W25QXX_PAGE_SIZE)
+        return false;
+
+    return (request->address < W25QXX_PAGE_TO_ADDRESS(w25qxx_Queue->w25qxx_Handle->numberOfPages));
+}
+
+static w25qxx_Error_t w25qxx_QueueExecute(w25qxx_QueueTypeDef *w25qxx_Queue, w25qxx_QueueRequestTypeDef *request)
+{
+    switch (request->operation)
+    {
+    case W25QXX_QUEUE_READ:
+        return w25qxx_Read(w25qxx_Queue->w25qxx_Handle, request->buf, request->dataLength, request->address,
+                           request->trailingCRC, request->fastRead);
+
+    case W25QXX_QUEUE_WRITE:
+        return w25qxx_Write(w25qxx_Queue->w25qxx_Handle, request->buf, request->dataLength, request->address,
+                            request->trailingCRC, W25QXX_WAIT_BUSY);
+
+    case W25QXX_QUEUE_ERASE:
+        return w25qxx_Erase(w25qxx_Queue->w25qxx_Handle, request->eraseInstruction, request->address,
+                            W25QXX_WAIT_BUSY);
+
+    default:
+        return W25QXX_ERROR_ARGUMENT;
+    }
+}
+
+static void w25qxx_QueueExecuteMerged(w25qxx_QueueTypeDef *w25qxx_Queue, w25qxx_QueueRequestTypeDef **batch,
+                                      uint8_t count)
+{
+    w25qxx_QueueRequestTypeDef *request;
+    uint32_t offset;
+    uint16_t CRC16;
+    uint8_t i;
+
+    /* One read instruction from the first page up to the end of the last frame */
+    offset = batch[count - 1]->address - batch[0]->address;
+    if (w25qxx_ReadStream(w25qxx_Queue->w25qxx_Handle, w25qxx_Queue->mergeBuf,
+                          offset + W25QXX_QUEUE_FRAME_LENGTH(batch[count - 1]), batch[0]->address,
+                          batch[0]->fastRead) != W25QXX_ERROR_NONE)
+    {
+        for (i = 0; i < count; i++)
+            batch[i]->error = w25qxx_Queue->w25qxx_Handle->error;
+
+        return;
+    }
+
+    /* Split frames and compare checksums */
+    for (i = 0; i < count; i++)
+    {
+        request = batch[i];
+        offset = request->address - batch[0]->address;
+        memcpy(request->buf, &w25qxx_Queue->mergeBuf[offset], request->dataLength);
+        request->error = W25QXX_ERROR_NONE;
+        if (request->trailingCRC == W25QXX_CRC)
+        {
+            CRC16 = w25qxx_CRC16(request->buf, request->dataLength);
+            if (memcmp(&w25qxx_Queue->mergeBuf[offset + request->dataLength], &CRC16, sizeof(CRC16)) != 0)
+                request->error = W25QXX_ERROR_CHECKSUM;
+        }
+    }
+}
\ No newline at end of file
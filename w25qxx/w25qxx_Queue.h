@@ -0,0 +1,124 @@
+#pragma once
+
+#include "w25qxx.h"
+
+/* Configuration */
+#ifndef W25QXX_QUEUE_WAIT_FOREVER
+#define W25QXX_QUEUE_WAIT_FOREVER 0xFFFFFFFF // Timeout value that blocks the worker until a request arrives
+#endif
+#ifndef W25QXX_QUEUE_MERGE_PAGES
+#define W25QXX_QUEUE_MERGE_PAGES 4 // Maximum number of page reads served by one read instruction
+#endif
+#ifndef W25QXX_QUEUE_MERGE_GAP
+#define W25QXX_QUEUE_MERGE_GAP 32 // Maximum number of unused bytes clocked out between merged reads
+#endif
+
+/* Data types */
+typedef enum w25qxx_QueueOperation_e {
+    W25QXX_QUEUE_READ, // Latency-critical class, served first
+    W25QXX_QUEUE_WRITE, // Normal class
+    W25QXX_QUEUE_ERASE, // Background class, served when no read or write is pending
+    W25QXX_QUEUE_CLASSES
+} w25qxx_QueueOperation_t;
+
+typedef struct w25qxx_QueueRequestTypeDef_s w25qxx_QueueRequestTypeDef;
+
+typedef void (*w25qxx_notify_fp)(void *context);
+typedef bool (*w25qxx_wait_fp)(void *context, uint32_t timeout);
+typedef void (*w25qxx_complete_fp)(w25qxx_QueueRequestTypeDef *request);
+
+struct w25qxx_QueueRequestTypeDef_s {
+    w25qxx_QueueOperation_t operation;
+    uint8_t *buf; // Read destination or write source
+    uint16_t dataLength;
+    uint32_t address;
+    w25qxx_CRC_t trailingCRC;
+    w25qxx_FastRead_t fastRead;
+    w25qxx_EraseInstruction_t eraseInstruction;
+
+    /* Optional (force `NULL` if not used) */
+    w25qxx_complete_fp complete; // Called from the worker context when the request is done
+    void *context; // Pointer to the user data (e.g. semaphore to give) be used in `complete` function
+    uint32_t deadline; // Tick by which the request has to be served, 0 if not important
+
+    /* Filled by the queue */
+    volatile w25qxx_Error_t error; // Result of the operation, device error is reset afterwards
+    volatile bool done;
+    w25qxx_QueueRequestTypeDef *next;
+};
+
+typedef struct w25qxx_QueueTypeDef_s {
+    struct {
+        w25qxx_lock_fp lock; // Pointer to the function that takes the queue mutex
+        w25qxx_lock_fp unlock; // Pointer to the function that releases the queue mutex
+        void *lockContext; // Pointer to the mutex be used in lock/unlock function
+        w25qxx_notify_fp notify; // Pointer to the function that wakes the worker (e.g. semaphore give)
+        w25qxx_wait_fp wait; // Pointer to the function that blocks the worker, returns false on timeout
+        void *notifyContext; // Pointer to the semaphore be used in notify/wait function
+
+        /* Optional (force `NULL` if not used) */
+        w25qxx_tick_fp now; // Pointer to the function that returns the tick of request deadlines
+    } interface;
+
+    w25qxx_HandleTypeDef *w25qxx_Handle;
+
+    struct {
+        w25qxx_QueueRequestTypeDef *head;
+        w25qxx_QueueRequestTypeDef *tail;
+    } pending[W25QXX_QUEUE_CLASSES];
+    uint32_t position; // Address of the last served request, requests within a class are served in ascending order
+
+    struct {
+        uint32_t submitted[W25QXX_QUEUE_CLASSES]; // Number of requests submitted in each class
+        uint32_t completed; // Number of requests done
+        uint32_t failed; // Number of requests done with error
+        uint32_t merged; // Number of reads served by the read instruction of another request
+        uint32_t expired; // Number of requests served ahead of their turn because of the deadline
+        uint32_t late; // Number of requests done after the deadline
+    } stats;
+
+    uint8_t mergeBuf[W25QXX_QUEUE_MERGE_PAGES * W25QXX_PAGE_SIZE];
+} w25qxx_QueueTypeDef;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Links the queue to the device and checks the OS functions
+ * @param w25qxx_Queue pointer to the queue structure with initialized interface
+ * @param w25qxx_Handle pointer to the initialized device handle
+ * @note The queue becomes the only user of the device, other tasks submit requests instead of calling the driver
+ * @return `W25QXX_ERROR_NONE`, `W25QXX_ERROR_PLATFORM` or `w25qxx_Handle->error`
+ */
+w25qxx_Error_t w25qxx_QueueInit(w25qxx_QueueTypeDef *w25qxx_Queue, w25qxx_HandleTypeDef *w25qxx_Handle);
+
+/**
+ * @brief Appends the request to its priority class and wakes the worker
+ * @param w25qxx_Queue pointer to the queue structure
+ * @param request pointer to the filled request, it must stay valid until `request->done` is set
+ * (until `request->complete` is called if provided)
+ * @note Arguments are validated by the worker, the result is reported in `request->error`
+ * @return `W25QXX_ERROR_NONE` or `W25QXX_ERROR_ARGUMENT`
+ */
+w25qxx_Error_t w25qxx_QueueSubmit(w25qxx_QueueTypeDef *w25qxx_Queue, w25qxx_QueueRequestTypeDef *request);
+
+/**
+ * @brief Waits for requests and executes them until the queue is empty
+ * @param w25qxx_Queue pointer to the queue structure
+ * @param timeout time to wait for the first request [ms]
+ * @note Request with expired deadline goes first, otherwise higher class first and ascending address within a class.
+ * Reads of consecutive pages are merged into one read instruction
+ * @return Number of requests done
+ */
+uint32_t w25qxx_QueueProcess(w25qxx_QueueTypeDef *w25qxx_Queue, uint32_t timeout);
+
+/**
+ * @brief Worker task entry, never returns
+ * @param argument pointer to the queue structure
+ */
+void w25qxx_QueueWorker(void *argument);
+
+#ifdef __cplusplus
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,198 @@
+#include "w25qxx_Stripe.h"
+
+static w25qxx_Error_t w25qxx_StripeWait(w25qxx_StripeTypeDef *w25qxx_Stripe, uint8_t device);
+static w25qxx_Error_t w25qxx_StripeWaitAll(w25qxx_StripeTypeDef *w25qxx_Stripe);
+
+w25qxx_Error_t w25qxx_StripeInit(w25qxx_StripeTypeDef *w25qxx_Stripe, w25qxx_HandleTypeDef *const *w25qxx_Handles,
+                                 uint8_t numberOfDevices)
+{
+    uint8_t device;
+
+    /* Argument guards */
+    if ((w25qxx_Stripe == NULL) || (w25qxx_Handles == NULL))
+        return W25QXX_ERROR_ARGUMENT;
+    if ((numberOfDevices == 0) || (numberOfDevices > W25QXX_STRIPE_MAX_DEVICES))
+        return W25QXX_ERROR_ARGUMENT;
+
+    memset(w25qxx_Stripe, 0, sizeof(*w25qxx_Stripe));
+    for (device = 0; device < numberOfDevices; device++)
+    {
+        if (w25qxx_Handles[device] == NULL)
+            return W25QXX_ERROR_ARGUMENT;
+        if (w25qxx_Handles[device]->error != W25QXX_ERROR_NONE)
+            return w25qxx_Handles[device]->error;
+
+        /* The smallest device limits the volume */
+        if ((device == 0) || (w25qxx_Handles[device]->numberOfPages < w25qxx_Stripe->numberOfPages))
+            w25qxx_Stripe->numberOfPages = w25qxx_Handles[device]->numberOfPages;
+        w25qxx_Stripe->w25qxx_Handles[device] = w25qxx_Handles[device];
+    }
+    w25qxx_Stripe->numberOfDevices = numberOfDevices;
+    w25qxx_Stripe->numberOfPages *= numberOfDevices;
+
+    return W25QXX_ERROR_NONE;
+}
+
+w25qxx_Error_t w25qxx_StripeWrite(w25qxx_StripeTypeDef *w25qxx_Stripe, const uint8_t *buf, uint32_t dataLength,
+                                  uint32_t address)
+{
+    uint32_t page, chunkLength;
+    uint8_t device;
+
+    /* Argument guards */
+    if ((w25qxx_Stripe == NULL) || (buf == NULL) || (dataLength == 0))
+        return W25QXX_ERROR_ARGUMENT;
+    if ((address % W25QXX_PAGE_SIZE) != 0)
+        return W25QXX_ERROR_ADDRESS;
+    if (((uint64_t) address + dataLength) > ((uint64_t) W25QXX_PAGE_SIZE * w25qxx_Stripe->numberOfPages))
+        return W25QXX_ERROR_ADDRESS;
+
+    for (page = address / W25QXX_PAGE_SIZE; dataLength > 0; page++)
+    {
+        device = page % w25qxx_Stripe->numberOfDevices;
+        chunkLength = (dataLength > W25QXX_PAGE_SIZE) ? W25QXX_PAGE_SIZE : dataLength;
+
+        /* Only the target device has to finish its previous page, others keep programming */
+        if (w25qxx_StripeWait(w25qxx_Stripe, device) != W25QXX_ERROR_NONE)
+            return w25qxx_Stripe->w25qxx_Handles[device]->error;
+        if (w25qxx_Write(w25qxx_Stripe->w25qxx_Handles[device], buf, chunkLength,
+                         W25QXX_PAGE_TO_ADDRESS(page / w25qxx_Stripe->numberOfDevices), W25QXX_CRC_NO,
+                         W25QXX_WAIT_NO) != W25QXX_ERROR_NONE)
+            return w25qxx_Stripe->w25qxx_Handles[device]->error;
+        w25qxx_Stripe->pendingTimeout[device] = W25QXX_PAGE_PROGRAM_TIME;
+
+        buf += chunkLength;
+        dataLength -= chunkLength;
+    }
+
+    return w25qxx_StripeWaitAll(w25qxx_Stripe);
+}
+
+w25qxx_Error_t w25qxx_StripeRead(w25qxx_StripeTypeDef *w25qxx_Stripe, uint8_t *buf, uint32_t dataLength,
+                                 uint32_t address, w25qxx_FastRead_t fastRead)
+{
+    uint32_t page, offset, chunkLength;
+    uint8_t device;
+
+    /* Argument guards */
+    if ((w25qxx_Stripe == NULL) || (buf == NULL) || (dataLength == 0))
+        return W25QXX_ERROR_ARGUMENT;
+    if (((uint64_t) address + dataLength) > ((uint64_t) W25QXX_PAGE_SIZE * w25qxx_Stripe->numberOfPages))
+        return W25QXX_ERROR_ADDRESS;
+
+    /* Unaligned head is read from the middle of its page, the rest page by page */
+    offset = address % W25QXX_PAGE_SIZE;
+    for (page = address / W25QXX_PAGE_SIZE; dataLength > 0; page++)
+    {
+        device = page % w25qxx_Stripe->numberOfDevices;
+        chunkLength = W25QXX_PAGE_SIZE - offset;
+        if (chunkLength > dataLength)
+            chunkLength = dataLength;
+
+        if (w25qxx_StripeWait(w25qxx_Stripe, device) != W25QXX_ERROR_NONE)
+            return w25qxx_Stripe->w25qxx_Handles[device]->error;
+        if (w25qxx_ReadStream(w25qxx_Stripe->w25qxx_Handles[device], buf, chunkLength,
+                              W25QXX_PAGE_TO_ADDRESS(page / w25qxx_Stripe->numberOfDevices) + offset,
+                              fastRead) != W25QXX_ERROR_NONE)
+            return w25qxx_Stripe->w25qxx_Handles[device]->error;
+
+        buf += chunkLength;
+        dataLength -= chunkLength;
+        offset = 0;
+    }
+
+    return W25QXX_ERROR_NONE;
+}
+
+w25qxx_Error_t w25qxx_StripeErase(w25qxx_StripeTypeDef *w25qxx_Stripe, uint32_t address, uint32_t length)
+{
+    w25qxx_EraseInstruction_t eraseInstruction;
+    uint32_t deviceAddress, deviceEnd, eraseSize, eraseTime;
+    uint8_t device;
+
+    /* Argument guards */
+    if (w25qxx_Stripe == NULL)
+        return W25QXX_ERROR_ARGUMENT;
+    if (w25qxx_Stripe->numberOfDevices == 0)
+        return W25QXX_ERROR_ARGUMENT;
+    if ((address % (W25QXX_SECTOR_SIZE_4KB * w25qxx_Stripe->numberOfDevices)) != 0)
+        return W25QXX_ERROR_ADDRESS;
+    if ((length == 0) || ((length % (W25QXX_SECTOR_SIZE_4KB * w25qxx_Stripe->numberOfDevices)) != 0))
+        return W25QXX_ERROR_ARGUMENT;
+    if (((uint64_t) address + length) > ((uint64_t) W25QXX_PAGE_SIZE * w25qxx_Stripe->numberOfPages))
+        return W25QXX_ERROR_ADDRESS;
+
+    /* Every device erases the same range of its own array */
+    deviceAddress = address / w25qxx_Stripe->numberOfDevices;
+    deviceEnd = deviceAddress + (length / w25qxx_Stripe->numberOfDevices);
+    while (deviceAddress < deviceEnd)
+    {
+        /* Biggest erase instruction that fits the remaining range */
+        if (((deviceAddress % W25QXX_BLOCK_SIZE_64KB) == 0) && ((deviceEnd - deviceAddress) >= W25QXX_BLOCK_SIZE_64KB))
+        {
+            eraseInstruction = W25QXX_BLOCK_ERASE_64KB;
+            eraseSize = W25QXX_BLOCK_SIZE_64KB;
+            eraseTime = W25QXX_BLOCK_ERASE_TIME_64KB;
+        }
+        else if (((deviceAddress % W25QXX_BLOCK_SIZE_32KB) == 0) &&
+                 ((deviceEnd - deviceAddress) >= W25QXX_BLOCK_SIZE_32KB))
+        {
+            eraseInstruction = W25QXX_BLOCK_ERASE_32KB;
+            eraseSize = W25QXX_BLOCK_SIZE_32KB;
+            eraseTime = W25QXX_BLOCK_ERASE_TIME_32KB;
+        }
+        else
+        {
+            eraseInstruction = W25QXX_SECTOR_ERASE_4KB;
+            eraseSize = W25QXX_SECTOR_SIZE_4KB;
+            eraseTime = W25QXX_SECTOR_ERASE_TIME_4KB;
+        }
+
+        for (device = 0; device < w25qxx_Stripe->numberOfDevices; device++)
+        {
+            if (w25qxx_StripeWait(w25qxx_Stripe, device) != W25QXX_ERROR_NONE)
+                return w25qxx_Stripe->w25qxx_Handles[device]->error;
+            if (w25qxx_Erase(w25qxx_Stripe->w25qxx_Handles[device], eraseInstruction, deviceAddress, W25QXX_WAIT_NO) !=
+                W25QXX_ERROR_NONE)
+                return w25qxx_Stripe->w25qxx_Handles[device]->error;
+            w25qxx_Stripe->pendingTimeout[device] = eraseTime;
+        }
+        deviceAddress += eraseSize;
+    }
+
+    return w25qxx_StripeWaitAll(w25qxx_Stripe);
+}
+
+/**
+ * @section Private functions
+ */
+static w25qxx_Error_t w25qxx_StripeWait(w25qxx_StripeTypeDef *w25qxx_Stripe, uint8_t device)
+{
+    w25qxx_HandleTypeDef *w25qxx_Handle = w25qxx_Stripe->w25qxx_Handles[device];
+
+    /* No operation in progress */
+    if (w25qxx_Stripe->pendingTimeout[device] == 0)
+        return w25qxx_Handle->error;
+
+    if (w25qxx_BusyCheck(w25qxx_Handle, w25qxx_Stripe->pendingTimeout[device]) != W25QXX_STATUS_READY)
+    {
+        if (w25qxx_Handle->error == W25QXX_ERROR_NONE)
+            w25qxx_Handle->error = W25QXX_ERROR_TIMEOUT;
+    }
+    w25qxx_Stripe->pendingTimeout[device] = 0;
+
+    return w25qxx_Handle->error;
+}
+
+static w25qxx_Error_t w25qxx_StripeWaitAll(w25qxx_StripeTypeDef *w25qxx_Stripe)
+{
+    uint8_t device;
+
+    for (device = 0; device < w25qxx_Stripe->numberOfDevices; device++)
+    {
+        if (w25qxx_StripeWait(w25qxx_Stripe, device) != W25QXX_ERROR_NONE)
+            return w25qxx_Stripe->w25qxx_Handles[device]->error;
+    }
+
+    return W25QXX_ERROR_NONE;
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "w25qxx.h"
+
+/* Configuration */
+#ifndef W25QXX_STRIPE_MAX_DEVICES
+#define W25QXX_STRIPE_MAX_DEVICES 4
+#endif
+
+/* Data types */
+typedef struct w25qxx_StripeTypeDef_s {
+    w25qxx_HandleTypeDef *w25qxx_Handles[W25QXX_STRIPE_MAX_DEVICES]; // Initialized member devices
+    uint8_t numberOfDevices;
+    uint32_t numberOfPages; // Number of pages of the whole volume
+    uint32_t pendingTimeout[W25QXX_STRIPE_MAX_DEVICES]; // Busy time of the device operation in progress [ms]
+} w25qxx_StripeTypeDef;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Builds a striped volume: consecutive pages are spread round-robin across the devices
+ * @param w25qxx_Stripe pointer to the striped volume structure
+ * @param w25qxx_Handles array of pointers to initialized device handles
+ * @param numberOfDevices number of devices within the array
+ * @note Volume capacity is limited by the smallest device
+ * @return `W25QXX_ERROR_NONE` or the error of the first failed device
+ */
+w25qxx_Error_t w25qxx_StripeInit(w25qxx_StripeTypeDef *w25qxx_Stripe, w25qxx_HandleTypeDef *const *w25qxx_Handles,
+                                 uint8_t numberOfDevices);
+
+/**
+ * @brief Writes data to the volume, page program of one device overlaps with the transfer to the next one
+ * @param w25qxx_Stripe pointer to the striped volume structure
+ * @param buf pointer to external buffer, that contains the data to send
+ * @param dataLength number of bytes to write
+ * @param address volume page address to write (multiple of 256 bytes)
+ * @note Writes are page aligned since a page is the striping unit and `w25qxx_Write()` programs whole page frames,
+ * the last page may be partial
+ * @return `W25QXX_ERROR_NONE` or the error of the first failed device
+ */
+w25qxx_Error_t w25qxx_StripeWrite(w25qxx_StripeTypeDef *w25qxx_Stripe, const uint8_t *buf, uint32_t dataLength,
+                                  uint32_t address);
+
+/**
+ * @brief Reads data from the volume to external buffer
+ * @param w25qxx_Stripe pointer to the striped volume structure
+ * @param buf pointer to external buffer, that will contain the received data
+ * @param dataLength number of bytes to read
+ * @param address volume address to read from, any alignment
+ * @param fastRead set true if SPIclk > 50MHz
+ * @return `W25QXX_ERROR_NONE` or the error of the first failed device
+ */
+w25qxx_Error_t w25qxx_StripeRead(w25qxx_StripeTypeDef *w25qxx_Stripe, uint8_t *buf, uint32_t dataLength,
+                                 uint32_t address, w25qxx_FastRead_t fastRead);
+
+/**
+ * @brief Erases an address range of the volume, member devices erase simultaneously
+ * @param w25qxx_Stripe pointer to the striped volume structure
+ * @param address start address (multiple of `numberOfDevices` sectors)
+ * @param length number of bytes to erase (multiple of `numberOfDevices` sectors)
+ * @return `W25QXX_ERROR_NONE` or the error of the first failed device
+ */
+w25qxx_Error_t w25qxx_StripeErase(w25qxx_StripeTypeDef *w25qxx_Stripe, uint32_t address, uint32_t length);
+
+#ifdef __cplusplus
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,190 @@
+#include "w25qxx_Update.h"
+
+typedef enum w25qxx_UpdateDelta_e {
+    W25QXX_UPDATE_EQUAL,
+    W25QXX_UPDATE_PROGRAM,
+    W25QXX_UPDATE_ERASE
+} w25qxx_UpdateDelta_t;
+
+static w25qxx_UpdateDelta_t w25qxx_UpdateCompare(const uint8_t *oldData, const uint8_t *newData, uint16_t newLength);
+static bool w25qxx_UpdateBlank(const uint8_t *data, uint16_t length);
+
+w25qxx_Error_t w25qxx_UpdateInit(w25qxx_UpdateTypeDef *w25qxx_Update, w25qxx_HandleTypeDef *w25qxx_Handle)
+{
+    /* Avoid dereferencing the null handle */
+    if ((w25qxx_Update == NULL) || (w25qxx_Handle == NULL))
+        return W25QXX_ERROR_ARGUMENT;
+
+    memset(w25qxx_Update, 0, sizeof(*w25qxx_Update));
+    w25qxx_Update->w25qxx_Handle = w25qxx_Handle;
+
+    return w25qxx_Handle->error;
+}
+
+w25qxx_Error_t w25qxx_UpdateSector(w25qxx_UpdateTypeDef *w25qxx_Update, uint32_t sector, const uint8_t *data,
+                                   uint16_t dataLength)
+{
+    w25qxx_HandleTypeDef *w25qxx_Handle;
+    uint32_t address;
+    uint16_t page, offset, pageLength, changedPages = 0;
+    bool eraseNeeded = false;
+
+    /* Avoid dereferencing the null handle */
+    if ((w25qxx_Update == NULL) || (w25qxx_Update->w25qxx_Handle == NULL))
+        return W25QXX_ERROR_ARGUMENT;
+    w25qxx_Handle = w25qxx_Update->w25qxx_Handle;
+
+    /* Argument guards */
+    if (data == NULL)
+        return w25qxx_Handle->error = W25QXX_ERROR_ARGUMENT;
+    if (dataLength > W25QXX_SECTOR_SIZE_4KB)
+        return w25qxx_Handle->error = W25QXX_ERROR_ARGUMENT;
+    if (W25QXX_SECTOR_TO_ADDRESS(sector) >= (W25QXX_PAGE_SIZE * w25qxx_Handle->numberOfPages))
+        return w25qxx_Handle->error = W25QXX_ERROR_ADDRESS;
+    address = W25QXX_SECTOR_TO_ADDRESS(sector);
+
+    /* Delta of each page against the current content, one read instruction per chunk */
+    for (page = 0; page < (W25QXX_SECTOR_SIZE_4KB / W25QXX_PAGE_SIZE); page++)
+    {
+        offset = page * W25QXX_PAGE_SIZE;
+        pageLength = (dataLength > offset) ? (dataLength - offset) : 0;
+        if (pageLength > W25QXX_PAGE_SIZE)
+            pageLength = W25QXX_PAGE_SIZE;
+
+        if (((offset % W25QXX_UPDATE_CHUNK_SIZE) == 0) &&
+            (w25qxx_ReadStream(w25qxx_Handle, w25qxx_Update->chunkBuf, W25QXX_UPDATE_CHUNK_SIZE, address + offset,
+                               W25QXX_FASTREAD_NO) != W25QXX_ERROR_NONE))
+            return w25qxx_Handle->error;
+
+        switch (w25qxx_UpdateCompare(&w25qxx_Update->chunkBuf[offset % W25QXX_UPDATE_CHUNK_SIZE], &data[offset],
+                                     pageLength))
+        {
+        case W25QXX_UPDATE_EQUAL:
+            break;
+
+        case W25QXX_UPDATE_PROGRAM:
+            changedPages |= 1u << page;
+            break;
+
+        case W25QXX_UPDATE_ERASE:
+            changedPages |= 1u << page;
+            eraseNeeded = true;
+            break;
+        }
+    }
+
+    if (changedPages == 0)
+    {
+        w25qxx_Update->stats.sectorsUnchanged++;
+        return w25qxx_Handle->error;
+    }
+
+    /* After the erase every page with data has to be programmed, blank ones are left as is */
+    if (eraseNeeded)
+    {
+        if (w25qxx_Erase(w25qxx_Handle, W25QXX_SECTOR_ERASE_4KB, address, W25QXX_WAIT_BUSY) != W25QXX_ERROR_NONE)
+            return w25qxx_Handle->error;
+        changedPages = 0;
+        for (offset = 0; offset < dataLength; offset += W25QXX_PAGE_SIZE)
+        {
+            pageLength = dataLength - offset;
+            if (pageLength > W25QXX_PAGE_SIZE)
+                pageLength = W25QXX_PAGE_SIZE;
+            if (!w25qxx_UpdateBlank(&data[offset], pageLength))
+                changedPages |= 1u << (offset / W25QXX_PAGE_SIZE);
+        }
+        w25qxx_Update->stats.sectorsErased++;
+    }
+    else
+        w25qxx_Update->stats.sectorsProgrammed++;
+
+    /* Program only clears bits, so the changed pages are written over the old content */
+    for (page = 0; page < (W25QXX_SECTOR_SIZE_4KB / W25QXX_PAGE_SIZE); page++)
+    {
+        offset = page * W25QXX_PAGE_SIZE;
+        pageLength = (dataLength > offset) ? (dataLength - offset) : 0;
+        if (pageLength > W25QXX_PAGE_SIZE)
+            pageLength = W25QXX_PAGE_SIZE;
+        if (!(changedPages & (1u << page)) || (pageLength == 0))
+            continue;
+
+        if (w25qxx_Write(w25qxx_Handle, &data[offset], pageLength, address + offset, W25QXX_CRC_NO,
+                         W25QXX_WAIT_BUSY) != W25QXX_ERROR_NONE)
+            return w25qxx_Handle->error;
+        w25qxx_Update->stats.pagesProgrammed++;
+        w25qxx_Update->stats.bytesProgrammed += pageLength;
+    }
+
+    return w25qxx_Handle->error;
+}
+
+w25qxx_Error_t w25qxx_UpdateImage(w25qxx_UpdateTypeDef *w25qxx_Update, const uint8_t *image, uint32_t imageLength,
+                                  uint32_t address)
+{
+    w25qxx_HandleTypeDef *w25qxx_Handle;
+    uint32_t offset, sectorLength;
+
+    /* Avoid dereferencing the null handle */
+    if ((w25qxx_Update == NULL) || (w25qxx_Update->w25qxx_Handle == NULL))
+        return W25QXX_ERROR_ARGUMENT;
+    w25qxx_Handle = w25qxx_Update->w25qxx_Handle;
+
+    /* Argument guards */
+    if (image == NULL)
+        return w25qxx_Handle->error = W25QXX_ERROR_ARGUMENT;
+    if ((address % W25QXX_SECTOR_SIZE_4KB) != 0)
+        return w25qxx_Handle->error = W25QXX_ERROR_ADDRESS;
+    if (imageLength > ((W25QXX_PAGE_SIZE * w25qxx_Handle->numberOfPages) - address))
+        return w25qxx_Handle->error = W25QXX_ERROR_ADDRESS;
+
+    for (offset = 0; offset < imageLength; offset += W25QXX_SECTOR_SIZE_4KB)
+    {
+        sectorLength = imageLength - offset;
+        if (sectorLength > W25QXX_SECTOR_SIZE_4KB)
+            sectorLength = W25QXX_SECTOR_SIZE_4KB;
+
+        if (w25qxx_UpdateSector(w25qxx_Update, (address + offset) / W25QXX_SECTOR_SIZE_4KB, &image[offset],
+                                (uint16_t) sectorLength) != W25QXX_ERROR_NONE)
+            break;
+    }
+
+    return w25qxx_Handle->error;
+}
+
+/**
+ * @section Private functions
+ */
+static w25qxx_UpdateDelta_t w25qxx_UpdateCompare(const uint8_t *oldData, const uint8_t *newData, uint16_t newLength)
+{
+    w25qxx_UpdateDelta_t delta = W25QXX_UPDATE_EQUAL;
+    uint16_t i;
+    uint8_t newByte;
+
+    /* Bytes beyond the new data are expected erased */
+    for (i = 0; i < W25QXX_PAGE_SIZE; i++)
+    {
+        newByte = (i < newLength) ? newData[i] : 0xFF;
+        if (oldData[i] == newByte)
+            continue;
+
+        /* Bit to be set needs the erase */
+        if ((uint8_t) (~oldData[i] & newByte) != 0)
+            return W25QXX_UPDATE_ERASE;
+        delta = W25QXX_UPDATE_PROGRAM;
+    }
+
+    return delta;
+}
+
+static bool w25qxx_UpdateBlank(const uint8_t *data, uint16_t length)
+{
+    uint16_t i;
+
+    for (i = 0; i < length; i++)
+    {
+        if (data[i] != 0xFF)
+            return false;
+    }
+
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "w25qxx.h"
+
+/* Configuration */
+#ifndef W25QXX_UPDATE_CHUNK_SIZE
+#define W25QXX_UPDATE_CHUNK_SIZE W25QXX_SECTOR_SIZE_4KB // Read-back chunk of the sector compare (n * 256 bytes <= 4KB)
+#endif
+
+/* Data types */
+typedef struct w25qxx_UpdateTypeDef_s {
+    w25qxx_HandleTypeDef *w25qxx_Handle;
+
+    struct {
+        uint32_t sectorsUnchanged; // Sectors identical to the new data, nothing is sent to the device
+        uint32_t sectorsProgrammed; // Sectors updated without erase, new data only clears bits
+        uint32_t sectorsErased; // Sectors erased and programmed
+        uint32_t pagesProgrammed; // Number of page program instructions
+        uint32_t bytesProgrammed; // Number of data bytes actually programmed
+    } stats;
+
+    uint8_t chunkBuf[W25QXX_UPDATE_CHUNK_SIZE];
+} w25qxx_UpdateTypeDef;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Links the updater to the device and resets its statistics
+ * @param w25qxx_Update pointer to the updater structure
+ * @param w25qxx_Handle pointer to the initialized device handle
+ * @return `w25qxx_Handle->error`
+ */
+w25qxx_Error_t w25qxx_UpdateInit(w25qxx_UpdateTypeDef *w25qxx_Update, w25qxx_HandleTypeDef *w25qxx_Handle);
+
+/**
+ * @brief Brings one sector to the new content with the least program/erase work
+ * @param w25qxx_Update pointer to the updater structure
+ * @param sector sector number to update
+ * @param data new content of the sector
+ * @param dataLength number of new bytes (<= 4KB), the rest of the sector is expected erased
+ * @note Sector is streamed back in `W25QXX_UPDATE_CHUNK_SIZE` chunks and compared with the new data page by page.
+ * Equal pages are skipped, the sector is erased only if a page needs any bit to be set, then blank pages are not
+ * programmed. Otherwise the changed pages are programmed over the old content
+ * @return `w25qxx_Handle->error`
+ */
+w25qxx_Error_t w25qxx_UpdateSector(w25qxx_UpdateTypeDef *w25qxx_Update, uint32_t sector, const uint8_t *data,
+                                   uint16_t dataLength);
+
+/**
+ * @brief Brings the area starting at `address` to the new image content, sector by sector
+ * @param w25qxx_Update pointer to the updater structure
+ * @param image new image
+ * @param imageLength number of bytes of the image
+ * @param address start address of the area (multiple of 4KB)
+ * @note The rest of the last sector is left erased. Progress and the amount of work are in `stats`
+ * @return `w25qxx_Handle->error`
+ */
+w25qxx_Error_t w25qxx_UpdateImage(w25qxx_UpdateTypeDef *w25qxx_Update, const uint8_t *image, uint32_t imageLength,
+                                  uint32_t address);
+
+#ifdef __cplusplus
+}
+#endif
\ No newline at end of file